@@ -48,6 +48,12 @@ function usage () {
     echo "    --propagate-copies            enable   copy propagation"
     echo "    --eliminate-unreachable-code  enable   unreachable code elimination"
     echo "    --eliminate-dead-stores       enable   dead store elimination"
+    echo "    --hoist-loop-invariants       enable   loop invariant code motion"
+    echo "    --number-values               enable   global value numbering"
+    echo "    --replace-aggregates          enable   scalar replacement of aggregates"
+    echo "    --unroll-loops                enable   loop unrolling"
+    echo "    --unroll-factor=<n>           set      loop unrolling factor (default 4)"
+    echo "    --unroll-budget=<n>           set      loop unrolling size budget (default 64)"
     echo "    --optimize                    enable   all level 1 optimizations"
     echo "    -O1                           alias    for --optimize"
     echo "    (Level 2):"
@@ -55,8 +61,25 @@ function usage () {
     echo "    --no-coalescing               disable  register coalescing"
     echo "    --allocate-register           enable   register allocation (default)"
     echo "    -O2                           alias    for --allocate-register"
+    echo "    (Codegen):"
+    echo "    -fomit-frame-pointer          enable   frame pointer omission"
+    echo "    -fno-omit-frame-pointer       disable  frame pointer omission (default)"
+    echo "    -foptimize-sibling-calls      enable   sibling call optimization"
+    echo "    -fno-optimize-sibling-calls   disable  sibling call optimization (default)"
+    echo "    -ftree-vectorize              enable   loop vectorization"
+    echo "    -fno-tree-vectorize           disable  loop vectorization (default)"
+    echo "    -freorder-blocks              enable   basic block reordering"
+    echo "    -fno-reorder-blocks           disable  basic block reordering (default)"
+    echo "    -falign-loops                 enable   loop head alignment"
+    echo "    -fno-align-loops              disable  loop head alignment (default)"
+    echo "    -fprofile-generate            enable   profile instrumentation"
+    echo "    -fintegrated-as               enable   object code emission without as"
+    echo "    -fno-integrated-as            disable  object code emission without as (default)"
+    echo "    -fprofile-use[=<file>]        set      profile file to optimize with (default wheelcc.prof)"
+    echo "    -ftime-report[=json]          print    time and memory spent in each stage (as table or json)"
     echo "    (Level 3):"
-    echo "    -O3                           alias    for -O1 -O2"
+    echo "    -O3                           alias    for -O1 -O2 -fomit-frame-pointer -foptimize-sibling-calls -ftree-vectorize"
+    echo "                                           -freorder-blocks -falign-loops"
     echo ""
     echo "[Preprocess]:"
     echo "    -E  enable macro expansion with ${PP}"
@@ -114,6 +137,9 @@ function clean_exit () {
     if [ -f "${PACKAGE_DIR}/crt.o" ]; then
         rm ${PACKAGE_DIR}/crt.o
     fi
+    if [ -f "${PACKAGE_DIR}/prof.o" ]; then
+        rm ${PACKAGE_DIR}/prof.o
+    fi
     exit ${EXIT_CODE}
 }
 
@@ -181,6 +207,7 @@ function parse_optimize_arg () {
         "-O0")
             OPTIM_L1_MASK=0
             OPTIM_L2_ENUM=0
+            CODEGEN_MASK=0
             ;;
         "--fold-constants")
             OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 0))
@@ -194,17 +221,49 @@ function parse_optimize_arg () {
         "--eliminate-dead-stores")
             OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 3))
             ;;
+        "--hoist-loop-invariants")
+            OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 4))
+            ;;
+        "--number-values")
+            OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 5))
+            ;;
+        "--replace-aggregates")
+            OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 6))
+            ;;
+        "--unroll-loops")
+            OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 7))
+            ;;
+        "--unroll-factor="*)
+            UNROLL_FACTOR="${ARG#*=}"
+            if [[ ! "${UNROLL_FACTOR}" =~ ^[0-9]+$ ]] || [ ${UNROLL_FACTOR} -gt 16 ]; then
+                raise_error "invalid loop unrolling factor $(em "${UNROLL_FACTOR}")"
+            fi
+            ;;
+        "--unroll-budget="*)
+            UNROLL_BUDGET="${ARG#*=}"
+            if [[ ! "${UNROLL_BUDGET}" =~ ^[0-9]+$ ]] || [ ${UNROLL_BUDGET} -gt 255 ]; then
+                raise_error "invalid loop unrolling budget $(em "${UNROLL_BUDGET}")"
+            fi
+            ;;
         "--optimize")
             OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 0))
             OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 1))
             OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 2))
             OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 3))
+            OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 4))
+            OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 5))
+            OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 6))
+            OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 7))
             ;;
         "-O1")
             OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 0))
             OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 1))
             OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 2))
             OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 3))
+            OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 4))
+            OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 5))
+            OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 6))
+            OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 7))
             ;;
         "--no-allocation")
             OPTIM_L2_ENUM=0
@@ -218,12 +277,84 @@ function parse_optimize_arg () {
         "-O2")
             OPTIM_L2_ENUM=2
             ;;
+        "-fomit-frame-pointer")
+            CODEGEN_MASK=$((CODEGEN_MASK | 1 << 0))
+            ;;
+        "-fno-omit-frame-pointer")
+            CODEGEN_MASK=$((CODEGEN_MASK & ~(1 << 0)))
+            ;;
+        "-foptimize-sibling-calls")
+            CODEGEN_MASK=$((CODEGEN_MASK | 1 << 1))
+            ;;
+        "-fno-optimize-sibling-calls")
+            CODEGEN_MASK=$((CODEGEN_MASK & ~(1 << 1)))
+            ;;
+        "-ftree-vectorize")
+            CODEGEN_MASK=$((CODEGEN_MASK | 1 << 2))
+            ;;
+        "-fno-tree-vectorize")
+            CODEGEN_MASK=$((CODEGEN_MASK & ~(1 << 2)))
+            ;;
+        "-freorder-blocks")
+            CODEGEN_MASK=$((CODEGEN_MASK | 1 << 4))
+            ;;
+        "-fno-reorder-blocks")
+            CODEGEN_MASK=$((CODEGEN_MASK & ~(1 << 4)))
+            ;;
+        "-falign-loops")
+            CODEGEN_MASK=$((CODEGEN_MASK | 1 << 5))
+            ;;
+        "-fno-align-loops")
+            CODEGEN_MASK=$((CODEGEN_MASK & ~(1 << 5)))
+            ;;
+        "-fintegrated-as")
+            if [[ "$(uname -s)" = "Darwin"* ]]; then
+                raise_error "$(em "-fintegrated-as") is not supported on macOS"
+            fi
+            CODEGEN_MASK=$((CODEGEN_MASK | 1 << 6))
+            ;;
+        "-fno-integrated-as")
+            CODEGEN_MASK=$((CODEGEN_MASK & ~(1 << 6)))
+            ;;
+        "-fprofile-generate")
+            if [[ "$(uname -s)" = "Darwin"* ]]; then
+                raise_error "$(em "-fprofile-generate") is not supported on macOS"
+            fi
+            CODEGEN_MASK=$((CODEGEN_MASK | 1 << 3))
+            ;;
+        "-fprofile-use")
+            PROFILE_FILE="$(readlink -f wheelcc.prof)"
+            if [ ! -f "${PROFILE_FILE}" ]; then
+                raise_error "cannot find $(em "${PROFILE_FILE}"): no such file"
+            fi
+            ;;
+        "-fprofile-use="*)
+            PROFILE_FILE="$(readlink -f ${ARG#*=})"
+            if [ ! -f "${PROFILE_FILE}" ]; then
+                raise_error "cannot find $(em "${PROFILE_FILE}"): no such file"
+            fi
+            ;;
+        "-ftime-report")
+            REPORT_ENUM=1
+            ;;
+        "-ftime-report=json")
+            REPORT_ENUM=2
+            ;;
         "-O3")
             OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 0))
             OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 1))
             OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 2))
             OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 3))
+            OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 4))
+            OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 5))
+            OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 6))
+            OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 7))
             OPTIM_L2_ENUM=2
+            CODEGEN_MASK=$((CODEGEN_MASK | 1 << 0))
+            CODEGEN_MASK=$((CODEGEN_MASK | 1 << 1))
+            CODEGEN_MASK=$((CODEGEN_MASK | 1 << 2))
+            CODEGEN_MASK=$((CODEGEN_MASK | 1 << 4))
+            CODEGEN_MASK=$((CODEGEN_MASK | 1 << 5))
             ;;
         *)
             return 1
@@ -528,14 +659,23 @@ function preprocess () {
 }
 
 function compile () {
+    if [ $((CODEGEN_MASK & 1 << 6)) -ne 0 ]; then
+        if [ ${LINK_ENUM} -eq 1 ] || [ $((CODEGEN_MASK & 1 << 3)) -ne 0 ]; then
+            CODEGEN_MASK=$((CODEGEN_MASK & ~(1 << 6)))
+        fi
+    fi
+    EXT_EMIT="${EXT_OUT}"
+    if [ $((CODEGEN_MASK & 1 << 6)) -ne 0 ]; then
+        EXT_EMIT="o"
+    fi
     for FILE in ${FILES}; do
         SOURCE_DIR="$(dirname ${FILE})/"
         echo "${INCLUDE_DIRS}" | grep -q "${SOURCE_DIR} "
         if [ ${?} -eq 0 ]; then
             SOURCE_DIR=""
         fi
-        verbose "Compile (${PACKAGE_NAME}) -> ${FILE}.${EXT_OUT}"
-        ${PACKAGE_DIR}/${PACKAGE_NAME} ${DEBUG_ENUM} ${OPTIM_L1_MASK} ${OPTIM_L2_ENUM} ${FILE}.${EXT_IN} ${LIBC_DIR} ${SOURCE_DIR} ${INCLUDE_DIRS}
+        verbose "Compile (${PACKAGE_NAME}) -> ${FILE}.${EXT_EMIT}"
+        ${PACKAGE_DIR}/${PACKAGE_NAME} ${DEBUG_ENUM} ${OPTIM_L1_MASK} ${OPTIM_L2_ENUM} ${CODEGEN_MASK} ${UNROLL_FACTOR} ${UNROLL_BUDGET} ${PROFILE_FILE} ${REPORT_ENUM} ${FILE}.${EXT_IN} ${LIBC_DIR} ${SOURCE_DIR} ${INCLUDE_DIRS}
         if [ ${?} -ne 0 ]; then
             raise_error "compilation failed"
         fi
@@ -544,6 +684,9 @@ function compile () {
 }
 
 function assemble () {
+    if [ $((CODEGEN_MASK & 1 << 6)) -ne 0 ]; then
+        return 0
+    fi
     for FILE in ${FILES}; do
         verbose "Assemble (as) -> ${FILE}.o"
         as ${AS_FLAGS} ${FILE}.${EXT_OUT} -o ${FILE}.o
@@ -558,6 +701,15 @@ function link () {
         case ${LINK_ENUM} in
             0)
                 assemble
+                PROF_OBJ=""
+                if [ $((CODEGEN_MASK & 1 << 3)) -ne 0 ]; then
+                    verbose "Assemble (as) -> ${PACKAGE_DIR}/prof.o"
+                    as ${AS_FLAGS} ${PACKAGE_DIR}/prof.${EXT_OUT} -o ${PACKAGE_DIR}/prof.o
+                    if [ ${?} -ne 0 ]; then
+                        raise_error "assembling failed"
+                    fi
+                    PROF_OBJ="${PACKAGE_DIR}/prof.o"
+                fi
                 if [ ! -f "${LD_LIB_64}" ]; then
                     LD_LIB_64=""
                 fi
@@ -569,14 +721,14 @@ function link () {
                     fi
                     verbose "Link (ld) -> ${NAME_OUT}"
                     ld --build-id -m elf_x86_64 --hash-style=gnu -dynamic-linker ${LD_LIB_64} -pie -lc ${PACKAGE_DIR}/crt.o \
-                        ${FILES// /.o }.o ${LINK_DIRS} ${LINK_LIBS} -o ${NAME_OUT}
+                        ${FILES// /.o }.o ${PROF_OBJ} ${LINK_DIRS} ${LINK_LIBS} -o ${NAME_OUT}
                     if [ ${?} -ne 0 ]; then
                         LD_LIB_64=""
                     fi
                 fi
                 if [ -z "${LD_LIB_64}" ]; then
                     verbose "Link (${CC}) -> ${NAME_OUT}"
-                    ${CC} ${FILES// /.o }.o ${LINK_DIRS} ${LINK_LIBS} -o ${NAME_OUT}
+                    ${CC} ${FILES// /.o }.o ${PROF_OBJ} ${LINK_DIRS} ${LINK_LIBS} -o ${NAME_OUT}
                     if [ ${?} -ne 0 ]; then
                         raise_error "linking failed"
                     fi
@@ -611,6 +763,11 @@ LINK_ENUM=0
 
 OPTIM_L1_MASK=0
 OPTIM_L2_ENUM=2
+CODEGEN_MASK=0
+UNROLL_FACTOR=4
+UNROLL_BUDGET=64
+PROFILE_FILE="-"
+REPORT_ENUM=0
 
 DEF_VALS=""
 PREPROC_DIRS=""
@@ -0,0 +1,89 @@
+    .globl __wheelcc_prof_init
+    .text
+__wheelcc_prof_init:
+    cmpb $0, .Lprof.is_init(%rip)
+    jne .Lprof.init_exit
+    movb $1, .Lprof.is_init(%rip)
+    pushq %rdi
+    pushq %rsi
+    pushq %rdx
+    pushq %rbx
+    movq %rsp, %rbx
+    andq $-16, %rsp
+    leaq __wheelcc_prof_dump(%rip), %rdi
+    xorl %esi, %esi
+    xorl %edx, %edx
+    call __cxa_atexit@PLT
+    movq %rbx, %rsp
+    popq %rbx
+    popq %rdx
+    popq %rsi
+    popq %rdi
+.Lprof.init_exit:
+    ret
+
+    .text
+__wheelcc_prof_dump:
+    pushq %rbx
+    pushq %r12
+    pushq %r13
+    pushq %r14
+    pushq %r15
+    leaq .Lprof.env(%rip), %rdi
+    call getenv@PLT
+    testq %rax, %rax
+    jne .Lprof.open
+    leaq .Lprof.path(%rip), %rax
+.Lprof.open:
+    movq %rax, %rdi
+    leaq .Lprof.mode(%rip), %rsi
+    call fopen@PLT
+    testq %rax, %rax
+    je .Lprof.dump_exit
+    movq %rax, %r12
+    leaq __start_wheelcc_prof(%rip), %r13
+    leaq __stop_wheelcc_prof(%rip), %r14
+.Lprof.table:
+    cmpq %r14, %r13
+    jae .Lprof.close
+    xorl %ebx, %ebx
+.Lprof.count:
+    cmpq (%r13), %rbx
+    jae .Lprof.next_table
+    movq 8(%r13), %rax
+    movq (%rax,%rbx,8), %rdx
+    movq 16(%r13), %rax
+    movq (%rax,%rbx,8), %rcx
+    movq %r12, %rdi
+    leaq .Lprof.format(%rip), %rsi
+    xorl %eax, %eax
+    call fprintf@PLT
+    incq %rbx
+    jmp .Lprof.count
+.Lprof.next_table:
+    addq $24, %r13
+    jmp .Lprof.table
+.Lprof.close:
+    movq %r12, %rdi
+    call fclose@PLT
+.Lprof.dump_exit:
+    popq %r15
+    popq %r14
+    popq %r13
+    popq %r12
+    popq %rbx
+    ret
+
+    .bss
+.Lprof.is_init:
+    .zero 1
+    .section .rodata
+.Lprof.env:
+    .asciz "WHEELCC_PROFILE"
+.Lprof.path:
+    .asciz "wheelcc.prof"
+.Lprof.mode:
+    .asciz "a"
+.Lprof.format:
+    .asciz "%s %lu\n"
+        .section .note.GNU-stack,"",@progbits
@@ -25,6 +25,9 @@ else
     CC_FLAGS="${CC_FLAGS} ${CC_FLAGS_DEBUG}"
 fi
 
+# Allocations of the libraries are counted for the time report
+LIB_FLAGS="-include util/lib_alloc.h"
+
 PROJECT_NAME="${PROJECT_DIR}/bin/${PACKAGE_NAME}"
 
 INCLUDE_DIRS="-I${PROJECT_DIR}/include/"
@@ -41,7 +44,9 @@ SOURCE_FILES="${SOURCE_FILES} ${PROJECT_DIR}/src/ast/back_symt.c"
 SOURCE_FILES="${SOURCE_FILES} ${PROJECT_DIR}/src/ast/front_ast.c"
 SOURCE_FILES="${SOURCE_FILES} ${PROJECT_DIR}/src/ast/front_symt.c"
 SOURCE_FILES="${SOURCE_FILES} ${PROJECT_DIR}/src/ast/interm_ast.c"
+SOURCE_FILES="${SOURCE_FILES} ${PROJECT_DIR}/src/optimization/block_layout.c"
 SOURCE_FILES="${SOURCE_FILES} ${PROJECT_DIR}/src/optimization/optim_tac.c"
+SOURCE_FILES="${SOURCE_FILES} ${PROJECT_DIR}/src/optimization/peephole.c"
 SOURCE_FILES="${SOURCE_FILES} ${PROJECT_DIR}/src/optimization/reg_alloc.c"
 SOURCE_FILES="${SOURCE_FILES} ${PROJECT_DIR}/src/frontend/parser/errors.c"
 SOURCE_FILES="${SOURCE_FILES} ${PROJECT_DIR}/src/frontend/parser/lexer.c"
@@ -53,11 +58,13 @@ SOURCE_FILES="${SOURCE_FILES} ${PROJECT_DIR}/src/backend/assembly/asm_gen.c"
 SOURCE_FILES="${SOURCE_FILES} ${PROJECT_DIR}/src/backend/assembly/registers.c"
 SOURCE_FILES="${SOURCE_FILES} ${PROJECT_DIR}/src/backend/assembly/stack_fix.c"
 SOURCE_FILES="${SOURCE_FILES} ${PROJECT_DIR}/src/backend/assembly/symt_cvt.c"
+SOURCE_FILES="${SOURCE_FILES} ${PROJECT_DIR}/src/backend/emitter/elf_code.c"
 SOURCE_FILES="${SOURCE_FILES} ${PROJECT_DIR}/src/backend/emitter/gas_code.c"
 SOURCE_FILES="${SOURCE_FILES} ${PROJECT_DIR}/src/util/fileio.c"
 SOURCE_FILES="${SOURCE_FILES} ${PROJECT_DIR}/src/util/pprint.c"
 SOURCE_FILES="${SOURCE_FILES} ${PROJECT_DIR}/src/util/str2t.c"
 SOURCE_FILES="${SOURCE_FILES} ${PROJECT_DIR}/src/util/throw.c"
+SOURCE_FILES="${SOURCE_FILES} ${PROJECT_DIR}/src/util/time_report.c"
 SOURCE_FILES="${SOURCE_FILES} ${PROJECT_DIR}/lib/sds/sds.c"
 SOURCE_FILES="${SOURCE_FILES} ${PROJECT_DIR}/lib/stb_ds/stb_ds.c"
 
@@ -77,6 +84,10 @@ for FILE in ${SOURCE_FILES}; do
     OBJECT_FILES="${OBJECT_FILES} ${OBJECT}"
     echo "${FILE} -> ${OBJECT}"
     BUILD_CC="${CC}"
+    BUILD_FLAGS="${CC_FLAGS}"
+    if [[ "${FILE}" = "${PROJECT_DIR}/lib/"* ]]; then
+        BUILD_FLAGS="${BUILD_FLAGS} ${LIB_FLAGS}"
+    fi
     case "${FILE##*.}" in
         "c")
             ;;
@@ -87,7 +98,7 @@ for FILE in ${SOURCE_FILES}; do
         *)
             exit 1
     esac
-    ${BUILD_CC} -c ${FILE} ${CC_FLAGS} ${INCLUDE_DIRS} -o ${OBJECT}
+    ${BUILD_CC} -c ${FILE} ${BUILD_FLAGS} ${INCLUDE_DIRS} -o ${OBJECT}
     if [ ${?} -ne 0 ]; then exit 1; fi
 done
 echo "OK"
@@ -256,7 +256,10 @@ typedef struct AsmUnaryOp {
 //             | Cvtsi2sd(assembly_type, operand, operand)
 //             | Unary(unary_operator, assembly_type, operand)
 //             | Binary(binary_operator, assembly_type, operand, operand)
+//             | MovPacked(assembly_type, operand, operand)
+//             | BinaryPacked(binary_operator, assembly_type, operand, operand)
 //             | Cmp(assembly_type, operand, operand)
+//             | Test(assembly_type, operand, operand)
 //             | Idiv(assembly_type, operand)
 //             | Div(assembly_type, operand)
 //             | Cdq(assembly_type)
@@ -267,6 +270,7 @@ typedef struct AsmUnaryOp {
 //             | Push(operand)
 //             | Pop(reg)
 //             | Call(identifier)
+//             | TailCall(identifier)
 //             | Ret
 
 typedef struct AsmMov {
@@ -319,12 +323,31 @@ typedef struct AsmBinary {
     shared_ptr_t(AsmOperand) dst;
 } AsmBinary;
 
+typedef struct AsmMovPacked {
+    shared_ptr_t(AssemblyType) asm_type;
+    shared_ptr_t(AsmOperand) src;
+    shared_ptr_t(AsmOperand) dst;
+} AsmMovPacked;
+
+typedef struct AsmBinaryPacked {
+    AsmBinaryOp binop;
+    shared_ptr_t(AssemblyType) asm_type;
+    shared_ptr_t(AsmOperand) src;
+    shared_ptr_t(AsmOperand) dst;
+} AsmBinaryPacked;
+
 typedef struct AsmCmp {
     shared_ptr_t(AssemblyType) asm_type;
     shared_ptr_t(AsmOperand) src;
     shared_ptr_t(AsmOperand) dst;
 } AsmCmp;
 
+typedef struct AsmTest {
+    shared_ptr_t(AssemblyType) asm_type;
+    shared_ptr_t(AsmOperand) src;
+    shared_ptr_t(AsmOperand) dst;
+} AsmTest;
+
 typedef struct AsmIdiv {
     shared_ptr_t(AssemblyType) asm_type;
     shared_ptr_t(AsmOperand) src;
@@ -369,6 +392,10 @@ typedef struct AsmCall {
     TIdentifier name;
 } AsmCall;
 
+typedef struct AsmTailCall {
+    TIdentifier name;
+} AsmTailCall;
+
 typedef struct AsmRet {
     int8_t _empty;
 } AsmRet;
@@ -385,7 +412,10 @@ typedef struct AsmInstruction {
         AsmCvtsi2sd _AsmCvtsi2sd;
         AsmUnary _AsmUnary;
         AsmBinary _AsmBinary;
+        AsmMovPacked _AsmMovPacked;
+        AsmBinaryPacked _AsmBinaryPacked;
         AsmCmp _AsmCmp;
+        AsmTest _AsmTest;
         AsmIdiv _AsmIdiv;
         AsmDiv _AsmDiv;
         AsmCdq _AsmCdq;
@@ -396,6 +426,7 @@ typedef struct AsmInstruction {
         AsmPush _AsmPush;
         AsmPop _AsmPop;
         AsmCall _AsmCall;
+        AsmTailCall _AsmTailCall;
         AsmRet _AsmRet;
     } get;
 } AsmInstruction;
@@ -419,8 +450,14 @@ unique_ptr_t(AsmInstruction)
     make_AsmUnary(const AsmUnaryOp* unop, shared_ptr_t(AssemblyType) * asm_type, shared_ptr_t(AsmOperand) * dst);
 unique_ptr_t(AsmInstruction) make_AsmBinary(const AsmBinaryOp* binop, shared_ptr_t(AssemblyType) * asm_type,
     shared_ptr_t(AsmOperand) * src, shared_ptr_t(AsmOperand) * dst);
+unique_ptr_t(AsmInstruction) make_AsmMovPacked(
+    shared_ptr_t(AssemblyType) * asm_type, shared_ptr_t(AsmOperand) * src, shared_ptr_t(AsmOperand) * dst);
+unique_ptr_t(AsmInstruction) make_AsmBinaryPacked(const AsmBinaryOp* binop, shared_ptr_t(AssemblyType) * asm_type,
+    shared_ptr_t(AsmOperand) * src, shared_ptr_t(AsmOperand) * dst);
 unique_ptr_t(AsmInstruction)
     make_AsmCmp(shared_ptr_t(AssemblyType) * asm_type, shared_ptr_t(AsmOperand) * src, shared_ptr_t(AsmOperand) * dst);
+unique_ptr_t(AsmInstruction)
+    make_AsmTest(shared_ptr_t(AssemblyType) * asm_type, shared_ptr_t(AsmOperand) * src, shared_ptr_t(AsmOperand) * dst);
 unique_ptr_t(AsmInstruction) make_AsmIdiv(shared_ptr_t(AssemblyType) * asm_type, shared_ptr_t(AsmOperand) * src);
 unique_ptr_t(AsmInstruction) make_AsmDiv(shared_ptr_t(AssemblyType) * asm_type, shared_ptr_t(AsmOperand) * src);
 unique_ptr_t(AsmInstruction) make_AsmCdq(shared_ptr_t(AssemblyType) * asm_type);
@@ -431,6 +468,7 @@ unique_ptr_t(AsmInstruction) make_AsmLabel(TIdentifier name);
 unique_ptr_t(AsmInstruction) make_AsmPush(shared_ptr_t(AsmOperand) * src);
 unique_ptr_t(AsmInstruction) make_AsmPop(const AsmReg* reg);
 unique_ptr_t(AsmInstruction) make_AsmCall(TIdentifier name);
+unique_ptr_t(AsmInstruction) make_AsmTailCall(TIdentifier name);
 unique_ptr_t(AsmInstruction) make_AsmRet(void);
 void free_AsmInstruction(unique_ptr_t(AsmInstruction) * self);
 #ifdef __cplusplus
@@ -386,6 +386,7 @@ typedef unique_ptr_t(StructTypedef) UPtrStructTypedef;
 PairKeyValue(TIdentifier, UPtrStructTypedef);
 typedef unique_ptr_t(Symbol) UPtrSymbol;
 PairKeyValue(TIdentifier, UPtrSymbol);
+PairKeyValue(TIdentifier, TULong);
 ElementKey(TIdentifier);
 
 typedef struct FrontEndContext {
@@ -393,6 +394,7 @@ typedef struct FrontEndContext {
     hashmap_t(TIdentifier, UPtrStructTypedef) struct_typedef_table;
     hashmap_t(TIdentifier, UPtrSymbol) symbol_table;
     hashset_t(TIdentifier) addressed_set;
+    hashmap_t(TIdentifier, TULong) profile_table;
 } FrontEndContext;
 
 #ifdef __cplusplus
@@ -400,6 +402,8 @@ extern "C" {
 #endif
 StructMember* get_struct_typedef_member(FrontEndContext* ctx, TIdentifier tag, TIdentifier member_name);
 const StructMember* get_struct_typedef_back(FrontEndContext* ctx, TIdentifier tag);
+TIdentifier get_profile_key(TIdentifier fun_name, TIdentifier label);
+bool get_profile_count(FrontEndContext* ctx, TIdentifier fun_name, TIdentifier label, TULong* count);
 #ifdef __cplusplus
 }
 #endif
@@ -172,6 +172,8 @@ void free_TacExpResult(unique_ptr_t(TacExpResult) * self);
 //             | AddPtr(int, val, val, val)
 //             | CopyToOffset(identifier, int, val)
 //             | CopyFromOffset(identifier, int, val)
+//             | VecCopy(type, val, val)
+//             | VecBinary(binary_operator, type, val, val, val)
 //             | Jump(identifier)
 //             | JumpIfZero(val, identifier)
 //             | JumpIfNotZero(val, identifier)
@@ -274,6 +276,20 @@ typedef struct TacCopyFromOffset {
     shared_ptr_t(TacValue) dst;
 } TacCopyFromOffset;
 
+typedef struct TacVecCopy {
+    shared_ptr_t(Type) elem_type;
+    shared_ptr_t(TacValue) src_ptr;
+    shared_ptr_t(TacValue) dst_ptr;
+} TacVecCopy;
+
+typedef struct TacVecBinary {
+    TacBinaryOp binop;
+    shared_ptr_t(Type) elem_type;
+    shared_ptr_t(TacValue) src1_ptr;
+    shared_ptr_t(TacValue) src2_ptr;
+    shared_ptr_t(TacValue) dst_ptr;
+} TacVecBinary;
+
 typedef struct TacJump {
     TIdentifier target;
 } TacJump;
@@ -314,6 +330,8 @@ typedef struct TacInstruction {
         TacAddPtr _TacAddPtr;
         TacCopyToOffset _TacCopyToOffset;
         TacCopyFromOffset _TacCopyFromOffset;
+        TacVecCopy _TacVecCopy;
+        TacVecBinary _TacVecBinary;
         TacJump _TacJump;
         TacJumpIfZero _TacJumpIfZero;
         TacJumpIfNotZero _TacJumpIfNotZero;
@@ -347,6 +365,10 @@ unique_ptr_t(TacInstruction) make_TacAddPtr(
     TLong scale, shared_ptr_t(TacValue) * src_ptr, shared_ptr_t(TacValue) * idx, shared_ptr_t(TacValue) * dst);
 unique_ptr_t(TacInstruction) make_TacCopyToOffset(TIdentifier dst_name, TLong offset, shared_ptr_t(TacValue) * src);
 unique_ptr_t(TacInstruction) make_TacCopyFromOffset(TIdentifier src_name, TLong offset, shared_ptr_t(TacValue) * dst);
+unique_ptr_t(TacInstruction) make_TacVecCopy(
+    shared_ptr_t(Type) * elem_type, shared_ptr_t(TacValue) * src_ptr, shared_ptr_t(TacValue) * dst_ptr);
+unique_ptr_t(TacInstruction) make_TacVecBinary(const TacBinaryOp* binop, shared_ptr_t(Type) * elem_type,
+    shared_ptr_t(TacValue) * src1_ptr, shared_ptr_t(TacValue) * src2_ptr, shared_ptr_t(TacValue) * dst_ptr);
 unique_ptr_t(TacInstruction) make_TacJump(TIdentifier target);
 unique_ptr_t(TacInstruction) make_TacJumpIfZero(TIdentifier target, shared_ptr_t(TacValue) * condition);
 unique_ptr_t(TacInstruction) make_TacJumpIfNotZero(TIdentifier target, shared_ptr_t(TacValue) * condition);
@@ -1,6 +1,8 @@
 #ifndef _BACK_ASSEMBLY_ASM_GEN_H
 #define _BACK_ASSEMBLY_ASM_GEN_H
 
+#include <stdbool.h>
+
 #include "util/c_std.h"
 
 typedef struct TacProgram TacProgram;
@@ -15,8 +17,8 @@ typedef struct IdentifierContext IdentifierContext;
 #ifdef __cplusplus
 extern "C" {
 #endif
-unique_ptr_t(AsmProgram)
-    generate_assembly(unique_ptr_t(TacProgram) * tac_ast, FrontEndContext* frontend, IdentifierContext* identifiers);
+unique_ptr_t(AsmProgram) generate_assembly(unique_ptr_t(TacProgram) * tac_ast, FrontEndContext* frontend,
+    IdentifierContext* identifiers, bool is_sibling_call);
 #ifdef __cplusplus
 }
 #endif
@@ -17,12 +17,14 @@ typedef struct BackEndContext BackEndContext;
 
 // Pseudo register replacement
 // Instruction fix up
+// Frame pointer omission
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 unique_ptr_t(AsmInstruction) alloc_stack_bytes(TLong byte);
-void fix_stack(const AsmProgram* node, BackEndContext* backend);
+unique_ptr_t(AsmInstruction) dealloc_stack_bytes(TLong byte);
+void fix_stack(const AsmProgram* node, BackEndContext* backend, bool is_omit_frame_ptr);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,24 @@
+#ifndef _BACK_EMITTER_ELF_CODE_H
+#define _BACK_EMITTER_ELF_CODE_H
+
+#include "util/c_std.h"
+
+typedef struct AsmProgram AsmProgram;
+typedef struct BackEndContext BackEndContext;
+typedef struct FileIoContext FileIoContext;
+typedef struct IdentifierContext IdentifierContext;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Elf object code emission
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+void emit_elf_code(unique_ptr_t(AsmProgram) * asm_ast, BackEndContext* backend, FileIoContext* fileio,
+    IdentifierContext* identifiers, bool is_omit_frame_ptr, bool is_align_loops);
+#ifdef __cplusplus
+}
+#endif
+
+#endif
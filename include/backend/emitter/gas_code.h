@@ -15,8 +15,8 @@ typedef struct IdentifierContext IdentifierContext;
 #ifdef __cplusplus
 extern "C" {
 #endif
-void emit_gas_code(
-    unique_ptr_t(AsmProgram) * asm_ast, BackEndContext* backend, FileIoContext* fileio, IdentifierContext* identifiers);
+void emit_gas_code(unique_ptr_t(AsmProgram) * asm_ast, BackEndContext* backend, FileIoContext* fileio,
+    IdentifierContext* identifiers, bool is_omit_frame_ptr, bool is_profile_generate, bool is_align_loops);
 #ifdef __cplusplus
 }
 #endif
@@ -45,6 +45,15 @@ typedef enum MESSAGE_ARG {
     MSG_invalid_optim_1_arg,
     MSG_no_optim_2_arg,
     MSG_invalid_optim_2_arg,
+    MSG_no_codegen_arg,
+    MSG_invalid_codegen_arg,
+    MSG_no_unroll_factor_arg,
+    MSG_invalid_unroll_factor_arg,
+    MSG_no_unroll_budget_arg,
+    MSG_invalid_unroll_budget_arg,
+    MSG_no_profile_arg,
+    MSG_no_report_arg,
+    MSG_invalid_report_arg,
     MSG_no_input_files_arg,
     MSG_no_stdlib_dir_arg,
     MSG_no_include_dir_arg
@@ -56,7 +65,8 @@ typedef enum MESSAGE_UTIL {
     MSG_failed_fwrite,
     MSG_failed_strtoi,
     MSG_failed_strtou,
-    MSG_failed_strtod
+    MSG_failed_strtod,
+    MSG_malformed_profile
 } MESSAGE_UTIL;
 
 #ifdef __cplusplus
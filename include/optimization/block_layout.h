@@ -0,0 +1,26 @@
+#ifndef _OPTIMIZATION_BLOCK_LAYOUT_H
+#define _OPTIMIZATION_BLOCK_LAYOUT_H
+
+typedef struct AsmProgram AsmProgram;
+typedef struct FrontEndContext FrontEndContext;
+typedef struct IdentifierContext IdentifierContext;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Block layout
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Fall through chaining
+// Conditional jump inversion
+// Cold block placement
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+void layout_blocks(const AsmProgram* node, FrontEndContext* frontend, IdentifierContext* identifiers);
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -2,9 +2,12 @@
 #define _OPTIMIZATION_OPTIM_TAC_H
 
 #include <inttypes.h>
+#include <stdbool.h>
 
 typedef struct TacProgram TacProgram;
 typedef struct FrontEndContext FrontEndContext;
+typedef struct IdentifierContext IdentifierContext;
+typedef struct TimeReportContext TimeReportContext;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -16,11 +19,17 @@ typedef struct FrontEndContext FrontEndContext;
 // Unreachable code elimination
 // Copy propagation
 // Dead store elimination
+// Loop invariant code motion
+// Global value numbering
+// Scalar replacement of aggregates
+// Loop unrolling
+// Loop vectorization
 
 #ifdef __cplusplus
 extern "C" {
 #endif
-void optimize_three_address_code(const TacProgram* node, FrontEndContext* frontend, uint8_t optim_1_mask);
+void optimize_three_address_code(const TacProgram* node, FrontEndContext* frontend, IdentifierContext* identifiers,
+    TimeReportContext* report, uint8_t optim_1_mask, uint8_t unroll_factor, uint8_t unroll_budget, bool is_vectorize);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,29 @@
+#ifndef _OPTIMIZATION_PEEPHOLE_H
+#define _OPTIMIZATION_PEEPHOLE_H
+
+#include <stdbool.h>
+
+typedef struct AsmProgram AsmProgram;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Peephole optimization
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Self move elimination
+// Jump to next label elimination
+// Compare with zero as test
+// Move zero as xor
+// Store then load elimination
+// Load then store elimination
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+void optimize_peephole(const AsmProgram* node, bool is_verbose);
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -2,10 +2,12 @@
 #define _OPTIMIZATION_REG_ALLOC_H
 
 #include <inttypes.h>
+#include <stdbool.h>
 
 typedef struct AsmProgram AsmProgram;
 typedef struct BackEndContext BackEndContext;
 typedef struct FrontEndContext FrontEndContext;
+typedef struct TimeReportContext TimeReportContext;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -19,8 +21,8 @@ typedef struct FrontEndContext FrontEndContext;
 #ifdef __cplusplus
 extern "C" {
 #endif
-void allocate_registers(
-    const AsmProgram* node, BackEndContext* backend, FrontEndContext* frontend, uint8_t optim_2_code);
+void allocate_registers(const AsmProgram* node, BackEndContext* backend, FrontEndContext* frontend,
+    TimeReportContext* report, uint8_t optim_2_code, bool is_omit_frame_ptr);
 #ifdef __cplusplus
 }
 #endif
@@ -20,6 +20,16 @@
 #endif
 #endif
 
+// Allocations are counted for the time report, and the build redirects the allocations of lib/ to these as well
+#ifdef __cplusplus
+extern "C" {
+#endif
+void* report_malloc(size_t size);
+void* report_realloc(void* ptr, size_t size);
+#ifdef __cplusplus
+}
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 // C std
@@ -86,14 +96,14 @@ static char _error_msg[ERROR_MSG_SIZE];
     if (!X) {          \
         return;        \
     }
-#define uptr_alloc(T, X)           \
-    do {                           \
-        free_##T(&X);              \
-        X = (T*)malloc(sizeof(T)); \
-        if (!X) {                  \
-            THROW_ALLOC(T);        \
-        }                          \
-    }                              \
+#define uptr_alloc(T, X)                  \
+    do {                                  \
+        free_##T(&X);                     \
+        X = (T*)report_malloc(sizeof(T)); \
+        if (!X) {                         \
+            THROW_ALLOC(T);               \
+        }                                 \
+    }                                     \
     while (0)
 #define uptr_free(X)    \
     if (X) {            \
@@ -38,6 +38,7 @@ error_t open_fread(FileIoContext* ctx, const string_t filename);
 error_t open_fwrite(FileIoContext* ctx, const string_t filename);
 bool read_line(FileIoContext* ctx, char** line, size_t* line_size);
 void write_buffer(FileIoContext* ctx, const char* buf);
+void write_bytes(FileIoContext* ctx, const void* buf, size_t buf_size);
 error_t close_fread(FileIoContext* ctx, size_t linenum);
 void close_fwrite(FileIoContext* ctx);
 void free_fileio(FileIoContext* ctx);
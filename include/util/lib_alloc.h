@@ -0,0 +1,13 @@
+#ifndef _UTIL_LIB_ALLOC_H
+#define _UTIL_LIB_ALLOC_H
+
+// The build includes this before the sources of lib/, so that the allocations of the containers are counted for the
+// time report without changes to the libraries. The C++ standard library undefines macros named after the allocation
+// functions, so the standard headers are included before the functions are renamed
+#include "util/c_std.h"
+#include <stdlib.h>
+
+#define malloc report_malloc
+#define realloc report_realloc
+
+#endif
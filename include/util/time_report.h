@@ -0,0 +1,87 @@
+#ifndef _UTIL_TIME_REPORT_H
+#define _UTIL_TIME_REPORT_H
+
+#include "util/c_std.h"
+
+typedef struct IdentifierContext IdentifierContext;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Time report
+
+typedef enum REPORT_STAGE {
+    STAGE_Lexing,
+    STAGE_Parsing,
+    STAGE_Semantic,
+    STAGE_TacRepr,
+    STAGE_OptimTac,
+    STAGE_ScalarReplacement,
+    STAGE_LoopUnrolling,
+    STAGE_ConstantFolding,
+    STAGE_ControlFlowGraph,
+    STAGE_UnreachableCode,
+    STAGE_GlobalValueNumbering,
+    STAGE_CopyPropagation,
+    STAGE_DeadStore,
+    STAGE_LoopInvariant,
+    STAGE_LoopVectorization,
+    STAGE_AsmGen,
+    STAGE_RegAlloc,
+    STAGE_StackFix,
+    STAGE_BlockLayout,
+    STAGE_Peephole,
+    STAGE_CodeEmission,
+    STAGE_Size
+} REPORT_STAGE;
+
+typedef enum REPORT_FORMAT {
+    REPORT_None,
+    REPORT_Table,
+    REPORT_Json
+} REPORT_FORMAT;
+
+typedef struct ReportStage {
+    size_t call_count;
+    double wall_time;
+    size_t alloc_count;
+    size_t alloc_bytes;
+    size_t peak_rss;
+    double start_time;
+    size_t start_alloc_count;
+    size_t start_alloc_bytes;
+} ReportStage;
+
+typedef struct ReportFunction {
+    size_t name;
+    REPORT_STAGE stage;
+    size_t instr_count;
+    size_t block_count;
+    size_t dfa_iter_count;
+    size_t fixed_point_count;
+} ReportFunction;
+
+typedef struct TimeReportContext {
+    REPORT_FORMAT format;
+    ReportStage stages[STAGE_Size];
+    vector_t(ReportFunction) functions;
+} TimeReportContext;
+
+// Counts on the last function record, the report is NULL when disabled
+#define REPORT_FUN_COUNT(X, Y, Z)        \
+    if (X) {                             \
+        vec_back((X)->functions).Y += Z; \
+    }
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+void report_begin(TimeReportContext* ctx, REPORT_STAGE stage);
+void report_end(TimeReportContext* ctx, REPORT_STAGE stage);
+void report_function(TimeReportContext* ctx, size_t name, REPORT_STAGE stage);
+void print_time_report(TimeReportContext* ctx, IdentifierContext* identifiers);
+void free_time_report(TimeReportContext* ctx);
+#ifdef __cplusplus
+}
+#endif
+
+#endif
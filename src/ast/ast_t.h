@@ -220,6 +220,8 @@ typedef enum AST_T {
     AST_TacAddPtr_t,
     AST_TacCopyToOffset_t,
     AST_TacCopyFromOffset_t,
+    AST_TacVecCopy_t,
+    AST_TacVecBinary_t,
     AST_TacJump_t,
     AST_TacJumpIfZero_t,
     AST_TacJumpIfNotZero_t,
@@ -308,7 +310,10 @@ typedef enum AST_T {
     AST_AsmCvtsi2sd_t,
     AST_AsmUnary_t,
     AST_AsmBinary_t,
+    AST_AsmMovPacked_t,
+    AST_AsmBinaryPacked_t,
     AST_AsmCmp_t,
+    AST_AsmTest_t,
     AST_AsmIdiv_t,
     AST_AsmDiv_t,
     AST_AsmCdq_t,
@@ -319,6 +324,7 @@ typedef enum AST_T {
     AST_AsmPush_t,
     AST_AsmPop_t,
     AST_AsmCall_t,
+    AST_AsmTailCall_t,
     AST_AsmRet_t,
     AST_AsmTopLevel_t,
     AST_AsmFunction_t,
@@ -212,6 +212,33 @@ unique_ptr_t(AsmInstruction) make_AsmBinary(const AsmBinaryOp* binop, shared_ptr
     return self;
 }
 
+unique_ptr_t(AsmInstruction) make_AsmMovPacked(
+    shared_ptr_t(AssemblyType) * asm_type, shared_ptr_t(AsmOperand) * src, shared_ptr_t(AsmOperand) * dst) {
+    unique_ptr_t(AsmInstruction) self = make_AsmInstruction();
+    self->type = AST_AsmMovPacked_t;
+    self->get._AsmMovPacked.asm_type = sptr_new();
+    sptr_move(AssemblyType, *asm_type, self->get._AsmMovPacked.asm_type);
+    self->get._AsmMovPacked.src = sptr_new();
+    sptr_move(AsmOperand, *src, self->get._AsmMovPacked.src);
+    self->get._AsmMovPacked.dst = sptr_new();
+    sptr_move(AsmOperand, *dst, self->get._AsmMovPacked.dst);
+    return self;
+}
+
+unique_ptr_t(AsmInstruction) make_AsmBinaryPacked(const AsmBinaryOp* binop, shared_ptr_t(AssemblyType) * asm_type,
+    shared_ptr_t(AsmOperand) * src, shared_ptr_t(AsmOperand) * dst) {
+    unique_ptr_t(AsmInstruction) self = make_AsmInstruction();
+    self->type = AST_AsmBinaryPacked_t;
+    self->get._AsmBinaryPacked.binop = *binop;
+    self->get._AsmBinaryPacked.asm_type = sptr_new();
+    sptr_move(AssemblyType, *asm_type, self->get._AsmBinaryPacked.asm_type);
+    self->get._AsmBinaryPacked.src = sptr_new();
+    sptr_move(AsmOperand, *src, self->get._AsmBinaryPacked.src);
+    self->get._AsmBinaryPacked.dst = sptr_new();
+    sptr_move(AsmOperand, *dst, self->get._AsmBinaryPacked.dst);
+    return self;
+}
+
 unique_ptr_t(AsmInstruction)
     make_AsmCmp(shared_ptr_t(AssemblyType) * asm_type, shared_ptr_t(AsmOperand) * src, shared_ptr_t(AsmOperand) * dst) {
     unique_ptr_t(AsmInstruction) self = make_AsmInstruction();
@@ -225,6 +252,19 @@ unique_ptr_t(AsmInstruction)
     return self;
 }
 
+unique_ptr_t(AsmInstruction) make_AsmTest(
+    shared_ptr_t(AssemblyType) * asm_type, shared_ptr_t(AsmOperand) * src, shared_ptr_t(AsmOperand) * dst) {
+    unique_ptr_t(AsmInstruction) self = make_AsmInstruction();
+    self->type = AST_AsmTest_t;
+    self->get._AsmTest.asm_type = sptr_new();
+    sptr_move(AssemblyType, *asm_type, self->get._AsmTest.asm_type);
+    self->get._AsmTest.src = sptr_new();
+    sptr_move(AsmOperand, *src, self->get._AsmTest.src);
+    self->get._AsmTest.dst = sptr_new();
+    sptr_move(AsmOperand, *dst, self->get._AsmTest.dst);
+    return self;
+}
+
 unique_ptr_t(AsmInstruction) make_AsmIdiv(shared_ptr_t(AssemblyType) * asm_type, shared_ptr_t(AsmOperand) * src) {
     unique_ptr_t(AsmInstruction) self = make_AsmInstruction();
     self->type = AST_AsmIdiv_t;
@@ -306,6 +346,13 @@ unique_ptr_t(AsmInstruction) make_AsmCall(TIdentifier name) {
     return self;
 }
 
+unique_ptr_t(AsmInstruction) make_AsmTailCall(TIdentifier name) {
+    unique_ptr_t(AsmInstruction) self = make_AsmInstruction();
+    self->type = AST_AsmTailCall_t;
+    self->get._AsmTailCall.name = name;
+    return self;
+}
+
 unique_ptr_t(AsmInstruction) make_AsmRet(void) {
     unique_ptr_t(AsmInstruction) self = make_AsmInstruction();
     self->type = AST_AsmRet_t;
@@ -357,11 +404,26 @@ void free_AsmInstruction(unique_ptr_t(AsmInstruction) * self) {
             free_AsmOperand(&(*self)->get._AsmBinary.src);
             free_AsmOperand(&(*self)->get._AsmBinary.dst);
             break;
+        case AST_AsmMovPacked_t:
+            free_AssemblyType(&(*self)->get._AsmMovPacked.asm_type);
+            free_AsmOperand(&(*self)->get._AsmMovPacked.src);
+            free_AsmOperand(&(*self)->get._AsmMovPacked.dst);
+            break;
+        case AST_AsmBinaryPacked_t:
+            free_AssemblyType(&(*self)->get._AsmBinaryPacked.asm_type);
+            free_AsmOperand(&(*self)->get._AsmBinaryPacked.src);
+            free_AsmOperand(&(*self)->get._AsmBinaryPacked.dst);
+            break;
         case AST_AsmCmp_t:
             free_AssemblyType(&(*self)->get._AsmCmp.asm_type);
             free_AsmOperand(&(*self)->get._AsmCmp.src);
             free_AsmOperand(&(*self)->get._AsmCmp.dst);
             break;
+        case AST_AsmTest_t:
+            free_AssemblyType(&(*self)->get._AsmTest.asm_type);
+            free_AsmOperand(&(*self)->get._AsmTest.src);
+            free_AsmOperand(&(*self)->get._AsmTest.dst);
+            break;
         case AST_AsmIdiv_t:
             free_AssemblyType(&(*self)->get._AsmIdiv.asm_type);
             free_AsmOperand(&(*self)->get._AsmIdiv.src);
@@ -389,6 +451,8 @@ void free_AsmInstruction(unique_ptr_t(AsmInstruction) * self) {
             break;
         case AST_AsmCall_t:
             break;
+        case AST_AsmTailCall_t:
+            break;
         case AST_AsmRet_t:
             break;
         default:
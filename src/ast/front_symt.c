@@ -448,3 +448,21 @@ const StructMember* get_struct_typedef_back(Ctx ctx, TIdentifier tag) {
     StructTypedef* struct_typedef = map_get(ctx->struct_typedef_table, tag);
     return map_get(struct_typedef->members, vec_back(struct_typedef->member_names));
 }
+
+// Block counts are keyed by function and label, as labels are only unique within a translation unit.
+// Function entry counts use the null label
+TIdentifier get_profile_key(TIdentifier fun_name, TIdentifier label) {
+    if (label == 0) {
+        return fun_name;
+    }
+    return fun_name ^ (label + 0x9e3779b97f4a7c15ul + (fun_name << 6) + (fun_name >> 2));
+}
+
+bool get_profile_count(Ctx ctx, TIdentifier fun_name, TIdentifier label, TULong* count) {
+    TIdentifier key = get_profile_key(fun_name, label);
+    if (map_find(ctx->profile_table, key) == map_end()) {
+        return false;
+    }
+    *count = map_get(ctx->profile_table, key);
+    return true;
+}
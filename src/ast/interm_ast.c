@@ -296,6 +296,35 @@ unique_ptr_t(TacInstruction) make_TacCopyFromOffset(TIdentifier src_name, TLong
     return self;
 }
 
+unique_ptr_t(TacInstruction) make_TacVecCopy(
+    shared_ptr_t(Type) * elem_type, shared_ptr_t(TacValue) * src_ptr, shared_ptr_t(TacValue) * dst_ptr) {
+    unique_ptr_t(TacInstruction) self = make_TacInstruction();
+    self->type = AST_TacVecCopy_t;
+    self->get._TacVecCopy.elem_type = sptr_new();
+    sptr_move(Type, *elem_type, self->get._TacVecCopy.elem_type);
+    self->get._TacVecCopy.src_ptr = sptr_new();
+    sptr_move(TacValue, *src_ptr, self->get._TacVecCopy.src_ptr);
+    self->get._TacVecCopy.dst_ptr = sptr_new();
+    sptr_move(TacValue, *dst_ptr, self->get._TacVecCopy.dst_ptr);
+    return self;
+}
+
+unique_ptr_t(TacInstruction) make_TacVecBinary(const TacBinaryOp* binop, shared_ptr_t(Type) * elem_type,
+    shared_ptr_t(TacValue) * src1_ptr, shared_ptr_t(TacValue) * src2_ptr, shared_ptr_t(TacValue) * dst_ptr) {
+    unique_ptr_t(TacInstruction) self = make_TacInstruction();
+    self->type = AST_TacVecBinary_t;
+    self->get._TacVecBinary.binop = *binop;
+    self->get._TacVecBinary.elem_type = sptr_new();
+    sptr_move(Type, *elem_type, self->get._TacVecBinary.elem_type);
+    self->get._TacVecBinary.src1_ptr = sptr_new();
+    sptr_move(TacValue, *src1_ptr, self->get._TacVecBinary.src1_ptr);
+    self->get._TacVecBinary.src2_ptr = sptr_new();
+    sptr_move(TacValue, *src2_ptr, self->get._TacVecBinary.src2_ptr);
+    self->get._TacVecBinary.dst_ptr = sptr_new();
+    sptr_move(TacValue, *dst_ptr, self->get._TacVecBinary.dst_ptr);
+    return self;
+}
+
 unique_ptr_t(TacInstruction) make_TacJump(TIdentifier target) {
     unique_ptr_t(TacInstruction) self = make_TacInstruction();
     self->type = AST_TacJump_t;
@@ -407,6 +436,17 @@ void free_TacInstruction(unique_ptr_t(TacInstruction) * self) {
         case AST_TacCopyFromOffset_t:
             free_TacValue(&(*self)->get._TacCopyFromOffset.dst);
             break;
+        case AST_TacVecCopy_t:
+            free_Type(&(*self)->get._TacVecCopy.elem_type);
+            free_TacValue(&(*self)->get._TacVecCopy.src_ptr);
+            free_TacValue(&(*self)->get._TacVecCopy.dst_ptr);
+            break;
+        case AST_TacVecBinary_t:
+            free_Type(&(*self)->get._TacVecBinary.elem_type);
+            free_TacValue(&(*self)->get._TacVecBinary.src1_ptr);
+            free_TacValue(&(*self)->get._TacVecBinary.src2_ptr);
+            free_TacValue(&(*self)->get._TacVecBinary.dst_ptr);
+            break;
         case AST_TacJump_t:
             break;
         case AST_TacJumpIfZero_t:
@@ -39,6 +39,9 @@ typedef struct AsmGenContext {
     FrontEndContext* frontend;
     IdentifierContext* identifiers;
     // Assembly generation
+    bool is_sibling_call;
+    bool is_sibling_fun;
+    TLong stack_param_bytes;
     FunType* p_fun_type;
     REGISTER_KIND arg_regs[6];
     REGISTER_KIND sse_arg_regs[8];
@@ -1175,20 +1178,7 @@ static void unsigned_to_dbl_instr(Ctx ctx, const TacUIntToDouble* node) {
 
 static void alloc_stack_instr(Ctx ctx, TLong byte) { push_instr(ctx, alloc_stack_bytes(byte)); }
 
-static void dealloc_stack_instr(Ctx ctx, TLong byte) {
-    AsmBinaryOp binop = init_AsmAdd();
-    shared_ptr_t(AssemblyType) asm_type = make_QuadWord();
-    shared_ptr_t(AsmOperand) src = sptr_new();
-    {
-        TULong value = (TULong)byte;
-        bool is_byte = byte <= 127l && byte >= -128l;
-        bool is_quad = byte > 2147483647l || byte < -2147483648l;
-        bool is_neg = byte < 0l;
-        src = make_AsmImm(value, is_byte, is_quad, is_neg);
-    }
-    shared_ptr_t(AsmOperand) dst = gen_register(REG_Sp);
-    push_instr(ctx, make_AsmBinary(&binop, &asm_type, &src, &dst));
-}
+static void dealloc_stack_instr(Ctx ctx, TLong byte) { push_instr(ctx, dealloc_stack_bytes(byte)); }
 
 static void reg_arg_call_instr(Ctx ctx, const TacValue* node, REGISTER_KIND arg_reg) {
     shared_ptr_t(AsmOperand) src = gen_op(ctx, node);
@@ -1317,7 +1307,14 @@ static void stack_8b_arg_call_instr(Ctx ctx, TIdentifier name, TLong offset, con
     free_AssemblyType(&asm_type);
 }
 
-static TLong arg_call_instr(Ctx ctx, const TacFunCall* node, FunType* fun_type, bool is_ret_memory) {
+static void sibling_stack_arg_call_instr(Ctx ctx, const TacValue* node, TLong stack_padding) {
+    shared_ptr_t(AsmOperand) src = gen_op(ctx, node);
+    shared_ptr_t(AsmOperand) dst = gen_memory(REG_Bp, 16l + stack_padding * 8l);
+    shared_ptr_t(AssemblyType) asm_type_src = gen_asm_type(ctx, node);
+    push_instr(ctx, make_AsmMov(&asm_type_src, &src, &dst));
+}
+
+static TLong arg_call_instr(Ctx ctx, const TacFunCall* node, FunType* fun_type, bool is_ret_memory, bool is_sibling) {
     size_t reg_size = is_ret_memory ? 1 : 0;
     size_t sse_size = 0;
     TLong stack_padding = 0l;
@@ -1330,6 +1327,10 @@ static TLong arg_call_instr(Ctx ctx, const TacFunCall* node, FunType* fun_type,
                 reg_arg_call_instr(ctx, arg, ctx->sse_arg_regs[sse_size]);
                 sse_size++;
             }
+            else if (is_sibling) {
+                sibling_stack_arg_call_instr(ctx, arg, stack_padding);
+                stack_padding++;
+            }
             else {
                 ctx->p_instrs = &stack_instrs;
                 stack_arg_call_instr(ctx, arg);
@@ -1342,6 +1343,10 @@ static TLong arg_call_instr(Ctx ctx, const TacFunCall* node, FunType* fun_type,
                 reg_arg_call_instr(ctx, arg, ctx->arg_regs[reg_size]);
                 reg_size++;
             }
+            else if (is_sibling) {
+                sibling_stack_arg_call_instr(ctx, arg, stack_padding);
+                stack_padding++;
+            }
             else {
                 ctx->p_instrs = &stack_instrs;
                 stack_arg_call_instr(ctx, arg);
@@ -1383,6 +1388,7 @@ static TLong arg_call_instr(Ctx ctx, const TacFunCall* node, FunType* fun_type,
                 }
             }
             else {
+                THROW_ABORT_IF(is_sibling);
                 TLong offset = 0l;
                 ctx->p_instrs = &stack_instrs;
                 for (size_t j = 0; j < struct_8b->size; ++j) {
@@ -1395,6 +1401,10 @@ static TLong arg_call_instr(Ctx ctx, const TacFunCall* node, FunType* fun_type,
         }
     }
     fun_param_reg_mask(ctx, fun_type, reg_size, sse_size);
+    if (is_sibling) {
+        vec_delete(stack_instrs);
+        return 0l;
+    }
     if (stack_padding % 2l == 1l) {
         alloc_stack_instr(ctx, 8l);
         stack_padding++;
@@ -1495,7 +1505,7 @@ static void call_instr(Ctx ctx, const TacFunCall* node) {
         }
     }
     {
-        TLong stack_padding = arg_call_instr(ctx, node, fun_type, is_ret_memory);
+        TLong stack_padding = arg_call_instr(ctx, node, fun_type, is_ret_memory, false);
 
         {
             TIdentifier name = node->name;
@@ -1560,6 +1570,119 @@ static void call_instr(Ctx ctx, const TacFunCall* node) {
     }
 }
 
+static bool is_struct_ret_memory(Ctx ctx, const Type* ret_type) {
+    if (ret_type->type == AST_Structure_t) {
+        const Structure* struct_type = &ret_type->get._Structure;
+        struct_8b_class(ctx, struct_type);
+        return map_get(ctx->struct_8b_map, struct_type->tag).clss[0] == CLS_memory;
+    }
+    return false;
+}
+
+static bool is_sibling_stack_arg_fit(Ctx ctx, const TacFunCall* node) {
+    size_t reg_size = 0;
+    size_t sse_size = 0;
+    TLong stack_bytes = 0l;
+    for (size_t i = 0; i < vec_size(node->args); ++i) {
+        const TacValue* arg = node->args[i];
+        if (is_value_dbl(ctx, arg)) {
+            if (sse_size < 8) {
+                sse_size++;
+            }
+            else {
+                stack_bytes += 8l;
+            }
+        }
+        else if (!is_value_struct(ctx, arg)) {
+            if (reg_size < 6) {
+                reg_size++;
+            }
+            else {
+                stack_bytes += 8l;
+            }
+        }
+        else {
+            const Structure* struct_type =
+                &map_get(ctx->frontend->symbol_table, arg->get._TacVariable.name)->type_t->get._Structure;
+            struct_8b_class(ctx, struct_type);
+            const Struct8Bytes* struct_8b = &map_get(ctx->struct_8b_map, struct_type->tag);
+            if (struct_8b->clss[0] == CLS_memory) {
+                return false;
+            }
+            size_t struct_reg_size = 0;
+            size_t struct_sse_size = 0;
+            for (size_t j = 0; j < struct_8b->size; ++j) {
+                if (struct_8b->clss[j] == CLS_sse) {
+                    struct_sse_size++;
+                }
+                else {
+                    struct_reg_size++;
+                }
+            }
+            if (struct_reg_size + reg_size > 6 || struct_sse_size + sse_size > 8) {
+                return false;
+            }
+            reg_size += struct_reg_size;
+            sse_size += struct_sse_size;
+        }
+    }
+    return stack_bytes <= ctx->stack_param_bytes;
+}
+
+// A call can reuse the caller's frame when its result is returned as is, when neither function returns through
+// memory, and when its stack arguments fit in the caller's incoming stack arguments area
+static bool is_sibling_call(Ctx ctx, const TacFunCall* node, const TacReturn* ret_node) {
+    if (ret_node->val) {
+        if (!node->dst || node->dst->type != AST_TacVariable_t || ret_node->val->type != AST_TacVariable_t
+            || node->dst->get._TacVariable.name != ret_node->val->get._TacVariable.name) {
+            return false;
+        }
+    }
+    const FunType* fun_type = &map_get(ctx->frontend->symbol_table, node->name)->type_t->get._FunType;
+    return !is_struct_ret_memory(ctx, fun_type->ret_type) && is_sibling_stack_arg_fit(ctx, node);
+}
+
+static void sibling_ret_reg_mask(Ctx ctx, const TacFunCall* node, FunType* fun_type) {
+    if (!node->dst) {
+        ret_2_reg_mask(fun_type, false, false);
+    }
+    else if (is_value_dbl(ctx, node->dst)) {
+        ret_1_reg_mask(fun_type, false);
+    }
+    else if (!is_value_struct(ctx, node->dst)) {
+        ret_1_reg_mask(fun_type, true);
+    }
+    else {
+        TIdentifier name = node->dst->get._TacVariable.name;
+        const Structure* struct_type = &map_get(ctx->frontend->symbol_table, name)->type_t->get._Structure;
+        const Struct8Bytes* struct_8b = &map_get(ctx->struct_8b_map, struct_type->tag);
+        bool reg_size = struct_8b->clss[0] == CLS_integer;
+        if (struct_8b->size == 2) {
+            ret_2_reg_mask(fun_type, reg_size, !reg_size || struct_8b->clss[1] == CLS_sse);
+        }
+        else {
+            ret_1_reg_mask(fun_type, reg_size);
+        }
+    }
+}
+
+static void sibling_call_instr(Ctx ctx, const TacFunCall* node, const TacReturn* ret_node) {
+    FunType* fun_type = &map_get(ctx->frontend->symbol_table, node->name)->type_t->get._FunType;
+    arg_call_instr(ctx, node, fun_type, false, true);
+    {
+        TIdentifier name = node->name;
+        push_instr(ctx, make_AsmTailCall(name));
+    }
+
+    sibling_ret_reg_mask(ctx, node, fun_type);
+    if (!ret_node->val) {
+        ret_2_reg_mask(ctx->p_fun_type, false, false);
+    }
+    else if (ctx->p_fun_type->ret_reg_mask == NULL_REGISTER_MASK) {
+        ctx->p_fun_type->ret_reg_mask = fun_type->ret_reg_mask;
+    }
+}
+
 static void zero_xmm_reg_instr(Ctx ctx) {
     AsmBinaryOp binop = init_AsmBitXor();
     shared_ptr_t(AsmOperand) src = gen_register(REG_Xmm0);
@@ -2351,6 +2474,73 @@ static void cp_from_offset_instr(Ctx ctx, const TacCopyFromOffset* node) {
     }
 }
 
+static shared_ptr_t(AssemblyType) vec_asm_type(const Type* elem_type) {
+    switch (elem_type->type) {
+        case AST_Int_t:
+        case AST_UInt_t:
+            return make_LongWord();
+        case AST_Long_t:
+        case AST_ULong_t:
+            return make_QuadWord();
+        case AST_Double_t:
+            return make_BackendDouble();
+        default:
+            THROW_ABORT;
+    }
+}
+
+// Vector operands are loaded and stored unaligned, as packed operations only accept aligned memory operands
+static void vec_load_instr(Ctx ctx, const TacValue* node, shared_ptr_t(AssemblyType) asm_type, REGISTER_KIND sse_reg) {
+    {
+        shared_ptr_t(AsmOperand) src = gen_op(ctx, node);
+        shared_ptr_t(AsmOperand) dst = gen_register(REG_Ax);
+        shared_ptr_t(AssemblyType) asm_type_src = make_QuadWord();
+        push_instr(ctx, make_AsmMov(&asm_type_src, &src, &dst));
+    }
+    {
+        shared_ptr_t(AsmOperand) src = gen_memory(REG_Ax, 0l);
+        shared_ptr_t(AsmOperand) dst = gen_register(sse_reg);
+        shared_ptr_t(AssemblyType) asm_type_dst = sptr_new();
+        sptr_copy(AssemblyType, asm_type, asm_type_dst);
+        push_instr(ctx, make_AsmMovPacked(&asm_type_dst, &src, &dst));
+    }
+}
+
+static void vec_store_instr(Ctx ctx, const TacValue* node, shared_ptr_t(AssemblyType) * asm_type) {
+    {
+        shared_ptr_t(AsmOperand) src = gen_op(ctx, node);
+        shared_ptr_t(AsmOperand) dst = gen_register(REG_Ax);
+        shared_ptr_t(AssemblyType) asm_type_src = make_QuadWord();
+        push_instr(ctx, make_AsmMov(&asm_type_src, &src, &dst));
+    }
+    {
+        shared_ptr_t(AsmOperand) src = gen_register(REG_Xmm0);
+        shared_ptr_t(AsmOperand) dst = gen_memory(REG_Ax, 0l);
+        push_instr(ctx, make_AsmMovPacked(asm_type, &src, &dst));
+    }
+}
+
+static void vec_copy_instr(Ctx ctx, const TacVecCopy* node) {
+    shared_ptr_t(AssemblyType) asm_type = vec_asm_type(node->elem_type);
+    vec_load_instr(ctx, node->src_ptr, asm_type, REG_Xmm0);
+    vec_store_instr(ctx, node->dst_ptr, &asm_type);
+}
+
+static void vec_binary_instr(Ctx ctx, const TacVecBinary* node) {
+    shared_ptr_t(AssemblyType) asm_type = vec_asm_type(node->elem_type);
+    vec_load_instr(ctx, node->src1_ptr, asm_type, REG_Xmm0);
+    vec_load_instr(ctx, node->src2_ptr, asm_type, REG_Xmm1);
+    {
+        AsmBinaryOp binop = gen_binop(&node->binop);
+        shared_ptr_t(AsmOperand) src = gen_register(REG_Xmm1);
+        shared_ptr_t(AsmOperand) dst = gen_register(REG_Xmm0);
+        shared_ptr_t(AssemblyType) asm_type_dst = sptr_new();
+        sptr_copy(AssemblyType, asm_type, asm_type_dst);
+        push_instr(ctx, make_AsmBinaryPacked(&binop, &asm_type_dst, &src, &dst));
+    }
+    vec_store_instr(ctx, node->dst_ptr, &asm_type);
+}
+
 static void jump_instr(Ctx ctx, const TacJump* node) {
     TIdentifier target = node->target;
     push_instr(ctx, make_AsmJmp(target));
@@ -2512,6 +2702,12 @@ static void gen_instr(Ctx ctx, const TacInstruction* node) {
         case AST_TacCopyFromOffset_t:
             cp_from_offset_instr(ctx, &node->get._TacCopyFromOffset);
             break;
+        case AST_TacVecCopy_t:
+            vec_copy_instr(ctx, &node->get._TacVecCopy);
+            break;
+        case AST_TacVecBinary_t:
+            vec_binary_instr(ctx, &node->get._TacVecBinary);
+            break;
         case AST_TacJump_t:
             jump_instr(ctx, &node->get._TacJump);
             break;
@@ -2533,12 +2729,26 @@ static void gen_instr(Ctx ctx, const TacInstruction* node) {
 //             | MovZeroExtend(assembly_type, assembly_type, operand, operand) | Lea(operand, operand)
 //             | Cvttsd2si(assembly_type, operand, operand) | Cvtsi2sd(assembly_type, operand, operand)
 //             | Unary(unary_operator, assembly_type, operand) | Binary(binary_operator, assembly_type, operand,
-//             operand) | Cmp(assembly_type, operand, operand) | Idiv(assembly_type, operand) | Div(assembly_type,
-//             operand) | Cdq(assembly_type) | Jmp(identifier) | JmpCC(cond_code, identifier) | SetCC(cond_code,
-//             operand) | Label(identifier) | Push(operand) | Pop(reg) | Call(identifier) | Ret
+//             operand) | MovPacked(assembly_type, operand, operand) | BinaryPacked(binary_operator, assembly_type,
+//             operand, operand) | Cmp(assembly_type, operand, operand) | Idiv(assembly_type, operand)
+//             | Div(assembly_type, operand) | Cdq(assembly_type) | Jmp(identifier) | JmpCC(cond_code, identifier)
+//             | SetCC(cond_code, operand) | Label(identifier) | Push(operand) | Pop(reg) | Call(identifier)
+//             | TailCall(identifier) | Ret
 static void gen_instr_list(Ctx ctx, vector_t(unique_ptr_t(TacInstruction)) node_list) {
     for (size_t i = 0; i < vec_size(node_list); ++i) {
         if (node_list[i]) {
+            if (ctx->is_sibling_fun && node_list[i]->type == AST_TacFunCall_t) {
+                size_t j = i + 1;
+                while (j < vec_size(node_list) && !node_list[j]) {
+                    j++;
+                }
+                if (j < vec_size(node_list) && node_list[j]->type == AST_TacReturn_t
+                    && is_sibling_call(ctx, &node_list[i]->get._TacFunCall, &node_list[j]->get._TacReturn)) {
+                    sibling_call_instr(ctx, &node_list[i]->get._TacFunCall, &node_list[j]->get._TacReturn);
+                    i = j;
+                    continue;
+                }
+            }
             gen_instr(ctx, node_list[i]);
         }
     }
@@ -2677,6 +2887,21 @@ static void fun_param_toplvl(Ctx ctx, const TacFunction* node, FunType* fun_type
         }
     }
     fun_param_reg_mask(ctx, fun_type, reg_size, sse_size);
+    ctx->stack_param_bytes = stack_bytes - 16l;
+}
+
+static bool is_frame_addressed(Ctx ctx, vector_t(unique_ptr_t(TacInstruction)) node_list) {
+    for (size_t i = 0; i < vec_size(node_list); ++i) {
+        if (node_list[i] && node_list[i]->type == AST_TacGetAddress_t) {
+            const TacValue* src = node_list[i]->get._TacGetAddress.src;
+            if (src->type == AST_TacVariable_t
+                && map_get(ctx->frontend->symbol_table, src->get._TacVariable.name)->attrs->type
+                       == AST_LocalAttr_t) {
+                return true;
+            }
+        }
+    }
+    return false;
 }
 
 static unique_ptr_t(AsmTopLevel) gen_fun_toplvl(Ctx ctx, const TacFunction* node) {
@@ -2705,6 +2930,7 @@ static unique_ptr_t(AsmTopLevel) gen_fun_toplvl(Ctx ctx, const TacFunction* node
         }
         fun_param_toplvl(ctx, node, fun_type, is_ret_memory);
 
+        ctx->is_sibling_fun = ctx->is_sibling_call && !is_ret_memory && !is_frame_addressed(ctx, node->body);
         ctx->p_fun_type = fun_type;
         gen_instr_list(ctx, node->body);
         ctx->p_fun_type = NULL;
@@ -2793,11 +3019,15 @@ static unique_ptr_t(AsmProgram) gen_program(Ctx ctx, const TacProgram* node) {
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 unique_ptr_t(AsmProgram)
-    generate_assembly(unique_ptr_t(TacProgram) * tac_ast, FrontEndContext* frontend, IdentifierContext* identifiers) {
+    generate_assembly(unique_ptr_t(TacProgram) * tac_ast, FrontEndContext* frontend, IdentifierContext* identifiers,
+        bool is_sibling_call) {
     AsmGenContext ctx;
     {
         ctx.frontend = frontend;
         ctx.identifiers = identifiers;
+        ctx.is_sibling_call = is_sibling_call;
+        ctx.is_sibling_fun = false;
+        ctx.stack_param_bytes = 0l;
 
         ctx.arg_regs[0] = REG_Di;
         ctx.arg_regs[1] = REG_Si;
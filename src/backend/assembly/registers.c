@@ -191,38 +191,39 @@ size_t register_mask_bit(REGISTER_KIND reg_kind) {
             return 10;
         case REG_R15:
             return 11;
-        case REG_Xmm0:
+        case REG_Bp:
             return 12;
-        case REG_Xmm1:
+        case REG_Xmm0:
             return 13;
-        case REG_Xmm2:
+        case REG_Xmm1:
             return 14;
-        case REG_Xmm3:
+        case REG_Xmm2:
             return 15;
-        case REG_Xmm4:
+        case REG_Xmm3:
             return 16;
-        case REG_Xmm5:
+        case REG_Xmm4:
             return 17;
-        case REG_Xmm6:
+        case REG_Xmm5:
             return 18;
-        case REG_Xmm7:
+        case REG_Xmm6:
             return 19;
-        case REG_Xmm8:
+        case REG_Xmm7:
             return 20;
-        case REG_Xmm9:
+        case REG_Xmm8:
             return 21;
-        case REG_Xmm10:
+        case REG_Xmm9:
             return 22;
-        case REG_Xmm11:
+        case REG_Xmm10:
             return 23;
-        case REG_Xmm12:
+        case REG_Xmm11:
             return 24;
-        case REG_Xmm13:
+        case REG_Xmm12:
             return 25;
+        case REG_Xmm13:
+            return 26;
         case REG_R10:
         case REG_R11:
         case REG_Sp:
-        case REG_Bp:
         case REG_Xmm14:
         case REG_Xmm15:
             THROW_ABORT;
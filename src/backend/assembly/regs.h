@@ -40,7 +40,7 @@ typedef enum REGISTER_KIND {
     REG_Xmm15
 } REGISTER_KIND;
 
-#define REGISTER_MASK_SIZE 26
+#define REGISTER_MASK_SIZE 27
 #define REGISTER_MASK_FALSE 0ul
 #define NULL_REGISTER_MASK ((uint8_t)1u) << REGISTER_MASK_SIZE
 
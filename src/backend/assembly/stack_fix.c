@@ -17,6 +17,10 @@ typedef struct StackFixContext {
     hashmap_t(TIdentifier, TLong) pseudo_stack_map;
     // Instruction fix up
     vector_t(unique_ptr_t(AsmInstruction)) * p_fix_instrs;
+    // Frame pointer omission
+    bool is_omit_frame_ptr;
+    TLong frame_bytes;
+    TLong sp_offset;
 } StackFixContext;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -426,17 +430,26 @@ static void repl_pseudo_regs(Ctx ctx, AsmInstruction* node) {
 
 // Instruction fix up
 
+static shared_ptr_t(AsmOperand) stack_bytes_imm(TLong byte) {
+    TULong value = (TULong)byte;
+    bool is_byte = byte <= 127l && byte >= -128l;
+    bool is_quad = byte > 2147483647l || byte < -2147483648l;
+    bool is_neg = byte < 0l;
+    return make_AsmImm(value, is_byte, is_quad, is_neg);
+}
+
 unique_ptr_t(AsmInstruction) alloc_stack_bytes(TLong byte) {
     AsmBinaryOp binop = init_AsmSub();
     shared_ptr_t(AssemblyType) asm_type = make_QuadWord();
-    shared_ptr_t(AsmOperand) src = sptr_new();
-    {
-        TULong value = (TULong)byte;
-        bool is_byte = byte <= 127l && byte >= -128l;
-        bool is_quad = byte > 2147483647l || byte < -2147483648l;
-        bool is_neg = byte < 0l;
-        src = make_AsmImm(value, is_byte, is_quad, is_neg);
-    }
+    shared_ptr_t(AsmOperand) src = stack_bytes_imm(byte);
+    shared_ptr_t(AsmOperand) dst = gen_register(REG_Sp);
+    return make_AsmBinary(&binop, &asm_type, &src, &dst);
+}
+
+unique_ptr_t(AsmInstruction) dealloc_stack_bytes(TLong byte) {
+    AsmBinaryOp binop = init_AsmAdd();
+    shared_ptr_t(AssemblyType) asm_type = make_QuadWord();
+    shared_ptr_t(AsmOperand) src = stack_bytes_imm(byte);
     shared_ptr_t(AsmOperand) dst = gen_register(REG_Sp);
     return make_AsmBinary(&binop, &asm_type, &src, &dst);
 }
@@ -473,32 +486,7 @@ static void push_callee_saved_regs(Ctx ctx, vector_t(shared_ptr_t(AsmOperand)) c
 static void pop_callee_saved_regs(Ctx ctx, vector_t(shared_ptr_t(AsmOperand)) callee_saved_regs) {
     for (size_t i = vec_size(callee_saved_regs); i-- > 0;) {
         THROW_ABORT_IF(callee_saved_regs[i]->type != AST_AsmRegister_t);
-        REGISTER_KIND reg_kind = register_mask_kind(&callee_saved_regs[i]->get._AsmRegister.reg);
-        AsmReg reg = init_AsmReg();
-        switch (reg_kind) {
-            case REG_Bx: {
-                reg = init_AsmBx();
-                break;
-            }
-            case REG_R12: {
-                reg = init_AsmR12();
-                break;
-            }
-            case REG_R13: {
-                reg = init_AsmR13();
-                break;
-            }
-            case REG_R14: {
-                reg = init_AsmR14();
-                break;
-            }
-            case REG_R15: {
-                reg = init_AsmR15();
-                break;
-            }
-            default:
-                THROW_ABORT;
-        }
+        AsmReg reg = callee_saved_regs[i]->get._AsmRegister.reg;
         push_fix_instr(ctx, make_AsmPop(&reg));
     }
 }
@@ -966,7 +954,7 @@ static void push_from_quad_imm(Ctx ctx, AsmPush* node) {
 static void fix_push_instr(Ctx ctx, AsmPush* node) {
     if (node->src->type == AST_AsmRegister_t) {
         REGISTER_KIND reg_kind = register_mask_kind(&node->src->get._AsmRegister.reg);
-        if (reg_kind != REG_Sp && register_mask_bit(reg_kind) > 11) {
+        if (reg_kind != REG_Sp && register_mask_bit(reg_kind) > 12) {
             push_dbl_from_xmm_reg(ctx, node);
         }
     }
@@ -1015,6 +1003,169 @@ static void fix_instr(Ctx ctx, AsmInstruction* node) {
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Frame pointer omission
+
+static void omit_frame_alloc_stack_bytes(Ctx ctx, TLong callee_saved_size, bool is_leaf) {
+    ctx->frame_bytes = 0l;
+    if (ctx->stack_bytes > 0l) {
+        align_offset_stack_bytes(ctx, 8);
+        ctx->frame_bytes = ctx->stack_bytes + 8l;
+        // Leaf functions can keep their locals in the red zone below the stack pointer
+        if (is_leaf && callee_saved_size == 0l && ctx->frame_bytes <= 128l) {
+            ctx->frame_bytes = 0l;
+        }
+    }
+    if (!is_leaf && (ctx->frame_bytes + callee_saved_size * 8l) % 16l == 0l) {
+        ctx->frame_bytes += 8l;
+    }
+    if (ctx->frame_bytes > 0l) {
+        (*ctx->p_fix_instrs)[0] = alloc_stack_bytes(ctx->frame_bytes);
+    }
+}
+
+static void omit_frame_op(Ctx ctx, shared_ptr_t(AsmOperand) * frame_op) {
+    switch ((*frame_op)->type) {
+        case AST_AsmMemory_t: {
+            if ((*frame_op)->get._AsmMemory.reg.type == AST_AsmBp_t) {
+                TLong value = (*frame_op)->get._AsmMemory.value + ctx->sp_offset - 8l;
+                free_AsmOperand(frame_op);
+                *frame_op = gen_memory(REG_Sp, value);
+            }
+            break;
+        }
+        case AST_AsmIndexed_t: {
+            // Stack slots are only addressed as Memory(Bp, value), indexed addresses are built from other registers
+            THROW_ABORT_IF((*frame_op)->get._AsmIndexed.reg_base.type == AST_AsmBp_t
+                           || (*frame_op)->get._AsmIndexed.reg_index.type == AST_AsmBp_t);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static void omit_frame_binary_instr(Ctx ctx, AsmBinary* node) {
+    if (node->dst->type == AST_AsmRegister_t && node->dst->get._AsmRegister.reg.type == AST_AsmSp_t) {
+        THROW_ABORT_IF(node->src->type != AST_AsmImm_t);
+        TLong value = (TLong)node->src->get._AsmImm.value;
+        switch (node->binop.type) {
+            case AST_AsmAdd_t:
+                ctx->sp_offset -= value;
+                break;
+            case AST_AsmSub_t:
+                ctx->sp_offset += value;
+                break;
+            default:
+                THROW_ABORT;
+        }
+    }
+    else {
+        omit_frame_op(ctx, &node->src);
+        omit_frame_op(ctx, &node->dst);
+    }
+}
+
+static void omit_frame_instr(Ctx ctx, AsmInstruction* node) {
+    switch (node->type) {
+        case AST_AsmMov_t:
+            omit_frame_op(ctx, &node->get._AsmMov.src);
+            omit_frame_op(ctx, &node->get._AsmMov.dst);
+            break;
+        case AST_AsmMovSx_t:
+            omit_frame_op(ctx, &node->get._AsmMovSx.src);
+            omit_frame_op(ctx, &node->get._AsmMovSx.dst);
+            break;
+        case AST_AsmMovZeroExtend_t:
+            omit_frame_op(ctx, &node->get._AsmMovZeroExtend.src);
+            omit_frame_op(ctx, &node->get._AsmMovZeroExtend.dst);
+            break;
+        case AST_AsmLea_t:
+            omit_frame_op(ctx, &node->get._AsmLea.src);
+            omit_frame_op(ctx, &node->get._AsmLea.dst);
+            break;
+        case AST_AsmCvttsd2si_t:
+            omit_frame_op(ctx, &node->get._AsmCvttsd2si.src);
+            omit_frame_op(ctx, &node->get._AsmCvttsd2si.dst);
+            break;
+        case AST_AsmCvtsi2sd_t:
+            omit_frame_op(ctx, &node->get._AsmCvtsi2sd.src);
+            omit_frame_op(ctx, &node->get._AsmCvtsi2sd.dst);
+            break;
+        case AST_AsmUnary_t:
+            omit_frame_op(ctx, &node->get._AsmUnary.dst);
+            break;
+        case AST_AsmBinary_t:
+            omit_frame_binary_instr(ctx, &node->get._AsmBinary);
+            break;
+        case AST_AsmMovPacked_t:
+            omit_frame_op(ctx, &node->get._AsmMovPacked.src);
+            omit_frame_op(ctx, &node->get._AsmMovPacked.dst);
+            break;
+        case AST_AsmBinaryPacked_t:
+            omit_frame_op(ctx, &node->get._AsmBinaryPacked.src);
+            omit_frame_op(ctx, &node->get._AsmBinaryPacked.dst);
+            break;
+        case AST_AsmCmp_t:
+            omit_frame_op(ctx, &node->get._AsmCmp.src);
+            omit_frame_op(ctx, &node->get._AsmCmp.dst);
+            break;
+        case AST_AsmTest_t:
+            omit_frame_op(ctx, &node->get._AsmTest.src);
+            omit_frame_op(ctx, &node->get._AsmTest.dst);
+            break;
+        case AST_AsmIdiv_t:
+            omit_frame_op(ctx, &node->get._AsmIdiv.src);
+            break;
+        case AST_AsmDiv_t:
+            omit_frame_op(ctx, &node->get._AsmDiv.src);
+            break;
+        case AST_AsmSetCC_t:
+            omit_frame_op(ctx, &node->get._AsmSetCC.dst);
+            break;
+        case AST_AsmPush_t:
+            omit_frame_op(ctx, &node->get._AsmPush.src);
+            ctx->sp_offset += 8l;
+            break;
+        case AST_AsmPop_t:
+            ctx->sp_offset -= 8l;
+            break;
+        default:
+            break;
+    }
+}
+
+static void omit_frame_fun_toplvl(Ctx ctx, AsmFunction* node, TLong callee_saved_size, bool is_leaf) {
+    omit_frame_alloc_stack_bytes(ctx, callee_saved_size, is_leaf);
+
+    vector_t(unique_ptr_t(AsmInstruction)) instructions = vec_new();
+    vec_move(node->instructions, instructions);
+
+    vec_clear(node->instructions);
+    vec_reserve(node->instructions, vec_size(instructions));
+
+    ctx->sp_offset = ctx->frame_bytes;
+    push_fix_instr(ctx, instructions[0]);
+    instructions[0] = uptr_new();
+    for (size_t i = 1; i < vec_size(instructions); ++i) {
+        if (instructions[i]) {
+            if (instructions[i]->type == AST_AsmRet_t || instructions[i]->type == AST_AsmTailCall_t) {
+                if (ctx->frame_bytes > 0l) {
+                    push_fix_instr(ctx, dealloc_stack_bytes(ctx->frame_bytes));
+                }
+                ctx->sp_offset = ctx->frame_bytes + callee_saved_size * 8l;
+            }
+            else {
+                omit_frame_instr(ctx, instructions[i]);
+            }
+        }
+        push_fix_instr(ctx, instructions[i]);
+        instructions[i] = uptr_new();
+    }
+    vec_delete(instructions);
+}
+
 static void fix_fun_toplvl(Ctx ctx, AsmFunction* node) {
     vector_t(unique_ptr_t(AsmInstruction)) instructions = vec_new();
     vec_move(node->instructions, instructions);
@@ -1029,13 +1180,19 @@ static void fix_fun_toplvl(Ctx ctx, AsmFunction* node) {
     vec_push_back(*ctx->p_fix_instrs, uptr_new());
 
     bool is_ret = false;
+    // A tail call releases the frame before it jumps, so the callee can only overwrite the red zone once the locals
+    // are dead, and it finds the stack aligned as on entry: functions that only make tail calls are leaves
+    bool is_leaf = true;
     push_callee_saved_regs(ctx, backend_fun->callee_saved_regs);
     for (size_t i = 0; i < vec_size(instructions); ++i) {
         if (instructions[i]) {
-            if (instructions[i]->type == AST_AsmRet_t) {
+            if (instructions[i]->type == AST_AsmRet_t || instructions[i]->type == AST_AsmTailCall_t) {
                 pop_callee_saved_regs(ctx, backend_fun->callee_saved_regs);
                 is_ret = true;
             }
+            else if (instructions[i]->type == AST_AsmCall_t) {
+                is_leaf = false;
+            }
             push_fix_instr(ctx, instructions[i]);
             instructions[i] = uptr_new();
 
@@ -1046,12 +1203,17 @@ static void fix_fun_toplvl(Ctx ctx, AsmFunction* node) {
     if (!is_ret) {
         pop_callee_saved_regs(ctx, backend_fun->callee_saved_regs);
     }
+    vec_delete(instructions);
     {
         TLong callee_saved_size = (TLong)vec_size(backend_fun->callee_saved_regs);
-        fix_alloc_stack_bytes(ctx, callee_saved_size);
+        if (ctx->is_omit_frame_ptr) {
+            omit_frame_fun_toplvl(ctx, node, callee_saved_size, is_leaf);
+        }
+        else {
+            fix_alloc_stack_bytes(ctx, callee_saved_size);
+        }
     }
     ctx->p_fix_instrs = NULL;
-    vec_delete(instructions);
 }
 
 static void fix_toplvl(Ctx ctx, AsmTopLevel* node) {
@@ -1074,12 +1236,15 @@ static void fix_program(Ctx ctx, const AsmProgram* node) {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void fix_stack(const AsmProgram* node, BackEndContext* backend) {
+void fix_stack(const AsmProgram* node, BackEndContext* backend, bool is_omit_frame_ptr) {
     StackFixContext ctx;
     {
         ctx.backend = backend;
         ctx.stack_bytes = 0l;
         ctx.pseudo_stack_map = map_new();
+        ctx.is_omit_frame_ptr = is_omit_frame_ptr;
+        ctx.frame_bytes = 0l;
+        ctx.sp_offset = 0l;
     }
     fix_program(&ctx, node);
 
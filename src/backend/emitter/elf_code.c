@@ -0,0 +1,1661 @@
+#include <stdlib.h>
+
+#include "util/c_std.h"
+#include "util/fileio.h"
+#include "util/throw.h"
+
+#include "ast/ast.h"
+#include "ast/back_ast.h"
+#include "ast/back_symt.h"
+#include "ast/front_symt.h"
+
+#include "backend/emitter/elf_code.h"
+
+#define ELF_SECTION_TEXT 1
+#define ELF_SECTION_DATA 2
+#define ELF_SECTION_BSS 3
+#define ELF_SECTION_RODATA 4
+#define ELF_SECTION_RELA_TEXT 5
+#define ELF_SECTION_RELA_DATA 6
+#define ELF_SECTION_SYMTAB 7
+#define ELF_SECTION_STRTAB 8
+#define ELF_SECTION_SHSTRTAB 9
+#define ELF_SECTION_NOTE_STACK 10
+#define ELF_SECTIONS_SIZE 11
+
+#define ELF_EHDR_SIZE 64
+#define ELF_SHDR_SIZE 64
+#define ELF_SYM_SIZE 24
+#define ELF_RELA_SIZE 24
+
+#define R_X86_64_64 1
+#define R_X86_64_PC32 2
+#define R_X86_64_PLT32 4
+
+typedef enum ELF_FRAG_KIND {
+    FRAG_Code,
+    FRAG_Jmp,
+    FRAG_JmpCC,
+    FRAG_Call,
+    FRAG_Label,
+    FRAG_Align
+} ELF_FRAG_KIND;
+
+typedef struct ElfReloc {
+    size_t offset;
+    TIdentifier name;
+    uint32_t type;
+    TLong addend;
+} ElfReloc;
+
+typedef struct ElfSymbol {
+    size_t section;
+    size_t value;
+    size_t size;
+    bool is_glob;
+    bool is_fun;
+    bool is_label;
+} ElfSymbol;
+
+PairKeyValue(TIdentifier, ElfSymbol);
+
+typedef struct ElfSection {
+    size_t bss_size;
+    size_t alignment;
+    vector_t(uint8_t) bytes;
+    vector_t(ElfReloc) relocs;
+} ElfSection;
+
+typedef struct ElfFragment {
+    ELF_FRAG_KIND kind;
+    bool is_near;
+    uint8_t cond_code;
+    TIdentifier target;
+    size_t addr;
+    size_t code_front;
+    size_t code_back;
+    size_t reloc_front;
+    size_t reloc_back;
+} ElfFragment;
+
+typedef struct ElfFunction {
+    TIdentifier name;
+    bool is_glob;
+    size_t frag_front;
+    size_t frag_back;
+} ElfFunction;
+
+typedef struct ElfCodeContext {
+    BackEndContext* backend;
+    FileIoContext* fileio;
+    IdentifierContext* identifiers;
+    // Elf object code emission
+    bool is_omit_frame_ptr;
+    bool is_align_loops;
+    ElfSection sections[ELF_SECTION_RODATA + 1];
+    vector_t(uint8_t) code;
+    vector_t(ElfReloc) code_relocs;
+    vector_t(ElfFragment) frags;
+    vector_t(ElfFunction) funs;
+    hashmap_t(TIdentifier, size_t) label_frag_map;
+    hashmap_t(TIdentifier, ElfSymbol) symbol_map;
+    hashmap_t(TIdentifier, size_t) symbol_idx_map;
+    hashset_t(TIdentifier) label_set;
+    hashset_t(TIdentifier) loop_label_set;
+    vector_t(uint8_t) elf;
+} ElfCodeContext;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Elf object code emission
+
+typedef ElfCodeContext* Ctx;
+
+static void push_bytes(vector_t(uint8_t) * p_bytes, TULong value, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        vec_push_back(*p_bytes, (uint8_t)(value >> (8 * i)));
+    }
+}
+
+static void set_bytes(vector_t(uint8_t) bytes, size_t offset, TULong value, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        bytes[offset + i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static void align_bytes(vector_t(uint8_t) * p_bytes, size_t alignment) {
+    while (vec_size(*p_bytes) % alignment != 0) {
+        vec_push_back(*p_bytes, 0);
+    }
+}
+
+static size_t get_section_size(Ctx ctx, size_t section) {
+    if (section == ELF_SECTION_BSS) {
+        return ctx->sections[section].bss_size;
+    }
+    else {
+        return vec_size(ctx->sections[section].bytes);
+    }
+}
+
+static void align_section(Ctx ctx, size_t section, TInt alignment) {
+    if (alignment > 1) {
+        if ((size_t)alignment > ctx->sections[section].alignment) {
+            ctx->sections[section].alignment = (size_t)alignment;
+        }
+        if (section == ELF_SECTION_BSS) {
+            ElfSection* bss = &ctx->sections[section];
+            bss->bss_size = (bss->bss_size + (size_t)alignment - 1) / (size_t)alignment * (size_t)alignment;
+        }
+        else {
+            align_bytes(&ctx->sections[section].bytes, (size_t)alignment);
+        }
+    }
+}
+
+static void ref_symbol(Ctx ctx, TIdentifier name) {
+    if (map_find(ctx->symbol_map, name) == map_end()) {
+        ElfSymbol symbol = {0, 0, 0, true, false, false};
+        map_add(ctx->symbol_map, name, symbol);
+    }
+}
+
+static void def_symbol(Ctx ctx, TIdentifier name, size_t section, size_t value, bool is_glob, bool is_fun) {
+    ElfSymbol symbol = {section, value, get_section_size(ctx, section) - value, is_glob, is_fun, false};
+    map_add(ctx->symbol_map, name, symbol);
+}
+
+static void def_fun_symbol(Ctx ctx, TIdentifier name, size_t value, size_t size, bool is_glob) {
+    ElfSymbol symbol = {ELF_SECTION_TEXT, value, size, is_glob, true, false};
+    map_add(ctx->symbol_map, name, symbol);
+}
+
+static void def_label_symbol(Ctx ctx, TIdentifier name, size_t section, size_t value) {
+    ElfSymbol symbol = {section, value, get_section_size(ctx, section) - value, false, false, true};
+    map_add(ctx->symbol_map, name, symbol);
+}
+
+// Reg(AX)  -> $ 0    Reg(SP)  -> $ 4    Reg(R8)  -> $ 8    Reg(R12) -> $ 12
+// Reg(CX)  -> $ 1    Reg(BP)  -> $ 5    Reg(R9)  -> $ 9    Reg(R13) -> $ 13
+// Reg(DX)  -> $ 2    Reg(SI)  -> $ 6    Reg(R10) -> $ 10   Reg(R14) -> $ 14
+// Reg(BX)  -> $ 3    Reg(DI)  -> $ 7    Reg(R11) -> $ 11   Reg(R15) -> $ 15
+// Reg(XMM<n>) -> $ <n>
+static uint8_t get_reg_num(const AsmReg* node) {
+    switch (node->type) {
+        case AST_AsmAx_t:
+        case AST_AsmXMM0_t:
+            return 0;
+        case AST_AsmCx_t:
+        case AST_AsmXMM1_t:
+            return 1;
+        case AST_AsmDx_t:
+        case AST_AsmXMM2_t:
+            return 2;
+        case AST_AsmBx_t:
+        case AST_AsmXMM3_t:
+            return 3;
+        case AST_AsmSp_t:
+        case AST_AsmXMM4_t:
+            return 4;
+        case AST_AsmBp_t:
+        case AST_AsmXMM5_t:
+            return 5;
+        case AST_AsmSi_t:
+        case AST_AsmXMM6_t:
+            return 6;
+        case AST_AsmDi_t:
+        case AST_AsmXMM7_t:
+            return 7;
+        case AST_AsmR8_t:
+        case AST_AsmXMM8_t:
+            return 8;
+        case AST_AsmR9_t:
+        case AST_AsmXMM9_t:
+            return 9;
+        case AST_AsmR10_t:
+        case AST_AsmXMM10_t:
+            return 10;
+        case AST_AsmR11_t:
+        case AST_AsmXMM11_t:
+            return 11;
+        case AST_AsmR12_t:
+        case AST_AsmXMM12_t:
+            return 12;
+        case AST_AsmR13_t:
+        case AST_AsmXMM13_t:
+            return 13;
+        case AST_AsmR14_t:
+        case AST_AsmXMM14_t:
+            return 14;
+        case AST_AsmR15_t:
+        case AST_AsmXMM15_t:
+            return 15;
+        default:
+            THROW_ABORT;
+    }
+}
+
+static bool is_op_xmm(const AsmOperand* node) {
+    if (node->type == AST_AsmRegister_t) {
+        switch (node->get._AsmRegister.reg.type) {
+            case AST_AsmXMM0_t:
+            case AST_AsmXMM1_t:
+            case AST_AsmXMM2_t:
+            case AST_AsmXMM3_t:
+            case AST_AsmXMM4_t:
+            case AST_AsmXMM5_t:
+            case AST_AsmXMM6_t:
+            case AST_AsmXMM7_t:
+            case AST_AsmXMM8_t:
+            case AST_AsmXMM9_t:
+            case AST_AsmXMM10_t:
+            case AST_AsmXMM11_t:
+            case AST_AsmXMM12_t:
+            case AST_AsmXMM13_t:
+            case AST_AsmXMM14_t:
+            case AST_AsmXMM15_t:
+                return true;
+            default:
+                break;
+        }
+    }
+    return false;
+}
+
+static uint8_t get_op_reg_num(const AsmOperand* node) {
+    THROW_ABORT_IF(node->type != AST_AsmRegister_t);
+    return get_reg_num(&node->get._AsmRegister.reg);
+}
+
+// E  -> $ 4    L  -> $ 12   B  -> $ 2    P -> $ 10
+// NE -> $ 5    LE -> $ 14   BE -> $ 6
+//              G  -> $ 15   A  -> $ 7
+//              GE -> $ 13   AE -> $ 3
+static uint8_t get_cond_code(const AsmCondCode* node) {
+    switch (node->type) {
+        case AST_AsmE_t:
+            return 0x4;
+        case AST_AsmNE_t:
+            return 0x5;
+        case AST_AsmL_t:
+            return 0xc;
+        case AST_AsmLE_t:
+            return 0xe;
+        case AST_AsmG_t:
+            return 0xf;
+        case AST_AsmGE_t:
+            return 0xd;
+        case AST_AsmB_t:
+            return 0x2;
+        case AST_AsmBE_t:
+            return 0x6;
+        case AST_AsmA_t:
+            return 0x7;
+        case AST_AsmAE_t:
+            return 0x3;
+        case AST_AsmP_t:
+            return 0xa;
+        default:
+            THROW_ABORT;
+    }
+}
+
+// Immediates are sign extended from the operand size
+static TLong get_imm_value(const AsmOperand* node, const AssemblyType* asm_type) {
+    THROW_ABORT_IF(node->type != AST_AsmImm_t);
+    TULong value = node->get._AsmImm.value;
+    switch (asm_type->type) {
+        case AST_Byte_t:
+            return (TLong)(int8_t)(uint8_t)value;
+        case AST_LongWord_t:
+            return (TLong)(int32_t)(uint32_t)value;
+        case AST_QuadWord_t:
+            return (TLong)value;
+        default:
+            THROW_ABORT;
+    }
+}
+
+static bool is_imm_1b(TLong value) { return value >= -128l && value <= 127l; }
+
+static bool is_imm_4b(TLong value) { return value >= -2147483648l && value <= 2147483647l; }
+
+static void emit_byte(Ctx ctx, uint8_t byte) { vec_push_back(ctx->code, byte); }
+
+static void emit_imm(Ctx ctx, TLong value, size_t size) { push_bytes(&ctx->code, (TULong)value, size); }
+
+static void emit_opcode(Ctx ctx, uint32_t opcode) {
+    if (opcode > 0xffffu) {
+        emit_byte(ctx, (uint8_t)(opcode >> 16));
+    }
+    if (opcode > 0xffu) {
+        emit_byte(ctx, (uint8_t)(opcode >> 8));
+    }
+    emit_byte(ctx, (uint8_t)opcode);
+}
+
+static uint8_t get_scale_bits(TLong scale) {
+    switch (scale) {
+        case 1l:
+            return 0;
+        case 2l:
+            return 1;
+        case 4l:
+            return 2;
+        case 8l:
+            return 3;
+        default:
+            THROW_ABORT;
+    }
+}
+
+static void data_reloc(Ctx ctx, const AsmData* node, size_t imm_size) {
+    ElfReloc reloc = {vec_size(ctx->code), node->name, R_X86_64_PC32, node->offset - 4l - (TLong)imm_size};
+    vec_push_back(ctx->code_relocs, reloc);
+    ref_symbol(ctx, node->name);
+    emit_imm(ctx, 0l, 4);
+}
+
+// Instructions are encoded as [prefix] [rex] <opcode> <modrm> [sib] [displacement] [immediate], where reg is either a
+// register number or an opcode extension, and the byte registers sp, bp, si and di of the r/m operand need a rex prefix
+// Register(reg)            -> $ modrm(11, reg, rm)
+// Memory(int, reg)         -> $ modrm(00 | 01 | 10, reg, rm) [sib] [disp8 | disp32]
+// Data(identifier, int)    -> $ modrm(00, reg, 101) disp32 + R_X86_64_PC32
+// Indexed(reg1, reg2, int) -> $ modrm(00 | 01, reg, 100) sib [disp8]
+static void encode_rex_instr(Ctx ctx, uint8_t prefix, uint8_t rex, bool is_byte, uint32_t opcode, uint8_t reg,
+    const AsmOperand* node, TLong imm, size_t imm_size) {
+    if (reg >= 8) {
+        rex |= 0x44;
+    }
+    switch (node->type) {
+        case AST_AsmRegister_t: {
+            uint8_t rm = get_reg_num(&node->get._AsmRegister.reg);
+            if (rm >= 8) {
+                rex |= 0x41;
+            }
+            if (is_byte && rm >= 4 && rm < 8) {
+                rex |= 0x40;
+            }
+            break;
+        }
+        case AST_AsmMemory_t: {
+            if (get_reg_num(&node->get._AsmMemory.reg) >= 8) {
+                rex |= 0x41;
+            }
+            break;
+        }
+        case AST_AsmData_t:
+            break;
+        case AST_AsmIndexed_t: {
+            if (get_reg_num(&node->get._AsmIndexed.reg_base) >= 8) {
+                rex |= 0x41;
+            }
+            if (get_reg_num(&node->get._AsmIndexed.reg_index) >= 8) {
+                rex |= 0x42;
+            }
+            break;
+        }
+        default:
+            THROW_ABORT;
+    }
+    if (prefix != 0x00) {
+        emit_byte(ctx, prefix);
+    }
+    if (rex != 0x00) {
+        emit_byte(ctx, rex);
+    }
+    emit_opcode(ctx, opcode);
+    reg = (reg & 7) << 3;
+    switch (node->type) {
+        case AST_AsmRegister_t:
+            emit_byte(ctx, 0xc0 | reg | (get_reg_num(&node->get._AsmRegister.reg) & 7));
+            break;
+        case AST_AsmMemory_t: {
+            uint8_t rm = get_reg_num(&node->get._AsmMemory.reg) & 7;
+            TLong value = node->get._AsmMemory.value;
+            uint8_t mod = 0x80;
+            if (value == 0l && rm != 5) {
+                mod = 0x00;
+            }
+            else if (is_imm_1b(value)) {
+                mod = 0x40;
+            }
+            emit_byte(ctx, mod | reg | rm);
+            if (rm == 4) {
+                emit_byte(ctx, 0x24);
+            }
+            if (mod == 0x40) {
+                emit_imm(ctx, value, 1);
+            }
+            else if (mod == 0x80) {
+                emit_imm(ctx, value, 4);
+            }
+            break;
+        }
+        case AST_AsmData_t:
+            emit_byte(ctx, reg | 5);
+            data_reloc(ctx, &node->get._AsmData, imm_size);
+            break;
+        case AST_AsmIndexed_t: {
+            uint8_t base = get_reg_num(&node->get._AsmIndexed.reg_base) & 7;
+            uint8_t index = get_reg_num(&node->get._AsmIndexed.reg_index) & 7;
+            uint8_t mod = base == 5 ? 0x40 : 0x00;
+            emit_byte(ctx, mod | reg | 4);
+            emit_byte(ctx, (get_scale_bits(node->get._AsmIndexed.scale) << 6) | (index << 3) | base);
+            if (mod == 0x40) {
+                emit_byte(ctx, 0x00);
+            }
+            break;
+        }
+        default:
+            THROW_ABORT;
+    }
+    emit_imm(ctx, imm, imm_size);
+}
+
+static void encode_instr(Ctx ctx, uint8_t prefix, bool is_quad, bool is_byte, uint32_t opcode, uint8_t reg,
+    const AsmOperand* node, TLong imm, size_t imm_size) {
+    encode_rex_instr(ctx, prefix, is_quad ? 0x48 : 0x00, is_byte, opcode, reg, node, imm, imm_size);
+}
+
+// Register(reg) -> $ [rex] <opcode> <modrm(reg, rm)>, where the byte registers sp, bp, si and di in the reg field also
+// need a rex prefix
+static void encode_reg_rm_instr(
+    Ctx ctx, bool is_quad, bool is_byte, uint32_t opcode, uint8_t reg, const AsmOperand* node) {
+    uint8_t rex = is_quad ? 0x48 : 0x00;
+    if (is_byte && reg >= 4 && reg < 8) {
+        rex |= 0x40;
+    }
+    encode_rex_instr(ctx, 0x00, rex, is_byte, opcode, reg, node, 0l, 0);
+}
+
+// Register(reg) -> $ [rex] <opcode + reg>
+static void encode_reg_instr(Ctx ctx, bool is_quad, bool is_byte, uint8_t opcode, uint8_t reg) {
+    uint8_t rex = is_quad ? 0x48 : 0x00;
+    if (reg >= 8) {
+        rex |= 0x41;
+    }
+    if (is_byte && reg >= 4 && reg < 8) {
+        rex |= 0x40;
+    }
+    if (rex != 0x00) {
+        emit_byte(ctx, rex);
+    }
+    emit_byte(ctx, opcode + (reg & 7));
+}
+
+// Register(ax) -> $ [rex.w] <opcode> <imm>, the accumulator forms are one byte shorter than the modrm forms
+static void encode_acc_instr(Ctx ctx, bool is_quad, uint8_t opcode, TLong imm, size_t imm_size) {
+    if (is_quad) {
+        emit_byte(ctx, 0x48);
+    }
+    emit_byte(ctx, opcode);
+    emit_imm(ctx, imm, imm_size);
+}
+
+static bool is_acc_reg(const AsmOperand* node) {
+    return node->type == AST_AsmRegister_t && get_reg_num(&node->get._AsmRegister.reg) == 0;
+}
+
+// Add              -> $ 0
+// BitOr            -> $ 1
+// BitAnd           -> $ 4
+// Sub              -> $ 5
+// BitXor           -> $ 6
+// Cmp              -> $ 7
+// BitShiftLeft     -> $ 4
+// BitShiftRight    -> $ 5
+// BitShrArithmetic -> $ 7
+static uint8_t get_binop_ext(const AsmBinaryOp* node) {
+    switch (node->type) {
+        case AST_AsmAdd_t:
+            return 0;
+        case AST_AsmBitOr_t:
+            return 1;
+        case AST_AsmBitAnd_t:
+            return 4;
+        case AST_AsmSub_t:
+            return 5;
+        case AST_AsmBitXor_t:
+            return 6;
+        case AST_AsmBitShiftLeft_t:
+            return 4;
+        case AST_AsmBitShiftRight_t:
+            return 5;
+        case AST_AsmBitShrArithmetic_t:
+            return 7;
+        default:
+            THROW_ABORT;
+    }
+}
+
+// Add<d>       -> $ f2 0f 58    Add<d> packed       -> $ 66 0f 58    Add<l> packed -> $ 66 0f fe
+// Sub<d>       -> $ f2 0f 5c    Sub<d> packed       -> $ 66 0f 5c    Add<q> packed -> $ 66 0f d4
+// Mult<d>      -> $ f2 0f 59    Mult<d> packed      -> $ 66 0f 59    Sub<l> packed -> $ 66 0f fa
+// DivDouble<d> -> $ f2 0f 5e    DivDouble<d> packed -> $ 66 0f 5e    Sub<q> packed -> $ 66 0f fb
+// BitXor<d>    -> $ 66 0f 57    BitAnd packed       -> $ 66 0f db    BitOr packed  -> $ 66 0f eb
+//                               BitXor packed       -> $ 66 0f ef
+static uint32_t get_sse_binop(const AsmBinaryOp* node, const AssemblyType* asm_type, bool is_packed) {
+    bool is_dbl = asm_type->type == AST_BackendDouble_t;
+    switch (node->type) {
+        case AST_AsmAdd_t:
+            return is_dbl ? 0x0f58 : asm_type->type == AST_LongWord_t ? 0x0ffe : 0x0fd4;
+        case AST_AsmSub_t:
+            return is_dbl ? 0x0f5c : asm_type->type == AST_LongWord_t ? 0x0ffa : 0x0ffb;
+        case AST_AsmMult_t:
+            THROW_ABORT_IF(!is_dbl);
+            return 0x0f59;
+        case AST_AsmDivDouble_t:
+            THROW_ABORT_IF(!is_dbl);
+            return 0x0f5e;
+        case AST_AsmBitAnd_t:
+            THROW_ABORT_IF(!is_packed);
+            return 0x0fdb;
+        case AST_AsmBitOr_t:
+            THROW_ABORT_IF(!is_packed);
+            return 0x0feb;
+        case AST_AsmBitXor_t:
+            return is_packed ? 0x0fef : 0x0f57;
+        default:
+            THROW_ABORT;
+    }
+}
+
+// Arithmetic(imm, ax)<b>  -> $ <8 * ext + 4> ib
+// Arithmetic(imm, ax)     -> $ 83 /ext ib | <8 * ext + 5> id
+// Arithmetic(imm, dst)<b> -> $ 80 /ext ib
+// Arithmetic(imm, dst)    -> $ 83 /ext ib | 81 /ext id
+// Arithmetic(reg, dst)    -> $ <8 * ext + 0 | 1> /reg
+// Arithmetic(src, reg)    -> $ <8 * ext + 2 | 3> /reg
+static void alu_instr(
+    Ctx ctx, uint8_t ext, const AssemblyType* asm_type, const AsmOperand* src, const AsmOperand* dst) {
+    bool is_byte = asm_type->type == AST_Byte_t;
+    bool is_quad = asm_type->type == AST_QuadWord_t;
+    if (src->type == AST_AsmImm_t) {
+        TLong value = get_imm_value(src, asm_type);
+        if (is_byte) {
+            if (is_acc_reg(dst)) {
+                encode_acc_instr(ctx, false, 8u * ext + 4u, value, 1);
+            }
+            else {
+                encode_instr(ctx, 0x00, false, true, 0x80, ext, dst, value, 1);
+            }
+        }
+        else if (is_imm_1b(value)) {
+            encode_instr(ctx, 0x00, is_quad, false, 0x83, ext, dst, value, 1);
+        }
+        else {
+            THROW_ABORT_IF(!is_imm_4b(value));
+            if (is_acc_reg(dst)) {
+                encode_acc_instr(ctx, is_quad, 8u * ext + 5u, value, 4);
+            }
+            else {
+                encode_instr(ctx, 0x00, is_quad, false, 0x81, ext, dst, value, 4);
+            }
+        }
+    }
+    else if (src->type == AST_AsmRegister_t) {
+        encode_reg_rm_instr(ctx, is_quad, is_byte, 8u * ext + (is_byte ? 0u : 1u), get_op_reg_num(src), dst);
+    }
+    else {
+        encode_reg_rm_instr(ctx, is_quad, is_byte, 8u * ext + (is_byte ? 2u : 3u), get_op_reg_num(dst), src);
+    }
+}
+
+// Mov<d>(src, xmm)     -> $ f2 0f 10 /xmm
+// Mov<d>(xmm, dst)     -> $ f2 0f 11 /xmm
+// Mov<q>(xmm, mem)     -> $ 66 0f d6 /xmm
+// Mov<q>(mem, xmm)     -> $ f3 0f 7e /xmm
+// Mov(xmm, reg)        -> $ 66 [rex.w] 0f 7e /xmm
+// Mov(reg, xmm)        -> $ 66 [rex.w] 0f 6e /xmm
+// Mov<b>(imm, reg)     -> $ b0+reg ib
+// Mov<l>(imm, reg)     -> $ b8+reg id
+// Mov<q>(imm, reg)     -> $ rex.w c7 /0 id | rex.w b8+reg iq
+// Mov(imm, dst)        -> $ c6 | c7 /0 ib | id
+// Mov(reg, dst)        -> $ 88 | 89 /reg
+// Mov(src, reg)        -> $ 8a | 8b /reg
+static void mov_instr(Ctx ctx, const AsmMov* node) {
+    bool is_byte = node->asm_type->type == AST_Byte_t;
+    bool is_quad = node->asm_type->type == AST_QuadWord_t;
+    if (node->asm_type->type == AST_BackendDouble_t) {
+        if (node->dst->type == AST_AsmRegister_t) {
+            encode_instr(ctx, 0xf2, false, false, 0x0f10, get_op_reg_num(node->dst), node->src, 0l, 0);
+        }
+        else {
+            encode_instr(ctx, 0xf2, false, false, 0x0f11, get_op_reg_num(node->src), node->dst, 0l, 0);
+        }
+    }
+    else if (is_op_xmm(node->src)) {
+        if (node->dst->type == AST_AsmRegister_t) {
+            encode_instr(ctx, 0x66, is_quad, false, 0x0f7e, get_op_reg_num(node->src), node->dst, 0l, 0);
+        }
+        else {
+            THROW_ABORT_IF(!is_quad);
+            encode_instr(ctx, 0x66, false, false, 0x0fd6, get_op_reg_num(node->src), node->dst, 0l, 0);
+        }
+    }
+    else if (is_op_xmm(node->dst)) {
+        if (node->src->type == AST_AsmRegister_t) {
+            encode_instr(ctx, 0x66, is_quad, false, 0x0f6e, get_op_reg_num(node->dst), node->src, 0l, 0);
+        }
+        else {
+            THROW_ABORT_IF(!is_quad);
+            encode_instr(ctx, 0xf3, false, false, 0x0f7e, get_op_reg_num(node->dst), node->src, 0l, 0);
+        }
+    }
+    else if (node->src->type == AST_AsmImm_t) {
+        TLong value = get_imm_value(node->src, node->asm_type);
+        if (node->dst->type == AST_AsmRegister_t) {
+            uint8_t reg = get_op_reg_num(node->dst);
+            if (is_byte) {
+                encode_reg_instr(ctx, false, true, 0xb0, reg);
+                emit_imm(ctx, value, 1);
+            }
+            else if (!is_quad) {
+                encode_reg_instr(ctx, false, false, 0xb8, reg);
+                emit_imm(ctx, value, 4);
+            }
+            else if (is_imm_4b(value)) {
+                encode_instr(ctx, 0x00, true, false, 0xc7, 0, node->dst, value, 4);
+            }
+            else {
+                encode_reg_instr(ctx, true, false, 0xb8, reg);
+                emit_imm(ctx, value, 8);
+            }
+        }
+        else if (is_byte) {
+            encode_instr(ctx, 0x00, false, true, 0xc6, 0, node->dst, value, 1);
+        }
+        else {
+            THROW_ABORT_IF(!is_imm_4b(value));
+            encode_instr(ctx, 0x00, is_quad, false, 0xc7, 0, node->dst, value, 4);
+        }
+    }
+    else if (node->src->type == AST_AsmRegister_t) {
+        encode_reg_rm_instr(ctx, is_quad, is_byte, is_byte ? 0x88 : 0x89, get_op_reg_num(node->src), node->dst);
+    }
+    else {
+        encode_reg_rm_instr(ctx, is_quad, is_byte, is_byte ? 0x8a : 0x8b, get_op_reg_num(node->dst), node->src);
+    }
+}
+
+// Movsx<b, l>(src, reg) -> $ 0f be /reg
+// Movsx<b, q>(src, reg) -> $ rex.w 0f be /reg
+// Movsx<l, q>(src, reg) -> $ rex.w 63 /reg
+static void mov_sx_instr(Ctx ctx, const AsmMovSx* node) {
+    bool is_quad = node->asm_type_dst->type == AST_QuadWord_t;
+    if (node->asm_type_src->type == AST_Byte_t) {
+        encode_instr(ctx, 0x00, is_quad, true, 0x0fbe, get_op_reg_num(node->dst), node->src, 0l, 0);
+    }
+    else {
+        THROW_ABORT_IF(node->asm_type_src->type != AST_LongWord_t || !is_quad);
+        encode_instr(ctx, 0x00, true, false, 0x63, get_op_reg_num(node->dst), node->src, 0l, 0);
+    }
+}
+
+// MovZeroExtend<b, l>(src, reg) -> $ 0f b6 /reg
+// MovZeroExtend<b, q>(src, reg) -> $ rex.w 0f b6 /reg
+static void zero_extend_instr(Ctx ctx, const AsmMovZeroExtend* node) {
+    bool is_quad = node->asm_type_dst->type == AST_QuadWord_t;
+    encode_instr(ctx, 0x00, is_quad, true, 0x0fb6, get_op_reg_num(node->dst), node->src, 0l, 0);
+}
+
+// Lea(src, reg) -> $ rex.w 8d /reg
+static void lea_instr(Ctx ctx, const AsmLea* node) {
+    encode_instr(ctx, 0x00, true, false, 0x8d, get_op_reg_num(node->dst), node->src, 0l, 0);
+}
+
+// Cvttsd2si(t, src, reg) -> $ f2 [rex.w] 0f 2c /reg
+static void cvttsd2si_instr(Ctx ctx, const AsmCvttsd2si* node) {
+    bool is_quad = node->asm_type->type == AST_QuadWord_t;
+    encode_instr(ctx, 0xf2, is_quad, false, 0x0f2c, get_op_reg_num(node->dst), node->src, 0l, 0);
+}
+
+// Cvtsi2sd(t, src, xmm) -> $ f2 [rex.w] 0f 2a /xmm
+static void cvtsi2sd_instr(Ctx ctx, const AsmCvtsi2sd* node) {
+    bool is_quad = node->asm_type->type == AST_QuadWord_t;
+    encode_instr(ctx, 0xf2, is_quad, false, 0x0f2a, get_op_reg_num(node->dst), node->src, 0l, 0);
+}
+
+// Unary(Not, t, dst) -> $ f6 | f7 /2
+// Unary(Neg, t, dst) -> $ f6 | f7 /3
+// Unary(Shr, t, dst) -> $ d0 | d1 /5
+static void unary_instr(Ctx ctx, const AsmUnary* node) {
+    bool is_byte = node->asm_type->type == AST_Byte_t;
+    bool is_quad = node->asm_type->type == AST_QuadWord_t;
+    switch (node->unop.type) {
+        case AST_AsmNot_t:
+            encode_instr(ctx, 0x00, is_quad, is_byte, is_byte ? 0xf6 : 0xf7, 2, node->dst, 0l, 0);
+            break;
+        case AST_AsmNeg_t:
+            encode_instr(ctx, 0x00, is_quad, is_byte, is_byte ? 0xf6 : 0xf7, 3, node->dst, 0l, 0);
+            break;
+        case AST_AsmShr_t:
+            encode_instr(ctx, 0x00, is_quad, is_byte, is_byte ? 0xd0 : 0xd1, 5, node->dst, 0l, 0);
+            break;
+        default:
+            THROW_ABORT;
+    }
+}
+
+// Binary<d>(binop, src, xmm)  -> $ <sse-binop> /xmm
+// Binary(Mult, imm, reg)      -> $ 6b | 69 /reg ib | id
+// Binary(Mult, src, reg)      -> $ 0f af /reg
+// Binary(shift, 1, dst)       -> $ d0 | d1 /ext
+// Binary(shift, imm, dst)     -> $ c0 | c1 /ext ib
+// Binary(shift, CX, dst)      -> $ d2 | d3 /ext
+// Binary(binop, src, dst)     -> $ <arithmetic>
+static void binary_instr(Ctx ctx, const AsmBinary* node) {
+    bool is_byte = node->asm_type->type == AST_Byte_t;
+    bool is_quad = node->asm_type->type == AST_QuadWord_t;
+    if (node->asm_type->type == AST_BackendDouble_t) {
+        uint8_t prefix = node->binop.type == AST_AsmBitXor_t ? 0x66 : 0xf2;
+        encode_instr(ctx, prefix, false, false, get_sse_binop(&node->binop, node->asm_type, false),
+            get_op_reg_num(node->dst), node->src, 0l, 0);
+        return;
+    }
+    switch (node->binop.type) {
+        case AST_AsmMult_t: {
+            THROW_ABORT_IF(is_byte);
+            uint8_t reg = get_op_reg_num(node->dst);
+            if (node->src->type == AST_AsmImm_t) {
+                TLong value = get_imm_value(node->src, node->asm_type);
+                if (is_imm_1b(value)) {
+                    encode_instr(ctx, 0x00, is_quad, false, 0x6b, reg, node->dst, value, 1);
+                }
+                else {
+                    THROW_ABORT_IF(!is_imm_4b(value));
+                    encode_instr(ctx, 0x00, is_quad, false, 0x69, reg, node->dst, value, 4);
+                }
+            }
+            else {
+                encode_instr(ctx, 0x00, is_quad, false, 0x0faf, reg, node->src, 0l, 0);
+            }
+            break;
+        }
+        case AST_AsmBitShiftLeft_t:
+        case AST_AsmBitShiftRight_t:
+        case AST_AsmBitShrArithmetic_t: {
+            uint8_t ext = get_binop_ext(&node->binop);
+            if (node->src->type == AST_AsmImm_t && node->src->get._AsmImm.value == 1ul) {
+                encode_instr(ctx, 0x00, is_quad, is_byte, is_byte ? 0xd0 : 0xd1, ext, node->dst, 0l, 0);
+            }
+            else if (node->src->type == AST_AsmImm_t) {
+                TLong value = (TLong)(node->src->get._AsmImm.value & 0xfful);
+                encode_instr(ctx, 0x00, is_quad, is_byte, is_byte ? 0xc0 : 0xc1, ext, node->dst, value, 1);
+            }
+            else {
+                THROW_ABORT_IF(get_op_reg_num(node->src) != 1);
+                encode_instr(ctx, 0x00, is_quad, is_byte, is_byte ? 0xd2 : 0xd3, ext, node->dst, 0l, 0);
+            }
+            break;
+        }
+        default:
+            alu_instr(ctx, get_binop_ext(&node->binop), node->asm_type, node->src, node->dst);
+            break;
+    }
+}
+
+// MovPacked<d>(src, xmm) -> $ 66 0f 10 /xmm
+// MovPacked<d>(xmm, dst) -> $ 66 0f 11 /xmm
+// MovPacked(src, xmm)    -> $ f3 0f 6f /xmm
+// MovPacked(xmm, dst)    -> $ f3 0f 7f /xmm
+static void mov_packed_instr(Ctx ctx, const AsmMovPacked* node) {
+    bool is_dbl = node->asm_type->type == AST_BackendDouble_t;
+    uint8_t prefix = is_dbl ? 0x66 : 0xf3;
+    if (node->dst->type == AST_AsmRegister_t) {
+        encode_instr(
+            ctx, prefix, false, false, is_dbl ? 0x0f10 : 0x0f6f, get_op_reg_num(node->dst), node->src, 0l, 0);
+    }
+    else {
+        encode_instr(
+            ctx, prefix, false, false, is_dbl ? 0x0f11 : 0x0f7f, get_op_reg_num(node->src), node->dst, 0l, 0);
+    }
+}
+
+// BinaryPacked(binop, t, src, xmm) -> $ <sse-binop> /xmm
+static void binary_packed_instr(Ctx ctx, const AsmBinaryPacked* node) {
+    encode_instr(ctx, 0x66, false, false, get_sse_binop(&node->binop, node->asm_type, true),
+        get_op_reg_num(node->dst), node->src, 0l, 0);
+}
+
+// Cmp<d>(src, xmm) -> $ 66 0f 2f /xmm
+// Cmp(src, dst)    -> $ <arithmetic /7>
+static void cmp_instr(Ctx ctx, const AsmCmp* node) {
+    if (node->asm_type->type == AST_BackendDouble_t) {
+        encode_instr(ctx, 0x66, false, false, 0x0f2f, get_op_reg_num(node->dst), node->src, 0l, 0);
+    }
+    else {
+        alu_instr(ctx, 7, node->asm_type, node->src, node->dst);
+    }
+}
+
+// Test(imm, ax)  -> $ a8 | a9 ib | id
+// Test(imm, dst) -> $ f6 | f7 /0 ib | id
+// Test(reg, dst) -> $ 84 | 85 /reg
+// Test(src, reg) -> $ 84 | 85 /reg
+static void test_instr(Ctx ctx, const AsmTest* node) {
+    bool is_byte = node->asm_type->type == AST_Byte_t;
+    bool is_quad = node->asm_type->type == AST_QuadWord_t;
+    if (node->src->type == AST_AsmImm_t) {
+        TLong value = get_imm_value(node->src, node->asm_type);
+        THROW_ABORT_IF(!is_imm_4b(value));
+        if (is_acc_reg(node->dst)) {
+            encode_acc_instr(ctx, is_quad, is_byte ? 0xa8 : 0xa9, value, is_byte ? 1 : 4);
+        }
+        else {
+            encode_instr(ctx, 0x00, is_quad, is_byte, is_byte ? 0xf6 : 0xf7, 0, node->dst, value, is_byte ? 1 : 4);
+        }
+    }
+    else if (node->src->type == AST_AsmRegister_t) {
+        encode_reg_rm_instr(ctx, is_quad, is_byte, is_byte ? 0x84 : 0x85, get_op_reg_num(node->src), node->dst);
+    }
+    else {
+        encode_reg_rm_instr(ctx, is_quad, is_byte, is_byte ? 0x84 : 0x85, get_op_reg_num(node->dst), node->src);
+    }
+}
+
+// Idiv(t, src) -> $ f6 | f7 /7
+static void idiv_instr(Ctx ctx, const AsmIdiv* node) {
+    bool is_byte = node->asm_type->type == AST_Byte_t;
+    bool is_quad = node->asm_type->type == AST_QuadWord_t;
+    encode_instr(ctx, 0x00, is_quad, is_byte, is_byte ? 0xf6 : 0xf7, 7, node->src, 0l, 0);
+}
+
+// Div(t, src) -> $ f6 | f7 /6
+static void div_instr(Ctx ctx, const AsmDiv* node) {
+    bool is_byte = node->asm_type->type == AST_Byte_t;
+    bool is_quad = node->asm_type->type == AST_QuadWord_t;
+    encode_instr(ctx, 0x00, is_quad, is_byte, is_byte ? 0xf6 : 0xf7, 6, node->src, 0l, 0);
+}
+
+// Cdq<l> -> $ 99
+// Cdq<q> -> $ rex.w 99
+static void cdq_instr(Ctx ctx, const AsmCdq* node) {
+    switch (node->asm_type->type) {
+        case AST_LongWord_t:
+            emit_byte(ctx, 0x99);
+            break;
+        case AST_QuadWord_t:
+            emit_byte(ctx, 0x48);
+            emit_byte(ctx, 0x99);
+            break;
+        default:
+            THROW_ABORT;
+    }
+}
+
+// SetCC(cond_code, dst) -> $ 0f 90+cc /0
+static void set_cc_instr(Ctx ctx, const AsmSetCC* node) {
+    encode_instr(ctx, 0x00, false, true, 0x0f90u + get_cond_code(&node->cond_code), 0, node->dst, 0l, 0);
+}
+
+// Push(imm) -> $ 6a ib | 68 id
+// Push(reg) -> $ 50+reg
+// Push(mem) -> $ ff /6
+static void push_instr(Ctx ctx, const AsmPush* node) {
+    switch (node->src->type) {
+        case AST_AsmImm_t: {
+            TLong value = (TLong)node->src->get._AsmImm.value;
+            if (is_imm_1b(value)) {
+                emit_byte(ctx, 0x6a);
+                emit_imm(ctx, value, 1);
+            }
+            else {
+                THROW_ABORT_IF(!is_imm_4b(value));
+                emit_byte(ctx, 0x68);
+                emit_imm(ctx, value, 4);
+            }
+            break;
+        }
+        case AST_AsmRegister_t:
+            encode_reg_instr(ctx, false, false, 0x50, get_op_reg_num(node->src));
+            break;
+        default:
+            encode_instr(ctx, 0x00, false, false, 0xff, 6, node->src, 0l, 0);
+            break;
+    }
+}
+
+// Pop(reg) -> $ 58+reg
+static void pop_instr(Ctx ctx, const AsmPop* node) {
+    encode_reg_instr(ctx, false, false, 0x58, get_reg_num(&node->reg));
+}
+
+static void call_reloc(Ctx ctx, TIdentifier name) {
+    ElfReloc reloc = {vec_size(ctx->code), name, R_X86_64_PLT32, -4l};
+    vec_push_back(ctx->code_relocs, reloc);
+    ref_symbol(ctx, name);
+    emit_imm(ctx, 0l, 4);
+}
+
+static bool is_fun_def(Ctx ctx, TIdentifier name) {
+    const BackendSymbol* backend_fun_symbol = map_get(ctx->backend->symbol_table, name);
+    THROW_ABORT_IF(backend_fun_symbol->type != AST_BackendFun_t);
+    return backend_fun_symbol->get._BackendFun.is_def;
+}
+
+// Call(label) -> $ e8 rel32 + R_X86_64_PLT32
+static void call_instr(Ctx ctx, const AsmCall* node) {
+    emit_byte(ctx, 0xe8);
+    call_reloc(ctx, node->name);
+}
+
+// Jumps and labels split the function code into fragments, so that jumps can be sized once all labels are placed
+static void push_frag(Ctx ctx, ELF_FRAG_KIND kind, TIdentifier target, uint8_t cond_code) {
+    if (!vec_empty(ctx->frags) && vec_back(ctx->frags).kind == FRAG_Code) {
+        vec_back(ctx->frags).code_back = vec_size(ctx->code);
+        vec_back(ctx->frags).reloc_back = vec_size(ctx->code_relocs);
+    }
+    ElfFragment frag = {kind, false, cond_code, target, 0, vec_size(ctx->code), vec_size(ctx->code),
+        vec_size(ctx->code_relocs), vec_size(ctx->code_relocs)};
+    vec_push_back(ctx->frags, frag);
+}
+
+static void code_frag(Ctx ctx) {
+    if (vec_empty(ctx->frags) || vec_back(ctx->frags).kind != FRAG_Code) {
+        push_frag(ctx, FRAG_Code, 0, 0);
+    }
+}
+
+// -> if not omit_frame_ptr $ rex.w 89 /rbp, %rsp
+//    if not omit_frame_ptr $ 5d
+static void epilogue_instr(Ctx ctx) {
+    if (!ctx->is_omit_frame_ptr) {
+        emit_byte(ctx, 0x48);
+        emit_byte(ctx, 0x89);
+        emit_byte(ctx, 0xec);
+        emit_byte(ctx, 0x5d);
+    }
+}
+
+// TailCall(label) -> $ <epilogue>
+//                    if defined $ <jmp>
+//                    else       $ e9 rel32 + R_X86_64_PLT32
+static void tail_call_instr(Ctx ctx, const AsmTailCall* node) {
+    epilogue_instr(ctx);
+    if (is_fun_def(ctx, node->name)) {
+        push_frag(ctx, FRAG_Jmp, node->name, 0);
+    }
+    else {
+        emit_byte(ctx, 0xe9);
+        call_reloc(ctx, node->name);
+    }
+}
+
+// Ret -> $ <epilogue>
+//        $ c3
+static void ret_instr(Ctx ctx) {
+    epilogue_instr(ctx);
+    emit_byte(ctx, 0xc3);
+}
+
+// Mov(t, src, dst)                      -> $ <mov>
+// Movsx(src_t, dst_t, src, dst)         -> $ <movsx>
+// MovZeroExtend(src_t, dst_t, src, dst) -> $ <movzx>
+// Lea(src, dst)                         -> $ <lea>
+// Cvttsd2si(t, src, dst)                -> $ <cvttsd2si>
+// Cvtsi2sd(t, src, dst)                 -> $ <cvtsi2sd>
+// Unary(unary_operator, t, operand)     -> $ <unary>
+// Binary(binary_operator, t, src, dst)  -> $ <binary>
+// Cmp(t, operand, operand)              -> $ <cmp>
+// Test(t, operand, operand)             -> $ <test>
+// Idiv(t, operand)                      -> $ <idiv>
+// Div(t, operand)                       -> $ <div>
+// Cdq(t)                                -> $ <cdq>
+// Jmp(label)                            -> $ eb rel8 | e9 rel32
+// JmpCC(cond_code, label)               -> $ 70+cc rel8 | 0f 80+cc rel32
+// SetCC(cond_code, operand)             -> $ <setcc>
+// Label(label)                          -> if align_loops and loop head $ <nop padding to 16 bytes, at most 10>
+// Push(operand)                         -> $ <push>
+// Pop(reg)                              -> $ <pop>
+// Call(label)                           -> if defined $ e8 rel32
+//                                          else       $ <call>
+// TailCall(label)                       -> $ <tail-call>
+// Ret                                   -> $ <ret>
+static void emit_instr(Ctx ctx, const AsmInstruction* node) {
+    switch (node->type) {
+        case AST_AsmJmp_t:
+            push_frag(ctx, FRAG_Jmp, node->get._AsmJmp.target, 0);
+            return;
+        case AST_AsmJmpCC_t:
+            push_frag(ctx, FRAG_JmpCC, node->get._AsmJmpCC.target, get_cond_code(&node->get._AsmJmpCC.cond_code));
+            return;
+        case AST_AsmCall_t:
+            if (is_fun_def(ctx, node->get._AsmCall.name)) {
+                push_frag(ctx, FRAG_Call, node->get._AsmCall.name, 0);
+                return;
+            }
+            break;
+        case AST_AsmLabel_t: {
+            if (ctx->is_align_loops && set_find(ctx->loop_label_set, node->get._AsmLabel.name) != set_end()) {
+                push_frag(ctx, FRAG_Align, 0, 0);
+            }
+            push_frag(ctx, FRAG_Label, node->get._AsmLabel.name, 0);
+            return;
+        }
+        default:
+            break;
+    }
+    code_frag(ctx);
+    switch (node->type) {
+        case AST_AsmMov_t:
+            mov_instr(ctx, &node->get._AsmMov);
+            break;
+        case AST_AsmMovSx_t:
+            mov_sx_instr(ctx, &node->get._AsmMovSx);
+            break;
+        case AST_AsmMovZeroExtend_t:
+            zero_extend_instr(ctx, &node->get._AsmMovZeroExtend);
+            break;
+        case AST_AsmLea_t:
+            lea_instr(ctx, &node->get._AsmLea);
+            break;
+        case AST_AsmCvttsd2si_t:
+            cvttsd2si_instr(ctx, &node->get._AsmCvttsd2si);
+            break;
+        case AST_AsmCvtsi2sd_t:
+            cvtsi2sd_instr(ctx, &node->get._AsmCvtsi2sd);
+            break;
+        case AST_AsmUnary_t:
+            unary_instr(ctx, &node->get._AsmUnary);
+            break;
+        case AST_AsmBinary_t:
+            binary_instr(ctx, &node->get._AsmBinary);
+            break;
+        case AST_AsmMovPacked_t:
+            mov_packed_instr(ctx, &node->get._AsmMovPacked);
+            break;
+        case AST_AsmBinaryPacked_t:
+            binary_packed_instr(ctx, &node->get._AsmBinaryPacked);
+            break;
+        case AST_AsmCmp_t:
+            cmp_instr(ctx, &node->get._AsmCmp);
+            break;
+        case AST_AsmTest_t:
+            test_instr(ctx, &node->get._AsmTest);
+            break;
+        case AST_AsmIdiv_t:
+            idiv_instr(ctx, &node->get._AsmIdiv);
+            break;
+        case AST_AsmDiv_t:
+            div_instr(ctx, &node->get._AsmDiv);
+            break;
+        case AST_AsmCdq_t:
+            cdq_instr(ctx, &node->get._AsmCdq);
+            break;
+        case AST_AsmSetCC_t:
+            set_cc_instr(ctx, &node->get._AsmSetCC);
+            break;
+        case AST_AsmPush_t:
+            push_instr(ctx, &node->get._AsmPush);
+            break;
+        case AST_AsmPop_t:
+            pop_instr(ctx, &node->get._AsmPop);
+            break;
+        case AST_AsmCall_t:
+            call_instr(ctx, &node->get._AsmCall);
+            break;
+        case AST_AsmTailCall_t:
+            tail_call_instr(ctx, &node->get._AsmTailCall);
+            break;
+        case AST_AsmRet_t:
+            ret_instr(ctx);
+            break;
+        default:
+            THROW_ABORT;
+    }
+}
+
+// Loop heads are the labels targeted by a jump placed after them, which are aligned to a 16-byte boundary when that
+// takes at most 10 bytes of padding
+static void init_loop_labels(Ctx ctx, vector_t(unique_ptr_t(AsmInstruction)) node_list) {
+    set_clear(ctx->label_set);
+    set_clear(ctx->loop_label_set);
+    for (size_t i = node_list[0] ? 0 : 1; i < vec_size(node_list); ++i) {
+        TIdentifier target = 0;
+        switch (node_list[i]->type) {
+            case AST_AsmLabel_t:
+                set_insert(ctx->label_set, node_list[i]->get._AsmLabel.name);
+                continue;
+            case AST_AsmJmp_t:
+                target = node_list[i]->get._AsmJmp.target;
+                break;
+            case AST_AsmJmpCC_t:
+                target = node_list[i]->get._AsmJmpCC.target;
+                break;
+            default:
+                continue;
+        }
+        if (set_find(ctx->label_set, target) != set_end()) {
+            set_insert(ctx->loop_label_set, target);
+        }
+    }
+}
+
+static size_t get_align_pad(size_t addr) {
+    size_t pad = (16 - addr % 16) % 16;
+    return pad <= 10 ? pad : 0;
+}
+
+static size_t get_frag_size(const ElfFragment* frag) {
+    switch (frag->kind) {
+        case FRAG_Code:
+            return frag->code_back - frag->code_front;
+        case FRAG_Jmp:
+            return frag->is_near ? 5 : 2;
+        case FRAG_JmpCC:
+            return frag->is_near ? 6 : 2;
+        case FRAG_Call:
+            return 5;
+        case FRAG_Label:
+            return 0;
+        case FRAG_Align:
+            return get_align_pad(frag->addr);
+        default:
+            THROW_ABORT;
+    }
+}
+
+static size_t get_label_frag(Ctx ctx, TIdentifier label) {
+    ssize_t map_it = map_find(ctx->label_frag_map, label);
+    THROW_ABORT_IF(map_it == map_end());
+    return pair_second(ctx->label_frag_map[map_it]);
+}
+
+static TLong get_jmp_disp(Ctx ctx, const ElfFragment* frag) {
+    return (TLong)ctx->frags[get_label_frag(ctx, frag->target)].addr - (TLong)(frag->addr + get_frag_size(frag));
+}
+
+// A forward target is not laid out yet in this pass, so it is moved by the growth of the pass so far, except for the
+// part of it that the alignment padding in between absorbs, which is how as estimates it
+static TLong get_relax_disp(Ctx ctx, size_t i, TLong stretch) {
+    size_t label_i = get_label_frag(ctx, ctx->frags[i].target);
+    TLong disp = get_jmp_disp(ctx, &ctx->frags[i]);
+    if (label_i > i) {
+        for (size_t j = i + 1; j < label_i && stretch > 0l; ++j) {
+            if (ctx->frags[j].kind == FRAG_Align) {
+                stretch &= ~15l;
+            }
+        }
+        disp += stretch;
+    }
+    return disp;
+}
+
+// Jumps start short and are grown to near jumps until every displacement fits, which always terminates as jumps
+// never shrink back. Each pass lays out the fragments in order, so that a jump already sees the growth of the jumps
+// before it in the pass, like as does
+static void relax_frags(Ctx ctx) {
+    size_t addr = 0;
+    for (size_t i = 0; i < vec_size(ctx->frags); ++i) {
+        ctx->frags[i].addr = addr;
+        if (ctx->frags[i].kind == FRAG_Label) {
+            map_add(ctx->label_frag_map, ctx->frags[i].target, i);
+        }
+        addr += get_frag_size(&ctx->frags[i]);
+    }
+    bool is_fixed_point = false;
+    while (!is_fixed_point) {
+        is_fixed_point = true;
+        addr = 0;
+        for (size_t i = 0; i < vec_size(ctx->frags); ++i) {
+            TLong stretch = (TLong)addr - (TLong)ctx->frags[i].addr;
+            ctx->frags[i].addr = addr;
+            if ((ctx->frags[i].kind == FRAG_Jmp || ctx->frags[i].kind == FRAG_JmpCC) && !ctx->frags[i].is_near
+                && !is_imm_1b(get_relax_disp(ctx, i, stretch))) {
+                ctx->frags[i].is_near = true;
+                is_fixed_point = false;
+            }
+            addr += get_frag_size(&ctx->frags[i]);
+        }
+    }
+}
+
+static void emit_nops(vector_t(uint8_t) * p_bytes, size_t size) {
+    static const uint8_t NOPS[11][10] = {{0}, {0x90}, {0x66, 0x90}, {0x0f, 0x1f, 0x00}, {0x0f, 0x1f, 0x40, 0x00},
+        {0x0f, 0x1f, 0x44, 0x00, 0x00}, {0x66, 0x0f, 0x1f, 0x44, 0x00, 0x00},
+        {0x0f, 0x1f, 0x80, 0x00, 0x00, 0x00, 0x00}, {0x0f, 0x1f, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00},
+        {0x66, 0x0f, 0x1f, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00},
+        {0x66, 0x2e, 0x0f, 0x1f, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00}};
+    THROW_ABORT_IF(size > 10);
+    for (size_t i = 0; i < size; ++i) {
+        vec_push_back(*p_bytes, NOPS[size][i]);
+    }
+}
+
+static void emit_frags(Ctx ctx) {
+    ElfSection* text = &ctx->sections[ELF_SECTION_TEXT];
+    for (size_t i = 0; i < vec_size(ctx->frags); ++i) {
+        const ElfFragment* frag = &ctx->frags[i];
+        THROW_ABORT_IF(vec_size(text->bytes) != frag->addr);
+        switch (frag->kind) {
+            case FRAG_Code: {
+                for (size_t reloc_idx = frag->reloc_front; reloc_idx < frag->reloc_back; ++reloc_idx) {
+                    ElfReloc reloc = ctx->code_relocs[reloc_idx];
+                    reloc.offset = reloc.offset - frag->code_front + frag->addr;
+                    vec_push_back(text->relocs, reloc);
+                }
+                for (size_t code_idx = frag->code_front; code_idx < frag->code_back; ++code_idx) {
+                    vec_push_back(text->bytes, ctx->code[code_idx]);
+                }
+                break;
+            }
+            case FRAG_Jmp: {
+                TLong disp = get_jmp_disp(ctx, frag);
+                vec_push_back(text->bytes, frag->is_near ? 0xe9 : 0xeb);
+                push_bytes(&text->bytes, (TULong)disp, frag->is_near ? 4 : 1);
+                break;
+            }
+            case FRAG_JmpCC: {
+                TLong disp = get_jmp_disp(ctx, frag);
+                if (frag->is_near) {
+                    vec_push_back(text->bytes, 0x0f);
+                    vec_push_back(text->bytes, 0x80 | frag->cond_code);
+                }
+                else {
+                    vec_push_back(text->bytes, 0x70 | frag->cond_code);
+                }
+                push_bytes(&text->bytes, (TULong)disp, frag->is_near ? 4 : 1);
+                break;
+            }
+            case FRAG_Call: {
+                vec_push_back(text->bytes, 0xe8);
+                if (map_get(ctx->symbol_map, frag->target).is_glob) {
+                    ElfReloc reloc = {frag->addr + 1, frag->target, R_X86_64_PLT32, -4l};
+                    vec_push_back(text->relocs, reloc);
+                    push_bytes(&text->bytes, 0ul, 4);
+                }
+                else {
+                    push_bytes(&text->bytes, (TULong)get_jmp_disp(ctx, frag), 4);
+                }
+                break;
+            }
+            case FRAG_Label:
+                break;
+            case FRAG_Align:
+                emit_nops(&text->bytes, get_frag_size(frag));
+                break;
+            default:
+                THROW_ABORT;
+        }
+    }
+}
+
+// Function(name, global, return_memory, instructions) -> $ <name>:
+//                                 if not omit_frame_ptr  $     55
+//                                 if not omit_frame_ptr  $     rex.w 89 /rsp, %rbp
+//                                                        $     <instructions>
+static void emit_fun_toplvl(Ctx ctx, const AsmFunction* node) {
+    ElfFunction fun = {node->name, node->is_glob, vec_size(ctx->frags), 0};
+    push_frag(ctx, FRAG_Label, node->name, 0);
+    code_frag(ctx);
+    if (!ctx->is_omit_frame_ptr) {
+        emit_byte(ctx, 0x55);
+        emit_byte(ctx, 0x48);
+        emit_byte(ctx, 0x89);
+        emit_byte(ctx, 0xe5);
+    }
+    if (ctx->is_align_loops) {
+        init_loop_labels(ctx, node->instructions);
+    }
+    for (size_t i = node->instructions[0] ? 0 : 1; i < vec_size(node->instructions); ++i) {
+        emit_instr(ctx, node->instructions[i]);
+    }
+    fun.frag_back = vec_size(ctx->frags);
+    push_frag(ctx, FRAG_Label, 0, 0);
+    vec_push_back(ctx->funs, fun);
+}
+
+// Functions are laid out together once all of them are encoded, so that calls to local functions and tail calls to
+// defined functions are resolved in the text section as as does, without relocations
+static void emit_text(Ctx ctx) {
+    relax_frags(ctx);
+    for (size_t i = 0; i < vec_size(ctx->funs); ++i) {
+        const ElfFunction* fun = &ctx->funs[i];
+        size_t value = ctx->frags[fun->frag_front].addr;
+        def_fun_symbol(ctx, fun->name, value, ctx->frags[fun->frag_back].addr - value, fun->is_glob);
+    }
+    emit_frags(ctx);
+}
+
+// CharInit(i)                         -> $ <1 byte i>
+// IntInit(i)                          -> $ <4 bytes i>
+// LongInit(i)                         -> $ <8 bytes i>
+// DoubleInit(d)                       -> $ <8 bytes d>
+// UCharInit(i)                        -> $ <1 byte i>
+// UIntInit(i)                         -> $ <4 bytes i>
+// ULongInit(i)                        -> $ <8 bytes i>
+// ZeroInit(n)                         -> $ <n zero bytes>
+// StringInit(s, b) if null terminated -> $ <s> 00
+//                                else -> $ <s>
+// PointerInit(label)                  -> $ <8 zero bytes> + R_X86_64_64
+static void static_init_toplvl(Ctx ctx, size_t section, const StaticInit* node) {
+    ElfSection* data = &ctx->sections[section];
+    if (section == ELF_SECTION_BSS) {
+        THROW_ABORT_IF(node->type != AST_ZeroInit_t);
+        data->bss_size += (size_t)node->get._ZeroInit.byte;
+        return;
+    }
+    switch (node->type) {
+        case AST_CharInit_t:
+            push_bytes(&data->bytes, (TULong)node->get._CharInit.value, 1);
+            break;
+        case AST_IntInit_t:
+            push_bytes(&data->bytes, (TULong)node->get._IntInit.value, 4);
+            break;
+        case AST_LongInit_t:
+            push_bytes(&data->bytes, (TULong)node->get._LongInit.value, 8);
+            break;
+        case AST_DoubleInit_t: {
+            const char* value = map_get(ctx->identifiers->hash_table, node->get._DoubleInit.dbl_const);
+            push_bytes(&data->bytes, (TULong)strtoull(value, NULL, 10), 8);
+            break;
+        }
+        case AST_UCharInit_t:
+            push_bytes(&data->bytes, (TULong)node->get._UCharInit.value, 1);
+            break;
+        case AST_UIntInit_t:
+            push_bytes(&data->bytes, (TULong)node->get._UIntInit.value, 4);
+            break;
+        case AST_ULongInit_t:
+            push_bytes(&data->bytes, node->get._ULongInit.value, 8);
+            break;
+        case AST_ZeroInit_t: {
+            for (TLong i = 0; i < node->get._ZeroInit.byte; ++i) {
+                vec_push_back(data->bytes, 0);
+            }
+            break;
+        }
+        case AST_StringInit_t: {
+            const CStringLiteral* literal = node->get._StringInit.literal;
+            for (size_t i = 0; i < vec_size(literal->value); ++i) {
+                vec_push_back(data->bytes, (uint8_t)literal->value[i]);
+            }
+            if (node->get._StringInit.is_null_term) {
+                vec_push_back(data->bytes, 0);
+            }
+            break;
+        }
+        case AST_PointerInit_t: {
+            ElfReloc reloc = {vec_size(data->bytes), node->get._PointerInit.name, R_X86_64_64, 0l};
+            vec_push_back(data->relocs, reloc);
+            ref_symbol(ctx, node->get._PointerInit.name);
+            push_bytes(&data->bytes, 0ul, 8);
+            break;
+        }
+        default:
+            THROW_ABORT;
+    }
+}
+
+// StaticVariable(name, global, init*) -> $ <data-section or bss-section>
+//                                        $ <alignment>
+//                                        $ <name>:
+//                                        $     <init_list>
+static void emit_static_var_toplvl(Ctx ctx, const AsmStaticVariable* node) {
+    size_t section = ELF_SECTION_DATA;
+    if (vec_size(node->static_inits) == 1 && node->static_inits[0]->type == AST_ZeroInit_t) {
+        section = ELF_SECTION_BSS;
+    }
+    align_section(ctx, section, node->alignment);
+    size_t value = get_section_size(ctx, section);
+    for (size_t i = 0; i < vec_size(node->static_inits); ++i) {
+        static_init_toplvl(ctx, section, node->static_inits[i]);
+    }
+    def_symbol(ctx, node->name, section, value, node->is_glob, false);
+}
+
+// StaticConstant(name, align, init) -> $ <rodata-section>
+//                                      $ <alignment>
+//                                      $ .L<name>:
+//                                      $     <init>
+static void emit_static_const_toplvl(Ctx ctx, const AsmStaticConstant* node) {
+    align_section(ctx, ELF_SECTION_RODATA, node->alignment);
+    size_t value = get_section_size(ctx, ELF_SECTION_RODATA);
+    static_init_toplvl(ctx, ELF_SECTION_RODATA, node->static_init);
+    def_label_symbol(ctx, node->name, ELF_SECTION_RODATA, value);
+}
+
+static void emit_toplvl(Ctx ctx, const AsmTopLevel* node) {
+    switch (node->type) {
+        case AST_AsmFunction_t:
+            emit_fun_toplvl(ctx, &node->get._AsmFunction);
+            break;
+        case AST_AsmStaticVariable_t:
+            emit_static_var_toplvl(ctx, &node->get._AsmStaticVariable);
+            break;
+        case AST_AsmStaticConstant_t:
+            emit_static_const_toplvl(ctx, &node->get._AsmStaticConstant);
+            break;
+        default:
+            THROW_ABORT;
+    }
+}
+
+// Elf64_Sym: name, info, other, section, value, size
+static void push_elf_sym(
+    vector_t(uint8_t) * p_bytes, size_t name, uint8_t info, size_t section, size_t value, size_t size) {
+    push_bytes(p_bytes, (TULong)name, 4);
+    push_bytes(p_bytes, (TULong)info, 1);
+    push_bytes(p_bytes, 0ul, 1);
+    push_bytes(p_bytes, (TULong)section, 2);
+    push_bytes(p_bytes, (TULong)value, 8);
+    push_bytes(p_bytes, (TULong)size, 8);
+}
+
+// The symbol table starts with the section symbols and the local symbols, followed by the global and undefined
+// symbols. Constants are not in the symbol table, and they are relocated from their section symbol as local symbols are
+static size_t init_symtab(Ctx ctx, vector_t(uint8_t) * p_symtab, vector_t(uint8_t) * p_strtab) {
+    size_t symbol_idx = 0;
+    vec_push_back(*p_strtab, 0);
+    push_elf_sym(p_symtab, 0, 0, 0, 0, 0);
+    for (size_t section = ELF_SECTION_TEXT; section <= ELF_SECTION_RODATA; ++section) {
+        push_elf_sym(p_symtab, 0, 0x03, section, 0, 0);
+    }
+    symbol_idx = ELF_SECTION_RODATA + 1;
+    size_t first_glob_idx = 0;
+    for (size_t i = 0; i < 2; ++i) {
+        bool is_glob = i > 0;
+        if (is_glob) {
+            first_glob_idx = symbol_idx;
+        }
+        for (size_t map_idx = 0; map_idx < map_size(ctx->symbol_map); ++map_idx) {
+            TIdentifier name = pair_first(ctx->symbol_map[map_idx]);
+            const ElfSymbol* symbol = &pair_second(ctx->symbol_map[map_idx]);
+            if (symbol->is_label || symbol->is_glob != is_glob) {
+                continue;
+            }
+            uint8_t info = (is_glob ? 0x10 : 0x00) | (symbol->section == 0 ? 0x00 : symbol->is_fun ? 0x02 : 0x01);
+            push_elf_sym(p_symtab, vec_size(*p_strtab), info, symbol->section, symbol->value, symbol->size);
+            const char* value = map_get(ctx->identifiers->hash_table, name);
+            for (; *value; ++value) {
+                vec_push_back(*p_strtab, (uint8_t)*value);
+            }
+            vec_push_back(*p_strtab, 0);
+            map_add(ctx->symbol_idx_map, name, symbol_idx);
+            symbol_idx++;
+        }
+    }
+    return first_glob_idx;
+}
+
+// Elf64_Rela: offset, info (symbol, type), addend
+static void init_rela(Ctx ctx, size_t section, vector_t(uint8_t) * p_rela) {
+    for (size_t i = 0; i < vec_size(ctx->sections[section].relocs); ++i) {
+        const ElfReloc* reloc = &ctx->sections[section].relocs[i];
+        const ElfSymbol* symbol = &map_get(ctx->symbol_map, reloc->name);
+        size_t symbol_idx = 0;
+        TLong addend = reloc->addend;
+        if (symbol->is_label || (!symbol->is_glob && symbol->section != 0)) {
+            symbol_idx = symbol->section;
+            addend += (TLong)symbol->value;
+        }
+        else {
+            symbol_idx = map_get(ctx->symbol_idx_map, reloc->name);
+        }
+        push_bytes(p_rela, (TULong)reloc->offset, 8);
+        push_bytes(p_rela, ((TULong)symbol_idx << 32) | reloc->type, 8);
+        push_bytes(p_rela, (TULong)addend, 8);
+    }
+}
+
+// Elf64_Shdr: name, type, flags, address, offset, size, link, info, alignment, entry size
+static void push_elf_shdr(Ctx ctx, size_t name, uint32_t type, TULong flags, size_t offset, size_t size,
+    size_t link, size_t info, size_t alignment, size_t entsize) {
+    push_bytes(&ctx->elf, (TULong)name, 4);
+    push_bytes(&ctx->elf, (TULong)type, 4);
+    push_bytes(&ctx->elf, flags, 8);
+    push_bytes(&ctx->elf, 0ul, 8);
+    push_bytes(&ctx->elf, (TULong)offset, 8);
+    push_bytes(&ctx->elf, (TULong)size, 8);
+    push_bytes(&ctx->elf, (TULong)link, 4);
+    push_bytes(&ctx->elf, (TULong)info, 4);
+    push_bytes(&ctx->elf, (TULong)alignment, 8);
+    push_bytes(&ctx->elf, (TULong)entsize, 8);
+}
+
+// Relocatable object: $ <elf-header>
+//                     $ [<section>]
+//                     $ [<section-header>]
+static void emit_elf_object(Ctx ctx) {
+    static const char* SECTION_NAMES[ELF_SECTIONS_SIZE] = {"", ".text", ".data", ".bss", ".rodata", ".rela.text",
+        ".rela.data", ".symtab", ".strtab", ".shstrtab", ".note.GNU-stack"};
+    // type, flags, link, info, entry size
+    static const TULong SECTION_ATTRS[ELF_SECTIONS_SIZE][5] = {{0, 0, 0, 0, 0}, {1, 0x6, 0, 0, 0}, {1, 0x3, 0, 0, 0},
+        {8, 0x3, 0, 0, 0}, {1, 0x2, 0, 0, 0}, {4, 0x40, ELF_SECTION_SYMTAB, ELF_SECTION_TEXT, ELF_RELA_SIZE},
+        {4, 0x40, ELF_SECTION_SYMTAB, ELF_SECTION_DATA, ELF_RELA_SIZE},
+        {2, 0, ELF_SECTION_STRTAB, 0, ELF_SYM_SIZE}, {3, 0, 0, 0, 0}, {3, 0, 0, 0, 0}, {1, 0, 0, 0, 0}};
+    vector_t(uint8_t) section_bytes[ELF_SECTIONS_SIZE];
+    size_t offsets[ELF_SECTIONS_SIZE];
+    size_t sizes[ELF_SECTIONS_SIZE];
+    size_t alignments[ELF_SECTIONS_SIZE];
+    size_t names[ELF_SECTIONS_SIZE];
+    for (size_t section = 0; section < ELF_SECTIONS_SIZE; ++section) {
+        section_bytes[section] = vec_new();
+        alignments[section] = 1;
+    }
+    for (size_t section = ELF_SECTION_TEXT; section <= ELF_SECTION_RODATA; ++section) {
+        alignments[section] = ctx->sections[section].alignment;
+    }
+    alignments[ELF_SECTION_RELA_TEXT] = 8;
+    alignments[ELF_SECTION_RELA_DATA] = 8;
+    alignments[ELF_SECTION_SYMTAB] = 8;
+
+    size_t first_glob_idx =
+        init_symtab(ctx, &section_bytes[ELF_SECTION_SYMTAB], &section_bytes[ELF_SECTION_STRTAB]);
+    init_rela(ctx, ELF_SECTION_TEXT, &section_bytes[ELF_SECTION_RELA_TEXT]);
+    init_rela(ctx, ELF_SECTION_DATA, &section_bytes[ELF_SECTION_RELA_DATA]);
+    for (size_t section = 0; section < ELF_SECTIONS_SIZE; ++section) {
+        names[section] = vec_size(section_bytes[ELF_SECTION_SHSTRTAB]);
+        for (const char* name = SECTION_NAMES[section]; *name; ++name) {
+            vec_push_back(section_bytes[ELF_SECTION_SHSTRTAB], (uint8_t)*name);
+        }
+        vec_push_back(section_bytes[ELF_SECTION_SHSTRTAB], 0);
+    }
+
+    vec_clear(ctx->elf);
+    push_bytes(&ctx->elf, 0ul, ELF_EHDR_SIZE);
+    offsets[0] = 0;
+    sizes[0] = 0;
+    for (size_t section = ELF_SECTION_TEXT; section < ELF_SECTIONS_SIZE; ++section) {
+        vector_t(uint8_t) bytes = section_bytes[section];
+        if (section <= ELF_SECTION_RODATA) {
+            bytes = ctx->sections[section].bytes;
+        }
+        align_bytes(&ctx->elf, alignments[section]);
+        offsets[section] = vec_size(ctx->elf);
+        sizes[section] = vec_size(bytes);
+        if (section == ELF_SECTION_BSS) {
+            sizes[section] = ctx->sections[section].bss_size;
+        }
+        for (size_t i = 0; i < vec_size(bytes); ++i) {
+            vec_push_back(ctx->elf, bytes[i]);
+        }
+    }
+    align_bytes(&ctx->elf, 8);
+    size_t shdr_offset = vec_size(ctx->elf);
+    for (size_t section = 0; section < ELF_SECTIONS_SIZE; ++section) {
+        size_t info = section == ELF_SECTION_SYMTAB ? first_glob_idx : (size_t)SECTION_ATTRS[section][3];
+        push_elf_shdr(ctx, names[section], (uint32_t)SECTION_ATTRS[section][0], SECTION_ATTRS[section][1],
+            offsets[section], sizes[section], (size_t)SECTION_ATTRS[section][2], info,
+            section == 0 ? 0 : alignments[section], (size_t)SECTION_ATTRS[section][4]);
+    }
+
+    // e_ident: magic, 64-bit, little endian, version 1, System V
+    set_bytes(ctx->elf, 0, 0x010102464c457ful, 8);
+    // e_type: relocatable, e_machine: x86-64, e_version: 1
+    set_bytes(ctx->elf, 16, 1ul, 2);
+    set_bytes(ctx->elf, 18, 62ul, 2);
+    set_bytes(ctx->elf, 20, 1ul, 4);
+    set_bytes(ctx->elf, 40, (TULong)shdr_offset, 8);
+    set_bytes(ctx->elf, 52, ELF_EHDR_SIZE, 2);
+    set_bytes(ctx->elf, 58, ELF_SHDR_SIZE, 2);
+    set_bytes(ctx->elf, 60, ELF_SECTIONS_SIZE, 2);
+    set_bytes(ctx->elf, 62, ELF_SECTION_SHSTRTAB, 2);
+
+    for (size_t section = 0; section < ELF_SECTIONS_SIZE; ++section) {
+        vec_delete(section_bytes[section]);
+    }
+}
+
+// Program(top_level*) -> $ <relocatable-object>
+static void emit_program(Ctx ctx, const AsmProgram* node) {
+    for (size_t i = 0; i < vec_size(node->static_const_toplvls); ++i) {
+        emit_toplvl(ctx, node->static_const_toplvls[i]);
+    }
+    for (size_t i = 0; i < vec_size(node->top_levels); ++i) {
+        emit_toplvl(ctx, node->top_levels[i]);
+    }
+    emit_text(ctx);
+    emit_elf_object(ctx);
+    write_bytes(ctx->fileio, ctx->elf, vec_size(ctx->elf));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void emit_elf_code(unique_ptr_t(AsmProgram) * asm_ast, BackEndContext* backend, FileIoContext* fileio,
+    IdentifierContext* identifiers, bool is_omit_frame_ptr, bool is_align_loops) {
+    ElfCodeContext ctx;
+    {
+        ctx.backend = backend;
+        ctx.fileio = fileio;
+        ctx.identifiers = identifiers;
+        ctx.is_omit_frame_ptr = is_omit_frame_ptr;
+        ctx.is_align_loops = is_align_loops;
+        for (size_t section = 0; section <= ELF_SECTION_RODATA; ++section) {
+            ctx.sections[section].bss_size = 0;
+            ctx.sections[section].alignment = 1;
+            ctx.sections[section].bytes = vec_new();
+            ctx.sections[section].relocs = vec_new();
+        }
+        ctx.sections[ELF_SECTION_TEXT].alignment = 16;
+        ctx.code = vec_new();
+        ctx.code_relocs = vec_new();
+        ctx.frags = vec_new();
+        ctx.funs = vec_new();
+        ctx.label_frag_map = map_new();
+        ctx.symbol_map = map_new();
+        ctx.symbol_idx_map = map_new();
+        ctx.label_set = set_new();
+        ctx.loop_label_set = set_new();
+        ctx.elf = vec_new();
+    }
+    emit_program(&ctx, *asm_ast);
+    free_AsmProgram(asm_ast);
+
+    for (size_t section = 0; section <= ELF_SECTION_RODATA; ++section) {
+        vec_delete(ctx.sections[section].bytes);
+        vec_delete(ctx.sections[section].relocs);
+    }
+    vec_delete(ctx.code);
+    vec_delete(ctx.code_relocs);
+    vec_delete(ctx.frags);
+    vec_delete(ctx.funs);
+    map_delete(ctx.label_frag_map);
+    map_delete(ctx.symbol_map);
+    map_delete(ctx.symbol_idx_map);
+    set_delete(ctx.label_set);
+    set_delete(ctx.loop_label_set);
+    vec_delete(ctx.elf);
+}
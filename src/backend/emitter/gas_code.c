@@ -1,3 +1,5 @@
+#include <string.h>
+
 #include "util/c_std.h"
 #include "util/fileio.h"
 #include "util/throw.h"
@@ -13,6 +15,14 @@ typedef struct GasCodeContext {
     FileIoContext* fileio;
     IdentifierContext* identifiers;
     // Gnu assembler code emission
+    bool is_omit_frame_ptr;
+    bool is_profile_generate;
+    bool is_align_loops;
+    TIdentifier fun_name;
+    vector_t(TIdentifier) profile_funs;
+    vector_t(TIdentifier) profile_labels;
+    hashset_t(TIdentifier) label_set;
+    hashset_t(TIdentifier) loop_label_set;
 } GasCodeContext;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -169,6 +179,7 @@ static const char* get_reg_rsp_sse(const AsmReg* node) {
 // Reg(R13) -> $ %r13b
 // Reg(R14) -> $ %r14b
 // Reg(R15) -> $ %r15b
+// Reg(BP)  -> $ %bpl
 static const char* get_reg_1b(const AsmReg* node) {
     switch (node->type) {
         case AST_AsmAx_t:
@@ -199,6 +210,8 @@ static const char* get_reg_1b(const AsmReg* node) {
             return "%r14b";
         case AST_AsmR15_t:
             return "%r15b";
+        case AST_AsmBp_t:
+            return "%bpl";
         default:
             return get_reg_rsp_sse(node);
     }
@@ -218,6 +231,7 @@ static const char* get_reg_1b(const AsmReg* node) {
 // Reg(R13) -> $ %r13d
 // Reg(R14) -> $ %r14d
 // Reg(R15) -> $ %r15d
+// Reg(BP)  -> $ %ebp
 static const char* get_reg_4b(const AsmReg* node) {
     switch (node->type) {
         case AST_AsmAx_t:
@@ -248,6 +262,8 @@ static const char* get_reg_4b(const AsmReg* node) {
             return "%r14d";
         case AST_AsmR15_t:
             return "%r15d";
+        case AST_AsmBp_t:
+            return "%ebp";
         default:
             return get_reg_rsp_sse(node);
     }
@@ -525,6 +541,58 @@ static const char* get_binop(const AsmBinaryOp* node, bool is_dbl) {
     }
 }
 
+// Add<d>        -> $ addpd
+// Add<l>        -> $ paddd
+// Add<q>        -> $ paddq
+// Sub<d>        -> $ subpd
+// Sub<l>        -> $ psubd
+// Sub<q>        -> $ psubq
+// Mult<d>       -> $ mulpd
+// DivDouble<d>  -> $ divpd
+// BitAnd        -> $ pand
+// BitOr         -> $ por
+// BitXor        -> $ pxor
+static const char* get_packed_binop(const AsmBinaryOp* node, const AssemblyType* asm_type) {
+    switch (node->type) {
+        case AST_AsmAdd_t:
+            switch (asm_type->type) {
+                case AST_BackendDouble_t:
+                    return "addpd";
+                case AST_LongWord_t:
+                    return "paddd";
+                case AST_QuadWord_t:
+                    return "paddq";
+                default:
+                    THROW_ABORT;
+            }
+        case AST_AsmSub_t:
+            switch (asm_type->type) {
+                case AST_BackendDouble_t:
+                    return "subpd";
+                case AST_LongWord_t:
+                    return "psubd";
+                case AST_QuadWord_t:
+                    return "psubq";
+                default:
+                    THROW_ABORT;
+            }
+        case AST_AsmMult_t:
+            THROW_ABORT_IF(asm_type->type != AST_BackendDouble_t);
+            return "mulpd";
+        case AST_AsmDivDouble_t:
+            THROW_ABORT_IF(asm_type->type != AST_BackendDouble_t);
+            return "divpd";
+        case AST_AsmBitAnd_t:
+            return "pand";
+        case AST_AsmBitOr_t:
+            return "por";
+        case AST_AsmBitXor_t:
+            return "pxor";
+        default:
+            THROW_ABORT;
+    }
+}
+
 static void mov_instr(Ctx ctx, const AsmMov* node) {
     emit(ctx, TAB TAB "mov");
     emit(ctx, get_type_suffix(node->asm_type, false));
@@ -641,6 +709,29 @@ static void binary_instr(Ctx ctx, const AsmBinary* node) {
     emit(ctx, LF);
 }
 
+static void mov_packed_instr(Ctx ctx, const AsmMovPacked* node) {
+    if (node->asm_type->type == AST_BackendDouble_t) {
+        emit(ctx, TAB TAB "movupd ");
+    }
+    else {
+        emit(ctx, TAB TAB "movdqu ");
+    }
+    emit_op(ctx, node->src, 8);
+    emit(ctx, ", ");
+    emit_op(ctx, node->dst, 8);
+    emit(ctx, LF);
+}
+
+static void binary_packed_instr(Ctx ctx, const AsmBinaryPacked* node) {
+    emit(ctx, TAB TAB);
+    emit(ctx, get_packed_binop(&node->binop, node->asm_type));
+    emit(ctx, " ");
+    emit_op(ctx, node->src, 8);
+    emit(ctx, ", ");
+    emit_op(ctx, node->dst, 8);
+    emit(ctx, LF);
+}
+
 static void cmp_instr(Ctx ctx, const AsmCmp* node) {
     if (node->asm_type->type == AST_BackendDouble_t) {
         emit(ctx, TAB TAB "comi");
@@ -659,6 +750,19 @@ static void cmp_instr(Ctx ctx, const AsmCmp* node) {
     emit(ctx, LF);
 }
 
+static void test_instr(Ctx ctx, const AsmTest* node) {
+    emit(ctx, TAB TAB "test");
+    emit(ctx, get_type_suffix(node->asm_type, false));
+    emit(ctx, " ");
+    {
+        TInt byte = type_align_bytes(node->asm_type);
+        emit_op(ctx, node->src, byte);
+        emit(ctx, ", ");
+        emit_op(ctx, node->dst, byte);
+    }
+    emit(ctx, LF);
+}
+
 static void idiv_instr(Ctx ctx, const AsmIdiv* node) {
     emit(ctx, TAB TAB "idiv");
     emit(ctx, get_type_suffix(node->asm_type, false));
@@ -717,6 +821,9 @@ static void set_cc_instr(Ctx ctx, const AsmSetCC* node) {
 }
 
 static void label_instr(Ctx ctx, const AsmLabel* node) {
+    if (ctx->is_align_loops && set_find(ctx->loop_label_set, node->name) != set_end()) {
+        emit(ctx, TAB ".p2align 4,,10" LF);
+    }
     emit(ctx, TAB LBL);
     emit_identifier(ctx, node->name);
     emit(ctx, ":" LF);
@@ -747,7 +854,28 @@ static void call_instr(Ctx ctx, const AsmCall* node) {
     emit(ctx, LF);
 }
 
-static void ret_instr(Ctx ctx) { emit(ctx, TAB "movq %rbp, %rsp" LF TAB "popq %rbp" LF TAB "ret" LF); }
+static void tail_call_instr(Ctx ctx, const AsmTailCall* node) {
+    if (!ctx->is_omit_frame_ptr) {
+        emit(ctx, TAB "movq %rbp, %rsp" LF TAB "popq %rbp" LF);
+    }
+    emit(ctx, TAB TAB "jmp ");
+    emit_identifier(ctx, node->name);
+#ifndef __APPLE__
+    const BackendSymbol* backend_fun_symbol = map_get(ctx->backend->symbol_table, node->name);
+    THROW_ABORT_IF(backend_fun_symbol->type != AST_BackendFun_t);
+    if (!backend_fun_symbol->get._BackendFun.is_def) {
+        emit(ctx, "@PLT");
+    }
+#endif
+    emit(ctx, LF);
+}
+
+static void ret_instr(Ctx ctx) {
+    if (!ctx->is_omit_frame_ptr) {
+        emit(ctx, TAB "movq %rbp, %rsp" LF TAB "popq %rbp" LF);
+    }
+    emit(ctx, TAB "ret" LF);
+}
 
 // Mov(t, src, dst)                      -> $ mov<t> <src>, <dst>
 // Movsx(src_t, dst_t, src, dst)         -> $ movs<src_t><dst_t> <src>, <dst>
@@ -759,6 +887,7 @@ static void ret_instr(Ctx ctx) { emit(ctx, TAB "movq %rbp, %rsp" LF TAB "popq %r
 // Binary(binary_operator, t, src, dst)  -> $ <binary_operator><t> <src>, <dst>
 // Cmp(t, operand, operand)<i>           -> $ cmp<t> <operand>, <operand>
 // Cmp(operand, operand)<d>              -> $ comisd <operand>, <operand>
+// Test(t, operand, operand)             -> $ test<t> <operand>, <operand>
 // Idiv(t, operand)                      -> $ idiv<t> <operand>
 // Div(t, operand)                       -> $ div<t> <operand>
 // Cdq<l>                                -> $ cdq
@@ -766,13 +895,17 @@ static void ret_instr(Ctx ctx) { emit(ctx, TAB "movq %rbp, %rsp" LF TAB "popq %r
 // Jmp(label)                            -> $ jmp .L<label>
 // JmpCC(cond_code, label)               -> $ j<cond_code> .L<label>
 // SetCC(cond_code, operand)             -> $ set<cond_code> <operand>
-// Label(label)                          -> $ .L<label>:
+// Label(label)                          -> if align_loops and loop head $ .p2align 4,,10
+//                                                                        $ .L<label>:
 // Push(operand)                         -> $ pushq <operand>
 // Pop(reg)                              -> $ popq <reg>
 // Call(label)                           -> $ call <label>@PLT
-// Ret                                   -> $ movq %rbp, %rsp
-//                                          $ popq %rbp
-//                                          $ ret
+// TailCall(label)                       -> if not omit_frame_ptr $ movq %rbp, %rsp
+//                                          if not omit_frame_ptr $ popq %rbp
+//                                                                $ jmp <label>@PLT
+// Ret                                   -> if not omit_frame_ptr $ movq %rbp, %rsp
+//                                          if not omit_frame_ptr $ popq %rbp
+//                                                                $ ret
 static void emit_instr(Ctx ctx, const AsmInstruction* node) {
     switch (node->type) {
         case AST_AsmMov_t:
@@ -799,9 +932,18 @@ static void emit_instr(Ctx ctx, const AsmInstruction* node) {
         case AST_AsmBinary_t:
             binary_instr(ctx, &node->get._AsmBinary);
             break;
+        case AST_AsmMovPacked_t:
+            mov_packed_instr(ctx, &node->get._AsmMovPacked);
+            break;
+        case AST_AsmBinaryPacked_t:
+            binary_packed_instr(ctx, &node->get._AsmBinaryPacked);
+            break;
         case AST_AsmCmp_t:
             cmp_instr(ctx, &node->get._AsmCmp);
             break;
+        case AST_AsmTest_t:
+            test_instr(ctx, &node->get._AsmTest);
+            break;
         case AST_AsmIdiv_t:
             idiv_instr(ctx, &node->get._AsmIdiv);
             break;
@@ -832,6 +974,9 @@ static void emit_instr(Ctx ctx, const AsmInstruction* node) {
         case AST_AsmCall_t:
             call_instr(ctx, &node->get._AsmCall);
             break;
+        case AST_AsmTailCall_t:
+            tail_call_instr(ctx, &node->get._AsmTailCall);
+            break;
         case AST_AsmRet_t:
             ret_instr(ctx);
             break;
@@ -840,9 +985,92 @@ static void emit_instr(Ctx ctx, const AsmInstruction* node) {
     }
 }
 
+// Block counters are incremented at the start of each function and after each label
+// -> $ incq .Lprof.counts+<8 * counter>(%rip)
+static void profile_count_instr(Ctx ctx, TIdentifier label) {
+    emit(ctx, TAB "incq " LBL "prof.counts+");
+    emit_long(ctx, (TLong)(vec_size(ctx->profile_funs) * 8));
+    emit(ctx, "(%rip)" LF);
+    vec_push_back(ctx->profile_funs, ctx->fun_name);
+    vec_push_back(ctx->profile_labels, label);
+}
+
+// The condition codes can stay live across an internal label, e.g. after the parity check of a comisd, in which case
+// the label is not counted, as the increment would overwrite them
+static bool is_flags_live(vector_t(unique_ptr_t(AsmInstruction)) node_list, size_t instr_idx) {
+    for (++instr_idx; instr_idx < vec_size(node_list); ++instr_idx) {
+        const AsmInstruction* node = node_list[instr_idx];
+        switch (node->type) {
+            case AST_AsmCmp_t:
+            case AST_AsmTest_t:
+            case AST_AsmIdiv_t:
+            case AST_AsmDiv_t:
+            case AST_AsmCall_t:
+            case AST_AsmTailCall_t:
+            case AST_AsmRet_t:
+                return false;
+            case AST_AsmUnary_t: {
+                if (node->get._AsmUnary.unop.type != AST_AsmNot_t) {
+                    return false;
+                }
+                break;
+            }
+            case AST_AsmBinary_t: {
+                if (node->get._AsmBinary.asm_type->type != AST_BackendDouble_t) {
+                    switch (node->get._AsmBinary.binop.type) {
+                        case AST_AsmBitShiftLeft_t:
+                        case AST_AsmBitShiftRight_t:
+                        case AST_AsmBitShrArithmetic_t:
+                            break;
+                        default:
+                            return false;
+                    }
+                }
+                break;
+            }
+            case AST_AsmJmp_t:
+            case AST_AsmJmpCC_t:
+            case AST_AsmSetCC_t:
+                return true;
+            default:
+                break;
+        }
+    }
+    return false;
+}
+
+// Loop heads are the labels targeted by a jump placed after them, which are aligned to a 16-byte boundary when that
+// takes at most 10 bytes of padding
+static void init_loop_labels(Ctx ctx, vector_t(unique_ptr_t(AsmInstruction)) node_list) {
+    set_clear(ctx->label_set);
+    set_clear(ctx->loop_label_set);
+    for (size_t i = node_list[0] ? 0 : 1; i < vec_size(node_list); ++i) {
+        TIdentifier target = 0;
+        switch (node_list[i]->type) {
+            case AST_AsmLabel_t:
+                set_insert(ctx->label_set, node_list[i]->get._AsmLabel.name);
+                continue;
+            case AST_AsmJmp_t:
+                target = node_list[i]->get._AsmJmp.target;
+                break;
+            case AST_AsmJmpCC_t:
+                target = node_list[i]->get._AsmJmpCC.target;
+                break;
+            default:
+                continue;
+        }
+        if (set_find(ctx->label_set, target) != set_end()) {
+            set_insert(ctx->loop_label_set, target);
+        }
+    }
+}
+
 static void emit_instr_list(Ctx ctx, vector_t(unique_ptr_t(AsmInstruction)) node_list) {
     for (size_t i = node_list[0] ? 0 : 1; i < vec_size(node_list); ++i) {
         emit_instr(ctx, node_list[i]);
+        if (ctx->is_profile_generate && node_list[i]->type == AST_AsmLabel_t && !is_flags_live(node_list, i)) {
+            profile_count_instr(ctx, node_list[i]->get._AsmLabel.name);
+        }
     }
 }
 
@@ -858,14 +1086,29 @@ static void glob_directive_toplvl(Ctx ctx, TIdentifier name, bool is_glob) {
 // Function(name, global, return_memory, instructions) -> $     <global-directive>
 //                                                        $     .text
 //                                                        $ <name>:
-//                                                        $     pushq %rbp
-//                                                        $     movq %rsp, %rbp
+//                                 if not omit_frame_ptr  $     pushq %rbp
+//                                 if not omit_frame_ptr  $     movq %rsp, %rbp
+//                                 if profile_generate    $     incq .Lprof.counts+<8 * counter>(%rip)
+//                         if profile_generate and main   $     call __wheelcc_prof_init@PLT
 //                                                        $     <instructions>
 static void emit_fun_toplvl(Ctx ctx, const AsmFunction* node) {
     glob_directive_toplvl(ctx, node->name, node->is_glob);
     emit(ctx, TAB ".text" LF);
     emit_identifier(ctx, node->name);
-    emit(ctx, ":" LF TAB "pushq %rbp" LF TAB "movq %rsp, %rbp" LF);
+    emit(ctx, ":" LF);
+    if (!ctx->is_omit_frame_ptr) {
+        emit(ctx, TAB "pushq %rbp" LF TAB "movq %rsp, %rbp" LF);
+    }
+    if (ctx->is_align_loops) {
+        init_loop_labels(ctx, node->instructions);
+    }
+    if (ctx->is_profile_generate) {
+        ctx->fun_name = node->name;
+        profile_count_instr(ctx, 0);
+        if (strcmp(map_get(ctx->identifiers->hash_table, node->name), "main") == 0) {
+            emit(ctx, TAB "call __wheelcc_prof_init@PLT" LF);
+        }
+    }
     emit_instr_list(ctx, node->instructions);
 }
 
@@ -1039,7 +1282,59 @@ static void emit_toplvl(Ctx ctx, const AsmTopLevel* node) {
     }
 }
 
+// The profile table of each translation unit is collected by the linker in the wheelcc_prof section, which the
+// profile runtime walks at exit to write out the counters
+// $     .section wheelcc_prof,"aw"
+// $     .balign 8
+// $     .quad <n>
+// $     .quad .Lprof.names
+// $     .quad .Lprof.counts
+// $     .data
+// $     .balign 8
+// $ .Lprof.names:
+// $     [.quad .Lprof.name.<i>]
+// $     .bss
+// $     .balign 8
+// $ .Lprof.counts:
+// $     .zero <8 * n>
+// $     .section .rodata
+// $ [.Lprof.name.<i>:
+// $     .asciz "<function>[:<label>]"]
+static void emit_profile_table(Ctx ctx) {
+    size_t profile_size = vec_size(ctx->profile_funs);
+    emit(ctx, LF TAB ".section wheelcc_prof,\"aw\"" LF);
+    align_directive_toplvl(ctx, 8);
+    emit(ctx, TAB TAB ".quad ");
+    emit_long(ctx, (TLong)profile_size);
+    emit(ctx, LF TAB TAB ".quad " LBL "prof.names" LF TAB TAB ".quad " LBL "prof.counts" LF);
+    emit(ctx, TAB ".data" LF);
+    align_directive_toplvl(ctx, 8);
+    emit(ctx, LBL "prof.names:" LF);
+    for (size_t i = 0; i < profile_size; ++i) {
+        emit(ctx, TAB TAB ".quad " LBL "prof.name.");
+        emit_long(ctx, (TLong)i);
+        emit(ctx, LF);
+    }
+    emit(ctx, TAB ".bss" LF);
+    align_directive_toplvl(ctx, 8);
+    emit(ctx, LBL "prof.counts:" LF TAB TAB ".zero ");
+    emit_long(ctx, (TLong)(profile_size * 8));
+    emit(ctx, LF TAB ".section .rodata" LF);
+    for (size_t i = 0; i < profile_size; ++i) {
+        emit(ctx, LBL "prof.name.");
+        emit_long(ctx, (TLong)i);
+        emit(ctx, ":" LF TAB TAB ".asciz \"");
+        emit_string(ctx, ctx->profile_funs[i]);
+        if (ctx->profile_labels[i] != 0) {
+            emit(ctx, ":");
+            emit_string(ctx, ctx->profile_labels[i]);
+        }
+        emit(ctx, "\"" LF);
+    }
+}
+
 // Program(top_level*) -> $ [<top_level>]
+//                        $     [<profile-table>]
 //                        $     .section .note.GNU-stack,"",@progbits
 static void emit_program(Ctx ctx, const AsmProgram* node) {
     for (size_t i = 0; i < vec_size(node->static_const_toplvls); ++i) {
@@ -1048,6 +1343,9 @@ static void emit_program(Ctx ctx, const AsmProgram* node) {
     for (size_t i = 0; i < vec_size(node->top_levels); ++i) {
         emit_toplvl(ctx, node->top_levels[i]);
     }
+    if (!vec_empty(ctx->profile_funs)) {
+        emit_profile_table(ctx);
+    }
 #ifndef __APPLE__
     emit(ctx, TAB TAB ".section .note.GNU-stack,\"\",@progbits" LF);
 #endif
@@ -1056,13 +1354,26 @@ static void emit_program(Ctx ctx, const AsmProgram* node) {
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 void emit_gas_code(unique_ptr_t(AsmProgram) * asm_ast, BackEndContext* backend, FileIoContext* fileio,
-    IdentifierContext* identifiers) {
+    IdentifierContext* identifiers, bool is_omit_frame_ptr, bool is_profile_generate, bool is_align_loops) {
     GasCodeContext ctx;
     {
         ctx.backend = backend;
         ctx.fileio = fileio;
         ctx.identifiers = identifiers;
+        ctx.is_omit_frame_ptr = is_omit_frame_ptr;
+        ctx.is_profile_generate = is_profile_generate;
+        ctx.is_align_loops = is_align_loops;
+        ctx.fun_name = 0;
+        ctx.profile_funs = vec_new();
+        ctx.profile_labels = vec_new();
+        ctx.label_set = set_new();
+        ctx.loop_label_set = set_new();
     }
     emit_program(&ctx, *asm_ast);
     free_AsmProgram(asm_ast);
+
+    vec_delete(ctx.profile_funs);
+    vec_delete(ctx.profile_labels);
+    set_delete(ctx.label_set);
+    set_delete(ctx.loop_label_set);
 }
@@ -16,6 +16,7 @@ typedef struct TacReprContext {
     FrontEndContext* frontend;
     IdentifierContext* identifiers;
     // Three address code representation
+    TIdentifier fun_name;
     vector_t(unique_ptr_t(TacInstruction)) * p_instrs;
     vector_t(unique_ptr_t(TacTopLevel)) * p_toplvls;
     vector_t(unique_ptr_t(TacTopLevel)) * p_static_consts;
@@ -1115,11 +1116,36 @@ static void for_statement_instr(Ctx ctx, const CFor* node) {
     push_instr(ctx, make_TacLabel(target_break));
 }
 
+// With a profile, cases are matched in decreasing order of execution count, and cases with equal counts keep their
+// source order
+static void repr_case_order(Ctx ctx, const CSwitch* node, vector_t(size_t) * case_order) {
+    vector_t(TULong) case_counts = vec_new();
+    vec_resize(*case_order, vec_size(node->cases));
+    vec_resize(case_counts, vec_size(node->cases));
+    for (size_t i = 0; i < vec_size(node->cases); ++i) {
+        TIdentifier target_case = repr_case_identifier(ctx->identifiers, node->target, true, i);
+        if (!get_profile_count(ctx->frontend, ctx->fun_name, target_case, &case_counts[i])) {
+            case_counts[i] = 0;
+        }
+        size_t j = i;
+        for (; j > 0 && case_counts[(*case_order)[j - 1]] < case_counts[i]; --j) {
+            (*case_order)[j] = (*case_order)[j - 1];
+        }
+        (*case_order)[j] = i;
+    }
+    vec_delete(case_counts);
+}
+
 static void switch_statement_instr(Ctx ctx, const CSwitch* node) {
     TIdentifier target_break = repr_loop_identifier(ctx->identifiers, LBL_Lbreak, node->target);
     {
+        vector_t(size_t) case_order = vec_new();
+        if (!map_empty(ctx->frontend->profile_table)) {
+            repr_case_order(ctx, node, &case_order);
+        }
         shared_ptr_t(TacValue) match = repr_exp_instr(ctx, node->match);
-        for (size_t i = 0; i < vec_size(node->cases); ++i) {
+        for (size_t j = 0; j < vec_size(node->cases); ++j) {
+            size_t i = vec_empty(case_order) ? j : case_order[j];
             TIdentifier target_case = repr_case_identifier(ctx->identifiers, node->target, true, i);
             shared_ptr_t(TacValue) case_match = sptr_new();
             {
@@ -1135,6 +1161,7 @@ static void switch_statement_instr(Ctx ctx, const CSwitch* node) {
             push_instr(ctx, make_TacJumpIfNotZero(target_case, &case_match));
         }
         free_TacValue(&match);
+        vec_delete(case_order);
     }
     if (node->is_default) {
         TIdentifier target_default = repr_loop_identifier(ctx->identifiers, LBL_Ldefault, node->target);
@@ -1443,6 +1470,7 @@ static unique_ptr_t(TacTopLevel) repr_fun_toplvl(Ctx ctx, const CFunctionDeclara
 
     vector_t(unique_ptr_t(TacInstruction)) body = vec_new();
     {
+        ctx->fun_name = name;
         ctx->p_instrs = &body;
         repr_block(ctx, node->body);
         {
@@ -1587,6 +1615,7 @@ unique_ptr_t(TacProgram) represent_three_address_code(
     {
         ctx.frontend = frontend;
         ctx.identifiers = identifiers;
+        ctx.fun_name = 0;
     }
     unique_ptr_t(TacProgram) tac_ast = repr_program(&ctx, *c_ast);
 
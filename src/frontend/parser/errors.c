@@ -503,15 +503,21 @@ const char* get_fatal_msg(MESSAGE_FATAL msg) {
 const char* get_arg_msg(MESSAGE_ARG msg) {
     switch (msg) {
         case MSG_print_help:
-            RET_ERRNO "Usage: %s [--help] Debug OptimL1 OptimL2 FILE StdlibDir SourceDir [IncludeDir...]\n"
+            RET_ERRNO "Usage: %s [--help] Debug OptimL1 OptimL2 Codegen UnrollFactor UnrollBudget Profile Report "
+                      "FILE StdlibDir SourceDir [IncludeDir...]\n"
                       "    [--help]:         print help and exit\n"
                       "    Debug:            print debug info (0..1"
 #ifndef __NDEBUG__
                       "|251..255"
 #endif
                       ")\n"
-                      "    OptimL1:          optimization level 1 mask (0..15)\n"
+                      "    OptimL1:          optimization level 1 mask (0..255)\n"
                       "    OptimL2:          optimization level 2 enum (0..2)\n"
+                      "    Codegen:          code generation mask (0..127)\n"
+                      "    UnrollFactor:     loop unrolling factor (0..16)\n"
+                      "    UnrollBudget:     loop unrolling size budget (0..255)\n"
+                      "    Profile:          profile file to read, or - for none\n"
+                      "    Report:           time report format (0..2)\n"
                       "    FILE:             source file to compile\n"
                       "    StdlibDir:        standard lib include path\n"
                       "    SourceDir:        source file include path\n"
@@ -529,12 +535,30 @@ const char* get_arg_msg(MESSAGE_ARG msg) {
             RET_ERRNO "no level 2 optimization code passed in third argument, see " EM_CSTR("--help");
         case MSG_invalid_optim_2_arg:
             RET_ERRNO "invalid level 2 optimization code " EM_VARG " passed in third argument, see " EM_CSTR("--help");
+        case MSG_no_codegen_arg:
+            RET_ERRNO "no code generation mask passed in fourth argument, see " EM_CSTR("--help");
+        case MSG_invalid_codegen_arg:
+            RET_ERRNO "invalid code generation mask " EM_VARG " passed in fourth argument, see " EM_CSTR("--help");
+        case MSG_no_unroll_factor_arg:
+            RET_ERRNO "no loop unrolling factor passed in fifth argument, see " EM_CSTR("--help");
+        case MSG_invalid_unroll_factor_arg:
+            RET_ERRNO "invalid loop unrolling factor " EM_VARG " passed in fifth argument, see " EM_CSTR("--help");
+        case MSG_no_unroll_budget_arg:
+            RET_ERRNO "no loop unrolling budget passed in sixth argument, see " EM_CSTR("--help");
+        case MSG_invalid_unroll_budget_arg:
+            RET_ERRNO "invalid loop unrolling budget " EM_VARG " passed in sixth argument, see " EM_CSTR("--help");
+        case MSG_no_profile_arg:
+            RET_ERRNO "no profile file passed in seventh argument, see " EM_CSTR("--help");
+        case MSG_no_report_arg:
+            RET_ERRNO "no time report format passed in eighth argument, see " EM_CSTR("--help");
+        case MSG_invalid_report_arg:
+            RET_ERRNO "invalid time report format " EM_VARG " passed in eighth argument, see " EM_CSTR("--help");
         case MSG_no_input_files_arg:
-            RET_ERRNO "no input file passed in fourth argument, see " EM_CSTR("--help");
+            RET_ERRNO "no input file passed in ninth argument, see " EM_CSTR("--help");
         case MSG_no_stdlib_dir_arg:
-            RET_ERRNO "no standard lib directory passed in fifth argument, see " EM_CSTR("--help");
+            RET_ERRNO "no standard lib directory passed in tenth argument, see " EM_CSTR("--help");
         case MSG_no_include_dir_arg:
-            RET_ERRNO "no include directories passed in sixth argument, see " EM_CSTR("--help");
+            RET_ERRNO "no include directories passed in eleventh argument, see " EM_CSTR("--help");
         default:
             THROW_ABORT;
     }
@@ -552,6 +576,8 @@ const char* get_util_msg(MESSAGE_UTIL msg) {
             RET_ERRNO "cannot interpret string " EM_VARG " to an unsigned integer value";
         case MSG_failed_strtod:
             RET_ERRNO "cannot interpret string " EM_VARG " to a floating point value";
+        case MSG_malformed_profile:
+            RET_ERRNO "malformed profile count " EM_VARG;
         default:
             THROW_ABORT;
     }
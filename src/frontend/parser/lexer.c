@@ -770,7 +770,6 @@ static error_t tokenize_include(Ctx ctx, size_t linenum) {
     string_t filename = str_new(NULL);
     string_t fopen_name = str_new(NULL);
     CATCH_ENTER;
-    char* line;
     size_t line_size;
     size_t match_at;
     size_t match_size;
@@ -802,7 +801,6 @@ static error_t tokenize_include(Ctx ctx, size_t linenum) {
             THROW_ABORT;
     }
 
-    line = ctx->line;
     line_size = ctx->line_size;
     match_at = ctx->match_at;
     match_size = ctx->match_size;
@@ -822,7 +820,8 @@ static error_t tokenize_include(Ctx ctx, size_t linenum) {
         vec_push_back(ctx->errors->fopen_lines, fopen_line);
     }
 
-    ctx->line = line;
+    // The line buffer is freed when the file was closed to stay under FOPEN_MAX, so read it back from the reopened file
+    ctx->line = vec_back(ctx->fileio->file_reads).buf;
     ctx->line_size = line_size;
     ctx->match_at = match_at;
     ctx->match_size = match_size;
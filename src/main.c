@@ -4,6 +4,7 @@
 #include "util/c_std.h"
 #include "util/fileio.h"
 #include "util/throw.h"
+#include "util/time_report.h"
 #ifndef __NDEBUG__
 #include "util/pprint.h"
 #endif
@@ -26,9 +27,12 @@
 #include "backend/assembly/stack_fix.h"
 #include "backend/assembly/symt_cvt.h"
 
+#include "backend/emitter/elf_code.h"
 #include "backend/emitter/gas_code.h"
 
+#include "optimization/block_layout.h"
 #include "optimization/optim_tac.h"
+#include "optimization/peephole.h"
 #include "optimization/reg_alloc.h"
 
 typedef struct MainContext {
@@ -43,7 +47,19 @@ typedef struct MainContext {
     uint8_t debug_code;
     uint8_t optim_1_mask;
     uint8_t optim_2_code;
+    uint8_t codegen_mask;
+    uint8_t unroll_factor;
+    uint8_t unroll_budget;
+    bool is_omit_frame_ptr;
+    bool is_sibling_call;
+    bool is_vectorize;
+    bool is_profile_generate;
+    bool is_reorder_blocks;
+    bool is_align_loops;
+    bool is_integrated_as;
+    REPORT_FORMAT report_format;
     string_t filename;
+    string_t profilename;
     vector_t(const char*) includedirs;
     vector_t(const char*) stdlibdirs;
 } MainContext;
@@ -127,10 +143,59 @@ static void set_filename_ext(Ctx ctx, const char* ext) {
     THROW_ABORT;
 }
 
+// Profile lines are "function count" for function entries and "function:label count" for basic blocks,
+// counts of the same block accumulated over several runs are summed
+static error_t read_profile(Ctx ctx, FileIoContext* fileio, FrontEndContext* frontend) {
+    CATCH_ENTER;
+    char* line = NULL;
+    size_t line_size = 0;
+    set_filename(fileio, ctx->profilename);
+    TRY(open_fread(fileio, ctx->profilename));
+    for (size_t linenum = 1; read_line(fileio, &line, &line_size); ++linenum) {
+        while (line_size > 0 && (line[line_size - 1] == '\n' || line[line_size - 1] == '\r')) {
+            line_size--;
+        }
+        if (line_size == 0) {
+            continue;
+        }
+        line[line_size] = '\0';
+
+        size_t count_at = line_size;
+        while (count_at > 0 && line[count_at - 1] != ' ') {
+            count_at--;
+        }
+        char* end_ptr = NULL;
+        TULong count = (TULong)strtoull(&line[count_at], &end_ptr, 10);
+        if (count_at < 2 || end_ptr == &line[count_at] || *end_ptr != '\0') {
+            THROW_BASE(GET_UTIL_MSG(MSG_malformed_profile, line));
+        }
+
+        TIdentifier label = 0;
+        line[count_at - 1] = '\0';
+        for (size_t i = 0; i < count_at - 1; ++i) {
+            if (line[i] == ':') {
+                line[i] = '\0';
+                label = str_hash(&line[i + 1]);
+                break;
+            }
+        }
+        TIdentifier key = get_profile_key(str_hash(line), label);
+        if (map_find(frontend->profile_table, key) != map_end()) {
+            count += map_get(frontend->profile_table, key);
+        }
+        map_add(frontend->profile_table, key, count);
+    }
+    TRY(close_fread(fileio, 0));
+    FINALLY;
+    CATCH_EXIT;
+}
+
 static error_t compile(Ctx ctx, ErrorsContext* errors, FileIoContext* fileio) {
     IdentifierContext identifiers;
     FrontEndContext frontend;
     BackEndContext backend;
+    TimeReportContext report;
+    TimeReportContext* p_report = NULL;
     vector_t(Token) tokens = vec_new();
     unique_ptr_t(CProgram) c_ast = uptr_new();
     unique_ptr_t(TacProgram) tac_ast = uptr_new();
@@ -160,8 +225,16 @@ static error_t compile(Ctx ctx, ErrorsContext* errors, FileIoContext* fileio) {
         frontend.struct_typedef_table = map_new();
         frontend.symbol_table = map_new();
         frontend.addressed_set = set_new();
+        frontend.profile_table = map_new();
 
         backend.symbol_table = map_new();
+
+        report.format = ctx->report_format;
+        memset(report.stages, 0, sizeof(report.stages));
+        report.functions = vec_new();
+        if (report.format != REPORT_None) {
+            p_report = &report;
+        }
     }
 
     CATCH_ENTER;
@@ -197,8 +270,16 @@ static error_t compile(Ctx ctx, ErrorsContext* errors, FileIoContext* fileio) {
     THROW_INIT(GET_FATAL_MSG(MSG_unsupported_os, "unknown"));
 #endif
 
+    if (ctx->profilename) {
+        verbose(ctx, "-- Profile reading ... ");
+        TRY(read_profile(ctx, fileio, &frontend));
+        verbose(ctx, "OK\n");
+    }
+
     verbose(ctx, "-- Lexing ... ");
+    report_begin(p_report, STAGE_Lexing);
     TRY(lex_c_code(ctx->filename, &ctx->includedirs, &ctx->stdlibdirs, errors, fileio, &identifiers, &tokens));
+    report_end(p_report, STAGE_Lexing);
     verbose(ctx, "OK\n");
 #ifndef __NDEBUG__
     if (ctx->debug_code == 255) {
@@ -208,7 +289,9 @@ static error_t compile(Ctx ctx, ErrorsContext* errors, FileIoContext* fileio) {
 #endif
 
     verbose(ctx, "-- Parsing ... ");
+    report_begin(p_report, STAGE_Parsing);
     TRY(parse_tokens(&tokens, errors, &identifiers, &c_ast));
+    report_end(p_report, STAGE_Parsing);
     verbose(ctx, "OK\n");
 #ifndef __NDEBUG__
     if (ctx->debug_code == 254) {
@@ -218,7 +301,9 @@ static error_t compile(Ctx ctx, ErrorsContext* errors, FileIoContext* fileio) {
 #endif
 
     verbose(ctx, "-- Semantic analysis ... ");
+    report_begin(p_report, STAGE_Semantic);
     TRY(analyze_semantic(c_ast, errors, &frontend, &identifiers));
+    report_end(p_report, STAGE_Semantic);
     verbose(ctx, "OK\n");
 #ifndef __NDEBUG__
     if (ctx->debug_code == 253) {
@@ -231,10 +316,15 @@ static error_t compile(Ctx ctx, ErrorsContext* errors, FileIoContext* fileio) {
 #endif
 
     verbose(ctx, "-- TAC representation ... ");
+    report_begin(p_report, STAGE_TacRepr);
     tac_ast = represent_three_address_code(&c_ast, &frontend, &identifiers);
-    if (ctx->optim_1_mask > 0) {
+    report_end(p_report, STAGE_TacRepr);
+    if (ctx->optim_1_mask > 0 || ctx->is_vectorize) {
         verbose(ctx, "OK\n-- Level 1 optimization ... ");
-        optimize_three_address_code(tac_ast, &frontend, ctx->optim_1_mask);
+        report_begin(p_report, STAGE_OptimTac);
+        optimize_three_address_code(tac_ast, &frontend, &identifiers, p_report, ctx->optim_1_mask,
+            ctx->unroll_factor, ctx->unroll_budget, ctx->is_vectorize);
+        report_end(p_report, STAGE_OptimTac);
     }
     verbose(ctx, "OK\n");
 #ifndef __NDEBUG__
@@ -248,13 +338,31 @@ static error_t compile(Ctx ctx, ErrorsContext* errors, FileIoContext* fileio) {
 #endif
 
     verbose(ctx, "-- Assembly generation ... ");
-    asm_ast = generate_assembly(&tac_ast, &frontend, &identifiers);
+    report_begin(p_report, STAGE_AsmGen);
+    asm_ast = generate_assembly(&tac_ast, &frontend, &identifiers, ctx->is_sibling_call);
     convert_symbol_table(asm_ast, &backend, &frontend);
+    report_end(p_report, STAGE_AsmGen);
     if (ctx->optim_2_code > 0) {
         verbose(ctx, "OK\n-- Level 2 optimization ... ");
-        allocate_registers(asm_ast, &backend, &frontend, ctx->optim_2_code);
+        report_begin(p_report, STAGE_RegAlloc);
+        allocate_registers(asm_ast, &backend, &frontend, p_report, ctx->optim_2_code, ctx->is_omit_frame_ptr);
+        report_end(p_report, STAGE_RegAlloc);
+    }
+    report_begin(p_report, STAGE_StackFix);
+    fix_stack(asm_ast, &backend, ctx->is_omit_frame_ptr);
+    report_end(p_report, STAGE_StackFix);
+    if (ctx->is_reorder_blocks) {
+        verbose(ctx, "OK\n-- Block layout ... ");
+        report_begin(p_report, STAGE_BlockLayout);
+        layout_blocks(asm_ast, &frontend, &identifiers);
+        report_end(p_report, STAGE_BlockLayout);
+    }
+    if (ctx->optim_2_code > 0) {
+        verbose(ctx, "OK\n-- Peephole optimization ... ");
+        report_begin(p_report, STAGE_Peephole);
+        optimize_peephole(asm_ast, ctx->is_verbose);
+        report_end(p_report, STAGE_Peephole);
     }
-    fix_stack(asm_ast, &backend);
     verbose(ctx, "OK\n");
 #ifndef __NDEBUG__
     if (ctx->debug_code == 251) {
@@ -269,11 +377,24 @@ static error_t compile(Ctx ctx, ErrorsContext* errors, FileIoContext* fileio) {
 #endif
 
     verbose(ctx, "-- Code emission ... ");
-    set_filename_ext(ctx, "s");
-    TRY(open_fwrite(fileio, ctx->filename));
-    emit_gas_code(&asm_ast, &backend, fileio, &identifiers);
+    report_begin(p_report, STAGE_CodeEmission);
+    if (ctx->is_integrated_as) {
+        set_filename_ext(ctx, "o");
+        TRY(open_fwrite(fileio, ctx->filename));
+        emit_elf_code(&asm_ast, &backend, fileio, &identifiers, ctx->is_omit_frame_ptr, ctx->is_align_loops);
+    }
+    else {
+        set_filename_ext(ctx, "s");
+        TRY(open_fwrite(fileio, ctx->filename));
+        emit_gas_code(&asm_ast, &backend, fileio, &identifiers, ctx->is_omit_frame_ptr, ctx->is_profile_generate,
+            ctx->is_align_loops);
+    }
     close_fwrite(fileio);
+    report_end(p_report, STAGE_CodeEmission);
     verbose(ctx, "OK\n");
+    if (p_report) {
+        print_time_report(p_report, &identifiers);
+    }
 
     FINALLY;
     for (size_t i = 0; i < map_size(identifiers.hash_table); ++i) {
@@ -291,6 +412,7 @@ static error_t compile(Ctx ctx, ErrorsContext* errors, FileIoContext* fileio) {
     }
     map_delete(frontend.symbol_table);
     set_delete(frontend.addressed_set);
+    map_delete(frontend.profile_table);
 
     for (size_t i = 0; i < map_size(backend.symbol_table); ++i) {
         free_BackendSymbol(&pair_second(backend.symbol_table[i]));
@@ -301,6 +423,7 @@ static error_t compile(Ctx ctx, ErrorsContext* errors, FileIoContext* fileio) {
     free_CProgram(&c_ast);
     free_TacProgram(&tac_ast);
     free_AsmProgram(&asm_ast);
+    free_time_report(&report);
     CATCH_EXIT;
 }
 
@@ -313,6 +436,7 @@ static bool arg_parse_uint8(const char* arg, uint8_t* value) {
 static error_t arg_parse(Ctx ctx, int argc, char** argv) {
     CATCH_ENTER;
     size_t i = 0;
+    uint8_t report_code = 0;
 
     if (argc == 2 && strcmp(argv[1], "--help") == 0) {
         THROW_INIT(GET_ARG_MSG(MSG_print_help, argv[0]));
@@ -328,7 +452,7 @@ static error_t arg_parse(Ctx ctx, int argc, char** argv) {
     if (!argv[++i]) {
         THROW_INIT(GET_ARG_MSG_0(MSG_no_optim_1_arg));
     }
-    else if (arg_parse_uint8(argv[i], &ctx->optim_1_mask) || ctx->optim_1_mask > 15) {
+    else if (arg_parse_uint8(argv[i], &ctx->optim_1_mask)) {
         THROW_INIT(GET_ARG_MSG(MSG_invalid_optim_1_arg, argv[i]));
     }
 
@@ -339,6 +463,50 @@ static error_t arg_parse(Ctx ctx, int argc, char** argv) {
         THROW_INIT(GET_ARG_MSG(MSG_invalid_optim_2_arg, argv[i]));
     }
 
+    if (!argv[++i]) {
+        THROW_INIT(GET_ARG_MSG_0(MSG_no_codegen_arg));
+    }
+    else if (arg_parse_uint8(argv[i], &ctx->codegen_mask) || ctx->codegen_mask > 127
+             || ((ctx->codegen_mask & (1u << 3)) > 0 && (ctx->codegen_mask & (1u << 6)) > 0)) {
+        THROW_INIT(GET_ARG_MSG(MSG_invalid_codegen_arg, argv[i]));
+    }
+    ctx->is_omit_frame_ptr = (ctx->codegen_mask & 1u) > 0;
+    ctx->is_sibling_call = (ctx->codegen_mask & (1u << 1)) > 0;
+    ctx->is_vectorize = (ctx->codegen_mask & (1u << 2)) > 0;
+    ctx->is_profile_generate = (ctx->codegen_mask & (1u << 3)) > 0;
+    ctx->is_reorder_blocks = (ctx->codegen_mask & (1u << 4)) > 0;
+    ctx->is_align_loops = (ctx->codegen_mask & (1u << 5)) > 0;
+    ctx->is_integrated_as = (ctx->codegen_mask & (1u << 6)) > 0;
+
+    if (!argv[++i]) {
+        THROW_INIT(GET_ARG_MSG_0(MSG_no_unroll_factor_arg));
+    }
+    else if (arg_parse_uint8(argv[i], &ctx->unroll_factor) || ctx->unroll_factor > 16) {
+        THROW_INIT(GET_ARG_MSG(MSG_invalid_unroll_factor_arg, argv[i]));
+    }
+
+    if (!argv[++i]) {
+        THROW_INIT(GET_ARG_MSG_0(MSG_no_unroll_budget_arg));
+    }
+    else if (arg_parse_uint8(argv[i], &ctx->unroll_budget)) {
+        THROW_INIT(GET_ARG_MSG(MSG_invalid_unroll_budget_arg, argv[i]));
+    }
+
+    if (!argv[++i]) {
+        THROW_INIT(GET_ARG_MSG_0(MSG_no_profile_arg));
+    }
+    else if (strcmp(argv[i], "-") != 0) {
+        ctx->profilename = str_new(argv[i]);
+    }
+
+    if (!argv[++i]) {
+        THROW_INIT(GET_ARG_MSG_0(MSG_no_report_arg));
+    }
+    else if (arg_parse_uint8(argv[i], &report_code) || report_code > 2) {
+        THROW_INIT(GET_ARG_MSG(MSG_invalid_report_arg, argv[i]));
+    }
+    ctx->report_format = (REPORT_FORMAT)report_code;
+
     if (!argv[++i]) {
         THROW_INIT(GET_ARG_MSG_0(MSG_no_input_files_arg));
     }
@@ -383,6 +551,7 @@ error_t main(int argc, char** argv) {
         ctx.errors = &errors;
         ctx.is_verbose = false;
         ctx.filename = str_new(NULL);
+        ctx.profilename = NULL;
         ctx.includedirs = vec_new();
         ctx.stdlibdirs = vec_new();
     }
@@ -406,6 +575,7 @@ error_t main(int argc, char** argv) {
     vec_delete(fileio.file_reads);
 
     str_delete(ctx.filename);
+    str_delete(ctx.profilename);
     vec_delete(ctx.includedirs);
     vec_delete(ctx.stdlibdirs);
     CATCH_EXIT;
@@ -0,0 +1,379 @@
+#include <stdlib.h>
+
+#include "util/c_std.h"
+#include "util/throw.h"
+
+#include "ast/ast.h"
+#include "ast/back_ast.h"
+#include "ast/front_symt.h"
+#include "ast_t.h" // ast
+
+#include "optimization/block_layout.h"
+
+#define NULL_BLOCK_ID ((size_t)-1)
+
+typedef struct LayoutBlock {
+    size_t instrs_front_idx;
+    size_t instrs_back_idx;
+    size_t fall_id;
+    size_t jump_id;
+    size_t chain_head_id;
+    size_t chain_tail_id;
+    size_t chain_next_id;
+    TIdentifier label;
+    TULong freq;
+} LayoutBlock;
+
+typedef struct LayoutEdge {
+    size_t src_id;
+    size_t dst_id;
+    TULong weight;
+    bool is_fall;
+} LayoutEdge;
+
+typedef struct BlockLayoutContext {
+    FrontEndContext* frontend;
+    IdentifierContext* identifiers;
+    // Block layout
+    bool is_profile;
+    vector_t(size_t) block_order;
+    vector_t(LayoutBlock) blocks;
+    vector_t(LayoutEdge) edges;
+    hashmap_t(TIdentifier, size_t) label_id_map;
+    hashset_t(TIdentifier) fall_label_set;
+    vector_t(unique_ptr_t(AsmInstruction)) instrs;
+} BlockLayoutContext;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Block layout
+
+typedef BlockLayoutContext* Ctx;
+
+#define GET_BLOCK(X) ctx->blocks[X]
+#define GET_BLOCK_INSTR(X, Y) ctx->instrs[GET_BLOCK(X).instrs_##Y##_idx]
+
+static TIdentifier make_block_label(Ctx ctx) {
+    string_t name = str_new("block");
+    return make_label_identifier(ctx->identifiers, &name);
+}
+
+// Basic blocks start at labels, and the fall through of a conditional jump is given a label so that it can be
+// placed apart from its predecessor
+static void init_layout_instrs(Ctx ctx, AsmFunction* node) {
+    vec_clear(ctx->instrs);
+    set_clear(ctx->fall_label_set);
+    for (size_t instr_idx = 0; instr_idx < vec_size(node->instructions); ++instr_idx) {
+        if (node->instructions[instr_idx]) {
+            bool is_jmp_cc = node->instructions[instr_idx]->type == AST_AsmJmpCC_t;
+            vec_move_back(ctx->instrs, node->instructions[instr_idx]);
+            if (is_jmp_cc) {
+                size_t next_idx = instr_idx + 1;
+                for (; next_idx < vec_size(node->instructions) && !node->instructions[next_idx]; ++next_idx) {
+                }
+                if (next_idx < vec_size(node->instructions)
+                    && node->instructions[next_idx]->type != AST_AsmLabel_t) {
+                    TIdentifier label = make_block_label(ctx);
+                    vec_push_back(ctx->instrs, make_AsmLabel(label));
+                    set_insert(ctx->fall_label_set, label);
+                }
+            }
+        }
+    }
+    vec_clear(node->instructions);
+}
+
+static bool init_layout_succ_ids(Ctx ctx, size_t block_id) {
+    const AsmInstruction* node = GET_BLOCK_INSTR(block_id, back);
+    size_t next_id = block_id + 1 < vec_size(ctx->blocks) ? block_id + 1 : NULL_BLOCK_ID;
+    switch (node->type) {
+        case AST_AsmJmp_t: {
+            if (map_find(ctx->label_id_map, node->get._AsmJmp.target) == map_end()) {
+                return false;
+            }
+            GET_BLOCK(block_id).jump_id = map_get(ctx->label_id_map, node->get._AsmJmp.target);
+            break;
+        }
+        case AST_AsmJmpCC_t: {
+            if (map_find(ctx->label_id_map, node->get._AsmJmpCC.target) == map_end()) {
+                return false;
+            }
+            GET_BLOCK(block_id).jump_id = map_get(ctx->label_id_map, node->get._AsmJmpCC.target);
+            GET_BLOCK(block_id).fall_id = next_id;
+            break;
+        }
+        case AST_AsmRet_t:
+        case AST_AsmTailCall_t:
+            break;
+        default: {
+            GET_BLOCK(block_id).fall_id = next_id;
+            break;
+        }
+    }
+    return node->type == AST_AsmJmp_t || node->type == AST_AsmRet_t || node->type == AST_AsmTailCall_t
+           || next_id != NULL_BLOCK_ID;
+}
+
+static bool init_layout_blocks(Ctx ctx) {
+    vec_clear(ctx->blocks);
+    map_clear(ctx->label_id_map);
+    for (size_t instr_idx = 0; instr_idx < vec_size(ctx->instrs); ++instr_idx) {
+        if (instr_idx == 0 || ctx->instrs[instr_idx]->type == AST_AsmLabel_t) {
+            if (instr_idx > 0) {
+                vec_back(ctx->blocks).instrs_back_idx = instr_idx - 1;
+            }
+            TIdentifier label = 0;
+            if (ctx->instrs[instr_idx]->type == AST_AsmLabel_t) {
+                label = ctx->instrs[instr_idx]->get._AsmLabel.name;
+            }
+            LayoutBlock block = {instr_idx, instr_idx, NULL_BLOCK_ID, NULL_BLOCK_ID, vec_size(ctx->blocks),
+                vec_size(ctx->blocks), NULL_BLOCK_ID, label, 1};
+            vec_push_back(ctx->blocks, block);
+            if (label != 0) {
+                map_add(ctx->label_id_map, label, vec_size(ctx->blocks) - 1);
+            }
+        }
+    }
+    if (vec_empty(ctx->blocks)) {
+        return false;
+    }
+    vec_back(ctx->blocks).instrs_back_idx = vec_size(ctx->instrs) - 1;
+
+    for (size_t block_id = 0; block_id < vec_size(ctx->blocks); ++block_id) {
+        if (!init_layout_succ_ids(ctx, block_id)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// With a profile, blocks starting with a label take the count of that label, and other blocks keep the previous
+// count. Fall through labels are made by this pass and do not keep their position when the profile changes the code
+// upstream, so they are not looked up. Without a profile, blocks are weighted by their static loop depth, where loops
+// are found from the jumps back to an earlier block
+static void init_layout_freqs(Ctx ctx, TIdentifier fun_name) {
+    TULong count;
+    ctx->is_profile =
+        !map_empty(ctx->frontend->profile_table) && get_profile_count(ctx->frontend, fun_name, 0, &count);
+    if (ctx->is_profile) {
+        for (size_t block_id = 0; block_id < vec_size(ctx->blocks); ++block_id) {
+            if (GET_BLOCK(block_id).label != 0
+                && set_find(ctx->fall_label_set, GET_BLOCK(block_id).label) == set_end()) {
+                get_profile_count(ctx->frontend, fun_name, GET_BLOCK(block_id).label, &count);
+            }
+            GET_BLOCK(block_id).freq = count;
+        }
+    }
+    else {
+        for (size_t block_id = 0; block_id < vec_size(ctx->blocks); ++block_id) {
+            size_t succ_ids[2] = {GET_BLOCK(block_id).fall_id, GET_BLOCK(block_id).jump_id};
+            for (size_t i = 0; i < 2; ++i) {
+                if (succ_ids[i] != NULL_BLOCK_ID && succ_ids[i] <= block_id) {
+                    for (size_t loop_id = succ_ids[i]; loop_id <= block_id; ++loop_id) {
+                        if (GET_BLOCK(loop_id).freq < (1ul << 24)) {
+                            GET_BLOCK(loop_id).freq <<= 3;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void push_layout_edge(Ctx ctx, size_t src_id, size_t dst_id, bool is_fall) {
+    if (dst_id != NULL_BLOCK_ID && dst_id != src_id) {
+        TULong weight = GET_BLOCK(src_id).freq;
+        if (GET_BLOCK(dst_id).freq < weight) {
+            weight = GET_BLOCK(dst_id).freq;
+        }
+        LayoutEdge edge = {src_id, dst_id, weight, is_fall};
+        vec_push_back(ctx->edges, edge);
+    }
+}
+
+// Heavier edges are chained first, and among equal edges the later blocks are chained first, so that a loop body
+// is placed before its condition and the back edge becomes the only jump of the loop
+static int cmp_layout_edges(const void* ptr_1, const void* ptr_2) {
+    const LayoutEdge* edge_1 = (const LayoutEdge*)ptr_1;
+    const LayoutEdge* edge_2 = (const LayoutEdge*)ptr_2;
+    if (edge_1->weight != edge_2->weight) {
+        return edge_1->weight > edge_2->weight ? -1 : 1;
+    }
+    else if (edge_1->src_id != edge_2->src_id) {
+        return edge_1->src_id > edge_2->src_id ? -1 : 1;
+    }
+    else if (edge_1->is_fall != edge_2->is_fall) {
+        return edge_1->is_fall ? -1 : 1;
+    }
+    else if (edge_1->dst_id != edge_2->dst_id) {
+        return edge_1->dst_id < edge_2->dst_id ? -1 : 1;
+    }
+    return 0;
+}
+
+static void chain_layout_edge(Ctx ctx, const LayoutEdge* edge) {
+    size_t head_id = GET_BLOCK(edge->src_id).chain_head_id;
+    if (edge->dst_id == 0 || GET_BLOCK(head_id).chain_tail_id != edge->src_id
+        || GET_BLOCK(edge->dst_id).chain_head_id != edge->dst_id || head_id == edge->dst_id) {
+        return;
+    }
+    GET_BLOCK(edge->src_id).chain_next_id = edge->dst_id;
+    GET_BLOCK(head_id).chain_tail_id = GET_BLOCK(edge->dst_id).chain_tail_id;
+    for (size_t block_id = edge->dst_id; block_id != NULL_BLOCK_ID; block_id = GET_BLOCK(block_id).chain_next_id) {
+        GET_BLOCK(block_id).chain_head_id = head_id;
+    }
+}
+
+// Chains are placed after the entry chain in source order, and with a profile the blocks that never ran are
+// placed at the end of the function
+static void order_layout_chains(Ctx ctx) {
+    vec_clear(ctx->block_order);
+    for (size_t i = 0; i < 2; ++i) {
+        bool is_cold = i > 0;
+        for (size_t head_id = 0; head_id < vec_size(ctx->blocks); ++head_id) {
+            if (GET_BLOCK(head_id).chain_head_id == head_id
+                && (head_id == 0 ? !is_cold : is_cold == (ctx->is_profile && GET_BLOCK(head_id).freq == 0))) {
+                for (size_t block_id = head_id; block_id != NULL_BLOCK_ID;
+                     block_id = GET_BLOCK(block_id).chain_next_id) {
+                    vec_push_back(ctx->block_order, block_id);
+                }
+            }
+        }
+    }
+}
+
+static bool invert_cond_code(AsmCondCode* cond_code) {
+    switch (cond_code->type) {
+        case AST_AsmE_t:
+            *cond_code = init_AsmNE();
+            return true;
+        case AST_AsmNE_t:
+            *cond_code = init_AsmE();
+            return true;
+        case AST_AsmG_t:
+            *cond_code = init_AsmLE();
+            return true;
+        case AST_AsmGE_t:
+            *cond_code = init_AsmL();
+            return true;
+        case AST_AsmL_t:
+            *cond_code = init_AsmGE();
+            return true;
+        case AST_AsmLE_t:
+            *cond_code = init_AsmG();
+            return true;
+        case AST_AsmA_t:
+            *cond_code = init_AsmBE();
+            return true;
+        case AST_AsmAE_t:
+            *cond_code = init_AsmB();
+            return true;
+        case AST_AsmB_t:
+            *cond_code = init_AsmAE();
+            return true;
+        case AST_AsmBE_t:
+            *cond_code = init_AsmA();
+            return true;
+        case AST_AsmP_t:
+            return false;
+        default:
+            THROW_ABORT;
+    }
+}
+
+// Blocks that no longer fall through to their successor jump to it, and a conditional jump to the next block is
+// inverted to jump to the fall through instead
+static void layout_block_exit(Ctx ctx, AsmFunction* node, size_t block_id, size_t next_id) {
+    size_t fall_id = GET_BLOCK(block_id).fall_id;
+    if (fall_id == NULL_BLOCK_ID || fall_id == next_id) {
+        return;
+    }
+    TIdentifier fall_label = GET_BLOCK(fall_id).label;
+    AsmInstruction* jmp_cc_instr = vec_back(node->instructions);
+    if (jmp_cc_instr->type == AST_AsmJmpCC_t && GET_BLOCK(block_id).jump_id == next_id
+        && invert_cond_code(&jmp_cc_instr->get._AsmJmpCC.cond_code)) {
+        jmp_cc_instr->get._AsmJmpCC.target = fall_label;
+    }
+    else {
+        vec_push_back(node->instructions, make_AsmJmp(fall_label));
+    }
+}
+
+static void layout_fun_toplvl(Ctx ctx, AsmFunction* node) {
+    init_layout_instrs(ctx, node);
+    if (!init_layout_blocks(ctx)) {
+        for (size_t instr_idx = 0; instr_idx < vec_size(ctx->instrs); ++instr_idx) {
+            vec_move_back(node->instructions, ctx->instrs[instr_idx]);
+        }
+        return;
+    }
+    init_layout_freqs(ctx, node->name);
+
+    vec_clear(ctx->edges);
+    for (size_t block_id = 0; block_id < vec_size(ctx->blocks); ++block_id) {
+        push_layout_edge(ctx, block_id, GET_BLOCK(block_id).fall_id, true);
+        push_layout_edge(ctx, block_id, GET_BLOCK(block_id).jump_id, false);
+    }
+    if (!vec_empty(ctx->edges)) {
+        qsort(ctx->edges, vec_size(ctx->edges), sizeof(LayoutEdge), cmp_layout_edges);
+    }
+    for (size_t i = 0; i < vec_size(ctx->edges); ++i) {
+        if (!ctx->is_profile || ctx->edges[i].weight > 0) {
+            chain_layout_edge(ctx, &ctx->edges[i]);
+        }
+    }
+    order_layout_chains(ctx);
+
+    for (size_t i = 0; i < vec_size(ctx->block_order); ++i) {
+        size_t block_id = ctx->block_order[i];
+        for (size_t instr_idx = GET_BLOCK(block_id).instrs_front_idx; instr_idx <= GET_BLOCK(block_id).instrs_back_idx;
+             ++instr_idx) {
+            vec_move_back(node->instructions, ctx->instrs[instr_idx]);
+        }
+        layout_block_exit(
+            ctx, node, block_id, i + 1 < vec_size(ctx->block_order) ? ctx->block_order[i + 1] : NULL_BLOCK_ID);
+    }
+}
+
+static void layout_toplvl(Ctx ctx, AsmTopLevel* node) {
+    switch (node->type) {
+        case AST_AsmFunction_t:
+            layout_fun_toplvl(ctx, &node->get._AsmFunction);
+            break;
+        case AST_AsmStaticVariable_t:
+            break;
+        default:
+            THROW_ABORT;
+    }
+}
+
+static void layout_program(Ctx ctx, const AsmProgram* node) {
+    for (size_t i = 0; i < vec_size(node->top_levels); ++i) {
+        layout_toplvl(ctx, node->top_levels[i]);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void layout_blocks(const AsmProgram* node, FrontEndContext* frontend, IdentifierContext* identifiers) {
+    BlockLayoutContext ctx;
+    {
+        ctx.frontend = frontend;
+        ctx.identifiers = identifiers;
+        ctx.is_profile = false;
+        ctx.block_order = vec_new();
+        ctx.blocks = vec_new();
+        ctx.edges = vec_new();
+        ctx.label_id_map = map_new();
+        ctx.fall_label_set = set_new();
+        ctx.instrs = vec_new();
+    }
+    layout_program(&ctx, node);
+
+    vec_delete(ctx.block_order);
+    vec_delete(ctx.blocks);
+    vec_delete(ctx.edges);
+    map_delete(ctx.label_id_map);
+    set_delete(ctx.fall_label_set);
+    vec_delete(ctx.instrs);
+}
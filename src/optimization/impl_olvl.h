@@ -342,6 +342,7 @@ static void cfg_init_block(Ctx ctx, size_t instr_idx, size_t* instrs_back_idx) {
 #elif __OPTIM_LEVEL__ == 2
         case AST_AsmJmp_t:
         case AST_AsmJmpCC_t:
+        case AST_AsmTailCall_t:
         case AST_AsmRet_t:
 #endif
         {
@@ -387,6 +388,7 @@ static void cfg_init_edges(Ctx ctx, size_t block_id) {
 #if __OPTIM_LEVEL__ == 1
         case AST_TacReturn_t:
 #elif __OPTIM_LEVEL__ == 2
+        case AST_AsmTailCall_t:
         case AST_AsmRet_t:
 #endif
             cfg_add_succ_edge(ctx, block_id, ctx->cfg->exit_id);
@@ -534,6 +536,8 @@ static bool is_transfer_instr(Ctx ctx, size_t instr_idx
         case AST_AsmCvtsi2sd_t:
         case AST_AsmUnary_t:
         case AST_AsmBinary_t:
+        case AST_AsmMovPacked_t:
+        case AST_AsmBinaryPacked_t:
         case AST_AsmCmp_t:
         case AST_AsmIdiv_t:
         case AST_AsmDiv_t:
@@ -541,6 +545,7 @@ static bool is_transfer_instr(Ctx ctx, size_t instr_idx
         case AST_AsmSetCC_t:
         case AST_AsmPush_t:
         case AST_AsmCall_t:
+        case AST_AsmTailCall_t:
             return true;
 #endif
         default:
@@ -798,6 +803,7 @@ static void dfa_forward_iter_alg(Ctx ctx) {
             }
         }
     }
+    REPORT_FUN_COUNT(ctx->report, dfa_iter_count, open_data_map_size);
 }
 #endif
 
@@ -834,6 +840,7 @@ static void dfa_iter_alg(Ctx ctx) {
             }
         }
     }
+    REPORT_FUN_COUNT(ctx->report, dfa_iter_count, open_data_map_size);
 }
 
 #if __OPTIM_LEVEL__ == 1
@@ -1205,6 +1212,18 @@ static bool init_data_flow_analysis(Ctx ctx,
                             infer_add_data_op(ctx, p_node->dst);
                             break;
                         }
+                        case AST_AsmMovPacked_t: {
+                            const AsmMovPacked* p_node = &node->get._AsmMovPacked;
+                            infer_add_data_op(ctx, p_node->src);
+                            infer_add_data_op(ctx, p_node->dst);
+                            break;
+                        }
+                        case AST_AsmBinaryPacked_t: {
+                            const AsmBinaryPacked* p_node = &node->get._AsmBinaryPacked;
+                            infer_add_data_op(ctx, p_node->src);
+                            infer_add_data_op(ctx, p_node->dst);
+                            break;
+                        }
                         case AST_AsmCmp_t: {
                             const AsmCmp* p_node = &node->get._AsmCmp;
                             infer_add_data_op(ctx, p_node->src);
@@ -1225,6 +1244,7 @@ static bool init_data_flow_analysis(Ctx ctx,
                             break;
                         case AST_AsmCdq_t:
                         case AST_AsmCall_t:
+                        case AST_AsmTailCall_t:
                             break;
 #endif
                         default:
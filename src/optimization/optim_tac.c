@@ -3,7 +3,9 @@
 #include "util/c_std.h"
 #include "util/str2t.h"
 #include "util/throw.h"
+#include "util/time_report.h"
 
+#include "ast/ast.h"
 #include "ast/front_ast.h"
 #include "ast/front_symt.h"
 #include "ast/interm_ast.h"
@@ -14,18 +16,33 @@
 typedef struct ControlFlowGraph ControlFlowGraph;
 typedef struct DataFlowAnalysis DataFlowAnalysis;
 typedef struct DataFlowAnalysisO1 DataFlowAnalysisO1;
+typedef struct DominatorAnalysis DominatorAnalysis;
+typedef struct ScalarReplacement ScalarReplacement;
+typedef struct LoopUnrolling LoopUnrolling;
+typedef struct LoopVectorization LoopVectorization;
 
 typedef struct OptimTacContext {
     FrontEndContext* frontend;
+    IdentifierContext* identifiers;
+    TimeReportContext* report;
     // Constant folding
     // Unreachable code elimination
     // Copy propagation
     // Dead store elimination
+    // Loop invariant code motion
+    // Global value numbering
+    // Scalar replacement of aggregates
+    // Loop unrolling
+    // Loop vectorization
     bool is_fixed_point;
-    bool enabled_optims[5];
+    bool enabled_optims[10];
     unique_ptr_t(ControlFlowGraph) cfg;
     unique_ptr_t(DataFlowAnalysis) dfa;
     unique_ptr_t(DataFlowAnalysisO1) dfa_o1;
+    unique_ptr_t(DominatorAnalysis) dom;
+    unique_ptr_t(ScalarReplacement) sra;
+    unique_ptr_t(LoopUnrolling) unroll;
+    unique_ptr_t(LoopVectorization) vector;
     vector_t(unique_ptr_t(TacInstruction)) * p_instrs;
 } OptimTacContext;
 
@@ -2624,33 +2641,3345 @@ static void eliminate_dead_stores(Ctx ctx, bool is_addressed_set) {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Loop invariant code motion
+
+typedef struct DominatorAnalysis {
+    // Dominator tree
+    vector_t(size_t) rpo_ids;
+    vector_t(size_t) rpo_idx_map;
+    vector_t(size_t) idom_ids;
+    vector_t(size_t) block_ids_stack;
+    vector_t(size_t) succ_idx_stack;
+    // Loop invariant code motion
+    vector_t(bool) hoist_blocks_map;
+    vector_t(size_t) loop_id_map;
+    vector_t(size_t) loop_block_ids;
+    vector_t(size_t) instr_block_map;
+    vector_t(size_t) preheader_idx_map;
+    vector_t(size_t) preheader_front_idxs;
+    vector_t(TIdentifier) use_names;
+    vector_t(size_t) use_instr_idxs;
+    vector_t(TIdentifier) def_names;
+    vector_t(size_t) def_instr_idxs;
+    hashmap_t(TIdentifier, size_t) use_count_map;
+    hashmap_t(TIdentifier, size_t) region_use_count_map;
+    hashmap_t(TIdentifier, size_t) region_def_idx_map;
+    vector_t(unique_ptr_t(TacInstruction)) hoist_instrs;
+    vector_t(unique_ptr_t(TacInstruction)) move_instrs;
+    // Global value numbering
+    vector_t(size_t) child_front_idxs;
+    vector_t(size_t) child_ids;
+    vector_t(size_t) block_def_front_idxs;
+    vector_t(size_t) undo_front_idxs_stack;
+    vector_t(hash_t) undo_hashes;
+    vector_t(size_t) undo_value_idxs;
+    hashmap_t(hash_t, size_t) value_idx_map;
+    hashmap_t(hash_t, size_t) local_value_idx_map;
+    hashmap_t(TIdentifier, size_t) local_def_idx_map;
+} DominatorAnalysis;
+
+static void free_DominatorAnalysis(unique_ptr_t(DominatorAnalysis) * self) {
+    uptr_delete(*self);
+    vec_delete((*self)->rpo_ids);
+    vec_delete((*self)->rpo_idx_map);
+    vec_delete((*self)->idom_ids);
+    vec_delete((*self)->block_ids_stack);
+    vec_delete((*self)->succ_idx_stack);
+    vec_delete((*self)->hoist_blocks_map);
+    vec_delete((*self)->loop_id_map);
+    vec_delete((*self)->loop_block_ids);
+    vec_delete((*self)->instr_block_map);
+    vec_delete((*self)->preheader_idx_map);
+    vec_delete((*self)->preheader_front_idxs);
+    vec_delete((*self)->use_names);
+    vec_delete((*self)->use_instr_idxs);
+    vec_delete((*self)->def_names);
+    vec_delete((*self)->def_instr_idxs);
+    map_delete((*self)->use_count_map);
+    map_delete((*self)->region_use_count_map);
+    map_delete((*self)->region_def_idx_map);
+    for (size_t i = 0; i < vec_size((*self)->hoist_instrs); ++i) {
+        free_TacInstruction(&(*self)->hoist_instrs[i]);
+    }
+    vec_delete((*self)->hoist_instrs);
+    for (size_t i = 0; i < vec_size((*self)->move_instrs); ++i) {
+        free_TacInstruction(&(*self)->move_instrs[i]);
+    }
+    vec_delete((*self)->move_instrs);
+    vec_delete((*self)->child_front_idxs);
+    vec_delete((*self)->child_ids);
+    vec_delete((*self)->block_def_front_idxs);
+    vec_delete((*self)->undo_front_idxs_stack);
+    vec_delete((*self)->undo_hashes);
+    vec_delete((*self)->undo_value_idxs);
+    map_delete((*self)->value_idx_map);
+    map_delete((*self)->local_value_idx_map);
+    map_delete((*self)->local_def_idx_map);
+    uptr_free(*self);
+}
+
+static unique_ptr_t(DominatorAnalysis) make_DominatorAnalysis(void) {
+    unique_ptr_t(DominatorAnalysis) self = uptr_new();
+    uptr_alloc(DominatorAnalysis, self);
+    self->rpo_ids = vec_new();
+    self->rpo_idx_map = vec_new();
+    self->idom_ids = vec_new();
+    self->block_ids_stack = vec_new();
+    self->succ_idx_stack = vec_new();
+    self->hoist_blocks_map = vec_new();
+    self->loop_id_map = vec_new();
+    self->loop_block_ids = vec_new();
+    self->instr_block_map = vec_new();
+    self->preheader_idx_map = vec_new();
+    self->preheader_front_idxs = vec_new();
+    self->use_names = vec_new();
+    self->use_instr_idxs = vec_new();
+    self->def_names = vec_new();
+    self->def_instr_idxs = vec_new();
+    self->use_count_map = map_new();
+    self->region_use_count_map = map_new();
+    self->region_def_idx_map = map_new();
+    self->hoist_instrs = vec_new();
+    self->move_instrs = vec_new();
+    self->child_front_idxs = vec_new();
+    self->child_ids = vec_new();
+    self->block_def_front_idxs = vec_new();
+    self->undo_front_idxs_stack = vec_new();
+    self->undo_hashes = vec_new();
+    self->undo_value_idxs = vec_new();
+    self->value_idx_map = map_new();
+    self->local_value_idx_map = map_new();
+    self->local_def_idx_map = map_new();
+    return self;
+}
+
+static void dom_init_rpo(Ctx ctx) {
+    vec_clear(ctx->dom->rpo_ids);
+    vec_clear(ctx->dom->block_ids_stack);
+    vec_clear(ctx->dom->succ_idx_stack);
+    for (size_t block_id = 0; block_id < vec_size(ctx->cfg->blocks); ++block_id) {
+        ctx->dom->rpo_idx_map[block_id] = ctx->cfg->exit_id;
+    }
+    ctx->dom->rpo_idx_map[0] = ctx->cfg->entry_id;
+    vec_push_back(ctx->dom->block_ids_stack, 0);
+    vec_push_back(ctx->dom->succ_idx_stack, 0);
+    while (!vec_empty(ctx->dom->block_ids_stack)) {
+        size_t block_id = vec_back(ctx->dom->block_ids_stack);
+        size_t i = vec_back(ctx->dom->succ_idx_stack);
+        if (i < vec_size(GET_CFG_BLOCK(block_id).succ_ids)) {
+            vec_back(ctx->dom->succ_idx_stack)++;
+            size_t succ_id = GET_CFG_BLOCK(block_id).succ_ids[i];
+            if (succ_id < ctx->cfg->exit_id && ctx->dom->rpo_idx_map[succ_id] == ctx->cfg->exit_id) {
+                ctx->dom->rpo_idx_map[succ_id] = ctx->cfg->entry_id;
+                vec_push_back(ctx->dom->block_ids_stack, succ_id);
+                vec_push_back(ctx->dom->succ_idx_stack, 0);
+            }
+        }
+        else {
+            vec_pop_back(ctx->dom->block_ids_stack);
+            vec_pop_back(ctx->dom->succ_idx_stack);
+            vec_push_back(ctx->dom->rpo_ids, block_id);
+        }
+    }
+    for (size_t i = 0, j = vec_size(ctx->dom->rpo_ids); i < --j; ++i) {
+        size_t block_id = ctx->dom->rpo_ids[i];
+        ctx->dom->rpo_ids[i] = ctx->dom->rpo_ids[j];
+        ctx->dom->rpo_ids[j] = block_id;
+    }
+    for (size_t i = 0; i < vec_size(ctx->dom->rpo_ids); ++i) {
+        ctx->dom->rpo_idx_map[ctx->dom->rpo_ids[i]] = i;
+    }
+}
+
+static size_t dom_intersect_idoms(Ctx ctx, size_t block_id_1, size_t block_id_2) {
+    while (block_id_1 != block_id_2) {
+        while (ctx->dom->rpo_idx_map[block_id_1] > ctx->dom->rpo_idx_map[block_id_2]) {
+            block_id_1 = ctx->dom->idom_ids[block_id_1];
+        }
+        while (ctx->dom->rpo_idx_map[block_id_2] > ctx->dom->rpo_idx_map[block_id_1]) {
+            block_id_2 = ctx->dom->idom_ids[block_id_2];
+        }
+    }
+    return block_id_1;
+}
+
+static void dom_init_idoms(Ctx ctx) {
+    for (size_t block_id = 0; block_id < vec_size(ctx->cfg->blocks); ++block_id) {
+        ctx->dom->idom_ids[block_id] = ctx->cfg->exit_id;
+    }
+    ctx->dom->idom_ids[0] = 0;
+    bool is_fixed_point = false;
+    while (!is_fixed_point) {
+        is_fixed_point = true;
+        for (size_t i = 1; i < vec_size(ctx->dom->rpo_ids); ++i) {
+            size_t block_id = ctx->dom->rpo_ids[i];
+            size_t idom_id = ctx->cfg->exit_id;
+            for (size_t j = 0; j < vec_size(GET_CFG_BLOCK(block_id).pred_ids); ++j) {
+                size_t pred_id = GET_CFG_BLOCK(block_id).pred_ids[j];
+                if (pred_id < ctx->cfg->exit_id && ctx->dom->idom_ids[pred_id] != ctx->cfg->exit_id) {
+                    idom_id = idom_id == ctx->cfg->exit_id ? pred_id : dom_intersect_idoms(ctx, idom_id, pred_id);
+                }
+            }
+            if (ctx->dom->idom_ids[block_id] != idom_id) {
+                ctx->dom->idom_ids[block_id] = idom_id;
+                is_fixed_point = false;
+            }
+        }
+    }
+}
+
+static void dom_init_tree(Ctx ctx) {
+    if (vec_size(ctx->dom->rpo_idx_map) < vec_size(ctx->cfg->blocks)) {
+        vec_resize(ctx->dom->rpo_idx_map, vec_size(ctx->cfg->blocks));
+        vec_resize(ctx->dom->idom_ids, vec_size(ctx->cfg->blocks));
+    }
+    if (vec_size(ctx->dom->instr_block_map) < vec_size(*ctx->p_instrs)) {
+        vec_resize(ctx->dom->instr_block_map, vec_size(*ctx->p_instrs));
+    }
+    dom_init_rpo(ctx);
+    dom_init_idoms(ctx);
+}
+
+static void dom_init_children(Ctx ctx) {
+    memset(ctx->dom->child_front_idxs, 0, sizeof(size_t) * (vec_size(ctx->cfg->blocks) + 1));
+    for (size_t i = 1; i < vec_size(ctx->dom->rpo_ids); ++i) {
+        ctx->dom->child_front_idxs[ctx->dom->idom_ids[ctx->dom->rpo_ids[i]]]++;
+    }
+    for (size_t block_id = 0; block_id < vec_size(ctx->cfg->blocks); ++block_id) {
+        ctx->dom->child_front_idxs[block_id + 1] += ctx->dom->child_front_idxs[block_id];
+    }
+    vec_resize(ctx->dom->child_ids, vec_size(ctx->dom->rpo_ids) - 1);
+    for (size_t i = vec_size(ctx->dom->rpo_ids); i-- > 1;) {
+        size_t block_id = ctx->dom->rpo_ids[i];
+        ctx->dom->child_ids[--ctx->dom->child_front_idxs[ctx->dom->idom_ids[block_id]]] = block_id;
+    }
+}
+
+static bool is_dominated_block(Ctx ctx, size_t dom_id, size_t block_id) {
+    while (ctx->dom->rpo_idx_map[block_id] > ctx->dom->rpo_idx_map[dom_id]) {
+        block_id = ctx->dom->idom_ids[block_id];
+    }
+    return block_id == dom_id;
+}
+
+static bool is_reachable_block(Ctx ctx, size_t block_id) {
+    return block_id < ctx->cfg->exit_id && ctx->dom->rpo_idx_map[block_id] < ctx->cfg->exit_id;
+}
+
+static void dom_transfer_src_name(Ctx ctx, TIdentifier name, size_t instr_idx, bool is_region) {
+    if (is_region) {
+        if (map_find(ctx->dom->region_use_count_map, name) == map_end()) {
+            map_add(ctx->dom->region_use_count_map, name, 1);
+        }
+        else {
+            map_get(ctx->dom->region_use_count_map, name)++;
+        }
+        vec_push_back(ctx->dom->use_names, name);
+        vec_push_back(ctx->dom->use_instr_idxs, instr_idx);
+    }
+    else {
+        if (map_find(ctx->dom->use_count_map, name) == map_end()) {
+            map_add(ctx->dom->use_count_map, name, 1);
+        }
+        else {
+            map_get(ctx->dom->use_count_map, name)++;
+        }
+    }
+}
+
+static void dom_transfer_src_value(Ctx ctx, const TacValue* node, size_t instr_idx, bool is_region) {
+    if (node->type == AST_TacVariable_t) {
+        dom_transfer_src_name(ctx, node->get._TacVariable.name, instr_idx, is_region);
+    }
+}
+
+static void dom_transfer_dst_name(Ctx ctx, TIdentifier name, size_t instr_idx, bool is_region) {
+    if (is_region) {
+        if (map_find(ctx->dom->region_def_idx_map, name) == map_end()) {
+            map_add(ctx->dom->region_def_idx_map, name, instr_idx);
+        }
+        else {
+            map_add(ctx->dom->region_def_idx_map, name, vec_size(*ctx->p_instrs));
+        }
+        vec_push_back(ctx->dom->def_names, name);
+        vec_push_back(ctx->dom->def_instr_idxs, instr_idx);
+    }
+}
+
+static void dom_transfer_dst_value(Ctx ctx, const TacValue* node, size_t instr_idx, bool is_region) {
+    THROW_ABORT_IF(node->type != AST_TacVariable_t);
+    dom_transfer_dst_name(ctx, node->get._TacVariable.name, instr_idx, is_region);
+}
+
+static void dom_transfer_instr(Ctx ctx, size_t instr_idx, bool is_region) {
+    const TacInstruction* node = GET_INSTR(instr_idx);
+    switch (node->type) {
+        case AST_TacReturn_t: {
+            const TacReturn* p_node = &node->get._TacReturn;
+            if (p_node->val) {
+                dom_transfer_src_value(ctx, p_node->val, instr_idx, is_region);
+            }
+            break;
+        }
+        case AST_TacSignExtend_t: {
+            const TacSignExtend* p_node = &node->get._TacSignExtend;
+            dom_transfer_dst_value(ctx, p_node->dst, instr_idx, is_region);
+            dom_transfer_src_value(ctx, p_node->src, instr_idx, is_region);
+            break;
+        }
+        case AST_TacTruncate_t: {
+            const TacTruncate* p_node = &node->get._TacTruncate;
+            dom_transfer_dst_value(ctx, p_node->dst, instr_idx, is_region);
+            dom_transfer_src_value(ctx, p_node->src, instr_idx, is_region);
+            break;
+        }
+        case AST_TacZeroExtend_t: {
+            const TacZeroExtend* p_node = &node->get._TacZeroExtend;
+            dom_transfer_dst_value(ctx, p_node->dst, instr_idx, is_region);
+            dom_transfer_src_value(ctx, p_node->src, instr_idx, is_region);
+            break;
+        }
+        case AST_TacDoubleToInt_t: {
+            const TacDoubleToInt* p_node = &node->get._TacDoubleToInt;
+            dom_transfer_dst_value(ctx, p_node->dst, instr_idx, is_region);
+            dom_transfer_src_value(ctx, p_node->src, instr_idx, is_region);
+            break;
+        }
+        case AST_TacDoubleToUInt_t: {
+            const TacDoubleToUInt* p_node = &node->get._TacDoubleToUInt;
+            dom_transfer_dst_value(ctx, p_node->dst, instr_idx, is_region);
+            dom_transfer_src_value(ctx, p_node->src, instr_idx, is_region);
+            break;
+        }
+        case AST_TacIntToDouble_t: {
+            const TacIntToDouble* p_node = &node->get._TacIntToDouble;
+            dom_transfer_dst_value(ctx, p_node->dst, instr_idx, is_region);
+            dom_transfer_src_value(ctx, p_node->src, instr_idx, is_region);
+            break;
+        }
+        case AST_TacUIntToDouble_t: {
+            const TacUIntToDouble* p_node = &node->get._TacUIntToDouble;
+            dom_transfer_dst_value(ctx, p_node->dst, instr_idx, is_region);
+            dom_transfer_src_value(ctx, p_node->src, instr_idx, is_region);
+            break;
+        }
+        case AST_TacFunCall_t: {
+            const TacFunCall* p_node = &node->get._TacFunCall;
+            if (p_node->dst) {
+                dom_transfer_dst_value(ctx, p_node->dst, instr_idx, is_region);
+            }
+            for (size_t i = 0; i < vec_size(p_node->args); ++i) {
+                dom_transfer_src_value(ctx, p_node->args[i], instr_idx, is_region);
+            }
+            break;
+        }
+        case AST_TacUnary_t: {
+            const TacUnary* p_node = &node->get._TacUnary;
+            dom_transfer_dst_value(ctx, p_node->dst, instr_idx, is_region);
+            dom_transfer_src_value(ctx, p_node->src, instr_idx, is_region);
+            break;
+        }
+        case AST_TacBinary_t: {
+            const TacBinary* p_node = &node->get._TacBinary;
+            dom_transfer_dst_value(ctx, p_node->dst, instr_idx, is_region);
+            dom_transfer_src_value(ctx, p_node->src1, instr_idx, is_region);
+            dom_transfer_src_value(ctx, p_node->src2, instr_idx, is_region);
+            break;
+        }
+        case AST_TacCopy_t: {
+            const TacCopy* p_node = &node->get._TacCopy;
+            dom_transfer_dst_value(ctx, p_node->dst, instr_idx, is_region);
+            dom_transfer_src_value(ctx, p_node->src, instr_idx, is_region);
+            break;
+        }
+        case AST_TacGetAddress_t: {
+            const TacGetAddress* p_node = &node->get._TacGetAddress;
+            dfa_add_aliased_value(ctx, p_node->src);
+            dom_transfer_dst_value(ctx, p_node->dst, instr_idx, is_region);
+            dom_transfer_src_value(ctx, p_node->src, instr_idx, is_region);
+            break;
+        }
+        case AST_TacLoad_t: {
+            const TacLoad* p_node = &node->get._TacLoad;
+            dom_transfer_dst_value(ctx, p_node->dst, instr_idx, is_region);
+            dom_transfer_src_value(ctx, p_node->src_ptr, instr_idx, is_region);
+            break;
+        }
+        case AST_TacStore_t: {
+            const TacStore* p_node = &node->get._TacStore;
+            dom_transfer_src_value(ctx, p_node->src, instr_idx, is_region);
+            dom_transfer_src_value(ctx, p_node->dst_ptr, instr_idx, is_region);
+            break;
+        }
+        case AST_TacAddPtr_t: {
+            const TacAddPtr* p_node = &node->get._TacAddPtr;
+            dom_transfer_dst_value(ctx, p_node->dst, instr_idx, is_region);
+            dom_transfer_src_value(ctx, p_node->src_ptr, instr_idx, is_region);
+            dom_transfer_src_value(ctx, p_node->idx, instr_idx, is_region);
+            break;
+        }
+        case AST_TacCopyToOffset_t: {
+            const TacCopyToOffset* p_node = &node->get._TacCopyToOffset;
+            dom_transfer_dst_name(ctx, p_node->dst_name, instr_idx, is_region);
+            dom_transfer_src_value(ctx, p_node->src, instr_idx, is_region);
+            break;
+        }
+        case AST_TacCopyFromOffset_t: {
+            const TacCopyFromOffset* p_node = &node->get._TacCopyFromOffset;
+            dom_transfer_dst_value(ctx, p_node->dst, instr_idx, is_region);
+            dom_transfer_src_name(ctx, p_node->src_name, instr_idx, is_region);
+            break;
+        }
+        case AST_TacJumpIfZero_t:
+            dom_transfer_src_value(ctx, node->get._TacJumpIfZero.condition, instr_idx, is_region);
+            break;
+        case AST_TacJumpIfNotZero_t:
+            dom_transfer_src_value(ctx, node->get._TacJumpIfNotZero.condition, instr_idx, is_region);
+            break;
+        case AST_TacJump_t:
+        case AST_TacLabel_t:
+            break;
+        default:
+            THROW_ABORT;
+    }
+}
+
+static void hoist_dominated_uses(Ctx ctx) {
+    for (size_t i = 0; i < vec_size(ctx->dom->use_names); ++i) {
+        TIdentifier name = ctx->dom->use_names[i];
+        if (map_find(ctx->dom->region_def_idx_map, name) != map_end()) {
+            size_t def_instr_idx = map_get(ctx->dom->region_def_idx_map, name);
+            if (def_instr_idx < vec_size(*ctx->p_instrs)) {
+                size_t use_instr_idx = ctx->dom->use_instr_idxs[i];
+                size_t def_block_id = ctx->dom->instr_block_map[def_instr_idx];
+                size_t use_block_id = ctx->dom->instr_block_map[use_instr_idx];
+                if (def_block_id == use_block_id ? def_instr_idx >= use_instr_idx
+                                                 : !is_dominated_block(ctx, def_block_id, use_block_id)) {
+                    map_add(ctx->dom->region_def_idx_map, name, vec_size(*ctx->p_instrs));
+                }
+            }
+        }
+    }
+}
+
+static bool is_hoist_src_value(Ctx ctx, const TacValue* node) {
+    if (node->type == AST_TacVariable_t) {
+        TIdentifier name = node->get._TacVariable.name;
+        return !is_aliased_name(ctx, name) && map_find(ctx->dom->region_def_idx_map, name) == map_end();
+    }
+    return true;
+}
+
+static bool is_hoist_dst_value(Ctx ctx, const TacValue* node, size_t instr_idx) {
+    THROW_ABORT_IF(node->type != AST_TacVariable_t);
+    TIdentifier name = node->get._TacVariable.name;
+    if (is_aliased_name(ctx, name) || map_find(ctx->dom->region_def_idx_map, name) == map_end()
+        || map_get(ctx->dom->region_def_idx_map, name) != instr_idx) {
+        return false;
+    }
+    switch (map_get(ctx->frontend->symbol_table, name)->type_t->type) {
+        case AST_Array_t:
+        case AST_Structure_t:
+            return false;
+        default:
+            break;
+    }
+    size_t use_count = 0;
+    if (map_find(ctx->dom->use_count_map, name) != map_end()) {
+        use_count = map_get(ctx->dom->use_count_map, name);
+    }
+    if (use_count > 0) {
+        return map_find(ctx->dom->region_use_count_map, name) != map_end()
+               && map_get(ctx->dom->region_use_count_map, name) == use_count;
+    }
+    return true;
+}
+
+static bool is_hoist_binary_trap(Ctx ctx, const TacBinary* node) {
+    switch (node->binop.type) {
+        case AST_TacDivide_t:
+        case AST_TacRemainder_t:
+            return map_get(ctx->frontend->symbol_table, node->dst->get._TacVariable.name)->type_t->type
+                   != AST_Double_t;
+        default:
+            return false;
+    }
+}
+
+static bool is_hoist_instr(Ctx ctx, size_t instr_idx) {
+    const TacInstruction* node = GET_INSTR(instr_idx);
+    switch (node->type) {
+        case AST_TacSignExtend_t: {
+            const TacSignExtend* p_node = &node->get._TacSignExtend;
+            return is_hoist_dst_value(ctx, p_node->dst, instr_idx) && is_hoist_src_value(ctx, p_node->src);
+        }
+        case AST_TacTruncate_t: {
+            const TacTruncate* p_node = &node->get._TacTruncate;
+            return is_hoist_dst_value(ctx, p_node->dst, instr_idx) && is_hoist_src_value(ctx, p_node->src);
+        }
+        case AST_TacZeroExtend_t: {
+            const TacZeroExtend* p_node = &node->get._TacZeroExtend;
+            return is_hoist_dst_value(ctx, p_node->dst, instr_idx) && is_hoist_src_value(ctx, p_node->src);
+        }
+        case AST_TacDoubleToInt_t: {
+            const TacDoubleToInt* p_node = &node->get._TacDoubleToInt;
+            return is_hoist_dst_value(ctx, p_node->dst, instr_idx) && is_hoist_src_value(ctx, p_node->src);
+        }
+        case AST_TacDoubleToUInt_t: {
+            const TacDoubleToUInt* p_node = &node->get._TacDoubleToUInt;
+            return is_hoist_dst_value(ctx, p_node->dst, instr_idx) && is_hoist_src_value(ctx, p_node->src);
+        }
+        case AST_TacIntToDouble_t: {
+            const TacIntToDouble* p_node = &node->get._TacIntToDouble;
+            return is_hoist_dst_value(ctx, p_node->dst, instr_idx) && is_hoist_src_value(ctx, p_node->src);
+        }
+        case AST_TacUIntToDouble_t: {
+            const TacUIntToDouble* p_node = &node->get._TacUIntToDouble;
+            return is_hoist_dst_value(ctx, p_node->dst, instr_idx) && is_hoist_src_value(ctx, p_node->src);
+        }
+        case AST_TacUnary_t: {
+            const TacUnary* p_node = &node->get._TacUnary;
+            return is_hoist_dst_value(ctx, p_node->dst, instr_idx) && is_hoist_src_value(ctx, p_node->src);
+        }
+        case AST_TacBinary_t: {
+            const TacBinary* p_node = &node->get._TacBinary;
+            return is_hoist_dst_value(ctx, p_node->dst, instr_idx) && !is_hoist_binary_trap(ctx, p_node)
+                   && is_hoist_src_value(ctx, p_node->src1) && is_hoist_src_value(ctx, p_node->src2);
+        }
+        case AST_TacCopy_t: {
+            const TacCopy* p_node = &node->get._TacCopy;
+            return is_hoist_dst_value(ctx, p_node->dst, instr_idx) && is_hoist_src_value(ctx, p_node->src);
+        }
+        case AST_TacAddPtr_t: {
+            const TacAddPtr* p_node = &node->get._TacAddPtr;
+            return is_hoist_dst_value(ctx, p_node->dst, instr_idx) && is_hoist_src_value(ctx, p_node->src_ptr)
+                   && is_hoist_src_value(ctx, p_node->idx);
+        }
+        default:
+            return false;
+    }
+}
+
+static shared_ptr_t(TacValue) get_dom_dst_value(const TacInstruction* node) {
+    switch (node->type) {
+        case AST_TacSignExtend_t:
+            return node->get._TacSignExtend.dst;
+        case AST_TacTruncate_t:
+            return node->get._TacTruncate.dst;
+        case AST_TacZeroExtend_t:
+            return node->get._TacZeroExtend.dst;
+        case AST_TacDoubleToInt_t:
+            return node->get._TacDoubleToInt.dst;
+        case AST_TacDoubleToUInt_t:
+            return node->get._TacDoubleToUInt.dst;
+        case AST_TacIntToDouble_t:
+            return node->get._TacIntToDouble.dst;
+        case AST_TacUIntToDouble_t:
+            return node->get._TacUIntToDouble.dst;
+        case AST_TacUnary_t:
+            return node->get._TacUnary.dst;
+        case AST_TacBinary_t:
+            return node->get._TacBinary.dst;
+        case AST_TacCopy_t:
+            return node->get._TacCopy.dst;
+        case AST_TacAddPtr_t:
+            return node->get._TacAddPtr.dst;
+        default:
+            THROW_ABORT;
+    }
+}
+
+static bool hoist_loop_instr(Ctx ctx, size_t instr_idx) {
+    if (!is_hoist_instr(ctx, instr_idx)) {
+        return false;
+    }
+    map_erase(ctx->dom->region_def_idx_map, get_dom_dst_value(GET_INSTR(instr_idx))->get._TacVariable.name);
+    vec_move_back(ctx->dom->hoist_instrs, GET_INSTR(instr_idx));
+    return true;
+}
+
+static void hoist_loop_blocks(Ctx ctx, size_t header_id) {
+    size_t loop_id = header_id + 1;
+    vec_clear(ctx->dom->loop_block_ids);
+    vec_clear(ctx->dom->block_ids_stack);
+    ctx->dom->loop_id_map[header_id] = loop_id;
+    vec_push_back(ctx->dom->loop_block_ids, header_id);
+    for (size_t i = 0; i < vec_size(GET_CFG_BLOCK(header_id).pred_ids); ++i) {
+        size_t pred_id = GET_CFG_BLOCK(header_id).pred_ids[i];
+        if (is_reachable_block(ctx, pred_id) && is_dominated_block(ctx, header_id, pred_id)
+            && ctx->dom->loop_id_map[pred_id] != loop_id) {
+            ctx->dom->loop_id_map[pred_id] = loop_id;
+            vec_push_back(ctx->dom->loop_block_ids, pred_id);
+            vec_push_back(ctx->dom->block_ids_stack, pred_id);
+        }
+    }
+    while (!vec_empty(ctx->dom->block_ids_stack)) {
+        size_t block_id = vec_back(ctx->dom->block_ids_stack);
+        vec_pop_back(ctx->dom->block_ids_stack);
+        for (size_t i = 0; i < vec_size(GET_CFG_BLOCK(block_id).pred_ids); ++i) {
+            size_t pred_id = GET_CFG_BLOCK(block_id).pred_ids[i];
+            if (is_reachable_block(ctx, pred_id) && ctx->dom->loop_id_map[pred_id] != loop_id) {
+                ctx->dom->loop_id_map[pred_id] = loop_id;
+                vec_push_back(ctx->dom->loop_block_ids, pred_id);
+                vec_push_back(ctx->dom->block_ids_stack, pred_id);
+            }
+        }
+    }
+}
+
+static bool hoist_preheader_idx(Ctx ctx, size_t header_id, size_t* instr_idx) {
+    size_t loop_id = header_id + 1;
+    size_t preheader_id = ctx->cfg->exit_id;
+    for (size_t i = 0; i < vec_size(GET_CFG_BLOCK(header_id).pred_ids); ++i) {
+        size_t pred_id = GET_CFG_BLOCK(header_id).pred_ids[i];
+        if (pred_id == ctx->cfg->entry_id || ctx->dom->loop_id_map[pred_id] != loop_id) {
+            if (preheader_id != ctx->cfg->exit_id) {
+                return false;
+            }
+            preheader_id = pred_id;
+        }
+    }
+    *instr_idx = GET_CFG_BLOCK(header_id).instrs_front_idx;
+    if (GET_INSTR(*instr_idx)->type != AST_TacLabel_t) {
+        return false;
+    }
+    else if (preheader_id == ctx->cfg->entry_id) {
+        return header_id == 0;
+    }
+    else if (preheader_id != header_id - 1) {
+        return false;
+    }
+    const TacInstruction* node = GET_INSTR(GET_CFG_BLOCK(preheader_id).instrs_back_idx);
+    switch (node->type) {
+        case AST_TacJump_t:
+            *instr_idx = GET_CFG_BLOCK(preheader_id).instrs_back_idx;
+            return true;
+        case AST_TacJumpIfZero_t:
+            return map_get(ctx->cfg->identifier_id_map, node->get._TacJumpIfZero.target) != header_id;
+        case AST_TacJumpIfNotZero_t:
+            return map_get(ctx->cfg->identifier_id_map, node->get._TacJumpIfNotZero.target) != header_id;
+        default:
+            return true;
+    }
+}
+
+static void hoist_loop(Ctx ctx, size_t header_id) {
+    hoist_loop_blocks(ctx, header_id);
+    for (size_t i = 0; i < vec_size(ctx->dom->loop_block_ids); ++i) {
+        if (ctx->dom->hoist_blocks_map[ctx->dom->loop_block_ids[i]]) {
+            return;
+        }
+    }
+    size_t preheader_idx;
+    if (!hoist_preheader_idx(ctx, header_id, &preheader_idx)) {
+        return;
+    }
+
+    map_clear(ctx->dom->region_use_count_map);
+    map_clear(ctx->dom->region_def_idx_map);
+    vec_clear(ctx->dom->use_names);
+    vec_clear(ctx->dom->use_instr_idxs);
+    vec_clear(ctx->dom->def_names);
+    vec_clear(ctx->dom->def_instr_idxs);
+    for (size_t i = 0; i < vec_size(ctx->dom->loop_block_ids); ++i) {
+        size_t block_id = ctx->dom->loop_block_ids[i];
+        for (size_t instr_idx = GET_CFG_BLOCK(block_id).instrs_front_idx;
+             instr_idx <= GET_CFG_BLOCK(block_id).instrs_back_idx; ++instr_idx) {
+            if (GET_INSTR(instr_idx)) {
+                ctx->dom->instr_block_map[instr_idx] = block_id;
+                dom_transfer_instr(ctx, instr_idx, true);
+            }
+        }
+    }
+    hoist_dominated_uses(ctx);
+
+    size_t hoist_front_idx = vec_size(ctx->dom->hoist_instrs);
+    bool is_fixed_point = false;
+    while (!is_fixed_point) {
+        is_fixed_point = true;
+        for (size_t i = 0; i < vec_size(ctx->dom->loop_block_ids); ++i) {
+            size_t block_id = ctx->dom->loop_block_ids[i];
+            for (size_t instr_idx = GET_CFG_BLOCK(block_id).instrs_front_idx;
+                 instr_idx <= GET_CFG_BLOCK(block_id).instrs_back_idx; ++instr_idx) {
+                if (GET_INSTR(instr_idx) && hoist_loop_instr(ctx, instr_idx)) {
+                    is_fixed_point = false;
+                }
+            }
+        }
+    }
+    if (vec_size(ctx->dom->hoist_instrs) > hoist_front_idx) {
+        for (size_t i = 0; i < vec_size(ctx->dom->loop_block_ids); ++i) {
+            ctx->dom->hoist_blocks_map[ctx->dom->loop_block_ids[i]] = true;
+        }
+        vec_push_back(ctx->dom->preheader_front_idxs, hoist_front_idx);
+        ctx->dom->preheader_idx_map[preheader_idx] = vec_size(ctx->dom->preheader_front_idxs);
+    }
+}
+
+static void hoist_preheader_instrs(Ctx ctx) {
+    vec_push_back(ctx->dom->preheader_front_idxs, vec_size(ctx->dom->hoist_instrs));
+    vec_clear(ctx->dom->move_instrs);
+    for (size_t instr_idx = 0; instr_idx < vec_size(*ctx->p_instrs); ++instr_idx) {
+        if (ctx->dom->preheader_idx_map[instr_idx] > 0) {
+            size_t i = ctx->dom->preheader_idx_map[instr_idx] - 1;
+            for (size_t j = ctx->dom->preheader_front_idxs[i]; j < ctx->dom->preheader_front_idxs[i + 1]; ++j) {
+                vec_move_back(ctx->dom->move_instrs, ctx->dom->hoist_instrs[j]);
+            }
+            ctx->dom->preheader_idx_map[instr_idx] = 0;
+        }
+        if (GET_INSTR(instr_idx)) {
+            vec_move_back(ctx->dom->move_instrs, GET_INSTR(instr_idx));
+        }
+    }
+    {
+        vector_t(unique_ptr_t(TacInstruction)) instrs = *ctx->p_instrs;
+        *ctx->p_instrs = ctx->dom->move_instrs;
+        ctx->dom->move_instrs = instrs;
+    }
+    vec_clear(ctx->dom->move_instrs);
+    vec_clear(ctx->dom->hoist_instrs);
+    vec_clear(ctx->dom->preheader_front_idxs);
+    ctx->is_fixed_point = false;
+}
+
+static void hoist_loop_invariants(Ctx ctx) {
+    init_control_flow_graph(ctx);
+    if (vec_empty(ctx->cfg->blocks)) {
+        return;
+    }
+    if (vec_size(ctx->dom->hoist_blocks_map) < vec_size(ctx->cfg->blocks)) {
+        vec_resize(ctx->dom->hoist_blocks_map, vec_size(ctx->cfg->blocks));
+        vec_resize(ctx->dom->loop_id_map, vec_size(ctx->cfg->blocks));
+    }
+    memset(ctx->dom->hoist_blocks_map, false, sizeof(bool) * vec_size(ctx->cfg->blocks));
+    memset(ctx->dom->loop_id_map, 0, sizeof(size_t) * vec_size(ctx->cfg->blocks));
+    if (vec_size(ctx->dom->preheader_idx_map) < vec_size(*ctx->p_instrs)) {
+        size_t i = vec_size(ctx->dom->preheader_idx_map);
+        vec_resize(ctx->dom->preheader_idx_map, vec_size(*ctx->p_instrs));
+        memset(ctx->dom->preheader_idx_map + i, 0, sizeof(size_t) * (vec_size(*ctx->p_instrs) - i));
+    }
+    dom_init_tree(ctx);
+
+    map_clear(ctx->dom->use_count_map);
+    for (size_t instr_idx = 0; instr_idx < vec_size(*ctx->p_instrs); ++instr_idx) {
+        if (GET_INSTR(instr_idx)) {
+            dom_transfer_instr(ctx, instr_idx, false);
+        }
+    }
+
+    for (size_t i = vec_size(ctx->dom->rpo_ids); i-- > 0;) {
+        size_t header_id = ctx->dom->rpo_ids[i];
+        for (size_t j = 0; j < vec_size(GET_CFG_BLOCK(header_id).pred_ids); ++j) {
+            size_t pred_id = GET_CFG_BLOCK(header_id).pred_ids[j];
+            if (is_reachable_block(ctx, pred_id) && is_dominated_block(ctx, header_id, pred_id)) {
+                hoist_loop(ctx, header_id);
+                break;
+            }
+        }
+    }
+    if (!vec_empty(ctx->dom->hoist_instrs)) {
+        hoist_preheader_instrs(ctx);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Global value numbering
+
+static hash_t gvn_hash_combine(hash_t hash, size_t value) {
+    return hash ^ (value + 0x9e3779b9u + (hash << 6) + (hash >> 2));
+}
+
+static size_t gvn_hash_const(const CConst* node) {
+    switch (node->type) {
+        case AST_CConstChar_t:
+            return (size_t)node->get._CConstChar.value;
+        case AST_CConstInt_t:
+            return (size_t)node->get._CConstInt.value;
+        case AST_CConstLong_t:
+            return (size_t)node->get._CConstLong.value;
+        case AST_CConstDouble_t: {
+            TDouble value = node->get._CConstDouble.value;
+            return value != value ? 0 : (size_t)dbl_to_binary(value);
+        }
+        case AST_CConstUChar_t:
+            return (size_t)node->get._CConstUChar.value;
+        case AST_CConstUInt_t:
+            return (size_t)node->get._CConstUInt.value;
+        case AST_CConstULong_t:
+            return (size_t)node->get._CConstULong.value;
+        default:
+            THROW_ABORT;
+    }
+}
+
+static hash_t gvn_hash_value(const TacValue* node) {
+    switch (node->type) {
+        case AST_TacConstant_t: {
+            const CConst* constant = node->get._TacConstant.constant;
+            return gvn_hash_combine(
+                gvn_hash_combine((hash_t)node->type, (size_t)constant->type), gvn_hash_const(constant));
+        }
+        case AST_TacVariable_t:
+            return gvn_hash_combine((hash_t)node->type, node->get._TacVariable.name);
+        default:
+            THROW_ABORT;
+    }
+}
+
+static size_t gvn_src_values(const TacInstruction* node, const TacValue** src_values) {
+    switch (node->type) {
+        case AST_TacSignExtend_t:
+            src_values[0] = node->get._TacSignExtend.src;
+            return 1;
+        case AST_TacTruncate_t:
+            src_values[0] = node->get._TacTruncate.src;
+            return 1;
+        case AST_TacZeroExtend_t:
+            src_values[0] = node->get._TacZeroExtend.src;
+            return 1;
+        case AST_TacDoubleToInt_t:
+            src_values[0] = node->get._TacDoubleToInt.src;
+            return 1;
+        case AST_TacDoubleToUInt_t:
+            src_values[0] = node->get._TacDoubleToUInt.src;
+            return 1;
+        case AST_TacIntToDouble_t:
+            src_values[0] = node->get._TacIntToDouble.src;
+            return 1;
+        case AST_TacUIntToDouble_t:
+            src_values[0] = node->get._TacUIntToDouble.src;
+            return 1;
+        case AST_TacUnary_t:
+            src_values[0] = node->get._TacUnary.src;
+            return 1;
+        case AST_TacBinary_t:
+            src_values[0] = node->get._TacBinary.src1;
+            src_values[1] = node->get._TacBinary.src2;
+            return 2;
+        case AST_TacAddPtr_t:
+            src_values[0] = node->get._TacAddPtr.src_ptr;
+            src_values[1] = node->get._TacAddPtr.idx;
+            return 2;
+        default:
+            return 0;
+    }
+}
+
+static bool is_gvn_commutative_binary(const TacBinary* node) {
+    switch (node->binop.type) {
+        case AST_TacAdd_t:
+        case AST_TacMultiply_t:
+        case AST_TacBitAnd_t:
+        case AST_TacBitOr_t:
+        case AST_TacBitXor_t:
+        case AST_TacEqual_t:
+        case AST_TacNotEqual_t:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool gvn_hash_instr(Ctx ctx, const TacInstruction* node, hash_t* hash) {
+    const TacValue* src_values[2];
+    size_t src_size = gvn_src_values(node, src_values);
+    if (src_size == 0) {
+        return false;
+    }
+    TIdentifier name = get_dom_dst_value(node)->get._TacVariable.name;
+    if (is_aliased_name(ctx, name)) {
+        return false;
+    }
+    switch (map_get(ctx->frontend->symbol_table, name)->type_t->type) {
+        case AST_Array_t:
+        case AST_Structure_t:
+            return false;
+        default:
+            break;
+    }
+
+    hash_t src_hashes[2];
+    for (size_t i = 0; i < src_size; ++i) {
+        if (src_values[i]->type == AST_TacVariable_t && is_aliased_name(ctx, src_values[i]->get._TacVariable.name)) {
+            return false;
+        }
+        src_hashes[i] = gvn_hash_value(src_values[i]);
+    }
+    *hash = gvn_hash_combine(
+        (hash_t)node->type, (size_t)map_get(ctx->frontend->symbol_table, name)->type_t->type);
+    switch (node->type) {
+        case AST_TacUnary_t:
+            *hash = gvn_hash_combine(*hash, (size_t)node->get._TacUnary.unop.type);
+            break;
+        case AST_TacBinary_t: {
+            *hash = gvn_hash_combine(*hash, (size_t)node->get._TacBinary.binop.type);
+            if (is_gvn_commutative_binary(&node->get._TacBinary) && src_hashes[0] > src_hashes[1]) {
+                hash_t src_hash = src_hashes[0];
+                src_hashes[0] = src_hashes[1];
+                src_hashes[1] = src_hash;
+            }
+            break;
+        }
+        case AST_TacAddPtr_t:
+            *hash = gvn_hash_combine(*hash, (size_t)node->get._TacAddPtr.scale);
+            break;
+        default:
+            break;
+    }
+    for (size_t i = 0; i < src_size; ++i) {
+        *hash = gvn_hash_combine(*hash, src_hashes[i]);
+    }
+    return true;
+}
+
+static bool is_gvn_same_instr(Ctx ctx, const TacInstruction* node_1, const TacInstruction* node_2) {
+    if (node_1->type != node_2->type) {
+        return false;
+    }
+    {
+        const Type* dst_type_1 =
+            map_get(ctx->frontend->symbol_table, get_dom_dst_value(node_1)->get._TacVariable.name)->type_t;
+        const Type* dst_type_2 =
+            map_get(ctx->frontend->symbol_table, get_dom_dst_value(node_2)->get._TacVariable.name)->type_t;
+        if (dst_type_1->type != dst_type_2->type) {
+            return false;
+        }
+    }
+    const TacValue* src_values_1[2];
+    const TacValue* src_values_2[2];
+    size_t src_size = gvn_src_values(node_1, src_values_1);
+    gvn_src_values(node_2, src_values_2);
+    switch (node_1->type) {
+        case AST_TacUnary_t: {
+            if (node_1->get._TacUnary.unop.type != node_2->get._TacUnary.unop.type) {
+                return false;
+            }
+            break;
+        }
+        case AST_TacBinary_t: {
+            if (node_1->get._TacBinary.binop.type != node_2->get._TacBinary.binop.type) {
+                return false;
+            }
+            else if (is_gvn_commutative_binary(&node_1->get._TacBinary)
+                     && !is_same_value(src_values_1[0], src_values_2[0])) {
+                const TacValue* src_value = src_values_2[0];
+                src_values_2[0] = src_values_2[1];
+                src_values_2[1] = src_value;
+            }
+            break;
+        }
+        case AST_TacAddPtr_t: {
+            if (node_1->get._TacAddPtr.scale != node_2->get._TacAddPtr.scale) {
+                return false;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    for (size_t i = 0; i < src_size; ++i) {
+        if (!is_same_value(src_values_1[i], src_values_2[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool is_gvn_stable_src_value(Ctx ctx, const TacValue* node, size_t instr_idx) {
+    if (node->type == AST_TacVariable_t) {
+        TIdentifier name = node->get._TacVariable.name;
+        if (map_find(ctx->dom->region_def_idx_map, name) != map_end()) {
+            size_t def_instr_idx = map_get(ctx->dom->region_def_idx_map, name);
+            if (def_instr_idx >= vec_size(*ctx->p_instrs)) {
+                return false;
+            }
+            size_t def_block_id = ctx->dom->instr_block_map[def_instr_idx];
+            size_t block_id = ctx->dom->instr_block_map[instr_idx];
+            return def_block_id == block_id ? def_instr_idx < instr_idx
+                                            : is_reachable_block(ctx, def_block_id)
+                                                  && is_dominated_block(ctx, def_block_id, block_id);
+        }
+    }
+    return true;
+}
+
+static bool is_gvn_stable_instr(Ctx ctx, size_t instr_idx) {
+    const TacInstruction* node = GET_INSTR(instr_idx);
+    TIdentifier name = get_dom_dst_value(node)->get._TacVariable.name;
+    if (map_get(ctx->dom->region_def_idx_map, name) != instr_idx) {
+        return false;
+    }
+    const TacValue* src_values[2];
+    size_t src_size = gvn_src_values(node, src_values);
+    for (size_t i = 0; i < src_size; ++i) {
+        if (!is_gvn_stable_src_value(ctx, src_values[i], instr_idx)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool is_gvn_local_instr(Ctx ctx, size_t instr_idx) {
+    const TacInstruction* node = GET_INSTR(instr_idx);
+    TIdentifier name = get_dom_dst_value(node)->get._TacVariable.name;
+    if (map_find(ctx->dom->local_def_idx_map, name) == map_end()
+        || map_get(ctx->dom->local_def_idx_map, name) != instr_idx) {
+        return false;
+    }
+    const TacValue* src_values[2];
+    size_t src_size = gvn_src_values(node, src_values);
+    for (size_t i = 0; i < src_size; ++i) {
+        if (src_values[i]->type == AST_TacVariable_t) {
+            name = src_values[i]->get._TacVariable.name;
+            if (map_find(ctx->dom->local_def_idx_map, name) != map_end()
+                && map_get(ctx->dom->local_def_idx_map, name) >= instr_idx) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void gvn_replace_instr(Ctx ctx, size_t value_idx, size_t instr_idx) {
+    shared_ptr_t(TacValue) value_dst = get_dom_dst_value(GET_INSTR(value_idx));
+    shared_ptr_t(TacValue) instr_dst = get_dom_dst_value(GET_INSTR(instr_idx));
+    if (is_same_value(value_dst, instr_dst)) {
+        set_instr(ctx, uptr_new(), instr_idx);
+    }
+    else {
+        shared_ptr_t(TacValue) src = sptr_new();
+        sptr_copy(TacValue, value_dst, src);
+        shared_ptr_t(TacValue) dst = sptr_new();
+        sptr_copy(TacValue, instr_dst, dst);
+        set_instr(ctx, make_TacCopy(&src, &dst), instr_idx);
+    }
+}
+
+static void gvn_add_value(Ctx ctx, hash_t hash, size_t instr_idx) {
+    vec_push_back(ctx->dom->undo_hashes, hash);
+    if (map_find(ctx->dom->value_idx_map, hash) != map_end()) {
+        vec_push_back(ctx->dom->undo_value_idxs, map_get(ctx->dom->value_idx_map, hash));
+    }
+    else {
+        vec_push_back(ctx->dom->undo_value_idxs, vec_size(*ctx->p_instrs));
+    }
+    map_add(ctx->dom->value_idx_map, hash, instr_idx);
+}
+
+static void gvn_undo_values(Ctx ctx, size_t undo_front_idx) {
+    while (vec_size(ctx->dom->undo_hashes) > undo_front_idx) {
+        hash_t hash = vec_back(ctx->dom->undo_hashes);
+        size_t value_idx = vec_back(ctx->dom->undo_value_idxs);
+        if (value_idx < vec_size(*ctx->p_instrs)) {
+            map_add(ctx->dom->value_idx_map, hash, value_idx);
+        }
+        else {
+            map_erase(ctx->dom->value_idx_map, hash);
+        }
+        vec_pop_back(ctx->dom->undo_hashes);
+        vec_pop_back(ctx->dom->undo_value_idxs);
+    }
+}
+
+static void gvn_instr(Ctx ctx, size_t instr_idx) {
+    hash_t hash;
+    if (!gvn_hash_instr(ctx, GET_INSTR(instr_idx), &hash)) {
+        return;
+    }
+    if (map_find(ctx->dom->local_value_idx_map, hash) != map_end()) {
+        size_t value_idx = map_get(ctx->dom->local_value_idx_map, hash);
+        if (is_gvn_local_instr(ctx, value_idx) && is_gvn_same_instr(ctx, GET_INSTR(value_idx), GET_INSTR(instr_idx))) {
+            gvn_replace_instr(ctx, value_idx, instr_idx);
+            return;
+        }
+    }
+    if (map_find(ctx->dom->value_idx_map, hash) != map_end()) {
+        size_t value_idx = map_get(ctx->dom->value_idx_map, hash);
+        if (is_gvn_same_instr(ctx, GET_INSTR(value_idx), GET_INSTR(instr_idx))) {
+            gvn_replace_instr(ctx, value_idx, instr_idx);
+            return;
+        }
+    }
+    map_add(ctx->dom->local_value_idx_map, hash, instr_idx);
+    if (is_gvn_stable_instr(ctx, instr_idx)) {
+        gvn_add_value(ctx, hash, instr_idx);
+    }
+}
+
+static void gvn_block(Ctx ctx, size_t block_id) {
+    map_clear(ctx->dom->local_value_idx_map);
+    map_clear(ctx->dom->local_def_idx_map);
+    size_t i = ctx->dom->block_def_front_idxs[block_id];
+    for (size_t instr_idx = GET_CFG_BLOCK(block_id).instrs_front_idx;
+         instr_idx <= GET_CFG_BLOCK(block_id).instrs_back_idx; ++instr_idx) {
+        if (GET_INSTR(instr_idx)) {
+            gvn_instr(ctx, instr_idx);
+        }
+        for (; i < vec_size(ctx->dom->def_instr_idxs) && ctx->dom->def_instr_idxs[i] == instr_idx; ++i) {
+            map_add(ctx->dom->local_def_idx_map, ctx->dom->def_names[i], instr_idx);
+        }
+    }
+}
+
+static void gvn_enter_block(Ctx ctx, size_t block_id) {
+    vec_push_back(ctx->dom->block_ids_stack, block_id);
+    vec_push_back(ctx->dom->succ_idx_stack, ctx->dom->child_front_idxs[block_id]);
+    vec_push_back(ctx->dom->undo_front_idxs_stack, vec_size(ctx->dom->undo_hashes));
+    gvn_block(ctx, block_id);
+}
+
+static void number_global_values(Ctx ctx) {
+    init_control_flow_graph(ctx);
+    if (vec_empty(ctx->cfg->blocks)) {
+        return;
+    }
+    if (vec_size(ctx->dom->block_def_front_idxs) < vec_size(ctx->cfg->blocks)) {
+        vec_resize(ctx->dom->block_def_front_idxs, vec_size(ctx->cfg->blocks));
+        vec_resize(ctx->dom->child_front_idxs, vec_size(ctx->cfg->blocks) + 1);
+    }
+    dom_init_tree(ctx);
+    dom_init_children(ctx);
+
+    map_clear(ctx->dom->region_use_count_map);
+    map_clear(ctx->dom->region_def_idx_map);
+    vec_clear(ctx->dom->use_names);
+    vec_clear(ctx->dom->use_instr_idxs);
+    vec_clear(ctx->dom->def_names);
+    vec_clear(ctx->dom->def_instr_idxs);
+    for (size_t block_id = 0; block_id < vec_size(ctx->cfg->blocks); ++block_id) {
+        ctx->dom->block_def_front_idxs[block_id] = vec_size(ctx->dom->def_names);
+        for (size_t instr_idx = GET_CFG_BLOCK(block_id).instrs_front_idx;
+             instr_idx <= GET_CFG_BLOCK(block_id).instrs_back_idx; ++instr_idx) {
+            if (GET_INSTR(instr_idx)) {
+                ctx->dom->instr_block_map[instr_idx] = block_id;
+                dom_transfer_instr(ctx, instr_idx, true);
+            }
+        }
+    }
+
+    vec_clear(ctx->dom->block_ids_stack);
+    vec_clear(ctx->dom->succ_idx_stack);
+    vec_clear(ctx->dom->undo_front_idxs_stack);
+    gvn_enter_block(ctx, 0);
+    while (!vec_empty(ctx->dom->block_ids_stack)) {
+        size_t block_id = vec_back(ctx->dom->block_ids_stack);
+        size_t i = vec_back(ctx->dom->succ_idx_stack);
+        if (i < ctx->dom->child_front_idxs[block_id + 1]) {
+            vec_back(ctx->dom->succ_idx_stack)++;
+            gvn_enter_block(ctx, ctx->dom->child_ids[i]);
+        }
+        else {
+            gvn_undo_values(ctx, vec_back(ctx->dom->undo_front_idxs_stack));
+            vec_pop_back(ctx->dom->block_ids_stack);
+            vec_pop_back(ctx->dom->succ_idx_stack);
+            vec_pop_back(ctx->dom->undo_front_idxs_stack);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Scalar replacement of aggregates
+
+typedef struct SraAggregate {
+    size_t fields_front_idx;
+    size_t fields_size;
+    bool is_split;
+    bool is_accessed;
+} SraAggregate;
+
+PairKeyValue(TIdentifier, SraAggregate);
+
+typedef struct ScalarReplacement {
+    hashmap_t(TIdentifier, SraAggregate) aggregate_map;
+    vector_t(TLong) field_offsets;
+    vector_t(Type*) field_types;
+    vector_t(TIdentifier) field_names;
+    vector_t(unique_ptr_t(TacInstruction)) split_instrs;
+} ScalarReplacement;
+
+static void free_ScalarReplacement(unique_ptr_t(ScalarReplacement) * self) {
+    uptr_delete(*self);
+    map_delete((*self)->aggregate_map);
+    vec_delete((*self)->field_offsets);
+    vec_delete((*self)->field_types);
+    vec_delete((*self)->field_names);
+    for (size_t i = 0; i < vec_size((*self)->split_instrs); ++i) {
+        free_TacInstruction(&(*self)->split_instrs[i]);
+    }
+    vec_delete((*self)->split_instrs);
+    uptr_free(*self);
+}
+
+static unique_ptr_t(ScalarReplacement) make_ScalarReplacement(void) {
+    unique_ptr_t(ScalarReplacement) self = uptr_new();
+    uptr_alloc(ScalarReplacement, self);
+    self->aggregate_map = map_new();
+    self->field_offsets = vec_new();
+    self->field_types = vec_new();
+    self->field_names = vec_new();
+    self->split_instrs = vec_new();
+    return self;
+}
+
+static TLong sra_scalar_size(const Type* type) {
+    switch (type->type) {
+        case AST_Char_t:
+        case AST_SChar_t:
+        case AST_UChar_t:
+            return 1l;
+        case AST_Int_t:
+        case AST_UInt_t:
+            return 4l;
+        case AST_Long_t:
+        case AST_ULong_t:
+        case AST_Double_t:
+        case AST_Pointer_t:
+            return 8l;
+        default:
+            return 0l;
+    }
+}
+
+static TLong sra_value_size(Ctx ctx, const TacValue* node, bool* is_dbl) {
+    switch (node->type) {
+        case AST_TacConstant_t: {
+            const CConst* constant = node->get._TacConstant.constant;
+            *is_dbl = constant->type == AST_CConstDouble_t;
+            switch (constant->type) {
+                case AST_CConstChar_t:
+                case AST_CConstUChar_t:
+                    return 1l;
+                case AST_CConstInt_t:
+                case AST_CConstUInt_t:
+                    return 4l;
+                case AST_CConstLong_t:
+                case AST_CConstULong_t:
+                case AST_CConstDouble_t:
+                    return 8l;
+                default:
+                    THROW_ABORT;
+            }
+        }
+        case AST_TacVariable_t: {
+            const Type* type = map_get(ctx->frontend->symbol_table, node->get._TacVariable.name)->type_t;
+            *is_dbl = type->type == AST_Double_t;
+            return sra_scalar_size(type);
+        }
+        default:
+            THROW_ABORT;
+    }
+}
+
+static bool sra_flatten_fields(Ctx ctx, const Structure* struct_type, TLong offset) {
+    if (struct_type->is_union) {
+        return false;
+    }
+    const StructTypedef* struct_typedef = map_get(ctx->frontend->struct_typedef_table, struct_type->tag);
+    for (size_t i = 0; i < vec_size(struct_typedef->member_names); ++i) {
+        const StructMember* member = get_struct_typedef_member(ctx->frontend, struct_type->tag, i);
+        Type* member_type = member->member_type;
+        if (member_type->type == AST_Structure_t) {
+            if (!sra_flatten_fields(ctx, &member_type->get._Structure, offset + member->offset)) {
+                return false;
+            }
+        }
+        else if (sra_scalar_size(member_type) > 0l) {
+            vec_push_back(ctx->sra->field_offsets, offset + member->offset);
+            vec_push_back(ctx->sra->field_types, member_type);
+        }
+        else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Only small local structures are split, so that their members can all be kept in registers
+static SraAggregate* sra_get_aggregate(Ctx ctx, TIdentifier name) {
+    if (map_find(ctx->sra->aggregate_map, name) == map_end()) {
+        const Symbol* symbol = map_get(ctx->frontend->symbol_table, name);
+        if (symbol->type_t->type != AST_Structure_t || symbol->attrs->type != AST_LocalAttr_t) {
+            return NULL;
+        }
+        SraAggregate aggregate = {vec_size(ctx->sra->field_offsets), 0, false, false};
+        aggregate.is_split = sra_flatten_fields(ctx, &symbol->type_t->get._Structure, 0l);
+        aggregate.fields_size = vec_size(ctx->sra->field_offsets) - aggregate.fields_front_idx;
+        if (!aggregate.is_split || aggregate.fields_size > 8) {
+            vec_resize(ctx->sra->field_offsets, aggregate.fields_front_idx);
+            vec_resize(ctx->sra->field_types, aggregate.fields_front_idx);
+            aggregate.fields_size = 0;
+            aggregate.is_split = false;
+        }
+        map_add(ctx->sra->aggregate_map, name, aggregate);
+    }
+    return &map_get(ctx->sra->aggregate_map, name);
+}
+
+static const SraAggregate* sra_find_split_aggregate(Ctx ctx, TIdentifier name) {
+    if (map_find(ctx->sra->aggregate_map, name) != map_end()) {
+        const SraAggregate* aggregate = &map_get(ctx->sra->aggregate_map, name);
+        if (aggregate->is_split && aggregate->is_accessed) {
+            return aggregate;
+        }
+    }
+    return NULL;
+}
+
+static size_t sra_field_idx(Ctx ctx, const SraAggregate* aggregate, TLong offset) {
+    for (size_t i = aggregate->fields_front_idx; i < aggregate->fields_front_idx + aggregate->fields_size; ++i) {
+        if (ctx->sra->field_offsets[i] == offset) {
+            return i;
+        }
+    }
+    return vec_size(ctx->sra->field_offsets);
+}
+
+static void sra_access_aggregate(Ctx ctx, TIdentifier name, TLong offset, const TacValue* node) {
+    SraAggregate* aggregate = sra_get_aggregate(ctx, name);
+    if (aggregate && aggregate->is_split) {
+        size_t i = sra_field_idx(ctx, aggregate, offset);
+        bool is_dbl = false;
+        TLong size = sra_value_size(ctx, node, &is_dbl);
+        if (i < vec_size(ctx->sra->field_offsets) && size > 0l && size == sra_scalar_size(ctx->sra->field_types[i])
+            && is_dbl == (ctx->sra->field_types[i]->type == AST_Double_t)) {
+            aggregate->is_accessed = true;
+        }
+        else {
+            aggregate->is_split = false;
+        }
+    }
+}
+
+static void sra_escape_aggregate(Ctx ctx, const TacValue* node) {
+    if (node->type == AST_TacVariable_t) {
+        SraAggregate* aggregate = sra_get_aggregate(ctx, node->get._TacVariable.name);
+        if (aggregate) {
+            aggregate->is_split = false;
+        }
+    }
+}
+
+// Structures copied to or from a split structure are split as well, so that the copy stays in registers
+static bool sra_copy_aggregate(Ctx ctx, const TacCopy* node) {
+    if (node->src->type != AST_TacVariable_t || node->dst->type != AST_TacVariable_t) {
+        return false;
+    }
+    SraAggregate* src_aggregate = sra_get_aggregate(ctx, node->src->get._TacVariable.name);
+    if (!src_aggregate || !src_aggregate->is_split) {
+        return false;
+    }
+    bool is_src_accessed = src_aggregate->is_accessed;
+    SraAggregate* dst_aggregate = sra_get_aggregate(ctx, node->dst->get._TacVariable.name);
+    if (!dst_aggregate || !dst_aggregate->is_split || is_src_accessed == dst_aggregate->is_accessed) {
+        return false;
+    }
+    dst_aggregate->is_accessed = true;
+    map_get(ctx->sra->aggregate_map, node->src->get._TacVariable.name).is_accessed = true;
+    return true;
+}
+
+static void sra_init_fields(Ctx ctx, TIdentifier name, const SraAggregate* aggregate) {
+    for (size_t i = aggregate->fields_front_idx; i < aggregate->fields_front_idx + aggregate->fields_size; ++i) {
+        string_t field_name = str_new(NULL);
+        str_copy(map_get(ctx->identifiers->hash_table, name), field_name);
+        ctx->sra->field_names[i] = make_var_identifier(ctx->identifiers, &field_name);
+        shared_ptr_t(Type) field_type = sptr_new();
+        sptr_copy(Type, ctx->sra->field_types[i], field_type);
+        unique_ptr_t(IdentifierAttr) field_attrs = make_LocalAttr();
+        unique_ptr_t(Symbol) symbol = make_Symbol(&field_type, &field_attrs);
+        map_move_add(ctx->frontend->symbol_table, ctx->sra->field_names[i], symbol);
+    }
+}
+
+static void sra_push_instr(Ctx ctx, unique_ptr_t(TacInstruction) instr) {
+    vec_move_back(ctx->sra->split_instrs, instr);
+}
+
+static void sra_split_value(Ctx ctx, const TacValue* node, bool is_def) {
+    if (node && node->type == AST_TacVariable_t) {
+        TIdentifier name = node->get._TacVariable.name;
+        const SraAggregate* aggregate = sra_find_split_aggregate(ctx, name);
+        if (aggregate) {
+            for (size_t i = aggregate->fields_front_idx; i < aggregate->fields_front_idx + aggregate->fields_size;
+                 ++i) {
+                shared_ptr_t(TacValue) field = make_TacVariable(ctx->sra->field_names[i]);
+                if (is_def) {
+                    sra_push_instr(ctx, make_TacCopyFromOffset(name, ctx->sra->field_offsets[i], &field));
+                }
+                else {
+                    sra_push_instr(ctx, make_TacCopyToOffset(name, ctx->sra->field_offsets[i], &field));
+                }
+            }
+        }
+    }
+}
+
+static void sra_split_instr(Ctx ctx, const TacInstruction* node, bool is_def) {
+    switch (node->type) {
+        case AST_TacReturn_t:
+            sra_split_value(ctx, node->get._TacReturn.val, is_def);
+            break;
+        case AST_TacFunCall_t: {
+            const TacFunCall* p_node = &node->get._TacFunCall;
+            if (is_def) {
+                sra_split_value(ctx, p_node->dst, true);
+            }
+            else {
+                for (size_t i = 0; i < vec_size(p_node->args); ++i) {
+                    sra_split_value(ctx, p_node->args[i], false);
+                }
+            }
+            break;
+        }
+        case AST_TacCopy_t:
+            sra_split_value(ctx, is_def ? node->get._TacCopy.dst : node->get._TacCopy.src, is_def);
+            break;
+        case AST_TacLoad_t:
+            if (is_def) {
+                sra_split_value(ctx, node->get._TacLoad.dst, true);
+            }
+            break;
+        case AST_TacStore_t:
+            if (!is_def) {
+                sra_split_value(ctx, node->get._TacStore.src, false);
+            }
+            break;
+        case AST_TacCopyToOffset_t:
+            if (!is_def) {
+                sra_split_value(ctx, node->get._TacCopyToOffset.src, false);
+            }
+            break;
+        case AST_TacCopyFromOffset_t:
+            if (is_def) {
+                sra_split_value(ctx, node->get._TacCopyFromOffset.dst, true);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static bool sra_cp_to_offset_instr(Ctx ctx, const TacCopyToOffset* node) {
+    const SraAggregate* aggregate = sra_find_split_aggregate(ctx, node->dst_name);
+    if (!aggregate) {
+        return false;
+    }
+    shared_ptr_t(TacValue) src = sptr_new();
+    sptr_copy(TacValue, node->src, src);
+    shared_ptr_t(TacValue) dst = make_TacVariable(ctx->sra->field_names[sra_field_idx(ctx, aggregate, node->offset)]);
+    sra_push_instr(ctx, make_TacCopy(&src, &dst));
+    return true;
+}
+
+static bool sra_cp_from_offset_instr(Ctx ctx, const TacCopyFromOffset* node) {
+    const SraAggregate* aggregate = sra_find_split_aggregate(ctx, node->src_name);
+    if (!aggregate) {
+        return false;
+    }
+    shared_ptr_t(TacValue) src = make_TacVariable(ctx->sra->field_names[sra_field_idx(ctx, aggregate, node->offset)]);
+    shared_ptr_t(TacValue) dst = sptr_new();
+    sptr_copy(TacValue, node->dst, dst);
+    sra_push_instr(ctx, make_TacCopy(&src, &dst));
+    return true;
+}
+
+static bool sra_copy_instr(Ctx ctx, const TacCopy* node) {
+    if (node->src->type != AST_TacVariable_t || node->dst->type != AST_TacVariable_t) {
+        return false;
+    }
+    const SraAggregate* src_aggregate = sra_find_split_aggregate(ctx, node->src->get._TacVariable.name);
+    const SraAggregate* dst_aggregate = sra_find_split_aggregate(ctx, node->dst->get._TacVariable.name);
+    if (!src_aggregate || !dst_aggregate) {
+        return false;
+    }
+    {
+        TIdentifier src_tag =
+            map_get(ctx->frontend->symbol_table, node->src->get._TacVariable.name)->type_t->get._Structure.tag;
+        TIdentifier dst_tag =
+            map_get(ctx->frontend->symbol_table, node->dst->get._TacVariable.name)->type_t->get._Structure.tag;
+        if (src_tag != dst_tag) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < src_aggregate->fields_size; ++i) {
+        shared_ptr_t(TacValue) src = make_TacVariable(ctx->sra->field_names[src_aggregate->fields_front_idx + i]);
+        shared_ptr_t(TacValue) dst = make_TacVariable(ctx->sra->field_names[dst_aggregate->fields_front_idx + i]);
+        sra_push_instr(ctx, make_TacCopy(&src, &dst));
+    }
+    return true;
+}
+
+static bool sra_instr(Ctx ctx, const TacInstruction* node) {
+    switch (node->type) {
+        case AST_TacCopyToOffset_t:
+            return sra_cp_to_offset_instr(ctx, &node->get._TacCopyToOffset);
+        case AST_TacCopyFromOffset_t:
+            return sra_cp_from_offset_instr(ctx, &node->get._TacCopyFromOffset);
+        case AST_TacCopy_t:
+            return sra_copy_instr(ctx, &node->get._TacCopy);
+        default:
+            return false;
+    }
+}
+
+static void replace_aggregates(Ctx ctx, TacFunction* node) {
+    map_clear(ctx->sra->aggregate_map);
+    vec_clear(ctx->sra->field_offsets);
+    vec_clear(ctx->sra->field_types);
+    for (size_t instr_idx = 0; instr_idx < vec_size(*ctx->p_instrs); ++instr_idx) {
+        const TacInstruction* instr = GET_INSTR(instr_idx);
+        if (!instr) {
+            continue;
+        }
+        switch (instr->type) {
+            case AST_TacCopyToOffset_t: {
+                const TacCopyToOffset* p_node = &instr->get._TacCopyToOffset;
+                sra_access_aggregate(ctx, p_node->dst_name, p_node->offset, p_node->src);
+                break;
+            }
+            case AST_TacCopyFromOffset_t: {
+                const TacCopyFromOffset* p_node = &instr->get._TacCopyFromOffset;
+                sra_access_aggregate(ctx, p_node->src_name, p_node->offset, p_node->dst);
+                break;
+            }
+            case AST_TacGetAddress_t:
+                sra_escape_aggregate(ctx, instr->get._TacGetAddress.src);
+                break;
+            default:
+                break;
+        }
+    }
+    for (bool is_fixed_point = false; !is_fixed_point;) {
+        is_fixed_point = true;
+        for (size_t instr_idx = 0; instr_idx < vec_size(*ctx->p_instrs); ++instr_idx) {
+            if (GET_INSTR(instr_idx) && GET_INSTR(instr_idx)->type == AST_TacCopy_t
+                && sra_copy_aggregate(ctx, &GET_INSTR(instr_idx)->get._TacCopy)) {
+                is_fixed_point = false;
+            }
+        }
+    }
+
+    bool is_split = false;
+    vec_resize(ctx->sra->field_names, vec_size(ctx->sra->field_offsets));
+    for (size_t i = 0; i < map_size(ctx->sra->aggregate_map); ++i) {
+        const SraAggregate* aggregate = &pair_second(ctx->sra->aggregate_map[i]);
+        if (aggregate->is_split && aggregate->is_accessed) {
+            sra_init_fields(ctx, pair_first(ctx->sra->aggregate_map[i]), aggregate);
+            is_split = true;
+        }
+    }
+    if (!is_split) {
+        return;
+    }
+
+    vec_clear(ctx->sra->split_instrs);
+    for (size_t i = 0; i < vec_size(node->params); ++i) {
+        shared_ptr_t(TacValue) param = make_TacVariable(node->params[i]);
+        sra_split_value(ctx, param, true);
+        free_TacValue(&param);
+    }
+    for (size_t instr_idx = 0; instr_idx < vec_size(*ctx->p_instrs); ++instr_idx) {
+        if (!GET_INSTR(instr_idx)) {
+            continue;
+        }
+        if (sra_instr(ctx, GET_INSTR(instr_idx))) {
+            free_TacInstruction(&GET_INSTR(instr_idx));
+        }
+        else {
+            sra_split_instr(ctx, GET_INSTR(instr_idx), false);
+            vec_move_back(ctx->sra->split_instrs, GET_INSTR(instr_idx));
+            sra_split_instr(ctx, vec_back(ctx->sra->split_instrs), true);
+        }
+    }
+    {
+        vector_t(unique_ptr_t(TacInstruction)) instrs = *ctx->p_instrs;
+        *ctx->p_instrs = ctx->sra->split_instrs;
+        ctx->sra->split_instrs = instrs;
+    }
+    vec_clear(ctx->sra->split_instrs);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Loop unrolling
+
+typedef struct LoopUnrolling {
+    size_t unroll_factor;
+    size_t unroll_budget;
+    hashmap_t(TIdentifier, size_t) jump_count_map;
+    hashmap_t(TIdentifier, size_t) use_count_map;
+    hashmap_t(TIdentifier, size_t) region_count_map;
+    hashmap_t(TIdentifier, TIdentifier) rename_map;
+    hashset_t(TIdentifier) addressed_set;
+    vector_t(TIdentifier) rename_names;
+    vector_t(unique_ptr_t(TacInstruction)) unroll_instrs;
+} LoopUnrolling;
+
+typedef struct UnrollLoop {
+    size_t start_idx;
+    size_t cond_idx;
+    size_t jump_idx;
+    size_t back_idx;
+    size_t break_idx;
+    size_t step_idx;
+    size_t def_idx;
+    size_t body_size;
+    AST_T cmp;
+    AST_T int_type;
+    TLong step;
+    shared_ptr_t(TacValue) induction;
+    shared_ptr_t(TacValue) bound;
+} UnrollLoop;
+
+static void free_LoopUnrolling(unique_ptr_t(LoopUnrolling) * self) {
+    uptr_delete(*self);
+    map_delete((*self)->jump_count_map);
+    map_delete((*self)->use_count_map);
+    map_delete((*self)->region_count_map);
+    map_delete((*self)->rename_map);
+    set_delete((*self)->addressed_set);
+    vec_delete((*self)->rename_names);
+    for (size_t i = 0; i < vec_size((*self)->unroll_instrs); ++i) {
+        free_TacInstruction(&(*self)->unroll_instrs[i]);
+    }
+    vec_delete((*self)->unroll_instrs);
+    uptr_free(*self);
+}
+
+static unique_ptr_t(LoopUnrolling) make_LoopUnrolling(uint8_t unroll_factor, uint8_t unroll_budget) {
+    unique_ptr_t(LoopUnrolling) self = uptr_new();
+    uptr_alloc(LoopUnrolling, self);
+    self->unroll_factor = (size_t)unroll_factor;
+    self->unroll_budget = (size_t)unroll_budget;
+    self->jump_count_map = map_new();
+    self->use_count_map = map_new();
+    self->region_count_map = map_new();
+    self->rename_map = map_new();
+    self->addressed_set = set_new();
+    self->rename_names = vec_new();
+    self->unroll_instrs = vec_new();
+    return self;
+}
+
+static size_t unroll_next_idx(Ctx ctx, size_t instr_idx) {
+    for (++instr_idx; instr_idx < vec_size(*ctx->p_instrs); ++instr_idx) {
+        if (GET_INSTR(instr_idx)) {
+            break;
+        }
+    }
+    return instr_idx;
+}
+
+static size_t unroll_get_count(hashmap_t(TIdentifier, size_t) * count_map, TIdentifier name) {
+    return map_find(*count_map, name) != map_end() ? map_get(*count_map, name) : 0;
+}
+
+static size_t unroll_jump_count(Ctx ctx, TIdentifier name) {
+    return unroll_get_count(&ctx->unroll->jump_count_map, name);
+}
+
+static void unroll_add_jump(Ctx ctx, TIdentifier target) {
+    size_t jump_count = unroll_jump_count(ctx, target) + 1;
+    map_add(ctx->unroll->jump_count_map, target, jump_count);
+}
+
+// Function calls are listed apart, as they have any number of arguments
+static size_t unroll_instr_values(TacInstruction* node, shared_ptr_t(TacValue) * *values) {
+    switch (node->type) {
+        case AST_TacReturn_t:
+            values[0] = &node->get._TacReturn.val;
+            return 1;
+        case AST_TacSignExtend_t:
+            values[0] = &node->get._TacSignExtend.src;
+            values[1] = &node->get._TacSignExtend.dst;
+            return 2;
+        case AST_TacTruncate_t:
+            values[0] = &node->get._TacTruncate.src;
+            values[1] = &node->get._TacTruncate.dst;
+            return 2;
+        case AST_TacZeroExtend_t:
+            values[0] = &node->get._TacZeroExtend.src;
+            values[1] = &node->get._TacZeroExtend.dst;
+            return 2;
+        case AST_TacDoubleToInt_t:
+            values[0] = &node->get._TacDoubleToInt.src;
+            values[1] = &node->get._TacDoubleToInt.dst;
+            return 2;
+        case AST_TacDoubleToUInt_t:
+            values[0] = &node->get._TacDoubleToUInt.src;
+            values[1] = &node->get._TacDoubleToUInt.dst;
+            return 2;
+        case AST_TacIntToDouble_t:
+            values[0] = &node->get._TacIntToDouble.src;
+            values[1] = &node->get._TacIntToDouble.dst;
+            return 2;
+        case AST_TacUIntToDouble_t:
+            values[0] = &node->get._TacUIntToDouble.src;
+            values[1] = &node->get._TacUIntToDouble.dst;
+            return 2;
+        case AST_TacUnary_t:
+            values[0] = &node->get._TacUnary.src;
+            values[1] = &node->get._TacUnary.dst;
+            return 2;
+        case AST_TacBinary_t:
+            values[0] = &node->get._TacBinary.src1;
+            values[1] = &node->get._TacBinary.src2;
+            values[2] = &node->get._TacBinary.dst;
+            return 3;
+        case AST_TacCopy_t:
+            values[0] = &node->get._TacCopy.src;
+            values[1] = &node->get._TacCopy.dst;
+            return 2;
+        case AST_TacGetAddress_t:
+            values[0] = &node->get._TacGetAddress.src;
+            values[1] = &node->get._TacGetAddress.dst;
+            return 2;
+        case AST_TacLoad_t:
+            values[0] = &node->get._TacLoad.src_ptr;
+            values[1] = &node->get._TacLoad.dst;
+            return 2;
+        case AST_TacStore_t:
+            values[0] = &node->get._TacStore.src;
+            values[1] = &node->get._TacStore.dst_ptr;
+            return 2;
+        case AST_TacAddPtr_t:
+            values[0] = &node->get._TacAddPtr.src_ptr;
+            values[1] = &node->get._TacAddPtr.idx;
+            values[2] = &node->get._TacAddPtr.dst;
+            return 3;
+        case AST_TacCopyToOffset_t:
+            values[0] = &node->get._TacCopyToOffset.src;
+            return 1;
+        case AST_TacCopyFromOffset_t:
+            values[0] = &node->get._TacCopyFromOffset.dst;
+            return 1;
+        case AST_TacJumpIfZero_t:
+            values[0] = &node->get._TacJumpIfZero.condition;
+            return 1;
+        case AST_TacJumpIfNotZero_t:
+            values[0] = &node->get._TacJumpIfNotZero.condition;
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static void unroll_add_use(hashmap_t(TIdentifier, size_t) * count_map, const TacValue* node) {
+    if (node && node->type == AST_TacVariable_t) {
+        size_t use_count = unroll_get_count(count_map, node->get._TacVariable.name) + 1;
+        map_add(*count_map, node->get._TacVariable.name, use_count);
+    }
+}
+
+static void unroll_add_uses(hashmap_t(TIdentifier, size_t) * count_map, TacInstruction* node) {
+    if (node->type == AST_TacFunCall_t) {
+        for (size_t i = 0; i < vec_size(node->get._TacFunCall.args); ++i) {
+            unroll_add_use(count_map, node->get._TacFunCall.args[i]);
+        }
+        unroll_add_use(count_map, node->get._TacFunCall.dst);
+    }
+    else {
+        shared_ptr_t(TacValue)* values[3];
+        size_t values_size = unroll_instr_values(node, values);
+        for (size_t i = 0; i < values_size; ++i) {
+            unroll_add_use(count_map, *values[i]);
+        }
+    }
+}
+
+static bool is_unroll_dst_name(const TacInstruction* node, TIdentifier name) {
+    const TacValue* dst;
+    switch (node->type) {
+        case AST_TacSignExtend_t:
+            dst = node->get._TacSignExtend.dst;
+            break;
+        case AST_TacTruncate_t:
+            dst = node->get._TacTruncate.dst;
+            break;
+        case AST_TacZeroExtend_t:
+            dst = node->get._TacZeroExtend.dst;
+            break;
+        case AST_TacDoubleToInt_t:
+            dst = node->get._TacDoubleToInt.dst;
+            break;
+        case AST_TacDoubleToUInt_t:
+            dst = node->get._TacDoubleToUInt.dst;
+            break;
+        case AST_TacIntToDouble_t:
+            dst = node->get._TacIntToDouble.dst;
+            break;
+        case AST_TacUIntToDouble_t:
+            dst = node->get._TacUIntToDouble.dst;
+            break;
+        case AST_TacFunCall_t:
+            dst = node->get._TacFunCall.dst;
+            break;
+        case AST_TacUnary_t:
+            dst = node->get._TacUnary.dst;
+            break;
+        case AST_TacBinary_t:
+            dst = node->get._TacBinary.dst;
+            break;
+        case AST_TacCopy_t:
+            dst = node->get._TacCopy.dst;
+            break;
+        case AST_TacGetAddress_t:
+            dst = node->get._TacGetAddress.dst;
+            break;
+        case AST_TacLoad_t:
+            dst = node->get._TacLoad.dst;
+            break;
+        case AST_TacAddPtr_t:
+            dst = node->get._TacAddPtr.dst;
+            break;
+        case AST_TacCopyToOffset_t:
+            return node->get._TacCopyToOffset.dst_name == name;
+        case AST_TacCopyFromOffset_t:
+            dst = node->get._TacCopyFromOffset.dst;
+            break;
+        default:
+            return false;
+    }
+    return dst && dst->type == AST_TacVariable_t && dst->get._TacVariable.name == name;
+}
+
+static bool is_unroll_var(const TacValue* node, TIdentifier name) {
+    return node->type == AST_TacVariable_t && node->get._TacVariable.name == name;
+}
+
+static bool unroll_const_bits(const TacValue* node, TULong* value) {
+    if (node->type != AST_TacConstant_t) {
+        return false;
+    }
+    const CConst* constant = node->get._TacConstant.constant;
+    switch (constant->type) {
+        case AST_CConstInt_t:
+            *value = (TULong)((TLong)constant->get._CConstInt.value);
+            return true;
+        case AST_CConstLong_t:
+            *value = (TULong)constant->get._CConstLong.value;
+            return true;
+        case AST_CConstUInt_t:
+            *value = (TULong)constant->get._CConstUInt.value;
+            return true;
+        case AST_CConstULong_t:
+            *value = constant->get._CConstULong.value;
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Values are kept as 64 bits, sign extended for int and zero extended for unsigned int
+static TULong unroll_norm_bits(AST_T int_type, TULong value) {
+    switch (int_type) {
+        case AST_Int_t:
+            return (TULong)((TLong)((TInt)value));
+        case AST_UInt_t:
+            return (TULong)((TUInt)value);
+        default:
+            return value;
+    }
+}
+
+static TLong unroll_signed_bits(AST_T int_type, TULong value) {
+    switch (int_type) {
+        case AST_Int_t:
+        case AST_UInt_t:
+            return (TLong)((TInt)value);
+        default:
+            return (TLong)value;
+    }
+}
+
+static bool is_unroll_cmp_true(AST_T cmp, AST_T int_type, TULong value_1, TULong value_2) {
+    if (int_type == AST_Int_t || int_type == AST_Long_t) {
+        value_1 ^= ((TULong)1ul) << 63;
+        value_2 ^= ((TULong)1ul) << 63;
+    }
+    switch (cmp) {
+        case AST_TacNotEqual_t:
+            return value_1 != value_2;
+        case AST_TacLessThan_t:
+            return value_1 < value_2;
+        case AST_TacLessOrEqual_t:
+            return value_1 <= value_2;
+        case AST_TacGreaterThan_t:
+            return value_1 > value_2;
+        case AST_TacGreaterOrEqual_t:
+            return value_1 >= value_2;
+        default:
+            THROW_ABORT;
+    }
+}
+
+static AST_T unroll_mirror_cmp(AST_T cmp) {
+    switch (cmp) {
+        case AST_TacLessThan_t:
+            return AST_TacGreaterThan_t;
+        case AST_TacLessOrEqual_t:
+            return AST_TacGreaterOrEqual_t;
+        case AST_TacGreaterThan_t:
+            return AST_TacLessThan_t;
+        case AST_TacGreaterOrEqual_t:
+            return AST_TacLessOrEqual_t;
+        default:
+            return cmp;
+    }
+}
+
+static bool is_unroll_local_name(Ctx ctx, TIdentifier name) {
+    return map_get(ctx->frontend->symbol_table, name)->attrs->type == AST_LocalAttr_t
+           && set_find(ctx->unroll->addressed_set, name) == set_end();
+}
+
+// Accepts i = i + c, and i = t after t = i + c
+static bool unroll_step_instr(UnrollLoop* loop, const TacInstruction* node, TIdentifier name) {
+    if (node->type != AST_TacBinary_t) {
+        return false;
+    }
+    const TacBinary* p_node = &node->get._TacBinary;
+    TULong value;
+    if (!is_unroll_var(p_node->src1, name) || !unroll_const_bits(p_node->src2, &value)) {
+        return false;
+    }
+    TLong step = unroll_signed_bits(loop->int_type, value);
+    switch (p_node->binop.type) {
+        case AST_TacAdd_t:
+            break;
+        case AST_TacSubtract_t:
+            step = -step;
+            break;
+        default:
+            return false;
+    }
+    if (step == 0l || step > 65536l || step < -65536l) {
+        return false;
+    }
+    loop->step = step;
+    return true;
+}
+
+static bool unroll_induction_var(Ctx ctx, UnrollLoop* loop, TIdentifier name) {
+    if (!is_unroll_local_name(ctx, name)) {
+        return false;
+    }
+    loop->int_type = map_get(ctx->frontend->symbol_table, name)->type_t->type;
+    switch (loop->int_type) {
+        case AST_Int_t:
+        case AST_Long_t:
+        case AST_UInt_t:
+        case AST_ULong_t:
+            break;
+        default:
+            return false;
+    }
+    size_t def_idx = vec_size(*ctx->p_instrs);
+    for (size_t instr_idx = loop->jump_idx; instr_idx < loop->back_idx; ++instr_idx) {
+        if (GET_INSTR(instr_idx) && is_unroll_dst_name(GET_INSTR(instr_idx), name)) {
+            if (def_idx < vec_size(*ctx->p_instrs)) {
+                return false;
+            }
+            def_idx = instr_idx;
+        }
+    }
+    if (def_idx == vec_size(*ctx->p_instrs)) {
+        return false;
+    }
+    const TacInstruction* node = GET_INSTR(def_idx);
+    loop->def_idx = def_idx;
+    loop->step_idx = def_idx;
+    if (node->type != AST_TacCopy_t) {
+        return unroll_step_instr(loop, node, name);
+    }
+    else if (node->get._TacCopy.src->type != AST_TacVariable_t) {
+        return false;
+    }
+    TIdentifier step_name = node->get._TacCopy.src->get._TacVariable.name;
+    size_t step_idx = vec_size(*ctx->p_instrs);
+    for (size_t instr_idx = loop->jump_idx; instr_idx < loop->back_idx; ++instr_idx) {
+        if (GET_INSTR(instr_idx) && is_unroll_dst_name(GET_INSTR(instr_idx), step_name)) {
+            if (step_idx < vec_size(*ctx->p_instrs) || instr_idx > def_idx) {
+                return false;
+            }
+            step_idx = instr_idx;
+        }
+    }
+    loop->step_idx = step_idx;
+    return step_idx < def_idx && unroll_step_instr(loop, GET_INSTR(step_idx), name);
+}
+
+static bool unroll_bound_value(Ctx ctx, const UnrollLoop* loop, const TacValue* node) {
+    if (node->type == AST_TacConstant_t) {
+        TULong value;
+        return unroll_const_bits(node, &value);
+    }
+    TIdentifier name = node->get._TacVariable.name;
+    if (!is_unroll_local_name(ctx, name)) {
+        return false;
+    }
+    for (size_t instr_idx = loop->jump_idx; instr_idx < loop->back_idx; ++instr_idx) {
+        if (GET_INSTR(instr_idx) && is_unroll_dst_name(GET_INSTR(instr_idx), name)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool unroll_cond_instr(Ctx ctx, UnrollLoop* loop) {
+    const TacBinary* node = &GET_INSTR(loop->cond_idx)->get._TacBinary;
+    switch (node->binop.type) {
+        case AST_TacNotEqual_t:
+        case AST_TacLessThan_t:
+        case AST_TacLessOrEqual_t:
+        case AST_TacGreaterThan_t:
+        case AST_TacGreaterOrEqual_t:
+            break;
+        default:
+            return false;
+    }
+    if (node->src1->type == AST_TacVariable_t
+        && unroll_induction_var(ctx, loop, node->src1->get._TacVariable.name)) {
+        loop->cmp = node->binop.type;
+        loop->induction = node->src1;
+        loop->bound = node->src2;
+    }
+    else if (node->src2->type == AST_TacVariable_t
+             && unroll_induction_var(ctx, loop, node->src2->get._TacVariable.name)) {
+        loop->cmp = unroll_mirror_cmp(node->binop.type);
+        loop->induction = node->src2;
+        loop->bound = node->src1;
+    }
+    else {
+        return false;
+    }
+    if (is_same_value(loop->induction, loop->bound) || is_same_value(loop->induction, node->dst)
+        || is_same_value(loop->bound, node->dst) || !unroll_bound_value(ctx, loop, loop->bound)) {
+        return false;
+    }
+    switch (loop->cmp) {
+        case AST_TacNotEqual_t:
+            return loop->step == 1l || loop->step == -1l;
+        case AST_TacLessThan_t:
+        case AST_TacLessOrEqual_t:
+            return loop->step > 0l;
+        case AST_TacGreaterThan_t:
+        case AST_TacGreaterOrEqual_t:
+            return loop->step < 0l;
+        default:
+            THROW_ABORT;
+    }
+}
+
+// Counted loops are matched on the shape of while and for loops,
+// with no other control flow inside the body:
+// Label(start), cond = i cmp n, JumpIfZero(cond, break), body, i = i + c, Jump(start), Label(break)
+static bool unroll_loop_shape(Ctx ctx, UnrollLoop* loop) {
+    const TacInstruction* node = GET_INSTR(loop->start_idx);
+    TIdentifier start_name = node->get._TacLabel.name;
+    if (unroll_jump_count(ctx, start_name) != 1) {
+        return false;
+    }
+    loop->cond_idx = unroll_next_idx(ctx, loop->start_idx);
+    if (loop->cond_idx == vec_size(*ctx->p_instrs) || GET_INSTR(loop->cond_idx)->type != AST_TacBinary_t) {
+        return false;
+    }
+    loop->jump_idx = unroll_next_idx(ctx, loop->cond_idx);
+    if (loop->jump_idx == vec_size(*ctx->p_instrs) || GET_INSTR(loop->jump_idx)->type != AST_TacJumpIfZero_t
+        || !is_same_value(GET_INSTR(loop->jump_idx)->get._TacJumpIfZero.condition,
+            GET_INSTR(loop->cond_idx)->get._TacBinary.dst)) {
+        return false;
+    }
+    TIdentifier break_name = GET_INSTR(loop->jump_idx)->get._TacJumpIfZero.target;
+    if (unroll_jump_count(ctx, break_name) != 1) {
+        return false;
+    }
+    loop->body_size = 0;
+    for (loop->back_idx = unroll_next_idx(ctx, loop->jump_idx);;
+         loop->back_idx = unroll_next_idx(ctx, loop->back_idx)) {
+        if (loop->back_idx == vec_size(*ctx->p_instrs)) {
+            return false;
+        }
+        node = GET_INSTR(loop->back_idx);
+        switch (node->type) {
+            case AST_TacReturn_t:
+            case AST_TacJumpIfZero_t:
+            case AST_TacJumpIfNotZero_t:
+                return false;
+            case AST_TacJump_t: {
+                if (node->get._TacJump.target != start_name) {
+                    return false;
+                }
+                loop->break_idx = unroll_next_idx(ctx, loop->back_idx);
+                return loop->break_idx < vec_size(*ctx->p_instrs)
+                       && GET_INSTR(loop->break_idx)->type == AST_TacLabel_t
+                       && GET_INSTR(loop->break_idx)->get._TacLabel.name == break_name && loop->body_size > 0
+                       && unroll_cond_instr(ctx, loop);
+            }
+            case AST_TacLabel_t:
+                if (unroll_jump_count(ctx, node->get._TacLabel.name) > 0) {
+                    return false;
+                }
+                break;
+            default:
+                loop->body_size++;
+                break;
+        }
+    }
+}
+
+static shared_ptr_t(TacValue) unroll_copy_value(shared_ptr_t(TacValue) node) {
+    shared_ptr_t(TacValue) value = sptr_new();
+    sptr_copy(TacValue, node, value);
+    return value;
+}
+
+static unique_ptr_t(TacInstruction) unroll_copy_instr(const TacInstruction* node) {
+    switch (node->type) {
+        case AST_TacSignExtend_t: {
+            shared_ptr_t(TacValue) src = unroll_copy_value(node->get._TacSignExtend.src);
+            shared_ptr_t(TacValue) dst = unroll_copy_value(node->get._TacSignExtend.dst);
+            return make_TacSignExtend(&src, &dst);
+        }
+        case AST_TacTruncate_t: {
+            shared_ptr_t(TacValue) src = unroll_copy_value(node->get._TacTruncate.src);
+            shared_ptr_t(TacValue) dst = unroll_copy_value(node->get._TacTruncate.dst);
+            return make_TacTruncate(&src, &dst);
+        }
+        case AST_TacZeroExtend_t: {
+            shared_ptr_t(TacValue) src = unroll_copy_value(node->get._TacZeroExtend.src);
+            shared_ptr_t(TacValue) dst = unroll_copy_value(node->get._TacZeroExtend.dst);
+            return make_TacZeroExtend(&src, &dst);
+        }
+        case AST_TacDoubleToInt_t: {
+            shared_ptr_t(TacValue) src = unroll_copy_value(node->get._TacDoubleToInt.src);
+            shared_ptr_t(TacValue) dst = unroll_copy_value(node->get._TacDoubleToInt.dst);
+            return make_TacDoubleToInt(&src, &dst);
+        }
+        case AST_TacDoubleToUInt_t: {
+            shared_ptr_t(TacValue) src = unroll_copy_value(node->get._TacDoubleToUInt.src);
+            shared_ptr_t(TacValue) dst = unroll_copy_value(node->get._TacDoubleToUInt.dst);
+            return make_TacDoubleToUInt(&src, &dst);
+        }
+        case AST_TacIntToDouble_t: {
+            shared_ptr_t(TacValue) src = unroll_copy_value(node->get._TacIntToDouble.src);
+            shared_ptr_t(TacValue) dst = unroll_copy_value(node->get._TacIntToDouble.dst);
+            return make_TacIntToDouble(&src, &dst);
+        }
+        case AST_TacUIntToDouble_t: {
+            shared_ptr_t(TacValue) src = unroll_copy_value(node->get._TacUIntToDouble.src);
+            shared_ptr_t(TacValue) dst = unroll_copy_value(node->get._TacUIntToDouble.dst);
+            return make_TacUIntToDouble(&src, &dst);
+        }
+        case AST_TacFunCall_t: {
+            const TacFunCall* p_node = &node->get._TacFunCall;
+            vector_t(shared_ptr_t(TacValue)) args = vec_new();
+            for (size_t i = 0; i < vec_size(p_node->args); ++i) {
+                shared_ptr_t(TacValue) arg = unroll_copy_value(p_node->args[i]);
+                vec_move_back(args, arg);
+            }
+            shared_ptr_t(TacValue) dst = unroll_copy_value(p_node->dst);
+            return make_TacFunCall(p_node->name, &args, &dst);
+        }
+        case AST_TacUnary_t: {
+            shared_ptr_t(TacValue) src = unroll_copy_value(node->get._TacUnary.src);
+            shared_ptr_t(TacValue) dst = unroll_copy_value(node->get._TacUnary.dst);
+            return make_TacUnary(&node->get._TacUnary.unop, &src, &dst);
+        }
+        case AST_TacBinary_t: {
+            shared_ptr_t(TacValue) src1 = unroll_copy_value(node->get._TacBinary.src1);
+            shared_ptr_t(TacValue) src2 = unroll_copy_value(node->get._TacBinary.src2);
+            shared_ptr_t(TacValue) dst = unroll_copy_value(node->get._TacBinary.dst);
+            return make_TacBinary(&node->get._TacBinary.binop, &src1, &src2, &dst);
+        }
+        case AST_TacCopy_t: {
+            shared_ptr_t(TacValue) src = unroll_copy_value(node->get._TacCopy.src);
+            shared_ptr_t(TacValue) dst = unroll_copy_value(node->get._TacCopy.dst);
+            return make_TacCopy(&src, &dst);
+        }
+        case AST_TacGetAddress_t: {
+            shared_ptr_t(TacValue) src = unroll_copy_value(node->get._TacGetAddress.src);
+            shared_ptr_t(TacValue) dst = unroll_copy_value(node->get._TacGetAddress.dst);
+            return make_TacGetAddress(&src, &dst);
+        }
+        case AST_TacLoad_t: {
+            shared_ptr_t(TacValue) src_ptr = unroll_copy_value(node->get._TacLoad.src_ptr);
+            shared_ptr_t(TacValue) dst = unroll_copy_value(node->get._TacLoad.dst);
+            return make_TacLoad(&src_ptr, &dst);
+        }
+        case AST_TacStore_t: {
+            shared_ptr_t(TacValue) src = unroll_copy_value(node->get._TacStore.src);
+            shared_ptr_t(TacValue) dst_ptr = unroll_copy_value(node->get._TacStore.dst_ptr);
+            return make_TacStore(&src, &dst_ptr);
+        }
+        case AST_TacAddPtr_t: {
+            const TacAddPtr* p_node = &node->get._TacAddPtr;
+            shared_ptr_t(TacValue) src_ptr = unroll_copy_value(p_node->src_ptr);
+            shared_ptr_t(TacValue) idx = unroll_copy_value(p_node->idx);
+            shared_ptr_t(TacValue) dst = unroll_copy_value(p_node->dst);
+            return make_TacAddPtr(p_node->scale, &src_ptr, &idx, &dst);
+        }
+        case AST_TacCopyToOffset_t: {
+            const TacCopyToOffset* p_node = &node->get._TacCopyToOffset;
+            shared_ptr_t(TacValue) src = unroll_copy_value(p_node->src);
+            return make_TacCopyToOffset(p_node->dst_name, p_node->offset, &src);
+        }
+        case AST_TacCopyFromOffset_t: {
+            const TacCopyFromOffset* p_node = &node->get._TacCopyFromOffset;
+            shared_ptr_t(TacValue) dst = unroll_copy_value(p_node->dst);
+            return make_TacCopyFromOffset(p_node->src_name, p_node->offset, &dst);
+        }
+        default:
+            THROW_ABORT;
+    }
+}
+
+static void unroll_push_instr(Ctx ctx, unique_ptr_t(TacInstruction) instr) {
+    vec_move_back(ctx->unroll->unroll_instrs, instr);
+}
+
+static void unroll_move_instr(Ctx ctx, size_t instr_idx) {
+    vec_move_back(ctx->unroll->unroll_instrs, GET_INSTR(instr_idx));
+}
+
+static TIdentifier unroll_make_var(Ctx ctx, TIdentifier name, shared_ptr_t(Type) * var_type) {
+    string_t var_name = str_new(NULL);
+    str_copy(map_get(ctx->identifiers->hash_table, name), var_name);
+    TIdentifier unroll_name = make_var_identifier(ctx->identifiers, &var_name);
+    unique_ptr_t(IdentifierAttr) var_attrs = make_LocalAttr();
+    unique_ptr_t(Symbol) symbol = make_Symbol(var_type, &var_attrs);
+    map_move_add(ctx->frontend->symbol_table, unroll_name, symbol);
+    return unroll_name;
+}
+
+static TIdentifier unroll_rename_var(Ctx ctx, TIdentifier name) {
+    shared_ptr_t(Type) var_type = sptr_new();
+    sptr_copy(Type, map_get(ctx->frontend->symbol_table, name)->type_t, var_type);
+    return unroll_make_var(ctx, name, &var_type);
+}
+
+static bool is_unroll_rename_name(
+    Ctx ctx, const TacInstruction* node, shared_ptr_t(TacValue) * *values, size_t values_size, TIdentifier name) {
+    if (!is_unroll_dst_name(node, name) || !is_unroll_local_name(ctx, name)
+        || map_get(ctx->frontend->symbol_table, name)->type_t->type == AST_Structure_t) {
+        return false;
+    }
+    size_t use_count = 0;
+    for (size_t i = 0; i < values_size; ++i) {
+        if (*values[i] && is_unroll_var(*values[i], name)) {
+            use_count++;
+        }
+    }
+    return use_count == 1;
+}
+
+// Variables which are set before being used in the body, and not used outside of it, are local to each iteration.
+// They are renamed in each copy of the body, so that temporary variables keep a single definition
+static void unroll_init_renames(Ctx ctx, const UnrollLoop* loop) {
+    map_clear(ctx->unroll->region_count_map);
+    map_clear(ctx->unroll->rename_map);
+    vec_clear(ctx->unroll->rename_names);
+    for (size_t instr_idx = loop->jump_idx + 1; instr_idx < loop->back_idx; ++instr_idx) {
+        TacInstruction* node = GET_INSTR(instr_idx);
+        if (!node || node->type == AST_TacLabel_t) {
+            continue;
+        }
+        if (node->type != AST_TacFunCall_t) {
+            shared_ptr_t(TacValue)* values[3];
+            size_t values_size = unroll_instr_values(node, values);
+            for (size_t i = 0; i < values_size; ++i) {
+                if (*values[i] && (*values[i])->type == AST_TacVariable_t) {
+                    TIdentifier name = (*values[i])->get._TacVariable.name;
+                    if (map_find(ctx->unroll->region_count_map, name) == map_end()
+                        && is_unroll_rename_name(ctx, node, values, values_size, name)) {
+                        vec_push_back(ctx->unroll->rename_names, name);
+                    }
+                }
+            }
+        }
+        unroll_add_uses(&ctx->unroll->region_count_map, node);
+    }
+    for (size_t i = 0; i < vec_size(ctx->unroll->rename_names); ++i) {
+        TIdentifier name = ctx->unroll->rename_names[i];
+        if (map_find(ctx->unroll->rename_map, name) == map_end()
+            && unroll_get_count(&ctx->unroll->region_count_map, name)
+                   == unroll_get_count(&ctx->unroll->use_count_map, name)) {
+            map_add(ctx->unroll->rename_map, name, name);
+        }
+    }
+}
+
+static void unroll_rename_value(Ctx ctx, shared_ptr_t(TacValue) * node) {
+    if (*node && (*node)->type == AST_TacVariable_t
+        && map_find(ctx->unroll->rename_map, (*node)->get._TacVariable.name) != map_end()) {
+        TIdentifier name = map_get(ctx->unroll->rename_map, (*node)->get._TacVariable.name);
+        free_TacValue(node);
+        *node = make_TacVariable(name);
+    }
+}
+
+static void unroll_rename_instr(Ctx ctx, TacInstruction* node) {
+    if (node->type == AST_TacFunCall_t) {
+        for (size_t i = 0; i < vec_size(node->get._TacFunCall.args); ++i) {
+            unroll_rename_value(ctx, &node->get._TacFunCall.args[i]);
+        }
+        unroll_rename_value(ctx, &node->get._TacFunCall.dst);
+    }
+    else {
+        shared_ptr_t(TacValue)* values[3];
+        size_t values_size = unroll_instr_values(node, values);
+        for (size_t i = 0; i < values_size; ++i) {
+            unroll_rename_value(ctx, values[i]);
+        }
+    }
+}
+
+static void unroll_copy_body(Ctx ctx, const UnrollLoop* loop, size_t unroll_count) {
+    for (size_t i = 0; i < unroll_count; ++i) {
+        for (size_t j = 0; j < map_size(ctx->unroll->rename_map); ++j) {
+            pair_second(ctx->unroll->rename_map[j]) = unroll_rename_var(ctx, pair_first(ctx->unroll->rename_map[j]));
+        }
+        for (size_t instr_idx = loop->jump_idx + 1; instr_idx < loop->back_idx; ++instr_idx) {
+            if (GET_INSTR(instr_idx) && GET_INSTR(instr_idx)->type != AST_TacLabel_t) {
+                unique_ptr_t(TacInstruction) instr = unroll_copy_instr(GET_INSTR(instr_idx));
+                unroll_rename_instr(ctx, instr);
+                unroll_push_instr(ctx, instr);
+            }
+        }
+    }
+}
+
+static shared_ptr_t(Type) unroll_unsigned_type(const UnrollLoop* loop) {
+    return loop->int_type == AST_Int_t || loop->int_type == AST_UInt_t ? make_UInt() : make_ULong();
+}
+
+static shared_ptr_t(TacValue) unroll_unsigned_value(Ctx ctx, const UnrollLoop* loop, shared_ptr_t(TacValue) node) {
+    if (loop->int_type == AST_UInt_t || loop->int_type == AST_ULong_t) {
+        return unroll_copy_value(node);
+    }
+    TULong value;
+    if (unroll_const_bits(node, &value)) {
+        shared_ptr_t(CConst) constant = loop->int_type == AST_Int_t ? make_CConstUInt((TUInt)value)
+                                                                    : make_CConstULong(value);
+        return make_TacConstant(&constant);
+    }
+    shared_ptr_t(Type) var_type = unroll_unsigned_type(loop);
+    shared_ptr_t(TacValue) dst =
+        make_TacVariable(unroll_make_var(ctx, loop->induction->get._TacVariable.name, &var_type));
+    {
+        shared_ptr_t(TacValue) src = unroll_copy_value(node);
+        shared_ptr_t(TacValue) copy_dst = unroll_copy_value(dst);
+        unroll_push_instr(ctx, make_TacCopy(&src, &copy_dst));
+    }
+    return dst;
+}
+
+static TIdentifier unroll_make_label(Ctx ctx, const UnrollLoop* loop) {
+    string_t label_name = str_new(NULL);
+    str_copy(map_get(ctx->identifiers->hash_table, GET_INSTR(loop->start_idx)->get._TacLabel.name), label_name);
+    return make_label_identifier(ctx->identifiers, &label_name);
+}
+
+static void unroll_push_cond(Ctx ctx, const UnrollLoop* loop, TIdentifier target) {
+    unique_ptr_t(TacInstruction) instr = unroll_copy_instr(GET_INSTR(loop->cond_idx));
+    shared_ptr_t(TacValue)* cond_dst = &instr->get._TacBinary.dst;
+    TIdentifier cond_name = unroll_rename_var(ctx, (*cond_dst)->get._TacVariable.name);
+    free_TacValue(cond_dst);
+    *cond_dst = make_TacVariable(cond_name);
+    unroll_push_instr(ctx, instr);
+    shared_ptr_t(TacValue) condition = make_TacVariable(cond_name);
+    unroll_push_instr(ctx, make_TacJumpIfZero(target, &condition));
+}
+
+// Jumps to target unless at least unroll_count iterations are left, as the unsigned distance between the
+// induction variable and the bound can not overflow once the loop condition holds
+static void unroll_push_count_check(Ctx ctx, const UnrollLoop* loop, size_t unroll_count, TIdentifier target) {
+    TIdentifier induction_name = loop->induction->get._TacVariable.name;
+    bool is_down = loop->cmp == AST_TacGreaterThan_t || loop->cmp == AST_TacGreaterOrEqual_t
+                   || (loop->cmp == AST_TacNotEqual_t && loop->step < 0l);
+    shared_ptr_t(TacValue) src1 = unroll_unsigned_value(ctx, loop, is_down ? loop->induction : loop->bound);
+    shared_ptr_t(TacValue) src2 = unroll_unsigned_value(ctx, loop, is_down ? loop->bound : loop->induction);
+    shared_ptr_t(Type) var_type = unroll_unsigned_type(loop);
+    shared_ptr_t(TacValue) dst = make_TacVariable(unroll_make_var(ctx, induction_name, &var_type));
+    shared_ptr_t(TacValue) distance = unroll_copy_value(dst);
+    TacBinaryOp binop = init_TacSubtract();
+    unroll_push_instr(ctx, make_TacBinary(&binop, &src1, &src2, &dst));
+
+    TULong min_distance = (TULong)(unroll_count - 1) * (TULong)(loop->step > 0l ? loop->step : -loop->step);
+    shared_ptr_t(CConst) constant = loop->int_type == AST_Int_t || loop->int_type == AST_UInt_t
+                                        ? make_CConstUInt((TUInt)min_distance)
+                                        : make_CConstULong(min_distance);
+    shared_ptr_t(TacValue) bound = make_TacConstant(&constant);
+    var_type = make_Int();
+    dst = make_TacVariable(unroll_make_var(ctx, induction_name, &var_type));
+    shared_ptr_t(TacValue) condition = unroll_copy_value(dst);
+    binop = loop->cmp == AST_TacLessOrEqual_t || loop->cmp == AST_TacGreaterOrEqual_t ? init_TacGreaterOrEqual()
+                                                                                      : init_TacGreaterThan();
+    unroll_push_instr(ctx, make_TacBinary(&binop, &distance, &bound, &dst));
+    unroll_push_instr(ctx, make_TacJumpIfZero(target, &condition));
+}
+
+// The unrolled body runs while enough iterations are left, then the remaining iterations run one at a time
+static void unroll_partial_loop(Ctx ctx, const UnrollLoop* loop, size_t unroll_count) {
+    TIdentifier remainder_name = unroll_make_label(ctx, loop);
+    unroll_move_instr(ctx, loop->start_idx);
+    unroll_push_cond(ctx, loop, GET_INSTR(loop->jump_idx)->get._TacJumpIfZero.target);
+    unroll_push_count_check(ctx, loop, unroll_count, remainder_name);
+    unroll_copy_body(ctx, loop, unroll_count);
+    unroll_move_instr(ctx, loop->back_idx);
+
+    unroll_push_instr(ctx, make_TacLabel(remainder_name));
+    unroll_move_instr(ctx, loop->cond_idx);
+    unroll_move_instr(ctx, loop->jump_idx);
+    for (size_t instr_idx = loop->jump_idx + 1; instr_idx < loop->back_idx; ++instr_idx) {
+        if (GET_INSTR(instr_idx)) {
+            unroll_move_instr(ctx, instr_idx);
+        }
+    }
+    unroll_push_instr(ctx, make_TacJump(remainder_name));
+    unroll_move_instr(ctx, loop->break_idx);
+}
+
+static void unroll_full_loop(Ctx ctx, const UnrollLoop* loop, size_t unroll_count) {
+    unroll_copy_body(ctx, loop, unroll_count);
+    unroll_move_instr(ctx, loop->cond_idx);
+    for (size_t instr_idx = loop->start_idx; instr_idx <= loop->break_idx; ++instr_idx) {
+        if (GET_INSTR(instr_idx)) {
+            free_TacInstruction(&GET_INSTR(instr_idx));
+        }
+    }
+}
+
+// Returns the trip count if the loop starts from a constant and runs less than max_count times
+static bool unroll_trip_count(Ctx ctx, const UnrollLoop* loop, size_t max_count, size_t* trip_count) {
+    TULong bound;
+    if (vec_empty(ctx->unroll->unroll_instrs) || !unroll_const_bits(loop->bound, &bound)) {
+        return false;
+    }
+    // Instructions before the loop are already moved to the unrolled instructions
+    const TacInstruction* node = vec_back(ctx->unroll->unroll_instrs);
+    TULong value;
+    if (node->type != AST_TacCopy_t || !is_same_value(node->get._TacCopy.dst, loop->induction)
+        || !unroll_const_bits(node->get._TacCopy.src, &value)) {
+        return false;
+    }
+    bound = unroll_norm_bits(loop->int_type, bound);
+    value = unroll_norm_bits(loop->int_type, value);
+    for (*trip_count = 0; is_unroll_cmp_true(loop->cmp, loop->int_type, value, bound); (*trip_count)++) {
+        if (*trip_count == max_count) {
+            return false;
+        }
+        TULong next_value = unroll_norm_bits(loop->int_type, value + (TULong)loop->step);
+        if (loop->int_type == AST_Int_t || loop->int_type == AST_Long_t) {
+            if ((loop->step > 0l && (TLong)next_value < (TLong)value)
+                || (loop->step < 0l && (TLong)next_value > (TLong)value)) {
+                return false;
+            }
+        }
+        value = next_value;
+    }
+    return true;
+}
+
+static bool vector_match_loop(Ctx ctx, const UnrollLoop* loop);
+
+static bool unroll_loop(Ctx ctx, UnrollLoop* loop) {
+    if (!unroll_loop_shape(ctx, loop) || (ctx->vector && vector_match_loop(ctx, loop))) {
+        return false;
+    }
+    unroll_init_renames(ctx, loop);
+    size_t max_count = ctx->unroll->unroll_budget / loop->body_size;
+    size_t trip_count;
+    if (unroll_trip_count(ctx, loop, max_count, &trip_count)) {
+        unroll_full_loop(ctx, loop, trip_count);
+        return true;
+    }
+    if (max_count > ctx->unroll->unroll_factor) {
+        max_count = ctx->unroll->unroll_factor;
+    }
+    if (max_count < 2) {
+        return false;
+    }
+    unroll_partial_loop(ctx, loop, max_count);
+    return true;
+}
+
+static void unroll_init_counts(Ctx ctx) {
+    map_clear(ctx->unroll->jump_count_map);
+    map_clear(ctx->unroll->use_count_map);
+    set_clear(ctx->unroll->addressed_set);
+    for (size_t instr_idx = 0; instr_idx < vec_size(*ctx->p_instrs); ++instr_idx) {
+        TacInstruction* node = GET_INSTR(instr_idx);
+        if (!node) {
+            continue;
+        }
+        unroll_add_uses(&ctx->unroll->use_count_map, node);
+        switch (node->type) {
+            case AST_TacGetAddress_t:
+                if (node->get._TacGetAddress.src->type == AST_TacVariable_t) {
+                    set_insert(ctx->unroll->addressed_set, node->get._TacGetAddress.src->get._TacVariable.name);
+                }
+                break;
+            case AST_TacJump_t:
+                unroll_add_jump(ctx, node->get._TacJump.target);
+                break;
+            case AST_TacJumpIfZero_t:
+                unroll_add_jump(ctx, node->get._TacJumpIfZero.target);
+                break;
+            case AST_TacJumpIfNotZero_t:
+                unroll_add_jump(ctx, node->get._TacJumpIfNotZero.target);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static void unroll_swap_instrs(Ctx ctx) {
+    vector_t(unique_ptr_t(TacInstruction)) instrs = *ctx->p_instrs;
+    *ctx->p_instrs = ctx->unroll->unroll_instrs;
+    ctx->unroll->unroll_instrs = instrs;
+    vec_clear(ctx->unroll->unroll_instrs);
+}
+
+static void unroll_loops(Ctx ctx) {
+    unroll_init_counts(ctx);
+    vec_clear(ctx->unroll->unroll_instrs);
+    for (size_t instr_idx = 0; instr_idx < vec_size(*ctx->p_instrs); ++instr_idx) {
+        if (!GET_INSTR(instr_idx)) {
+            continue;
+        }
+        if (GET_INSTR(instr_idx)->type == AST_TacLabel_t) {
+            UnrollLoop loop;
+            loop.start_idx = instr_idx;
+            if (unroll_loop(ctx, &loop)) {
+                instr_idx = loop.break_idx;
+                continue;
+            }
+        }
+        unroll_move_instr(ctx, instr_idx);
+    }
+    unroll_swap_instrs(ctx);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Loop vectorization
+
+typedef struct LoopVectorization {
+    AST_T elem_type;
+    TLong elem_size;
+    size_t lanes;
+    size_t store_idx;
+    size_t splat_idx;
+    hashmap_t(TIdentifier, size_t) def_map;
+    hashmap_t(TIdentifier, size_t) load_map;
+    hashmap_t(TIdentifier, size_t) fold_map;
+    hashmap_t(TIdentifier, TIdentifier) base_map;
+    hashmap_t(TIdentifier, TIdentifier) vector_map;
+    hashmap_t(TIdentifier, TIdentifier) reduce_map;
+    hashset_t(TIdentifier) index_set;
+    vector_t(TIdentifier) base_names;
+    vector_t(TIdentifier) store_names;
+    vector_t(TIdentifier) reduce_names;
+    vector_t(TIdentifier) acc_names;
+    vector_t(TIdentifier) splat_names;
+} LoopVectorization;
+
+static void free_LoopVectorization(unique_ptr_t(LoopVectorization) * self) {
+    uptr_delete(*self);
+    map_delete((*self)->def_map);
+    map_delete((*self)->load_map);
+    map_delete((*self)->fold_map);
+    map_delete((*self)->base_map);
+    map_delete((*self)->vector_map);
+    map_delete((*self)->reduce_map);
+    set_delete((*self)->index_set);
+    vec_delete((*self)->base_names);
+    vec_delete((*self)->store_names);
+    vec_delete((*self)->reduce_names);
+    vec_delete((*self)->acc_names);
+    vec_delete((*self)->splat_names);
+    uptr_free(*self);
+}
+
+static unique_ptr_t(LoopVectorization) make_LoopVectorization(void) {
+    unique_ptr_t(LoopVectorization) self = uptr_new();
+    uptr_alloc(LoopVectorization, self);
+    self->def_map = map_new();
+    self->load_map = map_new();
+    self->fold_map = map_new();
+    self->base_map = map_new();
+    self->vector_map = map_new();
+    self->reduce_map = map_new();
+    self->index_set = set_new();
+    self->base_names = vec_new();
+    self->store_names = vec_new();
+    self->reduce_names = vec_new();
+    self->acc_names = vec_new();
+    self->splat_names = vec_new();
+    return self;
+}
+
+static const TacValue* vector_dst_value(const TacInstruction* node) {
+    switch (node->type) {
+        case AST_TacSignExtend_t:
+            return node->get._TacSignExtend.dst;
+        case AST_TacZeroExtend_t:
+            return node->get._TacZeroExtend.dst;
+        case AST_TacBinary_t:
+            return node->get._TacBinary.dst;
+        case AST_TacCopy_t:
+            return node->get._TacCopy.dst;
+        case AST_TacLoad_t:
+            return node->get._TacLoad.dst;
+        case AST_TacAddPtr_t:
+            return node->get._TacAddPtr.dst;
+        default:
+            return NULL;
+    }
+}
+
+static bool is_vector_name(Ctx ctx, const TacValue* node) {
+    return node->type == AST_TacVariable_t
+           && map_find(ctx->vector->vector_map, node->get._TacVariable.name) != map_end();
+}
+
+static bool is_vector_reduce_name(Ctx ctx, TIdentifier name) {
+    return map_find(ctx->vector->reduce_map, name) != map_end() && map_get(ctx->vector->reduce_map, name) == name;
+}
+
+static void vector_add_name(vector_t(TIdentifier) * names, TIdentifier name) {
+    for (size_t i = 0; i < vec_size(*names); ++i) {
+        if ((*names)[i] == name) {
+            return;
+        }
+    }
+    vec_push_back(*names, name);
+}
+
+// SSE2 packs 4 int or 2 long and double elements in 128 bits, narrower elements are left scalar
+static bool vector_match_elem_type(Ctx ctx, TIdentifier name, TLong scale) {
+    const Type* ptr_type = map_get(ctx->frontend->symbol_table, name)->type_t;
+    if (ptr_type->type != AST_Pointer_t) {
+        return false;
+    }
+    AST_T elem_type = ptr_type->get._Pointer.ref_type->type;
+    TLong elem_size;
+    switch (elem_type) {
+        case AST_Int_t:
+        case AST_UInt_t:
+            elem_size = 4l;
+            break;
+        case AST_Long_t:
+        case AST_ULong_t:
+        case AST_Double_t:
+            elem_size = 8l;
+            break;
+        default:
+            return false;
+    }
+    if (scale != elem_size) {
+        return false;
+    }
+    else if (ctx->vector->lanes == 0) {
+        ctx->vector->elem_type = elem_type;
+        ctx->vector->elem_size = elem_size;
+        ctx->vector->lanes = (size_t)(16l / elem_size);
+    }
+    return ctx->vector->elem_type == elem_type;
+}
+
+// Loaded values are read from memory when they are used, so no store can come in between
+static bool vector_match_operand(Ctx ctx, const TacValue* node) {
+    if (node->type != AST_TacVariable_t) {
+        return true;
+    }
+    TIdentifier name = node->get._TacVariable.name;
+    if (map_find(ctx->vector->vector_map, name) != map_end()) {
+        return map_find(ctx->vector->load_map, name) == map_end()
+               || map_get(ctx->vector->load_map, name) > ctx->vector->store_idx;
+    }
+    return map_find(ctx->vector->def_map, name) == map_end() && is_unroll_local_name(ctx, name);
+}
+
+static bool vector_match_binop(Ctx ctx, const TacBinaryOp* node) {
+    switch (node->type) {
+        case AST_TacAdd_t:
+        case AST_TacSubtract_t:
+            return true;
+        case AST_TacMultiply_t:
+        case AST_TacDivide_t:
+            return ctx->vector->elem_type == AST_Double_t;
+        case AST_TacBitAnd_t:
+        case AST_TacBitOr_t:
+        case AST_TacBitXor_t:
+            return ctx->vector->elem_type != AST_Double_t;
+        default:
+            return false;
+    }
+}
+
+static bool vector_match_index(Ctx ctx, const UnrollLoop* loop, const TacValue* src, const TacValue* dst) {
+    if (!is_same_value(src, loop->induction) || dst->type != AST_TacVariable_t || is_same_value(src, dst)) {
+        return false;
+    }
+    set_insert(ctx->vector->index_set, dst->get._TacVariable.name);
+    return true;
+}
+
+static bool vector_match_add_ptr(Ctx ctx, const TacAddPtr* node) {
+    if (node->src_ptr->type != AST_TacVariable_t || node->idx->type != AST_TacVariable_t
+        || node->dst->type != AST_TacVariable_t) {
+        return false;
+    }
+    TIdentifier base_name = node->src_ptr->get._TacVariable.name;
+    if (map_find(ctx->vector->def_map, base_name) != map_end() || !is_unroll_local_name(ctx, base_name)
+        || set_find(ctx->vector->index_set, node->idx->get._TacVariable.name) == set_end()
+        || !vector_match_elem_type(ctx, base_name, node->scale)) {
+        return false;
+    }
+    map_add(ctx->vector->base_map, node->dst->get._TacVariable.name, base_name);
+    vector_add_name(&ctx->vector->base_names, base_name);
+    return true;
+}
+
+static bool vector_match_load(Ctx ctx, const TacLoad* node, size_t instr_idx) {
+    if (node->src_ptr->type != AST_TacVariable_t || node->dst->type != AST_TacVariable_t
+        || map_find(ctx->vector->base_map, node->src_ptr->get._TacVariable.name) == map_end()) {
+        return false;
+    }
+    map_add(ctx->vector->vector_map, node->dst->get._TacVariable.name, node->src_ptr->get._TacVariable.name);
+    map_add(ctx->vector->load_map, node->dst->get._TacVariable.name, instr_idx);
+    return true;
+}
+
+static bool vector_match_store(Ctx ctx, const TacStore* node, size_t instr_idx) {
+    if (node->dst_ptr->type != AST_TacVariable_t
+        || map_find(ctx->vector->base_map, node->dst_ptr->get._TacVariable.name) == map_end()
+        || !vector_match_operand(ctx, node->src)) {
+        return false;
+    }
+    vector_add_name(&ctx->vector->store_names, map_get(ctx->vector->base_map, node->dst_ptr->get._TacVariable.name));
+    ctx->vector->store_idx = instr_idx;
+    return true;
+}
+
+// Integer sums are accumulated in each lane and the lanes are added after the loop.
+// Floating point sums are left scalar, as reassociating them would change the rounding
+static bool vector_match_reduction(Ctx ctx, const TacBinary* node) {
+    if (node->binop.type != AST_TacAdd_t || ctx->vector->lanes == 0 || ctx->vector->elem_type == AST_Double_t
+        || node->dst->type != AST_TacVariable_t) {
+        return false;
+    }
+    const TacValue* src = is_vector_name(ctx, node->src1) ? node->src1 : node->src2;
+    const TacValue* reduce = src == node->src1 ? node->src2 : node->src1;
+    if (!is_vector_name(ctx, src) || !vector_match_operand(ctx, src) || reduce->type != AST_TacVariable_t
+        || is_vector_name(ctx, reduce)) {
+        return false;
+    }
+    TIdentifier name = reduce->get._TacVariable.name;
+    TIdentifier dst_name = node->dst->get._TacVariable.name;
+    if (map_find(ctx->vector->def_map, name) == map_end() || !is_unroll_local_name(ctx, name)
+        || map_get(ctx->frontend->symbol_table, name)->type_t->type != ctx->vector->elem_type
+        || unroll_get_count(&ctx->unroll->region_count_map, name) != 2
+        || (dst_name != name && unroll_get_count(&ctx->unroll->use_count_map, dst_name) != 2)) {
+        return false;
+    }
+    map_add(ctx->vector->reduce_map, dst_name, name);
+    map_add(ctx->vector->reduce_map, name, name);
+    vec_push_back(ctx->vector->reduce_names, name);
+    return true;
+}
+
+static bool vector_match_binary(Ctx ctx, const TacBinary* node) {
+    if (vector_match_reduction(ctx, node)) {
+        return true;
+    }
+    else if (ctx->vector->lanes == 0 || node->dst->type != AST_TacVariable_t
+             || (!is_vector_name(ctx, node->src1) && !is_vector_name(ctx, node->src2))
+             || !vector_match_binop(ctx, &node->binop) || !vector_match_operand(ctx, node->src1)
+             || !vector_match_operand(ctx, node->src2)) {
+        return false;
+    }
+    map_add(ctx->vector->vector_map, node->dst->get._TacVariable.name, node->dst->get._TacVariable.name);
+    return true;
+}
+
+// Element addresses can be copied when value numbering reuses them for a store
+static bool vector_match_copy(Ctx ctx, const UnrollLoop* loop, const TacCopy* node) {
+    if (node->src->type == AST_TacVariable_t
+        && map_find(ctx->vector->reduce_map, node->src->get._TacVariable.name) != map_end()) {
+        TIdentifier name = map_get(ctx->vector->reduce_map, node->src->get._TacVariable.name);
+        return name != node->src->get._TacVariable.name && is_unroll_var(node->dst, name);
+    }
+    else if (node->src->type == AST_TacVariable_t && node->dst->type == AST_TacVariable_t
+             && map_find(ctx->vector->base_map, node->src->get._TacVariable.name) != map_end()) {
+        TIdentifier base_name = map_get(ctx->vector->base_map, node->src->get._TacVariable.name);
+        map_add(ctx->vector->base_map, node->dst->get._TacVariable.name, base_name);
+        return true;
+    }
+    return vector_match_index(ctx, loop, node->src, node->dst);
+}
+
+static bool vector_match_instr(Ctx ctx, const UnrollLoop* loop, size_t instr_idx) {
+    const TacInstruction* node = GET_INSTR(instr_idx);
+    switch (node->type) {
+        case AST_TacSignExtend_t:
+            return loop->int_type == AST_Int_t
+                   && vector_match_index(ctx, loop, node->get._TacSignExtend.src, node->get._TacSignExtend.dst);
+        case AST_TacZeroExtend_t:
+            return loop->int_type == AST_UInt_t
+                   && vector_match_index(ctx, loop, node->get._TacZeroExtend.src, node->get._TacZeroExtend.dst);
+        case AST_TacBinary_t:
+            return vector_match_binary(ctx, &node->get._TacBinary);
+        case AST_TacCopy_t:
+            return vector_match_copy(ctx, loop, &node->get._TacCopy);
+        case AST_TacLoad_t:
+            return vector_match_load(ctx, &node->get._TacLoad, instr_idx);
+        case AST_TacStore_t:
+            return vector_match_store(ctx, &node->get._TacStore, instr_idx);
+        case AST_TacAddPtr_t:
+            return vector_match_add_ptr(ctx, &node->get._TacAddPtr);
+        case AST_TacLabel_t:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Counted loops which step by 1 over arrays indexed by the induction variable are vectorized:
+// elements are loaded and stored at the same index, and values computed in the body are only used in the body
+static bool vector_match_loop(Ctx ctx, const UnrollLoop* loop) {
+    if (loop->step != 1l || (loop->cmp != AST_TacLessThan_t && loop->cmp != AST_TacLessOrEqual_t
+                                && loop->cmp != AST_TacNotEqual_t)) {
+        return false;
+    }
+    ctx->vector->lanes = 0;
+    ctx->vector->store_idx = loop->jump_idx;
+    map_clear(ctx->vector->def_map);
+    map_clear(ctx->vector->load_map);
+    map_clear(ctx->vector->base_map);
+    map_clear(ctx->vector->vector_map);
+    map_clear(ctx->vector->reduce_map);
+    set_clear(ctx->vector->index_set);
+    vec_clear(ctx->vector->base_names);
+    vec_clear(ctx->vector->store_names);
+    vec_clear(ctx->vector->reduce_names);
+    map_clear(ctx->unroll->region_count_map);
+    for (size_t instr_idx = loop->jump_idx + 1; instr_idx < loop->back_idx; ++instr_idx) {
+        TacInstruction* node = GET_INSTR(instr_idx);
+        if (node) {
+            unroll_add_uses(&ctx->unroll->region_count_map, node);
+            const TacValue* dst = vector_dst_value(node);
+            if (dst && dst->type == AST_TacVariable_t) {
+                if (map_find(ctx->vector->def_map, dst->get._TacVariable.name) != map_end()) {
+                    return false;
+                }
+                map_add(ctx->vector->def_map, dst->get._TacVariable.name, instr_idx);
+            }
+        }
+    }
+    TIdentifier induction_name = loop->induction->get._TacVariable.name;
+    if (loop->int_type == AST_Long_t || loop->int_type == AST_ULong_t) {
+        set_insert(ctx->vector->index_set, induction_name);
+    }
+    for (size_t instr_idx = loop->jump_idx + 1; instr_idx < loop->back_idx; ++instr_idx) {
+        if (!GET_INSTR(instr_idx) || instr_idx == loop->step_idx || instr_idx == loop->def_idx) {
+            continue;
+        }
+        else if ((instr_idx > loop->def_idx && GET_INSTR(instr_idx)->type != AST_TacLabel_t)
+                 || !vector_match_instr(ctx, loop, instr_idx)) {
+            return false;
+        }
+    }
+    if ((vec_empty(ctx->vector->store_names) && vec_empty(ctx->vector->reduce_names))
+        || vec_size(ctx->vector->base_names) > 4) {
+        return false;
+    }
+    for (size_t i = 0; i < map_size(ctx->vector->def_map); ++i) {
+        TIdentifier name = pair_first(ctx->vector->def_map[i]);
+        if (name != induction_name && !is_vector_reduce_name(ctx, name)
+            && unroll_get_count(&ctx->unroll->use_count_map, name)
+                   != unroll_get_count(&ctx->unroll->region_count_map, name)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static shared_ptr_t(Type) vector_elem_type(Ctx ctx) {
+    switch (ctx->vector->elem_type) {
+        case AST_Int_t:
+            return make_Int();
+        case AST_Long_t:
+            return make_Long();
+        case AST_UInt_t:
+            return make_UInt();
+        case AST_ULong_t:
+            return make_ULong();
+        case AST_Double_t:
+            return make_Double();
+        default:
+            THROW_ABORT;
+    }
+}
+
+static shared_ptr_t(TacValue) vector_zero_value(Ctx ctx) {
+    shared_ptr_t(CConst) constant = sptr_new();
+    switch (ctx->vector->elem_type) {
+        case AST_Int_t:
+            constant = make_CConstInt(0);
+            break;
+        case AST_Long_t:
+            constant = make_CConstLong(0l);
+            break;
+        case AST_UInt_t:
+            constant = make_CConstUInt(0u);
+            break;
+        case AST_ULong_t:
+            constant = make_CConstULong(0ul);
+            break;
+        default:
+            THROW_ABORT;
+    }
+    return make_TacConstant(&constant);
+}
+
+static shared_ptr_t(TacValue) vector_lanes_value(Ctx ctx, const UnrollLoop* loop) {
+    shared_ptr_t(CConst) constant = sptr_new();
+    switch (loop->int_type) {
+        case AST_Int_t:
+            constant = make_CConstInt((TInt)ctx->vector->lanes);
+            break;
+        case AST_Long_t:
+            constant = make_CConstLong((TLong)ctx->vector->lanes);
+            break;
+        case AST_UInt_t:
+            constant = make_CConstUInt((TUInt)ctx->vector->lanes);
+            break;
+        case AST_ULong_t:
+            constant = make_CConstULong((TULong)ctx->vector->lanes);
+            break;
+        default:
+            THROW_ABORT;
+    }
+    return make_TacConstant(&constant);
+}
+
+// Vector values are kept in 16 bytes local arrays, and vector instructions operate on their addresses
+static TIdentifier vector_make_array(Ctx ctx, TIdentifier name) {
+    shared_ptr_t(Type) elem_type = vector_elem_type(ctx);
+    shared_ptr_t(Type) var_type = make_Array((TLong)ctx->vector->lanes, &elem_type);
+    return unroll_make_var(ctx, name, &var_type);
+}
+
+static TIdentifier vector_push_address(Ctx ctx, TIdentifier array_name) {
+    shared_ptr_t(Type) ref_type = vector_elem_type(ctx);
+    shared_ptr_t(Type) var_type = make_Pointer(&ref_type);
+    TIdentifier ptr_name = unroll_make_var(ctx, array_name, &var_type);
+    shared_ptr_t(TacValue) src = make_TacVariable(array_name);
+    shared_ptr_t(TacValue) dst = make_TacVariable(ptr_name);
+    unroll_push_instr(ctx, make_TacGetAddress(&src, &dst));
+    return ptr_name;
+}
+
+static TIdentifier vector_push_splat(Ctx ctx, TIdentifier name, shared_ptr_t(TacValue) node) {
+    TIdentifier array_name = vector_make_array(ctx, name);
+    for (size_t i = 0; i < ctx->vector->lanes; ++i) {
+        shared_ptr_t(TacValue) src = unroll_copy_value(node);
+        unroll_push_instr(ctx, make_TacCopyToOffset(array_name, (TLong)i * ctx->vector->elem_size, &src));
+    }
+    return vector_push_address(ctx, array_name);
+}
+
+static void vector_add_splat(Ctx ctx, TIdentifier name, shared_ptr_t(TacValue) node) {
+    if (!is_vector_name(ctx, node)) {
+        TIdentifier ptr_name = vector_push_splat(ctx, name, node);
+        vec_push_back(ctx->vector->splat_names, ptr_name);
+    }
+}
+
+// The result is computed straight to memory when it is stored right after, with no memory access in between
+static bool vector_fold_store(Ctx ctx, const UnrollLoop* loop, size_t instr_idx, TIdentifier* ptr_name) {
+    const TacValue* dst = GET_INSTR(instr_idx)->get._TacBinary.dst;
+    if (unroll_get_count(&ctx->unroll->use_count_map, dst->get._TacVariable.name) != 2) {
+        return false;
+    }
+    for (size_t i = instr_idx + 1; i < loop->back_idx; ++i) {
+        const TacInstruction* node = GET_INSTR(i);
+        if (!node) {
+            continue;
+        }
+        switch (node->type) {
+            case AST_TacSignExtend_t:
+            case AST_TacZeroExtend_t:
+            case AST_TacCopy_t:
+            case AST_TacAddPtr_t:
+            case AST_TacLabel_t:
+                break;
+            case AST_TacStore_t: {
+                const TacStore* p_node = &node->get._TacStore;
+                if (!is_same_value(p_node->src, dst)) {
+                    return false;
+                }
+                *ptr_name = p_node->dst_ptr->get._TacVariable.name;
+                map_add(ctx->vector->fold_map, dst->get._TacVariable.name, instr_idx);
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+    return false;
+}
+
+// Pointers at least 16 bytes apart do not overlap within a vector iteration, otherwise the loop runs scalar
+static void vector_push_alias_check(Ctx ctx, TIdentifier name_1, TIdentifier name_2, TIdentifier target) {
+    shared_ptr_t(TacValue) ptr_1;
+    shared_ptr_t(TacValue) ptr_2;
+    {
+        shared_ptr_t(Type) var_type = make_ULong();
+        ptr_1 = make_TacVariable(unroll_make_var(ctx, name_1, &var_type));
+        shared_ptr_t(TacValue) src = make_TacVariable(name_1);
+        shared_ptr_t(TacValue) dst = unroll_copy_value(ptr_1);
+        unroll_push_instr(ctx, make_TacCopy(&src, &dst));
+    }
+    {
+        shared_ptr_t(Type) var_type = make_ULong();
+        ptr_2 = make_TacVariable(unroll_make_var(ctx, name_2, &var_type));
+        shared_ptr_t(TacValue) src = make_TacVariable(name_2);
+        shared_ptr_t(TacValue) dst = unroll_copy_value(ptr_2);
+        unroll_push_instr(ctx, make_TacCopy(&src, &dst));
+    }
+    shared_ptr_t(Type) var_type = make_ULong();
+    shared_ptr_t(TacValue) dst = make_TacVariable(unroll_make_var(ctx, name_1, &var_type));
+    shared_ptr_t(TacValue) distance = unroll_copy_value(dst);
+    TacBinaryOp binop = init_TacSubtract();
+    unroll_push_instr(ctx, make_TacBinary(&binop, &ptr_1, &ptr_2, &dst));
+
+    shared_ptr_t(CConst) constant = make_CConstULong(15ul);
+    shared_ptr_t(TacValue) src2 = make_TacConstant(&constant);
+    var_type = make_ULong();
+    dst = make_TacVariable(unroll_make_var(ctx, name_1, &var_type));
+    shared_ptr_t(TacValue) offset = unroll_copy_value(dst);
+    binop = init_TacAdd();
+    unroll_push_instr(ctx, make_TacBinary(&binop, &distance, &src2, &dst));
+
+    constant = make_CConstULong(31ul);
+    src2 = make_TacConstant(&constant);
+    var_type = make_Int();
+    dst = make_TacVariable(unroll_make_var(ctx, name_1, &var_type));
+    shared_ptr_t(TacValue) condition = unroll_copy_value(dst);
+    binop = init_TacGreaterOrEqual();
+    unroll_push_instr(ctx, make_TacBinary(&binop, &offset, &src2, &dst));
+    unroll_push_instr(ctx, make_TacJumpIfZero(target, &condition));
+}
+
+static void vector_push_alias_checks(Ctx ctx, TIdentifier target) {
+    for (size_t i = 0; i < vec_size(ctx->vector->store_names); ++i) {
+        TIdentifier store_name = ctx->vector->store_names[i];
+        for (size_t j = 0; j < vec_size(ctx->vector->base_names); ++j) {
+            TIdentifier base_name = ctx->vector->base_names[j];
+            bool is_checked = base_name == store_name;
+            for (size_t k = 0; k < i && !is_checked; ++k) {
+                is_checked = ctx->vector->store_names[k] == base_name;
+            }
+            if (!is_checked) {
+                vector_push_alias_check(ctx, store_name, base_name, target);
+            }
+        }
+    }
+}
+
+// Accumulators, splatted operands and intermediate results are set up before the loop
+static void vector_push_preheader(Ctx ctx, const UnrollLoop* loop, TIdentifier target) {
+    TIdentifier induction_name = loop->induction->get._TacVariable.name;
+    map_clear(ctx->vector->fold_map);
+    vec_clear(ctx->vector->acc_names);
+    vec_clear(ctx->vector->splat_names);
+    for (size_t i = 0; i < vec_size(ctx->vector->reduce_names); ++i) {
+        TIdentifier name = ctx->vector->reduce_names[i];
+        shared_ptr_t(TacValue) zero = vector_zero_value(ctx);
+        TIdentifier array_name = vector_make_array(ctx, name);
+        for (size_t j = 0; j < ctx->vector->lanes; ++j) {
+            shared_ptr_t(TacValue) src = unroll_copy_value(zero);
+            unroll_push_instr(ctx, make_TacCopyToOffset(array_name, (TLong)j * ctx->vector->elem_size, &src));
+        }
+        free_TacValue(&zero);
+        vec_push_back(ctx->vector->acc_names, array_name);
+        map_add(ctx->vector->vector_map, name, vector_push_address(ctx, array_name));
+    }
+    for (size_t instr_idx = loop->jump_idx + 1; instr_idx < loop->back_idx; ++instr_idx) {
+        const TacInstruction* node = GET_INSTR(instr_idx);
+        if (!node || instr_idx == loop->step_idx || instr_idx == loop->def_idx) {
+            continue;
+        }
+        else if (node->type == AST_TacBinary_t) {
+            const TacBinary* p_node = &node->get._TacBinary;
+            TIdentifier dst_name = p_node->dst->get._TacVariable.name;
+            if (map_find(ctx->vector->reduce_map, dst_name) != map_end()) {
+                continue;
+            }
+            vector_add_splat(ctx, induction_name, p_node->src1);
+            vector_add_splat(ctx, induction_name, p_node->src2);
+            TIdentifier ptr_name;
+            if (!vector_fold_store(ctx, loop, instr_idx, &ptr_name)) {
+                ptr_name = vector_push_address(ctx, vector_make_array(ctx, dst_name));
+            }
+            map_add(ctx->vector->vector_map, dst_name, ptr_name);
+        }
+        else if (node->type == AST_TacStore_t) {
+            vector_add_splat(ctx, induction_name, node->get._TacStore.src);
+        }
+    }
+    vector_push_alias_checks(ctx, target);
+}
+
+static shared_ptr_t(TacValue) vector_operand(Ctx ctx, const TacValue* node) {
+    if (is_vector_name(ctx, node)) {
+        return make_TacVariable(map_get(ctx->vector->vector_map, node->get._TacVariable.name));
+    }
+    TIdentifier ptr_name = ctx->vector->splat_names[ctx->vector->splat_idx];
+    ctx->vector->splat_idx++;
+    return make_TacVariable(ptr_name);
+}
+
+static void vector_push_binary(Ctx ctx, const TacBinary* node) {
+    TacBinaryOp binop = node->binop;
+    shared_ptr_t(TacValue) src1 = sptr_new();
+    shared_ptr_t(TacValue) src2 = sptr_new();
+    shared_ptr_t(TacValue) dst = sptr_new();
+    TIdentifier dst_name = node->dst->get._TacVariable.name;
+    if (map_find(ctx->vector->reduce_map, dst_name) != map_end()) {
+        TIdentifier acc_name = map_get(ctx->vector->vector_map, map_get(ctx->vector->reduce_map, dst_name));
+        src1 = make_TacVariable(acc_name);
+        bool is_src1_reduce = node->src1->type == AST_TacVariable_t
+                              && is_vector_reduce_name(ctx, node->src1->get._TacVariable.name);
+        src2 = vector_operand(ctx, is_src1_reduce ? node->src2 : node->src1);
+        dst = make_TacVariable(acc_name);
+    }
+    else {
+        src1 = vector_operand(ctx, node->src1);
+        src2 = vector_operand(ctx, node->src2);
+        dst = make_TacVariable(map_get(ctx->vector->vector_map, dst_name));
+    }
+    shared_ptr_t(Type) elem_type = vector_elem_type(ctx);
+    unroll_push_instr(ctx, make_TacVecBinary(&binop, &elem_type, &src1, &src2, &dst));
+}
+
+// Folded results are computed when they are stored, after the address of the store is computed
+static void vector_push_store(Ctx ctx, const TacStore* node) {
+    if (node->src->type == AST_TacVariable_t
+        && map_find(ctx->vector->fold_map, node->src->get._TacVariable.name) != map_end()) {
+        vector_push_binary(
+            ctx, &GET_INSTR(map_get(ctx->vector->fold_map, node->src->get._TacVariable.name))->get._TacBinary);
+        return;
+    }
+    else if (is_vector_name(ctx, node->src)
+        && map_get(ctx->vector->vector_map, node->src->get._TacVariable.name)
+               == node->dst_ptr->get._TacVariable.name) {
+        return;
+    }
+    shared_ptr_t(TacValue) src = vector_operand(ctx, node->src);
+    shared_ptr_t(TacValue) dst = unroll_copy_value(node->dst_ptr);
+    shared_ptr_t(Type) elem_type = vector_elem_type(ctx);
+    unroll_push_instr(ctx, make_TacVecCopy(&elem_type, &src, &dst));
+}
+
+static void vector_push_body(Ctx ctx, const UnrollLoop* loop) {
+    ctx->vector->splat_idx = 0;
+    for (size_t instr_idx = loop->jump_idx + 1; instr_idx < loop->back_idx; ++instr_idx) {
+        const TacInstruction* node = GET_INSTR(instr_idx);
+        if (!node || instr_idx == loop->step_idx || instr_idx == loop->def_idx) {
+            continue;
+        }
+        switch (node->type) {
+            case AST_TacCopy_t:
+                if (is_vector_reduce_name(ctx, node->get._TacCopy.dst->get._TacVariable.name)) {
+                    break;
+                }
+                unroll_push_instr(ctx, unroll_copy_instr(node));
+                break;
+            case AST_TacSignExtend_t:
+            case AST_TacZeroExtend_t:
+            case AST_TacAddPtr_t:
+                unroll_push_instr(ctx, unroll_copy_instr(node));
+                break;
+            case AST_TacBinary_t:
+                if (map_find(ctx->vector->fold_map, node->get._TacBinary.dst->get._TacVariable.name) == map_end()) {
+                    vector_push_binary(ctx, &node->get._TacBinary);
+                }
+                break;
+            case AST_TacStore_t:
+                vector_push_store(ctx, &node->get._TacStore);
+                break;
+            default:
+                break;
+        }
+    }
+    TacBinaryOp binop = init_TacAdd();
+    shared_ptr_t(TacValue) src1 = unroll_copy_value(loop->induction);
+    shared_ptr_t(TacValue) src2 = vector_lanes_value(ctx, loop);
+    shared_ptr_t(TacValue) dst = unroll_copy_value(loop->induction);
+    unroll_push_instr(ctx, make_TacBinary(&binop, &src1, &src2, &dst));
+}
+
+static void vector_push_reductions(Ctx ctx) {
+    for (size_t i = 0; i < vec_size(ctx->vector->reduce_names); ++i) {
+        TIdentifier name = ctx->vector->reduce_names[i];
+        for (size_t j = 0; j < ctx->vector->lanes; ++j) {
+            shared_ptr_t(Type) var_type = vector_elem_type(ctx);
+            shared_ptr_t(TacValue) src2 = make_TacVariable(unroll_make_var(ctx, name, &var_type));
+            {
+                shared_ptr_t(TacValue) dst = unroll_copy_value(src2);
+                unroll_push_instr(ctx, make_TacCopyFromOffset(
+                                           ctx->vector->acc_names[i], (TLong)j * ctx->vector->elem_size, &dst));
+            }
+            TacBinaryOp binop = init_TacAdd();
+            shared_ptr_t(TacValue) src1 = make_TacVariable(name);
+            shared_ptr_t(TacValue) dst = make_TacVariable(name);
+            unroll_push_instr(ctx, make_TacBinary(&binop, &src1, &src2, &dst));
+        }
+    }
+}
+
+// The vector body runs while enough iterations are left for all the lanes, then the remaining iterations
+// and the loops with overlapping arrays run scalar:
+// checks, Label(start), cond, vector body, Jump(start), Label(exit), sums, Label(remainder), scalar loop
+static void vectorize_loop(Ctx ctx, const UnrollLoop* loop) {
+    TIdentifier exit_name = unroll_make_label(ctx, loop);
+    TIdentifier remainder_name = unroll_make_label(ctx, loop);
+    vector_push_preheader(ctx, loop, exit_name);
+    unroll_move_instr(ctx, loop->start_idx);
+    unroll_push_cond(ctx, loop, exit_name);
+    unroll_push_count_check(ctx, loop, ctx->vector->lanes, exit_name);
+    vector_push_body(ctx, loop);
+    unroll_move_instr(ctx, loop->back_idx);
+
+    unroll_push_instr(ctx, make_TacLabel(exit_name));
+    vector_push_reductions(ctx);
+    unroll_push_instr(ctx, make_TacLabel(remainder_name));
+    unroll_move_instr(ctx, loop->cond_idx);
+    unroll_move_instr(ctx, loop->jump_idx);
+    for (size_t instr_idx = loop->jump_idx + 1; instr_idx < loop->back_idx; ++instr_idx) {
+        if (GET_INSTR(instr_idx)) {
+            unroll_move_instr(ctx, instr_idx);
+        }
+    }
+    unroll_push_instr(ctx, make_TacJump(remainder_name));
+    unroll_move_instr(ctx, loop->break_idx);
+}
+
+static void vectorize_loops(Ctx ctx) {
+    unroll_init_counts(ctx);
+    vec_clear(ctx->unroll->unroll_instrs);
+    for (size_t instr_idx = 0; instr_idx < vec_size(*ctx->p_instrs); ++instr_idx) {
+        if (!GET_INSTR(instr_idx)) {
+            continue;
+        }
+        if (GET_INSTR(instr_idx)->type == AST_TacLabel_t) {
+            UnrollLoop loop;
+            loop.start_idx = instr_idx;
+            if (unroll_loop_shape(ctx, &loop) && vector_match_loop(ctx, &loop)) {
+                vectorize_loop(ctx, &loop);
+                instr_idx = loop.break_idx;
+                continue;
+            }
+        }
+        unroll_move_instr(ctx, instr_idx);
+    }
+    unroll_swap_instrs(ctx);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 #define CONSTANT_FOLDING 0
 #define COPY_PROPAGATION 1
 #define UNREACHABLE_CODE_ELIMINATION 2
 #define DEAD_STORE_ELIMINATION 3
-#define CONTROL_FLOW_GRAPH 4
+#define LOOP_INVARIANT_CODE_MOTION 4
+#define GLOBAL_VALUE_NUMBERING 5
+#define SCALAR_REPLACEMENT 6
+#define LOOP_UNROLLING 7
+#define LOOP_VECTORIZATION 8
+#define CONTROL_FLOW_GRAPH 9
+
+static void report_fun_counts(Ctx ctx) {
+    if (ctx->report) {
+        ReportFunction* function = &vec_back(ctx->report->functions);
+        for (size_t instr_idx = 0; instr_idx < vec_size(*ctx->p_instrs); ++instr_idx) {
+            if (GET_INSTR(instr_idx)) {
+                function->instr_count++;
+            }
+        }
+        if (ctx->enabled_optims[CONTROL_FLOW_GRAPH]) {
+            function->block_count = vec_size(ctx->cfg->blocks);
+        }
+    }
+}
 
 static void optim_fun_toplvl(Ctx ctx, TacFunction* node) {
     ctx->p_instrs = &node->body;
+    report_function(ctx->report, node->name, STAGE_OptimTac);
+    if (ctx->enabled_optims[SCALAR_REPLACEMENT]) {
+        report_begin(ctx->report, STAGE_ScalarReplacement);
+        replace_aggregates(ctx, node);
+        report_end(ctx->report, STAGE_ScalarReplacement);
+    }
+    if (ctx->enabled_optims[LOOP_UNROLLING]) {
+        report_begin(ctx->report, STAGE_LoopUnrolling);
+        unroll_loops(ctx);
+        report_end(ctx->report, STAGE_LoopUnrolling);
+    }
     do {
         ctx->is_fixed_point = true;
+        REPORT_FUN_COUNT(ctx->report, fixed_point_count, 1);
         if (ctx->enabled_optims[CONSTANT_FOLDING]) {
+            report_begin(ctx->report, STAGE_ConstantFolding);
             fold_constants(ctx);
+            report_end(ctx->report, STAGE_ConstantFolding);
         }
         if (ctx->enabled_optims[CONTROL_FLOW_GRAPH]) {
+            report_begin(ctx->report, STAGE_ControlFlowGraph);
             init_control_flow_graph(ctx);
+            report_end(ctx->report, STAGE_ControlFlowGraph);
             if (ctx->enabled_optims[UNREACHABLE_CODE_ELIMINATION]) {
+                report_begin(ctx->report, STAGE_UnreachableCode);
                 eliminate_unreachable_code(ctx);
+                report_end(ctx->report, STAGE_UnreachableCode);
+            }
+            if (ctx->enabled_optims[GLOBAL_VALUE_NUMBERING]) {
+                report_begin(ctx->report, STAGE_GlobalValueNumbering);
+                number_global_values(ctx);
+                report_end(ctx->report, STAGE_GlobalValueNumbering);
             }
             if (ctx->enabled_optims[COPY_PROPAGATION]) {
+                report_begin(ctx->report, STAGE_CopyPropagation);
                 propagate_copies(ctx);
+                report_end(ctx->report, STAGE_CopyPropagation);
             }
             if (ctx->enabled_optims[DEAD_STORE_ELIMINATION]) {
+                report_begin(ctx->report, STAGE_DeadStore);
                 eliminate_dead_stores(ctx, !ctx->enabled_optims[COPY_PROPAGATION]);
+                report_end(ctx->report, STAGE_DeadStore);
+            }
+            if (ctx->enabled_optims[LOOP_INVARIANT_CODE_MOTION]) {
+                report_begin(ctx->report, STAGE_LoopInvariant);
+                hoist_loop_invariants(ctx);
+                report_end(ctx->report, STAGE_LoopInvariant);
             }
         }
     }
     while (!ctx->is_fixed_point);
+    if (ctx->enabled_optims[LOOP_VECTORIZATION]) {
+        report_begin(ctx->report, STAGE_LoopVectorization);
+        vectorize_loops(ctx);
+        report_end(ctx->report, STAGE_LoopVectorization);
+    }
+    report_fun_counts(ctx);
     ctx->p_instrs = NULL;
 }
 
@@ -2672,22 +6001,45 @@ static void optim_program(Ctx ctx, const TacProgram* node) {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void optimize_three_address_code(const TacProgram* node, FrontEndContext* frontend, uint8_t optim_1_mask) {
+void optimize_three_address_code(const TacProgram* node, FrontEndContext* frontend, IdentifierContext* identifiers,
+    TimeReportContext* report, uint8_t optim_1_mask, uint8_t unroll_factor, uint8_t unroll_budget,
+    bool is_vectorize) {
     OptimTacContext ctx;
     {
         ctx.frontend = frontend;
+        ctx.identifiers = identifiers;
+        ctx.report = report;
         ctx.is_fixed_point = true;
 
         ctx.enabled_optims[CONSTANT_FOLDING] = (optim_1_mask & (((uint8_t)1u) << 0)) > 0;
         ctx.enabled_optims[COPY_PROPAGATION] = (optim_1_mask & (((uint8_t)1u) << 1)) > 0;
         ctx.enabled_optims[UNREACHABLE_CODE_ELIMINATION] = (optim_1_mask & (((uint8_t)1u) << 2)) > 0;
         ctx.enabled_optims[DEAD_STORE_ELIMINATION] = (optim_1_mask & (((uint8_t)1u) << 3)) > 0;
-        ctx.enabled_optims[CONTROL_FLOW_GRAPH] = (optim_1_mask & ~(((uint8_t)1u) << 0)) > 0;
+        ctx.enabled_optims[LOOP_INVARIANT_CODE_MOTION] = (optim_1_mask & (((uint8_t)1u) << 4)) > 0;
+        ctx.enabled_optims[GLOBAL_VALUE_NUMBERING] = (optim_1_mask & (((uint8_t)1u) << 5)) > 0;
+        ctx.enabled_optims[SCALAR_REPLACEMENT] = (optim_1_mask & (((uint8_t)1u) << 6)) > 0;
+        ctx.enabled_optims[LOOP_UNROLLING] = (optim_1_mask & (((uint8_t)1u) << 7)) > 0;
+        ctx.enabled_optims[LOOP_VECTORIZATION] = is_vectorize;
+        ctx.enabled_optims[CONTROL_FLOW_GRAPH] =
+            (optim_1_mask & ~((((uint8_t)1u) << 0) | (((uint8_t)1u) << 6) | (((uint8_t)1u) << 7))) > 0;
 
         ctx.cfg = uptr_new();
         ctx.dfa = uptr_new();
         ctx.dfa_o1 = uptr_new();
+        ctx.dom = uptr_new();
+        ctx.sra = uptr_new();
+        ctx.unroll = uptr_new();
+        ctx.vector = uptr_new();
 
+        if (ctx.enabled_optims[SCALAR_REPLACEMENT]) {
+            ctx.sra = make_ScalarReplacement();
+        }
+        if (ctx.enabled_optims[LOOP_UNROLLING] || ctx.enabled_optims[LOOP_VECTORIZATION]) {
+            ctx.unroll = make_LoopUnrolling(unroll_factor, unroll_budget);
+        }
+        if (ctx.enabled_optims[LOOP_VECTORIZATION]) {
+            ctx.vector = make_LoopVectorization();
+        }
         if (ctx.enabled_optims[CONTROL_FLOW_GRAPH]) {
             ctx.cfg = make_ControlFlowGraph();
 
@@ -2695,6 +6047,9 @@ void optimize_three_address_code(const TacProgram* node, FrontEndContext* fronte
                 ctx.dfa = make_DataFlowAnalysis();
                 ctx.dfa_o1 = make_DataFlowAnalysisO1();
             }
+            if (ctx.enabled_optims[LOOP_INVARIANT_CODE_MOTION] || ctx.enabled_optims[GLOBAL_VALUE_NUMBERING]) {
+                ctx.dom = make_DominatorAnalysis();
+            }
         }
     }
     optim_program(&ctx, node);
@@ -2702,4 +6057,8 @@ void optimize_three_address_code(const TacProgram* node, FrontEndContext* fronte
     free_ControlFlowGraph(&ctx.cfg);
     free_DataFlowAnalysis(&ctx.dfa);
     free_DataFlowAnalysisO1(&ctx.dfa_o1);
+    free_DominatorAnalysis(&ctx.dom);
+    free_ScalarReplacement(&ctx.sra);
+    free_LoopUnrolling(&ctx.unroll);
+    free_LoopVectorization(&ctx.vector);
 }
@@ -0,0 +1,394 @@
+#include <stdio.h>
+
+#include "util/c_std.h"
+#include "util/throw.h"
+
+#include "ast/back_ast.h"
+#include "ast/back_symt.h"
+#include "ast_t.h" // ast
+
+#include "optimization/peephole.h"
+
+#define PEEPHOLE_RULES_SIZE 7
+
+typedef struct PeepholeContext {
+    // Peephole optimization
+    bool is_fixed_point;
+    size_t rule_hits[PEEPHOLE_RULES_SIZE];
+    vector_t(unique_ptr_t(AsmInstruction)) * p_instrs;
+} PeepholeContext;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Peephole optimization
+
+typedef PeepholeContext* Ctx;
+
+#define GET_INSTR(X) (*ctx->p_instrs)[X]
+
+static size_t next_instr_idx(Ctx ctx, size_t instr_idx) {
+    for (++instr_idx; instr_idx < vec_size(*ctx->p_instrs); ++instr_idx) {
+        if (GET_INSTR(instr_idx)) {
+            break;
+        }
+    }
+    return instr_idx;
+}
+
+static void set_instr(Ctx ctx, unique_ptr_t(AsmInstruction) instr, size_t instr_idx) {
+    if (instr) {
+        uptr_move(AsmInstruction, instr, GET_INSTR(instr_idx));
+    }
+    else {
+        free_AsmInstruction(&GET_INSTR(instr_idx));
+    }
+}
+
+static bool is_same_reg(const AsmReg* reg_1, const AsmReg* reg_2) { return reg_1->type == reg_2->type; }
+
+static bool is_same_operand(const AsmOperand* node_1, const AsmOperand* node_2) {
+    if (node_1->type != node_2->type) {
+        return false;
+    }
+    switch (node_1->type) {
+        case AST_AsmImm_t:
+            return node_1->get._AsmImm.value == node_2->get._AsmImm.value;
+        case AST_AsmRegister_t:
+            return is_same_reg(&node_1->get._AsmRegister.reg, &node_2->get._AsmRegister.reg);
+        case AST_AsmMemory_t:
+            return node_1->get._AsmMemory.value == node_2->get._AsmMemory.value
+                   && is_same_reg(&node_1->get._AsmMemory.reg, &node_2->get._AsmMemory.reg);
+        case AST_AsmData_t:
+            return node_1->get._AsmData.name == node_2->get._AsmData.name
+                   && node_1->get._AsmData.offset == node_2->get._AsmData.offset;
+        case AST_AsmIndexed_t:
+            return node_1->get._AsmIndexed.scale == node_2->get._AsmIndexed.scale
+                   && is_same_reg(&node_1->get._AsmIndexed.reg_base, &node_2->get._AsmIndexed.reg_base)
+                   && is_same_reg(&node_1->get._AsmIndexed.reg_index, &node_2->get._AsmIndexed.reg_index);
+        default:
+            THROW_ABORT;
+    }
+}
+
+static bool is_op_addr(const AsmOperand* node) {
+    switch (node->type) {
+        case AST_AsmMemory_t:
+        case AST_AsmData_t:
+        case AST_AsmIndexed_t:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool is_op_addr_reg(const AsmOperand* node, const AsmReg* reg) {
+    switch (node->type) {
+        case AST_AsmMemory_t:
+            return is_same_reg(&node->get._AsmMemory.reg, reg);
+        case AST_AsmIndexed_t:
+            return is_same_reg(&node->get._AsmIndexed.reg_base, reg)
+                   || is_same_reg(&node->get._AsmIndexed.reg_index, reg);
+        default:
+            return false;
+    }
+}
+
+static bool is_op_zero_imm(const AsmOperand* node) {
+    return node->type == AST_AsmImm_t && node->get._AsmImm.value == 0ul;
+}
+
+static bool is_op_sse_reg(const AsmOperand* node) {
+    if (node->type != AST_AsmRegister_t) {
+        return false;
+    }
+    switch (node->get._AsmRegister.reg.type) {
+        case AST_AsmXMM0_t:
+        case AST_AsmXMM1_t:
+        case AST_AsmXMM2_t:
+        case AST_AsmXMM3_t:
+        case AST_AsmXMM4_t:
+        case AST_AsmXMM5_t:
+        case AST_AsmXMM6_t:
+        case AST_AsmXMM7_t:
+        case AST_AsmXMM8_t:
+        case AST_AsmXMM9_t:
+        case AST_AsmXMM10_t:
+        case AST_AsmXMM11_t:
+        case AST_AsmXMM12_t:
+        case AST_AsmXMM13_t:
+        case AST_AsmXMM14_t:
+        case AST_AsmXMM15_t:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// A 32-bit mov to a register also clears the upper half of the 64-bit register, so it is never a no-op
+static bool is_mov_type_no_extend(const AssemblyType* asm_type) {
+    switch (asm_type->type) {
+        case AST_Byte_t:
+        case AST_QuadWord_t:
+        case AST_BackendDouble_t:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool is_next_label(Ctx ctx, size_t instr_idx, TIdentifier target) {
+    for (instr_idx = next_instr_idx(ctx, instr_idx);
+         instr_idx < vec_size(*ctx->p_instrs) && GET_INSTR(instr_idx)->type == AST_AsmLabel_t;
+         instr_idx = next_instr_idx(ctx, instr_idx)) {
+        if (GET_INSTR(instr_idx)->get._AsmLabel.name == target) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool is_flags_dead(Ctx ctx, size_t instr_idx) {
+    for (instr_idx = next_instr_idx(ctx, instr_idx); instr_idx < vec_size(*ctx->p_instrs);
+         instr_idx = next_instr_idx(ctx, instr_idx)) {
+        const AsmInstruction* node = GET_INSTR(instr_idx);
+        switch (node->type) {
+            case AST_AsmCmp_t:
+            case AST_AsmTest_t:
+            case AST_AsmIdiv_t:
+            case AST_AsmDiv_t:
+            case AST_AsmCall_t:
+            case AST_AsmTailCall_t:
+            case AST_AsmRet_t:
+                return true;
+            case AST_AsmUnary_t: {
+                if (node->get._AsmUnary.unop.type != AST_AsmNot_t) {
+                    return true;
+                }
+                break;
+            }
+            case AST_AsmBinary_t: {
+                if (node->get._AsmBinary.asm_type->type != AST_BackendDouble_t) {
+                    switch (node->get._AsmBinary.binop.type) {
+                        case AST_AsmBitShiftLeft_t:
+                        case AST_AsmBitShiftRight_t:
+                        case AST_AsmBitShrArithmetic_t:
+                            break;
+                        default:
+                            return true;
+                    }
+                }
+                break;
+            }
+            case AST_AsmJmp_t:
+            case AST_AsmJmpCC_t:
+            case AST_AsmSetCC_t:
+            case AST_AsmLabel_t:
+                return false;
+            default:
+                break;
+        }
+    }
+    return false;
+}
+
+// Mov(t, Reg(r), Reg(r)) -> _
+static bool peep_self_mov(Ctx ctx, size_t instr_idx) {
+    const AsmMov* node = &GET_INSTR(instr_idx)->get._AsmMov;
+    if (node->src->type != AST_AsmRegister_t || !is_same_operand(node->src, node->dst)
+        || !is_mov_type_no_extend(node->asm_type)) {
+        return false;
+    }
+    set_instr(ctx, uptr_new(), instr_idx);
+    return true;
+}
+
+// Jmp(label), Label(label) -> Label(label)
+static bool peep_jmp_next_label(Ctx ctx, size_t instr_idx) {
+    if (!is_next_label(ctx, instr_idx, GET_INSTR(instr_idx)->get._AsmJmp.target)) {
+        return false;
+    }
+    set_instr(ctx, uptr_new(), instr_idx);
+    return true;
+}
+
+// JmpCC(cond_code, label), Label(label) -> Label(label)
+static bool peep_jmp_cc_next_label(Ctx ctx, size_t instr_idx) {
+    if (!is_next_label(ctx, instr_idx, GET_INSTR(instr_idx)->get._AsmJmpCC.target)) {
+        return false;
+    }
+    set_instr(ctx, uptr_new(), instr_idx);
+    return true;
+}
+
+// Cmp(t, Imm(0), Reg(r)) -> Test(t, Reg(r), Reg(r))
+static bool peep_cmp_zero_test(Ctx ctx, size_t instr_idx) {
+    const AsmCmp* node = &GET_INSTR(instr_idx)->get._AsmCmp;
+    if (node->asm_type->type == AST_BackendDouble_t || !is_op_zero_imm(node->src)
+        || node->dst->type != AST_AsmRegister_t) {
+        return false;
+    }
+    shared_ptr_t(AssemblyType) asm_type = sptr_new();
+    sptr_copy(AssemblyType, node->asm_type, asm_type);
+    shared_ptr_t(AsmOperand) src = sptr_new();
+    sptr_copy(AsmOperand, node->dst, src);
+    shared_ptr_t(AsmOperand) dst = sptr_new();
+    sptr_copy(AsmOperand, node->dst, dst);
+    set_instr(ctx, make_AsmTest(&asm_type, &src, &dst), instr_idx);
+    return true;
+}
+
+// Mov(t, Imm(0), Reg(r)) -> Binary(BitXor, t, Reg(r), Reg(r)), if flags are dead
+static bool peep_mov_zero_xor(Ctx ctx, size_t instr_idx) {
+    const AsmMov* node = &GET_INSTR(instr_idx)->get._AsmMov;
+    if (node->asm_type->type == AST_BackendDouble_t || !is_op_zero_imm(node->src)
+        || node->dst->type != AST_AsmRegister_t || is_op_sse_reg(node->dst) || !is_flags_dead(ctx, instr_idx)) {
+        return false;
+    }
+    AsmBinaryOp binop = init_AsmBitXor();
+    shared_ptr_t(AssemblyType) asm_type = sptr_new();
+    if (node->asm_type->type == AST_QuadWord_t) {
+        asm_type = make_LongWord();
+    }
+    else {
+        sptr_copy(AssemblyType, node->asm_type, asm_type);
+    }
+    shared_ptr_t(AsmOperand) src = sptr_new();
+    sptr_copy(AsmOperand, node->dst, src);
+    shared_ptr_t(AsmOperand) dst = sptr_new();
+    sptr_copy(AsmOperand, node->dst, dst);
+    set_instr(ctx, make_AsmBinary(&binop, &asm_type, &src, &dst), instr_idx);
+    return true;
+}
+
+// Mov(t, Reg(r), addr), Mov(t, addr, Reg(r)) -> Mov(t, Reg(r), addr)
+static bool peep_store_load(Ctx ctx, size_t instr_idx) {
+    const AsmMov* node = &GET_INSTR(instr_idx)->get._AsmMov;
+    if (node->src->type != AST_AsmRegister_t || !is_op_addr(node->dst) || !is_mov_type_no_extend(node->asm_type)) {
+        return false;
+    }
+    size_t next_idx = next_instr_idx(ctx, instr_idx);
+    if (next_idx == vec_size(*ctx->p_instrs) || GET_INSTR(next_idx)->type != AST_AsmMov_t) {
+        return false;
+    }
+    const AsmMov* next_node = &GET_INSTR(next_idx)->get._AsmMov;
+    if (next_node->asm_type->type != node->asm_type->type || !is_same_operand(next_node->src, node->dst)
+        || !is_same_operand(next_node->dst, node->src)) {
+        return false;
+    }
+    set_instr(ctx, uptr_new(), next_idx);
+    return true;
+}
+
+// Mov(t, addr, Reg(r)), Mov(t, Reg(r), addr) -> Mov(t, addr, Reg(r))
+static bool peep_load_store(Ctx ctx, size_t instr_idx) {
+    const AsmMov* node = &GET_INSTR(instr_idx)->get._AsmMov;
+    if (node->dst->type != AST_AsmRegister_t || !is_op_addr(node->src)
+        || is_op_addr_reg(node->src, &node->dst->get._AsmRegister.reg)) {
+        return false;
+    }
+    size_t next_idx = next_instr_idx(ctx, instr_idx);
+    if (next_idx == vec_size(*ctx->p_instrs) || GET_INSTR(next_idx)->type != AST_AsmMov_t) {
+        return false;
+    }
+    const AsmMov* next_node = &GET_INSTR(next_idx)->get._AsmMov;
+    if (next_node->asm_type->type != node->asm_type->type || !is_same_operand(next_node->src, node->dst)
+        || !is_same_operand(next_node->dst, node->src)) {
+        return false;
+    }
+    set_instr(ctx, uptr_new(), next_idx);
+    return true;
+}
+
+typedef struct PeepholeRule {
+    const char* name;
+    AST_T instr_type;
+    bool (*apply)(Ctx ctx, size_t instr_idx);
+} PeepholeRule;
+
+static const PeepholeRule PEEPHOLE_RULES[PEEPHOLE_RULES_SIZE] = {
+    {"self move", AST_AsmMov_t, peep_self_mov},
+    {"jump to next label", AST_AsmJmp_t, peep_jmp_next_label},
+    {"cond jump to next label", AST_AsmJmpCC_t, peep_jmp_cc_next_label},
+    {"compare zero as test", AST_AsmCmp_t, peep_cmp_zero_test},
+    {"move zero as xor", AST_AsmMov_t, peep_mov_zero_xor},
+    {"store then load", AST_AsmMov_t, peep_store_load},
+    {"load then store", AST_AsmMov_t, peep_load_store},
+};
+
+static void peep_instr(Ctx ctx, size_t instr_idx) {
+    for (size_t i = 0; i < PEEPHOLE_RULES_SIZE; ++i) {
+        if (GET_INSTR(instr_idx)->type == PEEPHOLE_RULES[i].instr_type && PEEPHOLE_RULES[i].apply(ctx, instr_idx)) {
+            ctx->rule_hits[i]++;
+            ctx->is_fixed_point = false;
+            return;
+        }
+    }
+}
+
+static void peep_fun_toplvl(Ctx ctx, AsmFunction* node) {
+    ctx->p_instrs = &node->instructions;
+    do {
+        ctx->is_fixed_point = true;
+        for (size_t instr_idx = 0; instr_idx < vec_size(*ctx->p_instrs); ++instr_idx) {
+            if (GET_INSTR(instr_idx)) {
+                peep_instr(ctx, instr_idx);
+            }
+        }
+    }
+    while (!ctx->is_fixed_point);
+
+    size_t instrs_size = 0;
+    for (size_t instr_idx = 0; instr_idx < vec_size(*ctx->p_instrs); ++instr_idx) {
+        if (GET_INSTR(instr_idx)) {
+            if (instr_idx > instrs_size) {
+                uptr_move(AsmInstruction, GET_INSTR(instr_idx), GET_INSTR(instrs_size));
+            }
+            instrs_size++;
+        }
+    }
+    vec_resize(*ctx->p_instrs, instrs_size);
+    ctx->p_instrs = NULL;
+}
+
+static void peep_toplvl(Ctx ctx, AsmTopLevel* node) {
+    switch (node->type) {
+        case AST_AsmFunction_t:
+            peep_fun_toplvl(ctx, &node->get._AsmFunction);
+            break;
+        case AST_AsmStaticVariable_t:
+            break;
+        default:
+            THROW_ABORT;
+    }
+}
+
+static void peep_program(Ctx ctx, const AsmProgram* node) {
+    for (size_t i = 0; i < vec_size(node->top_levels); ++i) {
+        peep_toplvl(ctx, node->top_levels[i]);
+    }
+}
+
+static void print_rule_hits(Ctx ctx) {
+    for (size_t i = 0; i < PEEPHOLE_RULES_SIZE; ++i) {
+        if (ctx->rule_hits[i] > 0) {
+            printf("(%s: %zu) ", PEEPHOLE_RULES[i].name, ctx->rule_hits[i]);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void optimize_peephole(const AsmProgram* node, bool is_verbose) {
+    PeepholeContext ctx;
+    {
+        ctx.is_fixed_point = true;
+        for (size_t i = 0; i < PEEPHOLE_RULES_SIZE; ++i) {
+            ctx.rule_hits[i] = 0;
+        }
+    }
+    peep_program(&ctx, node);
+
+    if (is_verbose) {
+        print_rule_hits(&ctx);
+    }
+}
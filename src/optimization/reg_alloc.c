@@ -2,6 +2,7 @@
 
 #include "util/c_std.h"
 #include "util/throw.h"
+#include "util/time_report.h"
 
 #include "ast/back_ast.h"
 #include "ast/back_symt.h"
@@ -41,18 +42,20 @@ typedef struct InferenceGraph {
 typedef struct RegAllocContext {
     BackEndContext* backend;
     FrontEndContext* frontend;
+    TimeReportContext* report;
     // Register allocation
     mask_t callee_saved_reg_mask;
     BackendFun* p_backend_fun;
     InferenceGraph* p_infer_graph;
-    REGISTER_KIND reg_color_map[26];
-    InferenceRegister hard_regs[26];
+    REGISTER_KIND reg_color_map[27];
+    InferenceRegister hard_regs[27];
     unique_ptr_t(ControlFlowGraph) cfg;
     unique_ptr_t(DataFlowAnalysis) dfa;
     unique_ptr_t(DataFlowAnalysisO2) dfa_o2;
     unique_ptr_t(InferenceGraph) infer_graph;
     unique_ptr_t(InferenceGraph) sse_infer_graph;
     vector_t(unique_ptr_t(AsmInstruction)) * p_instrs;
+    size_t spill_weight;
     // Register coalescing
     bool is_with_coal;
 } RegAllocContext;
@@ -68,7 +71,7 @@ static void free_InferenceGraph(unique_ptr_t(InferenceGraph) * self) {
     uptr_free(*self);
 }
 
-static unique_ptr_t(InferenceGraph) make_InferenceGraph(bool is_sse) {
+static unique_ptr_t(InferenceGraph) make_InferenceGraph(bool is_sse, bool is_omit_frame_ptr) {
     unique_ptr_t(InferenceGraph) self = uptr_new();
     uptr_alloc(InferenceGraph, self);
     self->hard_reg_mask = REGISTER_MASK_FALSE;
@@ -77,7 +80,7 @@ static unique_ptr_t(InferenceGraph) make_InferenceGraph(bool is_sse) {
     self->pseudo_reg_map = map_new();
     if (is_sse) {
         self->k = 14;
-        self->offset = 12;
+        self->offset = 13;
         register_mask_set(&self->hard_reg_mask, REG_Xmm0, true);
         register_mask_set(&self->hard_reg_mask, REG_Xmm1, true);
         register_mask_set(&self->hard_reg_mask, REG_Xmm2, true);
@@ -108,6 +111,10 @@ static unique_ptr_t(InferenceGraph) make_InferenceGraph(bool is_sse) {
         register_mask_set(&self->hard_reg_mask, REG_R13, true);
         register_mask_set(&self->hard_reg_mask, REG_R14, true);
         register_mask_set(&self->hard_reg_mask, REG_R15, true);
+        if (is_omit_frame_ptr) {
+            self->k++;
+            register_mask_set(&self->hard_reg_mask, REG_Bp, true);
+        }
     }
     return self;
 }
@@ -194,8 +201,8 @@ static void infer_transfer_used_op(Ctx ctx, const AsmOperand* node, size_t next_
     }
 }
 
-static void infer_transfer_used_call(Ctx ctx, const AsmCall* node, size_t next_instr_idx) {
-    const FunType* fun_type = &map_get(ctx->frontend->symbol_table, node->name)->type_t->get._FunType;
+static void infer_transfer_used_call(Ctx ctx, TIdentifier name, size_t next_instr_idx) {
+    const FunType* fun_type = &map_get(ctx->frontend->symbol_table, name)->type_t->get._FunType;
     GET_DFA_INSTR_SET_MASK(next_instr_idx, 0) |= fun_type->param_reg_mask;
 }
 
@@ -236,6 +243,30 @@ static void infer_transfer_updated_op(Ctx ctx, const AsmOperand* node, size_t ne
     }
 }
 
+static void infer_transfer_updated_call(Ctx ctx, size_t next_instr_idx) {
+    infer_transfer_updated_reg(ctx, REG_Ax, next_instr_idx);
+    infer_transfer_updated_reg(ctx, REG_Cx, next_instr_idx);
+    infer_transfer_updated_reg(ctx, REG_Dx, next_instr_idx);
+    infer_transfer_updated_reg(ctx, REG_Di, next_instr_idx);
+    infer_transfer_updated_reg(ctx, REG_Si, next_instr_idx);
+    infer_transfer_updated_reg(ctx, REG_R8, next_instr_idx);
+    infer_transfer_updated_reg(ctx, REG_R9, next_instr_idx);
+    infer_transfer_updated_reg(ctx, REG_Xmm0, next_instr_idx);
+    infer_transfer_updated_reg(ctx, REG_Xmm1, next_instr_idx);
+    infer_transfer_updated_reg(ctx, REG_Xmm2, next_instr_idx);
+    infer_transfer_updated_reg(ctx, REG_Xmm3, next_instr_idx);
+    infer_transfer_updated_reg(ctx, REG_Xmm4, next_instr_idx);
+    infer_transfer_updated_reg(ctx, REG_Xmm5, next_instr_idx);
+    infer_transfer_updated_reg(ctx, REG_Xmm6, next_instr_idx);
+    infer_transfer_updated_reg(ctx, REG_Xmm7, next_instr_idx);
+    infer_transfer_updated_reg(ctx, REG_Xmm8, next_instr_idx);
+    infer_transfer_updated_reg(ctx, REG_Xmm9, next_instr_idx);
+    infer_transfer_updated_reg(ctx, REG_Xmm10, next_instr_idx);
+    infer_transfer_updated_reg(ctx, REG_Xmm11, next_instr_idx);
+    infer_transfer_updated_reg(ctx, REG_Xmm12, next_instr_idx);
+    infer_transfer_updated_reg(ctx, REG_Xmm13, next_instr_idx);
+}
+
 static void infer_transfer_live_regs(Ctx ctx, size_t instr_idx, size_t next_instr_idx) {
     const AsmInstruction* node = GET_INSTR(instr_idx);
     switch (node->type) {
@@ -287,6 +318,18 @@ static void infer_transfer_live_regs(Ctx ctx, size_t instr_idx, size_t next_inst
             }
             break;
         }
+        case AST_AsmMovPacked_t: {
+            const AsmMovPacked* p_node = &node->get._AsmMovPacked;
+            infer_transfer_updated_op(ctx, p_node->dst, next_instr_idx);
+            infer_transfer_used_op(ctx, p_node->src, next_instr_idx);
+            break;
+        }
+        case AST_AsmBinaryPacked_t: {
+            const AsmBinaryPacked* p_node = &node->get._AsmBinaryPacked;
+            infer_transfer_used_op(ctx, p_node->src, next_instr_idx);
+            infer_transfer_used_op(ctx, p_node->dst, next_instr_idx);
+            break;
+        }
         case AST_AsmCmp_t: {
             const AsmCmp* p_node = &node->get._AsmCmp;
             infer_transfer_used_op(ctx, p_node->src, next_instr_idx);
@@ -313,28 +356,12 @@ static void infer_transfer_live_regs(Ctx ctx, size_t instr_idx, size_t next_inst
             infer_transfer_used_op(ctx, node->get._AsmPush.src, next_instr_idx);
             break;
         case AST_AsmCall_t:
-            infer_transfer_updated_reg(ctx, REG_Ax, next_instr_idx);
-            infer_transfer_updated_reg(ctx, REG_Cx, next_instr_idx);
-            infer_transfer_updated_reg(ctx, REG_Dx, next_instr_idx);
-            infer_transfer_updated_reg(ctx, REG_Di, next_instr_idx);
-            infer_transfer_updated_reg(ctx, REG_Si, next_instr_idx);
-            infer_transfer_updated_reg(ctx, REG_R8, next_instr_idx);
-            infer_transfer_updated_reg(ctx, REG_R9, next_instr_idx);
-            infer_transfer_updated_reg(ctx, REG_Xmm0, next_instr_idx);
-            infer_transfer_updated_reg(ctx, REG_Xmm1, next_instr_idx);
-            infer_transfer_updated_reg(ctx, REG_Xmm2, next_instr_idx);
-            infer_transfer_updated_reg(ctx, REG_Xmm3, next_instr_idx);
-            infer_transfer_updated_reg(ctx, REG_Xmm4, next_instr_idx);
-            infer_transfer_updated_reg(ctx, REG_Xmm5, next_instr_idx);
-            infer_transfer_updated_reg(ctx, REG_Xmm6, next_instr_idx);
-            infer_transfer_updated_reg(ctx, REG_Xmm7, next_instr_idx);
-            infer_transfer_updated_reg(ctx, REG_Xmm8, next_instr_idx);
-            infer_transfer_updated_reg(ctx, REG_Xmm9, next_instr_idx);
-            infer_transfer_updated_reg(ctx, REG_Xmm10, next_instr_idx);
-            infer_transfer_updated_reg(ctx, REG_Xmm11, next_instr_idx);
-            infer_transfer_updated_reg(ctx, REG_Xmm12, next_instr_idx);
-            infer_transfer_updated_reg(ctx, REG_Xmm13, next_instr_idx);
-            infer_transfer_used_call(ctx, &node->get._AsmCall, next_instr_idx);
+            infer_transfer_updated_call(ctx, next_instr_idx);
+            infer_transfer_used_call(ctx, node->get._AsmCall.name, next_instr_idx);
+            break;
+        case AST_AsmTailCall_t:
+            infer_transfer_updated_call(ctx, next_instr_idx);
+            infer_transfer_used_call(ctx, node->get._AsmTailCall.name, next_instr_idx);
             break;
         default:
             THROW_ABORT;
@@ -403,7 +430,7 @@ static void infer_rm_unpruned_pseudo_name(Ctx ctx, TIdentifier name) {
 static void infer_init_used_name_edges(Ctx ctx, TIdentifier name) {
     if (!is_aliased_name(ctx, name)) {
         set_p_infer_graph(ctx, map_get(ctx->frontend->symbol_table, name)->type_t->type == AST_Double_t);
-        map_get(ctx->p_infer_graph->pseudo_reg_map, name).spill_cost++;
+        map_get(ctx->p_infer_graph->pseudo_reg_map, name).spill_cost += ctx->spill_weight;
     }
 }
 
@@ -428,7 +455,7 @@ static void infer_init_updated_regs_edges(
             else {
                 bool is_src_dbl = map_get(ctx->frontend->symbol_table, src_name)->type_t->type == AST_Double_t;
                 set_p_infer_graph(ctx, is_src_dbl);
-                map_get(ctx->p_infer_graph->pseudo_reg_map, src_name).spill_cost++;
+                map_get(ctx->p_infer_graph->pseudo_reg_map, src_name).spill_cost += ctx->spill_weight;
                 mov_mask_bit = map_get(ctx->cfg->identifier_id_map, src_name);
                 is_mov = is_dbl == is_src_dbl;
             }
@@ -492,7 +519,7 @@ static void infer_init_updated_name_edges(Ctx ctx, TIdentifier name, size_t inst
                 }
                 else {
                     mov_mask_bit = register_mask_bit(src_reg_kind);
-                    is_mov = is_dbl == (mov_mask_bit > 11);
+                    is_mov = is_dbl == (mov_mask_bit > 12);
                 }
                 break;
             }
@@ -504,7 +531,7 @@ static void infer_init_updated_name_edges(Ctx ctx, TIdentifier name, size_t inst
                 else {
                     bool is_src_dbl = map_get(ctx->frontend->symbol_table, src_name)->type_t->type == AST_Double_t;
                     set_p_infer_graph(ctx, is_src_dbl);
-                    map_get(ctx->p_infer_graph->pseudo_reg_map, src_name).spill_cost++;
+                    map_get(ctx->p_infer_graph->pseudo_reg_map, src_name).spill_cost += ctx->spill_weight;
                     mov_mask_bit = map_get(ctx->cfg->identifier_id_map, src_name);
                     is_mov = is_dbl == is_src_dbl;
                 }
@@ -517,7 +544,7 @@ static void infer_init_updated_name_edges(Ctx ctx, TIdentifier name, size_t inst
                 }
                 else {
                     mov_mask_bit = register_mask_bit(src_reg_kind);
-                    is_mov = is_dbl == (mov_mask_bit > 11);
+                    is_mov = is_dbl == (mov_mask_bit > 12);
                 }
                 break;
             }
@@ -530,7 +557,7 @@ static void infer_init_updated_name_edges(Ctx ctx, TIdentifier name, size_t inst
         }
     }
     set_p_infer_graph(ctx, is_dbl);
-    map_get(ctx->p_infer_graph->pseudo_reg_map, name).spill_cost++;
+    map_get(ctx->p_infer_graph->pseudo_reg_map, name).spill_cost += ctx->spill_weight;
 
     if (GET_DFA_INSTR_SET_MASK(instr_idx, 0) != MASK_FALSE) {
         size_t i = ctx->p_infer_graph->offset;
@@ -580,7 +607,7 @@ static void infer_init_updated_op_edges(Ctx ctx, const AsmOperand* node, size_t
         case AST_AsmRegister_t: {
             REGISTER_KIND reg_kinds[1] = {register_mask_kind(&node->get._AsmRegister.reg)};
             if (reg_kinds[0] != REG_Sp) {
-                bool is_dbl = register_mask_bit(reg_kinds[0]) > 11;
+                bool is_dbl = register_mask_bit(reg_kinds[0]) > 12;
                 infer_init_updated_regs_edges(ctx, reg_kinds, instr_idx, 1, is_dbl);
             }
             break;
@@ -627,6 +654,12 @@ static void infer_init_edges(Ctx ctx, size_t instr_idx) {
             infer_init_used_op_edges(ctx, p_node->src);
             break;
         }
+        case AST_AsmMovPacked_t:
+            infer_init_updated_op_edges(ctx, node->get._AsmMovPacked.dst, instr_idx);
+            break;
+        case AST_AsmBinaryPacked_t:
+            infer_init_updated_op_edges(ctx, node->get._AsmBinaryPacked.dst, instr_idx);
+            break;
         case AST_AsmCmp_t: {
             const AsmCmp* p_node = &node->get._AsmCmp;
             infer_init_used_op_edges(ctx, p_node->src);
@@ -673,6 +706,21 @@ static void infer_init_edges(Ctx ctx, size_t instr_idx) {
     }
 }
 
+// With a profile, uses and updates are weighted by the execution count of their block, blocks starting with a label
+// take the count of that label, and other blocks are only entered by fall through and keep the previous count
+static void infer_init_spill_weight(Ctx ctx, TIdentifier fun_name, size_t block_id) {
+    TULong count;
+    const AsmInstruction* node = GET_INSTR(GET_CFG_BLOCK(block_id).instrs_front_idx);
+    if (node && node->type == AST_AsmLabel_t) {
+        if (get_profile_count(ctx->frontend, fun_name, node->get._AsmLabel.name, &count)) {
+            ctx->spill_weight = (size_t)count + 1;
+        }
+    }
+    else if (block_id == 0 && get_profile_count(ctx->frontend, fun_name, 0, &count)) {
+        ctx->spill_weight = (size_t)count + 1;
+    }
+}
+
 static bool init_inference_graph(Ctx ctx, TIdentifier fun_name) {
     if (!init_data_flow_analysis(ctx, fun_name)) {
         return false;
@@ -710,15 +758,16 @@ static bool init_inference_graph(Ctx ctx, TIdentifier fun_name) {
     }
 
     if (!map_empty(ctx->infer_graph->pseudo_reg_map)) {
-        if (vec_size(ctx->infer_graph->unpruned_hard_mask_bits) < 12) {
-            vec_resize(ctx->infer_graph->unpruned_hard_mask_bits, 12);
+        size_t k = ctx->infer_graph->k;
+        if (vec_size(ctx->infer_graph->unpruned_hard_mask_bits) < k) {
+            vec_resize(ctx->infer_graph->unpruned_hard_mask_bits, k);
         }
 
         mask_t hard_reg_mask = ctx->infer_graph->hard_reg_mask;
-        for (size_t i = 0; i < 12; ++i) {
+        for (size_t i = 0; i < k; ++i) {
             ctx->reg_color_map[i] = REG_Sp;
             ctx->hard_regs[i].color = REG_Sp;
-            ctx->hard_regs[i].degree = 11;
+            ctx->hard_regs[i].degree = k - 1;
             ctx->hard_regs[i].spill_cost = 0;
             ctx->hard_regs[i].linked_hard_mask = hard_reg_mask;
             vec_clear(ctx->hard_regs[i].linked_pseudo_names);
@@ -731,19 +780,23 @@ static bool init_inference_graph(Ctx ctx, TIdentifier fun_name) {
         }
 
         mask_t hard_reg_mask = ctx->sse_infer_graph->hard_reg_mask;
-        for (size_t i = 12; i < 26; ++i) {
+        for (size_t i = 13; i < 27; ++i) {
             ctx->reg_color_map[i] = REG_Sp;
             ctx->hard_regs[i].color = REG_Sp;
             ctx->hard_regs[i].degree = 13;
             ctx->hard_regs[i].spill_cost = 0;
             ctx->hard_regs[i].linked_hard_mask = hard_reg_mask;
             vec_clear(ctx->hard_regs[i].linked_pseudo_names);
-            ctx->sse_infer_graph->unpruned_hard_mask_bits[i - 12] = i;
+            ctx->sse_infer_graph->unpruned_hard_mask_bits[i - 13] = i;
         }
     }
 
+    ctx->spill_weight = 1;
     for (size_t block_id = 0; block_id < vec_size(ctx->cfg->blocks); ++block_id) {
         if (GET_CFG_BLOCK(block_id).size > 0) {
+            if (!map_empty(ctx->frontend->profile_table)) {
+                infer_init_spill_weight(ctx, fun_name, block_id);
+            }
             for (size_t instr_idx = GET_CFG_BLOCK(block_id).instrs_front_idx;
                  instr_idx <= GET_CFG_BLOCK(block_id).instrs_back_idx; ++instr_idx) {
                 if (GET_INSTR(instr_idx)) {
@@ -766,6 +819,7 @@ static bool is_reg_callee_saved(REGISTER_KIND reg_kind) {
         case REG_R13:
         case REG_R14:
         case REG_R15:
+        case REG_Bp:
             return true;
         default:
             return false;
@@ -1199,6 +1253,8 @@ static void alloc_instr(Ctx ctx, size_t instr_idx) {
         case AST_AsmPush_t:
             alloc_push_instr(ctx, &node->get._AsmPush);
             break;
+        case AST_AsmMovPacked_t:
+        case AST_AsmBinaryPacked_t:
         case AST_AsmCdq_t:
         case AST_AsmCall_t:
             break;
@@ -1285,7 +1341,7 @@ static bool get_coalescable_infer_regs(
         if (src_idx < REGISTER_MASK_SIZE) {
             TIdentifier dst_name = ctx->dfa_o2->data_name_map[dst_idx - REGISTER_MASK_SIZE];
             bool is_dbl = map_get(ctx->frontend->symbol_table, dst_name)->type_t->type == AST_Double_t;
-            if (is_dbl == (src_idx > 11)) {
+            if (is_dbl == (src_idx > 12)) {
                 set_p_infer_graph(ctx, is_dbl);
                 *src_infer = &ctx->hard_regs[src_idx];
                 *dst_infer = &map_get(ctx->p_infer_graph->pseudo_reg_map, dst_name);
@@ -1295,7 +1351,7 @@ static bool get_coalescable_infer_regs(
         else if (dst_idx < REGISTER_MASK_SIZE) {
             TIdentifier src_name = ctx->dfa_o2->data_name_map[src_idx - REGISTER_MASK_SIZE];
             bool is_dbl = map_get(ctx->frontend->symbol_table, src_name)->type_t->type == AST_Double_t;
-            if (is_dbl == (dst_idx > 11)) {
+            if (is_dbl == (dst_idx > 12)) {
                 set_p_infer_graph(ctx, is_dbl);
                 *src_infer = &map_get(ctx->p_infer_graph->pseudo_reg_map, src_name);
                 *dst_infer = &ctx->hard_regs[dst_idx];
@@ -1720,6 +1776,8 @@ static void coal_instr(Ctx ctx, size_t instr_idx, size_t block_id) {
         case AST_AsmPush_t:
             coal_push_instr(ctx, &node->get._AsmPush);
             break;
+        case AST_AsmMovPacked_t:
+        case AST_AsmBinaryPacked_t:
         case AST_AsmCdq_t:
         case AST_AsmCall_t:
             break;
@@ -1767,10 +1825,24 @@ static bool coalesce_registers(Ctx ctx) {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+static void report_fun_counts(Ctx ctx) {
+    if (ctx->report) {
+        ReportFunction* function = &vec_back(ctx->report->functions);
+        for (size_t instr_idx = 0; instr_idx < vec_size(*ctx->p_instrs); ++instr_idx) {
+            if (GET_INSTR(instr_idx)) {
+                function->instr_count++;
+            }
+        }
+        function->block_count = vec_size(ctx->cfg->blocks);
+    }
+}
+
 static void alloc_fun_toplvl(Ctx ctx, AsmFunction* node) {
     ctx->p_instrs = &node->instructions;
+    report_function(ctx->report, node->name, STAGE_RegAlloc);
     init_control_flow_graph(ctx);
 Ldowhile:
+    REPORT_FUN_COUNT(ctx->report, fixed_point_count, 1);
     if (init_inference_graph(ctx, node->name)) {
         if (ctx->is_with_coal && coalesce_registers(ctx)) {
             if (vec_empty(ctx->infer_graph->unpruned_pseudo_names)
@@ -1787,6 +1859,7 @@ Ldowhile:
         ctx->p_backend_fun = NULL;
     }
 Lbreak:
+    report_fun_counts(ctx);
     ctx->p_infer_graph = NULL;
     ctx->p_instrs = NULL;
 }
@@ -1811,12 +1884,13 @@ static void alloc_program(Ctx ctx, const AsmProgram* node) {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void allocate_registers(
-    const AsmProgram* node, BackEndContext* backend, FrontEndContext* frontend, uint8_t optim_2_code) {
+void allocate_registers(const AsmProgram* node, BackEndContext* backend, FrontEndContext* frontend,
+    TimeReportContext* report, uint8_t optim_2_code, bool is_omit_frame_ptr) {
     RegAllocContext ctx;
     {
         ctx.backend = backend;
         ctx.frontend = frontend;
+        ctx.report = report;
         ctx.is_with_coal = optim_2_code > 1u;
 
         ctx.hard_regs[0].reg_kind = REG_Ax;
@@ -1831,35 +1905,36 @@ void allocate_registers(
         ctx.hard_regs[9].reg_kind = REG_R13;
         ctx.hard_regs[10].reg_kind = REG_R14;
         ctx.hard_regs[11].reg_kind = REG_R15;
-
-        ctx.hard_regs[12].reg_kind = REG_Xmm0;
-        ctx.hard_regs[13].reg_kind = REG_Xmm1;
-        ctx.hard_regs[14].reg_kind = REG_Xmm2;
-        ctx.hard_regs[15].reg_kind = REG_Xmm3;
-        ctx.hard_regs[16].reg_kind = REG_Xmm4;
-        ctx.hard_regs[17].reg_kind = REG_Xmm5;
-        ctx.hard_regs[18].reg_kind = REG_Xmm6;
-        ctx.hard_regs[19].reg_kind = REG_Xmm7;
-        ctx.hard_regs[20].reg_kind = REG_Xmm8;
-        ctx.hard_regs[21].reg_kind = REG_Xmm9;
-        ctx.hard_regs[22].reg_kind = REG_Xmm10;
-        ctx.hard_regs[23].reg_kind = REG_Xmm11;
-        ctx.hard_regs[24].reg_kind = REG_Xmm12;
-        ctx.hard_regs[25].reg_kind = REG_Xmm13;
-
-        for (size_t i = 0; i < 26; ++i) {
+        ctx.hard_regs[12].reg_kind = REG_Bp;
+
+        ctx.hard_regs[13].reg_kind = REG_Xmm0;
+        ctx.hard_regs[14].reg_kind = REG_Xmm1;
+        ctx.hard_regs[15].reg_kind = REG_Xmm2;
+        ctx.hard_regs[16].reg_kind = REG_Xmm3;
+        ctx.hard_regs[17].reg_kind = REG_Xmm4;
+        ctx.hard_regs[18].reg_kind = REG_Xmm5;
+        ctx.hard_regs[19].reg_kind = REG_Xmm6;
+        ctx.hard_regs[20].reg_kind = REG_Xmm7;
+        ctx.hard_regs[21].reg_kind = REG_Xmm8;
+        ctx.hard_regs[22].reg_kind = REG_Xmm9;
+        ctx.hard_regs[23].reg_kind = REG_Xmm10;
+        ctx.hard_regs[24].reg_kind = REG_Xmm11;
+        ctx.hard_regs[25].reg_kind = REG_Xmm12;
+        ctx.hard_regs[26].reg_kind = REG_Xmm13;
+
+        for (size_t i = 0; i < 27; ++i) {
             ctx.hard_regs[i].linked_pseudo_names = vec_new();
         }
 
         ctx.cfg = make_ControlFlowGraph();
         ctx.dfa = make_DataFlowAnalysis();
         ctx.dfa_o2 = make_DataFlowAnalysisO2();
-        ctx.infer_graph = make_InferenceGraph(false);
-        ctx.sse_infer_graph = make_InferenceGraph(true);
+        ctx.infer_graph = make_InferenceGraph(false, is_omit_frame_ptr);
+        ctx.sse_infer_graph = make_InferenceGraph(true, is_omit_frame_ptr);
     }
     alloc_program(&ctx, node);
 
-    for (size_t i = 0; i < 26; ++i) {
+    for (size_t i = 0; i < 27; ++i) {
         vec_delete(ctx.hard_regs[i].linked_pseudo_names);
     }
 
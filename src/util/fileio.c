@@ -117,6 +117,12 @@ void write_buffer(Ctx ctx, const char* buf) {
     }
 }
 
+void write_bytes(Ctx ctx, const void* buf, size_t buf_size) {
+    write_chunk(ctx, ctx->write_buf, str_size(ctx->write_buf));
+    str_clear(ctx->write_buf);
+    write_chunk(ctx, (const char*)buf, buf_size);
+}
+
 error_t close_fread(Ctx ctx, size_t linenum) {
     CATCH_ENTER;
     fclose(vec_back(ctx->file_reads).fd);
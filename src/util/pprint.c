@@ -1065,6 +1065,20 @@ static void print_TacInstruction(Ctx ctx, const TacInstruction* node, size_t tab
             print_field(tab + 1, "TLong: %zi", (ssize_t)node->get._TacCopyFromOffset.offset);
             print_TacValue(ctx, node->get._TacCopyFromOffset.dst, tab);
             break;
+        case AST_TacVecCopy_t:
+            print_field(++tab, "TacVecCopy: ");
+            print_Type(ctx, node->get._TacVecCopy.elem_type, tab);
+            print_TacValue(ctx, node->get._TacVecCopy.src_ptr, tab);
+            print_TacValue(ctx, node->get._TacVecCopy.dst_ptr, tab);
+            break;
+        case AST_TacVecBinary_t:
+            print_field(++tab, "TacVecBinary: ");
+            print_TacBinaryOp(&node->get._TacVecBinary.binop, tab);
+            print_Type(ctx, node->get._TacVecBinary.elem_type, tab);
+            print_TacValue(ctx, node->get._TacVecBinary.src1_ptr, tab);
+            print_TacValue(ctx, node->get._TacVecBinary.src2_ptr, tab);
+            print_TacValue(ctx, node->get._TacVecBinary.dst_ptr, tab);
+            break;
         case AST_TacJump_t:
             print_field(++tab, "TacJump: ");
             print_field(tab + 1, "TIdentifier: %s", map_get(ctx->hash_table, node->get._TacJump.target));
@@ -1519,12 +1533,31 @@ static void print_AsmInstruction(Ctx ctx, const AsmInstruction* node, size_t tab
             print_AsmOperand(ctx, node->get._AsmBinary.src, tab);
             print_AsmOperand(ctx, node->get._AsmBinary.dst, tab);
             break;
+        case AST_AsmMovPacked_t:
+            print_field(++tab, "AsmMovPacked: ");
+            print_AssemblyType(node->get._AsmMovPacked.asm_type, tab);
+            print_AsmOperand(ctx, node->get._AsmMovPacked.src, tab);
+            print_AsmOperand(ctx, node->get._AsmMovPacked.dst, tab);
+            break;
+        case AST_AsmBinaryPacked_t:
+            print_field(++tab, "AsmBinaryPacked: ");
+            print_AsmBinaryOp(&node->get._AsmBinaryPacked.binop, tab);
+            print_AssemblyType(node->get._AsmBinaryPacked.asm_type, tab);
+            print_AsmOperand(ctx, node->get._AsmBinaryPacked.src, tab);
+            print_AsmOperand(ctx, node->get._AsmBinaryPacked.dst, tab);
+            break;
         case AST_AsmCmp_t:
             print_field(++tab, "AsmCmp: ");
             print_AssemblyType(node->get._AsmCmp.asm_type, tab);
             print_AsmOperand(ctx, node->get._AsmCmp.src, tab);
             print_AsmOperand(ctx, node->get._AsmCmp.dst, tab);
             break;
+        case AST_AsmTest_t:
+            print_field(++tab, "AsmTest: ");
+            print_AssemblyType(node->get._AsmTest.asm_type, tab);
+            print_AsmOperand(ctx, node->get._AsmTest.src, tab);
+            print_AsmOperand(ctx, node->get._AsmTest.dst, tab);
+            break;
         case AST_AsmIdiv_t:
             print_field(++tab, "AsmIdiv: ");
             print_AssemblyType(node->get._AsmIdiv.asm_type, tab);
@@ -1569,6 +1602,10 @@ static void print_AsmInstruction(Ctx ctx, const AsmInstruction* node, size_t tab
             print_field(++tab, "AsmCall: ");
             print_field(tab + 1, "TIdentifier: %s", map_get(ctx->hash_table, node->get._AsmCall.name));
             break;
+        case AST_AsmTailCall_t:
+            print_field(++tab, "AsmTailCall: ");
+            print_field(tab + 1, "TIdentifier: %s", map_get(ctx->hash_table, node->get._AsmTailCall.name));
+            break;
         case AST_AsmRet_t:
             print_field(++tab, "AsmRet: ");
             break;
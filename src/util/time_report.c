@@ -0,0 +1,213 @@
+#ifndef __cplusplus
+#if __GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 10)
+#define _POSIX_C_SOURCE 200809L
+#else
+#define _GNU_SOURCE
+#endif
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <time.h>
+
+#include "util/c_std.h"
+#include "util/time_report.h"
+
+#include "ast/ast.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Time report
+
+typedef TimeReportContext* Ctx;
+
+// The containers of c_std.h allocate through these hooks, which keep process wide counters as the sds and stb_ds
+// allocators are not passed any context. Allocations are only counted once a report has begun, so that the hooks do
+// not cost more than the allocator when the report is disabled
+static bool is_alloc_count = false;
+static size_t alloc_count = 0;
+static size_t alloc_bytes = 0;
+
+void* report_malloc(size_t size) {
+    if (is_alloc_count) {
+        alloc_count++;
+        alloc_bytes += size;
+    }
+    return malloc(size);
+}
+
+void* report_realloc(void* ptr, size_t size) {
+    if (is_alloc_count) {
+        alloc_count++;
+        alloc_bytes += size;
+    }
+    return realloc(ptr, size);
+}
+
+static double get_wall_time(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec + (double)time.tv_nsec * 1e-9;
+}
+
+static size_t get_peak_rss(void) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return (size_t)usage.ru_maxrss / 1024;
+#else
+    return (size_t)usage.ru_maxrss;
+#endif
+}
+
+void report_begin(Ctx ctx, REPORT_STAGE stage) {
+    if (!ctx) {
+        return;
+    }
+    is_alloc_count = true;
+    ReportStage* report_stage = &ctx->stages[stage];
+    report_stage->call_count++;
+    report_stage->start_alloc_count = alloc_count;
+    report_stage->start_alloc_bytes = alloc_bytes;
+    report_stage->start_time = get_wall_time();
+}
+
+void report_end(Ctx ctx, REPORT_STAGE stage) {
+    if (!ctx) {
+        return;
+    }
+    ReportStage* report_stage = &ctx->stages[stage];
+    report_stage->wall_time += get_wall_time() - report_stage->start_time;
+    report_stage->alloc_count += alloc_count - report_stage->start_alloc_count;
+    report_stage->alloc_bytes += alloc_bytes - report_stage->start_alloc_bytes;
+    report_stage->peak_rss = get_peak_rss();
+}
+
+void report_function(Ctx ctx, size_t name, REPORT_STAGE stage) {
+    if (!ctx) {
+        return;
+    }
+    ReportFunction function = {name, stage, 0, 0, 0, 0};
+    vec_push_back(ctx->functions, function);
+}
+
+static const char* get_stage_name(REPORT_STAGE stage) {
+    switch (stage) {
+        case STAGE_Lexing:
+            return "lexing";
+        case STAGE_Parsing:
+            return "parsing";
+        case STAGE_Semantic:
+            return "semantic analysis";
+        case STAGE_TacRepr:
+            return "tac representation";
+        case STAGE_OptimTac:
+            return "level 1 optimization";
+        case STAGE_ScalarReplacement:
+            return "scalar replacement";
+        case STAGE_LoopUnrolling:
+            return "loop unrolling";
+        case STAGE_ConstantFolding:
+            return "constant folding";
+        case STAGE_ControlFlowGraph:
+            return "control flow graph";
+        case STAGE_UnreachableCode:
+            return "unreachable code elimination";
+        case STAGE_GlobalValueNumbering:
+            return "global value numbering";
+        case STAGE_CopyPropagation:
+            return "copy propagation";
+        case STAGE_DeadStore:
+            return "dead store elimination";
+        case STAGE_LoopInvariant:
+            return "loop invariant code motion";
+        case STAGE_LoopVectorization:
+            return "loop vectorization";
+        case STAGE_AsmGen:
+            return "assembly generation";
+        case STAGE_RegAlloc:
+            return "register allocation";
+        case STAGE_StackFix:
+            return "stack fix";
+        case STAGE_BlockLayout:
+            return "block layout";
+        case STAGE_Peephole:
+            return "peephole optimization";
+        case STAGE_CodeEmission:
+            return "code emission";
+        default:
+            return "";
+    }
+}
+
+static bool is_stage_pass(REPORT_STAGE stage) { return stage > STAGE_OptimTac && stage <= STAGE_LoopVectorization; }
+
+static void print_table(Ctx ctx, IdentifierContext* identifiers) {
+    fprintf(stderr, "Time report:\n");
+    fprintf(stderr, "  %-34s %8s %12s %10s %12s %10s\n", "stage", "calls", "wall (ms)", "allocs", "bytes",
+        "peak (kB)");
+    for (size_t i = 0; i < STAGE_Size; ++i) {
+        const ReportStage* stage = &ctx->stages[i];
+        if (stage->call_count > 0) {
+            fprintf(stderr, "  %s%-*s %8zu %12.3f %10zu %12zu %10zu\n", is_stage_pass((REPORT_STAGE)i) ? "  " : "",
+                is_stage_pass((REPORT_STAGE)i) ? 32 : 34, get_stage_name((REPORT_STAGE)i), stage->call_count,
+                stage->wall_time * 1e3, stage->alloc_count, stage->alloc_bytes, stage->peak_rss);
+        }
+    }
+    if (!vec_empty(ctx->functions)) {
+        fprintf(stderr, "  %-34s %-22s %8s %8s %10s %8s\n", "function", "stage", "instrs", "blocks", "dfa iters",
+            "rounds");
+        for (size_t i = 0; i < vec_size(ctx->functions); ++i) {
+            const ReportFunction* function = &ctx->functions[i];
+            fprintf(stderr, "  %-34s %-22s %8zu %8zu %10zu %8zu\n", map_get(identifiers->hash_table, function->name),
+                get_stage_name(function->stage), function->instr_count, function->block_count,
+                function->dfa_iter_count, function->fixed_point_count);
+        }
+    }
+}
+
+static void print_json(Ctx ctx, IdentifierContext* identifiers) {
+    fprintf(stderr, "{\"stages\": [");
+    bool is_first = true;
+    for (size_t i = 0; i < STAGE_Size; ++i) {
+        const ReportStage* stage = &ctx->stages[i];
+        if (stage->call_count > 0) {
+            fprintf(stderr,
+                "%s\n  {\"name\": \"%s\", \"calls\": %zu, \"wall_ms\": %.3f, \"allocs\": %zu, \"bytes\": %zu, "
+                "\"peak_rss_kb\": %zu}",
+                is_first ? "" : ",", get_stage_name((REPORT_STAGE)i), stage->call_count, stage->wall_time * 1e3,
+                stage->alloc_count, stage->alloc_bytes, stage->peak_rss);
+            is_first = false;
+        }
+    }
+    fprintf(stderr, "\n], \"functions\": [");
+    for (size_t i = 0; i < vec_size(ctx->functions); ++i) {
+        const ReportFunction* function = &ctx->functions[i];
+        fprintf(stderr,
+            "%s\n  {\"name\": \"%s\", \"stage\": \"%s\", \"instructions\": %zu, \"blocks\": %zu, "
+            "\"dfa_iterations\": %zu, \"fixed_point_rounds\": %zu}",
+            i > 0 ? "," : "", map_get(identifiers->hash_table, function->name), get_stage_name(function->stage),
+            function->instr_count, function->block_count, function->dfa_iter_count, function->fixed_point_count);
+    }
+    fprintf(stderr, "\n]}\n");
+}
+
+void print_time_report(Ctx ctx, IdentifierContext* identifiers) {
+    switch (ctx->format) {
+        case REPORT_Table:
+            print_table(ctx, identifiers);
+            break;
+        case REPORT_Json:
+            print_json(ctx, identifiers);
+            break;
+        default:
+            break;
+    }
+}
+
+void free_time_report(Ctx ctx) {
+    is_alloc_count = false;
+    vec_delete(ctx->functions);
+}
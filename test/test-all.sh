@@ -11,7 +11,7 @@ echo ""
 
 function test () {
     echo "./${@}"
-    RESULTS_FILE="${RESULTS_DIR}/${1%.*}${2}.out.1"
+    RESULTS_FILE="${RESULTS_DIR}/${1%.*}$(echo "${@:2}" | tr -d ' ').out.1"
     ./${@} > ${RESULTS_FILE}
     RETURN=${?}
     cat ${RESULTS_FILE} | tail -1
@@ -25,6 +25,23 @@ test "test-compiler.sh" "-O0"
 test "test-compiler.sh" "-O1"
 test "test-compiler.sh" "-O2"
 test "test-compiler.sh" "-O3"
+test "test-compiler.sh" "-O0" "-fintegrated-as"
+test "test-compiler.sh" "-O3" "-fintegrated-as"
+
+test "test-integrated-as.sh" "-O0"
+test "test-integrated-as.sh" "-O1"
+test "test-integrated-as.sh" "-O2"
+test "test-integrated-as.sh" "-O3"
+
+test "test-profile.sh" "-O0"
+test "test-profile.sh" "-O1"
+test "test-profile.sh" "-O2"
+test "test-profile.sh" "-O3"
+
+test "test-time-report.sh" "-O0"
+test "test-time-report.sh" "-O1"
+test "test-time-report.sh" "-O2"
+test "test-time-report.sh" "-O3"
 
 test "test-memory.sh" "-O0"
 test "test-memory.sh" "-O1"
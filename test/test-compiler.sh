@@ -321,21 +321,25 @@ PASS=0
 TOTAL=0
 RETURN=0
 
-ARG=${1}
-
 OPTIM="-O0"
 if [ "${1}" = "-O0" ]; then
-    ARG=${2}
+    shift
 elif [ "${1}" = "-O1" ]; then
     OPTIM="-O0 -O1"
-    ARG=${2}
+    shift
 elif [ "${1}" = "-O2" ]; then
     OPTIM="-O0 -O2"
-    ARG=${2}
+    shift
 elif [ "${1}" = "-O3" ]; then
     OPTIM="-O3"
-    ARG=${2}
+    shift
 fi
+while [[ "${1}" = "-"* ]]; do
+    OPTIM="${OPTIM} ${1}"
+    shift
+done
+
+ARG=${1}
 
 cd ${TEST_DIR_GCC}
 if [ ! -z "${ARG}" ]; then
@@ -0,0 +1,94 @@
+#!/bin/bash
+
+PACKAGE_TEST="$(dirname $(readlink -f ${0}))"
+PACKAGE_DIR="$(dirname ${PACKAGE_TEST})/bin"
+PACKAGE_NAME="$(cat ${PACKAGE_DIR}/pkgname.cfg)"
+
+LIGHT_RED='\033[1;31m'
+LIGHT_GREEN='\033[1;32m'
+NC='\033[0m'
+
+TEST_DIR="${PACKAGE_TEST}/tests/compiler"
+
+function total () {
+    echo "----------------------------------------------------------------------"
+    RESULT="${PASS} / ${TOTAL}"
+    if [ ${PASS} -eq ${TOTAL} ]; then
+        RESULT="${LIGHT_GREEN}PASS: ${RESULT}${NC}"
+        RETURN=0
+    else
+        RESULT="${LIGHT_RED}FAIL: ${RESULT}${NC}"
+        RETURN=1
+    fi
+    echo -e "${RESULT}"
+}
+
+function print_check () {
+    echo " ${OPTIM} check ${1} -> ${2}"
+}
+
+function print_objdump () {
+    echo -e -n "${TOTAL} ${RESULT} ${FILE}${NC}"
+    print_check "integrated as" "[${PRINT}]"
+}
+
+# Disassembles the code and dumps the data of an object with their relocations, without the file name header and the
+# nearest symbol of each address, as as does not give a type and a size to the symbols
+function dump_obj () {
+    objdump -d -r -z ${1} | tail -n +3 | sed "/^ /s/ <[^>]*>//g" > ${2}
+    objdump -r -j .data ${1} 2> /dev/null | grep "R_X86_64" >> ${2}
+    objdump -s -j .data -j .rodata ${1} 2> /dev/null | tail -n +3 >> ${2}
+}
+
+# Assembles with as and with the integrated assembler, and checks that both objects have the same bytes and relocations
+function check_objdump () {
+    let TOTAL+=1
+
+    OBJ_FILE="${PACKAGE_TEST}/integrated_as.o"
+    DUMP_FILE="${PACKAGE_TEST}/integrated_as.out"
+    RESULT="${LIGHT_RED}[n]"
+    PRINT="objdump"
+    ${PACKAGE_NAME} ${OPTIM} -c ${FILE} > /dev/null 2>&1
+    if [ ${?} -ne 0 ]; then
+        PRINT="compilation failed"
+    else
+        mv ${FILE%.*}.o ${OBJ_FILE}
+        ${PACKAGE_NAME} ${OPTIM} -fintegrated-as -c ${FILE} > /dev/null 2>&1
+        if [ ${?} -ne 0 ]; then
+            PRINT="integrated as failed"
+        else
+            dump_obj ${OBJ_FILE} ${DUMP_FILE}
+            dump_obj ${FILE%.*}.o ${DUMP_FILE}.1
+            diff -q ${DUMP_FILE} ${DUMP_FILE}.1 > /dev/null 2>&1
+            if [ ${?} -ne 0 ]; then
+                PRINT="objdump differs"
+            else
+                RESULT="${LIGHT_GREEN}[y]"
+                let PASS+=1
+            fi
+        fi
+    fi
+    rm -f ${FILE%.*}.o ${OBJ_FILE} ${DUMP_FILE} ${DUMP_FILE}.1
+
+    print_objdump
+}
+
+function test_all () {
+    for FILE in $(find ${TEST_DIR} -name "*.c" -not -path "*/invalid_*" -type f | sort --uniq); do
+        check_objdump
+    done
+}
+
+PASS=0
+TOTAL=0
+RETURN=0
+
+OPTIM="-O0"
+if [ ! -z "${1}" ]; then
+    OPTIM="${@}"
+fi
+
+test_all
+total
+
+exit ${RETURN}
@@ -8,6 +8,7 @@ NC='\033[0m'
 
 TEST_DIR="${PWD}/tests/preprocessor"
 TEST_SRC="${TEST_DIR}/preprocessor"
+TEST_CHAIN="${TEST_DIR}/include_chain"
 
 function file () {
     FILE=${1%.*}
@@ -199,13 +200,76 @@ function check_test () {
     check_error
 }
 
+# Each header includes the next one, so that more files are open than FOPEN_MAX
+function make_chain_test () {
+    if [ -d "${TEST_CHAIN}" ]; then
+        rm -r ${TEST_CHAIN}
+    fi
+    mkdir -p ${TEST_CHAIN}
+
+    for i in $(seq 1 $((${DEPTH}-1))); do
+        echo "#include \"chain-header_$((${i}+1)).h\"" > ${TEST_CHAIN}/chain-header_${i}.h
+        echo "char* c${i} = \"Chain ${i}!\";" >> ${TEST_CHAIN}/chain-header_${i}.h
+    done
+    echo "char* c${DEPTH} = \"Chain ${DEPTH}!\";" > ${TEST_CHAIN}/chain-header_${DEPTH}.h
+
+    echo "int puts(char* s);" > ${FILE}.c
+    echo "" >> ${FILE}.c
+    echo "#include \"chain-header_1.h\"" >> ${FILE}.c
+    echo "" >> ${FILE}.c
+    echo "int main(void) {" >> ${FILE}.c
+    for i in $(seq 1 ${DEPTH}); do
+        echo "    puts(c${i});" >> ${FILE}.c
+    done
+    echo "    return ${DEPTH};" >> ${FILE}.c
+    echo "}" >> ${FILE}.c
+}
+
+function check_chain () {
+    let TOTAL+=1
+
+    make_chain_test
+
+    ${PACKAGE_NAME} ${FILE}.c > /dev/null 2>&1
+    RETURN=${?}
+    STDOUT=""
+    if [ ${RETURN} -ne 0 ]; then
+        RESULT="${LIGHT_RED}[n]"
+    else
+        STDOUT=$(${FILE})
+        RETURN=${?}
+        rm ${FILE}
+
+        diff -sq <(echo "${STDOUT}") <(
+            for i in $(seq 1 ${DEPTH}); do
+                echo "Chain ${i}!"
+            done
+        ) | grep -q "identical"
+        if [ ${?} -eq 0 ] && [ ${RETURN} -eq ${DEPTH} ]; then
+            RESULT="${LIGHT_GREEN}[y]"
+            let PASS+=1
+        else
+            RESULT="${LIGHT_RED}[n]"
+        fi
+    fi
+
+    print_preprocess
+}
+
+function check_chain_test () {
+    FILE=$(file ${1})
+    check_chain
+}
+
 N=63
 ERR=27
+DEPTH=64
 
 PASS=0
 TOTAL=0
 RETURN=0
 check_test ${TEST_SRC}/main.c
+check_chain_test ${TEST_CHAIN}/main.c
 total
 
 exit ${RETURN}
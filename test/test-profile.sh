@@ -0,0 +1,112 @@
+#!/bin/bash
+
+PACKAGE_TEST="$(dirname $(readlink -f ${0}))"
+PACKAGE_DIR="$(dirname ${PACKAGE_TEST})/bin"
+PACKAGE_NAME="$(cat ${PACKAGE_DIR}/pkgname.cfg)"
+CC="gcc -pedantic-errors -std=c17"
+
+LIGHT_RED='\033[1;31m'
+LIGHT_GREEN='\033[1;32m'
+NC='\033[0m'
+
+TEST_DIR="${PACKAGE_TEST}/tests/profile"
+
+function file () {
+    FILE=${1%.*}
+    if [ -f "${FILE}" ]; then rm ${FILE}; fi
+    if [ -f "${FILE}.prof" ]; then rm ${FILE}.prof; fi
+    echo "${FILE}"
+}
+
+function total () {
+    echo "----------------------------------------------------------------------"
+    RESULT="${PASS} / ${TOTAL}"
+    if [ ${PASS} -eq ${TOTAL} ]; then
+        RESULT="${LIGHT_GREEN}PASS: ${RESULT}${NC}"
+        RETURN=0
+    else
+        RESULT="${LIGHT_RED}FAIL: ${RESULT}${NC}"
+        RETURN=1
+    fi
+    echo -e "${RESULT}"
+}
+
+function print_check () {
+    echo " ${OPTIM} check ${1} -> ${2}"
+}
+
+function print_profile () {
+    echo -e -n "${TOTAL} ${RESULT} ${FILE}.c${NC}"
+    PRINT="gcc: ${RETURN_GCC}, ${PACKAGE_NAME}: ${RETURN_THIS}"
+    print_check "return" "[${PRINT}]"
+}
+
+# Compiles and runs the test with the profile options, and checks its result against gcc
+function check_run () {
+    ${PACKAGE_NAME} ${OPTIM} ${1} ${FILE}.c > /dev/null 2>&1
+    RETURN_THIS=${?}
+    if [ ${RETURN_THIS} -ne 0 ]; then
+        return 1
+    fi
+
+    STDOUT_THIS=$(WHEELCC_PROFILE=${FILE}.prof ${FILE})
+    RETURN_THIS=${?}
+    rm ${FILE}
+    if [ ${RETURN_GCC} -ne ${RETURN_THIS} ] || [[ "${STDOUT_GCC}" != "${STDOUT_THIS}" ]]; then
+        return 1
+    fi
+    return 0
+}
+
+function check_profile () {
+    let TOTAL+=1
+
+    ${CC} ${FILE}.c -o ${FILE} > /dev/null 2>&1
+    STDOUT_GCC=$(${FILE})
+    RETURN_GCC=${?}
+    rm ${FILE}
+
+    RESULT="${LIGHT_RED}[n]"
+    check_run "-fprofile-generate"
+    if [ ${?} -eq 0 ]; then
+        # the profile has a count for each function and for the blocks after each label
+        if [ -s "${FILE}.prof" ] && grep -q "^main [0-9]*$" ${FILE}.prof && grep -q ":" ${FILE}.prof; then
+            check_run "-fprofile-use=${FILE}.prof"
+            if [ ${?} -eq 0 ]; then
+                RESULT="${LIGHT_GREEN}[y]"
+                let PASS+=1
+            fi
+        fi
+    fi
+    if [ -f "${FILE}.prof" ]; then rm ${FILE}.prof; fi
+
+    print_profile
+}
+
+function test_all () {
+    for FILE in $(find ${TEST_DIR} -name "*.c" -type f | sort --uniq); do
+        FILE=$(file ${FILE})
+        check_profile
+    done
+}
+
+PASS=0
+TOTAL=0
+RETURN=0
+
+OPTIM="-O0"
+if [ ! -z "${1}" ]; then
+    OPTIM="${1}"
+fi
+
+# Profile instrumentation is only supported on Linux
+if [[ "$(uname -s)" = "Darwin"* ]]; then
+    total
+    exit 0
+fi
+
+cd ${TEST_DIR}
+test_all
+total
+
+exit ${RETURN}
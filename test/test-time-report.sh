@@ -0,0 +1,103 @@
+#!/bin/bash
+
+PACKAGE_TEST="$(dirname $(readlink -f ${0}))"
+PACKAGE_DIR="$(dirname ${PACKAGE_TEST})/bin"
+PACKAGE_NAME="$(cat ${PACKAGE_DIR}/pkgname.cfg)"
+
+LIGHT_RED='\033[1;31m'
+LIGHT_GREEN='\033[1;32m'
+NC='\033[0m'
+
+TEST_DIR="${PACKAGE_TEST}/tests/compiler"
+TEST_SRCS=("19_optimizing_three_address_code_programs" "20_register_allocation")
+
+function total () {
+    echo "----------------------------------------------------------------------"
+    RESULT="${PASS} / ${TOTAL}"
+    if [ ${PASS} -eq ${TOTAL} ]; then
+        RESULT="${LIGHT_GREEN}PASS: ${RESULT}${NC}"
+        RETURN=0
+    else
+        RESULT="${LIGHT_RED}FAIL: ${RESULT}${NC}"
+        RETURN=1
+    fi
+    echo -e "${RESULT}"
+}
+
+function print_check () {
+    echo " ${OPTIM} check ${1} -> ${2}"
+}
+
+function print_report () {
+    echo -e -n "${TOTAL} ${RESULT} ${FILE}${NC}"
+    print_check "time report" "[${PRINT}]"
+}
+
+# Compiles with the report option, and checks that the report parses and the assembly is unchanged
+function check_run () {
+    ${PACKAGE_NAME} ${OPTIM} ${1} -S ${FILE} 2> ${REPORT_FILE}
+    if [ ${?} -ne 0 ]; then
+        PRINT="compilation failed"
+        return 1
+    fi
+    mv ${FILE%.*}.s ${ASM_FILE}.1
+    python3 ${PACKAGE_TEST}/tools/check_time_report.py ${2} ${REPORT_FILE}
+    if [ ${?} -ne 0 ]; then
+        PRINT="${2} report malformed"
+        return 1
+    fi
+    diff -q ${ASM_FILE} ${ASM_FILE}.1 > /dev/null 2>&1
+    if [ ${?} -ne 0 ]; then
+        PRINT="assembly changed"
+        return 1
+    fi
+    return 0
+}
+
+function check_report () {
+    let TOTAL+=1
+
+    ASM_FILE="${PACKAGE_TEST}/time_report.s"
+    REPORT_FILE="${PACKAGE_TEST}/time_report.out"
+    RESULT="${LIGHT_RED}[n]"
+    PRINT="table, json"
+    ${PACKAGE_NAME} ${OPTIM} -S ${FILE} > /dev/null 2>&1
+    if [ ${?} -ne 0 ]; then
+        PRINT="compilation failed"
+    else
+        mv ${FILE%.*}.s ${ASM_FILE}
+        check_run "-ftime-report" "table"
+        if [ ${?} -eq 0 ]; then
+            check_run "-ftime-report=json" "json"
+            if [ ${?} -eq 0 ]; then
+                RESULT="${LIGHT_GREEN}[y]"
+                let PASS+=1
+            fi
+        fi
+    fi
+    rm -f ${FILE%.*}.s ${ASM_FILE} ${ASM_FILE}.1 ${REPORT_FILE}
+
+    print_report
+}
+
+function test_all () {
+    for SRC in ${TEST_SRCS[@]}; do
+        for FILE in $(find ${TEST_DIR}/${SRC} -name "*.c" -not -name "*_client.c" -type f | sort --uniq); do
+            check_report
+        done
+    done
+}
+
+PASS=0
+TOTAL=0
+RETURN=0
+
+OPTIM="-O0"
+if [ ! -z "${1}" ]; then
+    OPTIM="${1}"
+fi
+
+test_all
+total
+
+exit ${RETURN}
@@ -0,0 +1,31 @@
+/* Test that expressions reading variables whose address is taken are not
+ * reused, as the variables may be updated through a pointer or a call.
+ * */
+
+static int counter = 0;
+
+void update(int *ptr) {
+    *ptr = *ptr + 10;
+    counter = counter + 1;
+}
+
+int target(int a) {
+    int b = 5;
+    int *ptr = &b;
+    int x = a + b;
+    update(ptr);
+    // b was updated through a pointer
+    int y = a + b;
+    int z = counter * 2;
+    update(ptr);
+    // counter was updated by a call
+    int w = counter * 2;
+    return x * 1000 + y * 100 + z * 10 + w;
+}
+
+int main(void) {
+    if (target(1) != 7624) {
+        return 1; // fail
+    }
+    return 0; // success
+}
@@ -0,0 +1,25 @@
+/* Test that redundant type conversions and pointer arithmetic are evaluated
+ * once, and that the reused values keep the right types.
+ * */
+
+double target(int i, unsigned long ul, double d) {
+    double arr[4] = {1.5, 2.5, 3.5, 4.5};
+    // arr[i] computes the same address twice
+    arr[i] = arr[i] * 2.0;
+    double x = (double)i + (double)ul;
+    double y = (double)ul + (double)i;
+    long l = (long)d;
+    unsigned long u = (unsigned long)d;
+    int j = (int)(long)i;
+    return x + y + (double)l + (double)u + arr[i] + (double)j;
+}
+
+int main(void) {
+    if (target(2, 10ul, 7.9) != 47.0) {
+        return 1; // fail
+    }
+    if (target(0, 4294967296ul, 1.2) != 8589934597.0) {
+        return 2; // fail
+    }
+    return 0; // success
+}
@@ -0,0 +1,30 @@
+/* Test that an expression is not reused after one of its operands is
+ * redefined, whether in the same block, in a branch or in a loop.
+ * */
+
+int target(int a, int b, int n) {
+    int x = a + b;
+    a = a + 1;
+    // a + b has changed
+    int y = a + b;
+    if (n > 2) {
+        b = b * 2;
+    }
+    // b may have changed
+    int z = a + b;
+    for (int i = 0; i < n; i = i + 1) {
+        x = x + (a + b);
+        a = a - 1;
+    }
+    return x * 1000 + y * 100 + z;
+}
+
+int main(void) {
+    if (target(1, 2, 3) != 18406) {
+        return 1; // fail
+    }
+    if (target(1, 2, 1) != 7404) {
+        return 2; // fail
+    }
+    return 0; // success
+}
@@ -0,0 +1,27 @@
+/* Test that a division dominated by the same division is reused, and that a
+ * division in a branch is not reused on paths that don't go through it.
+ * */
+
+int target(int a, int b) {
+    int result = 0;
+    if (b != 0) {
+        result = a / b;
+    }
+    if (b != 0) {
+        // a / b was not computed on every path to this point
+        result = result + a / b + a % b;
+        // a / b was computed just above
+        result = result + a / b;
+    }
+    return result;
+}
+
+int main(void) {
+    if (target(17, 5) != 11) {
+        return 1; // fail
+    }
+    if (target(17, 0) != 0) {
+        return 2; // fail
+    }
+    return 0; // success
+}
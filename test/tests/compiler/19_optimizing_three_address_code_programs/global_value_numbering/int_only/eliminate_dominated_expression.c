@@ -0,0 +1,28 @@
+/* Test that an expression computed in a block is reused by the blocks it
+ * dominates, such as both branches of an if statement and the body of a loop.
+ * */
+
+int target(int a, int b, int flag) {
+    int x = a << b;
+    int result;
+    if (flag) {
+        result = (a << b) + 1;
+    }
+    else {
+        result = (a << b) - 1;
+    }
+    for (int i = 0; i < 3; i = i + 1) {
+        result = result + (a << b);
+    }
+    return result + x;
+}
+
+int main(void) {
+    if (target(3, 2, 1) != 61) {
+        return 1; // fail
+    }
+    if (target(3, 2, 0) != 59) {
+        return 2; // fail
+    }
+    return 0; // success
+}
@@ -0,0 +1,22 @@
+/* Test that an expression computed twice in the same basic block is only
+ * evaluated once, including when the operands of a commutative operator are
+ * swapped.
+ * */
+
+int target(int a, int b) {
+    int x = a * b + 3;
+    // b * a is the same value as a * b
+    int y = b * a + 3;
+    int z = (a - b) * (a - b);
+    return x + y + z;
+}
+
+int main(void) {
+    if (target(3, 4) != 31) {
+        return 1; // fail
+    }
+    if (target(-2, 5) != 35) {
+        return 2; // fail
+    }
+    return 0; // success
+}
@@ -0,0 +1,29 @@
+/* Test that loads through a loop invariant pointer are not hoisted out of a
+ * loop, as the pointer may be null or its value may be updated in the loop.
+ * */
+
+long target(long *ptr, int n) {
+    long sum = 0l;
+    for (int i = 0; i < n; i = i + 1) {
+        if (ptr) {
+            // *ptr is updated below
+            sum = sum + *ptr;
+            *ptr = *ptr + 1l;
+        }
+    }
+    return sum;
+}
+
+int main(void) {
+    long l = 10l;
+    if (target(0, 3) != 0l) {
+        return 1; // fail
+    }
+    if (target(&l, 3) != 33l) {
+        return 2; // fail
+    }
+    if (l != 13l) {
+        return 3; // fail
+    }
+    return 0; // success
+}
@@ -0,0 +1,22 @@
+/* Test that loop invariant type conversions and pointer arithmetic are hoisted
+ * out of a loop and still produce the right result.
+ * */
+
+double target(int a, unsigned long b, double *arr, int idx, int n) {
+    double sum = 0.0;
+    for (int i = 0; i < n; i = i + 1) {
+        // conversions of a and b, and &arr[idx], are loop invariant
+        double d = (double)a + (double)b;
+        double *ptr = arr + idx;
+        sum = sum + d * i + *ptr;
+    }
+    return sum;
+}
+
+int main(void) {
+    double arr[4] = {1.5, 2.5, 3.5, 4.5};
+    if (target(-3, 10ul, arr, 2, 4) != 56.0) {
+        return 1; // fail
+    }
+    return 0; // success
+}
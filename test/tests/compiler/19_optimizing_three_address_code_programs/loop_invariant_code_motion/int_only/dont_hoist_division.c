@@ -0,0 +1,27 @@
+/* Test that a division by a loop invariant value is not hoisted out of a loop
+ * when it is only executed under a condition, as it could trap.
+ * */
+
+int target(int a, int b, int n) {
+    int sum = 0;
+    for (int i = 0; i < n; i = i + 1) {
+        if (b != 0) {
+            // a / b and a % b would trap if executed with b == 0
+            int q = a / b;
+            int r = a % b;
+            sum = sum + q + r;
+        }
+        sum = sum + i;
+    }
+    return sum;
+}
+
+int main(void) {
+    if (target(17, 0, 5) != 10) {
+        return 1; // fail
+    }
+    if (target(17, 5, 5) != 35) {
+        return 2; // fail
+    }
+    return 0; // success
+}
@@ -0,0 +1,24 @@
+/* Test that an invariant expression is not hoisted out of a loop when its
+ * result is still read after the loop, as the loop may run zero times.
+ * */
+
+int target(int a, int b, int n) {
+    int x = -1;
+    int i = 0;
+    while (i < n) {
+        // a + b is invariant, but x is read after the loop
+        x = a + b;
+        i = i + 1;
+    }
+    return x;
+}
+
+int main(void) {
+    if (target(2, 3, 0) != -1) {
+        return 1; // fail
+    }
+    if (target(2, 3, 4) != 5) {
+        return 2; // fail
+    }
+    return 0; // success
+}
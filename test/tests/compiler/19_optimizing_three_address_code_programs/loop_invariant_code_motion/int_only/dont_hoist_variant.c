@@ -0,0 +1,32 @@
+/* Test that expressions that depend on values updated inside a loop, or that
+ * are used before they are defined in the loop, are not hoisted.
+ * */
+
+int glob = 3;
+
+int update(void) {
+    glob = glob + 1;
+    return 0;
+}
+
+int target(int a, int n) {
+    int sum = 0;
+    int x = 10;
+    for (int i = 0; i < n; i = i + 1) {
+        // x is read before it is redefined on each iteration
+        sum = sum + x;
+        x = a * 2;
+        // glob is updated by a function call in the loop
+        int g = glob * a;
+        sum = sum + g;
+        update();
+    }
+    return sum;
+}
+
+int main(void) {
+    if (target(5, 3) != 90) {
+        return 1; // fail
+    }
+    return 0; // success
+}
@@ -0,0 +1,23 @@
+/* Test that an expression computed from values that don't change inside a loop
+ * is hoisted out of the loop and still produces the right result.
+ * */
+
+int target(int a, int b, int n) {
+    int sum = 0;
+    for (int i = 0; i < n; i = i + 1) {
+        // a * b + 7 is loop invariant
+        int c = a * b + 7;
+        sum = sum + c * i;
+    }
+    return sum;
+}
+
+int main(void) {
+    if (target(3, 4, 10) != 855) {
+        return 1; // fail
+    }
+    if (target(3, 4, 0) != 0) {
+        return 2; // fail
+    }
+    return 0; // success
+}
@@ -0,0 +1,25 @@
+/* Test that invariant expressions are hoisted out of nested loops,
+ * one loop at a time, and that values defined by the outer loop are
+ * not hoisted out of the outer loop.
+ * */
+
+int target(int a, int b, int n, int m) {
+    int sum = 0;
+    for (int i = 0; i < n; i = i + 1) {
+        int x = i * a;
+        for (int j = 0; j < m; j = j + 1) {
+            // a + b is invariant in both loops, x - b only in the inner loop
+            int y = (a + b) * j;
+            int z = x - b;
+            sum = sum + y + z;
+        }
+    }
+    return sum;
+}
+
+int main(void) {
+    if (target(2, 5, 4, 3) != 60) {
+        return 1; // fail
+    }
+    return 0; // success
+}
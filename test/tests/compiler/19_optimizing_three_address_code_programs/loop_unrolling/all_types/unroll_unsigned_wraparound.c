@@ -0,0 +1,51 @@
+/* Test that unrolled loops do not wrap around when the bound is close to the
+ * largest unsigned value, or when the induction variable is a long.
+ * */
+
+unsigned int near_max(unsigned int start) {
+    unsigned int count = 0u;
+    for (unsigned int i = start; i < 4294967295u; i = i + 1u) {
+        count = count + 1u;
+    }
+    return count;
+}
+
+unsigned int near_zero(unsigned int start) {
+    unsigned int count = 0u;
+    for (unsigned int i = start; i > 0u; i = i - 1u) {
+        count = count + i;
+    }
+    return count;
+}
+
+long long_counter(long n) {
+    long sum = 0l;
+    for (long i = 0l; i < n; i = i + 1l) {
+        sum = sum + i * 4294967296l;
+    }
+    return sum;
+}
+
+double dbl_body(int n) {
+    double sum = 0.0;
+    for (int i = 0; i < n; i = i + 1) {
+        sum = sum + 0.5 * i;
+    }
+    return sum;
+}
+
+int main(void) {
+    if (near_max(4294967290u) != 5u || near_max(4294967293u) != 2u || near_max(4294967295u) != 0u) {
+        return 1; // fail
+    }
+    if (near_zero(6u) != 21u || near_zero(3u) != 6u || near_zero(0u) != 0u) {
+        return 2; // fail
+    }
+    if (long_counter(7l) != 21l * 4294967296l) {
+        return 3; // fail
+    }
+    if (dbl_body(9) != 18.0 || dbl_body(2) != 0.5) {
+        return 4; // fail
+    }
+    return 0; // success
+}
@@ -0,0 +1,91 @@
+/* Test that loops with a constant trip count give the same result whether they
+ * fit the size budget and are fully unrolled or not.
+ * */
+
+int trip_15(void) {
+    int sum = 0;
+    for (int i = 0; i < 15; i = i + 1) {
+        sum = sum + i;
+    }
+    return sum;
+}
+
+int trip_16(void) {
+    int sum = 0;
+    for (int i = 0; i < 16; i = i + 1) {
+        sum = sum + i;
+    }
+    return sum;
+}
+
+int trip_17(void) {
+    int sum = 0;
+    for (int i = 16; i >= 0; i = i - 1) {
+        sum = sum + i;
+    }
+    return sum;
+}
+
+int trip_64(void) {
+    int sum = 0;
+    for (int i = 0; i < 64; i = i + 1) {
+        sum = sum + (i ^ 5);
+    }
+    return sum;
+}
+
+int trip_65(void) {
+    int sum = 0;
+    for (int i = 0; i < 65; i = i + 1) {
+        sum = sum + (i ^ 5);
+    }
+    return sum;
+}
+
+int trip_1(void) {
+    int sum = 7;
+    for (int i = 3; i < 4; i = i + 1) {
+        sum = sum * i;
+    }
+    return sum;
+}
+
+int trip_0(void) {
+    int sum = 7;
+    for (int i = 4; i < 4; i = i + 1) {
+        sum = sum * i;
+    }
+    return sum;
+}
+
+// the body is large, so that a few iterations exceed the budget
+int large_body(int a) {
+    int x = a;
+    for (int i = 0; i < 10; i = i + 1) {
+        x = x * 3 + i;
+        x = x - (x / 7);
+        x = x + (i & 3);
+        x = x ^ (x >> 2);
+        x = x % 100003;
+        x = x + i * i;
+        x = x - a;
+        x = x | 1;
+    }
+    return x;
+}
+
+int main(void) {
+    if (trip_15() != 105 || trip_16() != 120 || trip_17() != 136) {
+        return 1; // fail
+    }
+    if (trip_64() != 2016 || trip_65() != 2016 + (64 ^ 5)) {
+        return 2; // fail
+    }
+    if (trip_1() != 21 || trip_0() != 7) {
+        return 3; // fail
+    }
+    if (large_body(5) != 7867) {
+        return 4; // fail
+    }
+    return 0; // success
+}
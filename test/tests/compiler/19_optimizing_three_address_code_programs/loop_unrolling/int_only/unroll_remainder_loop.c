@@ -0,0 +1,58 @@
+/* Test that loops with a trip count unknown at compile time run the right
+ * number of iterations when unrolled, for trip counts around multiples of the
+ * unrolling factor, where the remainder loop runs between 0 and 3 times.
+ * */
+
+int count_up(int n) {
+    int sum = 0;
+    for (int i = 0; i < n; i = i + 1) {
+        sum = sum + i * 2 + 1;
+    }
+    return sum;
+}
+
+int count_down(int n) {
+    int sum = 0;
+    for (int i = n; i > 0; i = i - 1) {
+        sum = sum * 3 + i;
+    }
+    return sum;
+}
+
+int step_by(int start, int n) {
+    int count = 0;
+    for (int i = start; i <= n; i = i + 3) {
+        count = count + 1;
+    }
+    return count;
+}
+
+// the variable bound is not defined in the loop
+int le_bound(int n) {
+    int bound = n - 1;
+    int sum = 0;
+    for (int i = 0; i <= bound; i = i + 1) {
+        sum = sum + n - i;
+    }
+    return sum;
+}
+
+int main(void) {
+    for (int n = -2; n < 14; n = n + 1) {
+        // sum of the first n odd numbers
+        if (count_up(n) != (n > 0 ? n * n : 0)) {
+            return 1; // fail
+        }
+        if (le_bound(n) != (n > 0 ? n * (n + 1) / 2 : 0)) {
+            return 2; // fail
+        }
+    }
+    if (count_down(0) != 0 || count_down(1) != 1 || count_down(4) != 142 || count_down(5) != 547
+        || count_down(9) != 83653) {
+        return 3; // fail
+    }
+    if (step_by(0, 11) != 4 || step_by(0, 12) != 5 || step_by(1, 12) != 4 || step_by(5, 4) != 0) {
+        return 4; // fail
+    }
+    return 0; // success
+}
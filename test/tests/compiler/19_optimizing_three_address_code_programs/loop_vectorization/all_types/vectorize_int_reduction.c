@@ -0,0 +1,82 @@
+/* Test integer sum reductions which are accumulated per lane in vectorized
+ * loops, for trip counts which leave 0 to 3 leftover iterations, and double
+ * sums which must be added in order.
+ * */
+
+int ints[19];
+long longs[11];
+double dbls[10];
+
+void init(void) {
+    int int_init[19] = {5, -3, 17, 2, -40, 9, 11, -6, 23, 8, -1, 4, 30, -12, 7, 6, -9, 14, 3};
+    long long_init[11] = {4000000000l, -3l, 17l, 2l, -8000000000l, 9l, 11l, -6l, 123456789012l, 8l, -1l};
+    double dbl_init[10] = {0.1, 0.2, 0.3, 1e16, -1e16, 0.7, 1.1, 2.5, -0.3, 1e-5};
+    for (int i = 0; i < 19; i = i + 1) {
+        ints[i] = int_init[i];
+    }
+    for (int i = 0; i < 11; i = i + 1) {
+        longs[i] = long_init[i];
+    }
+    for (int i = 0; i < 10; i = i + 1) {
+        dbls[i] = dbl_init[i];
+    }
+}
+
+int int_sum(int *arr, int n, int init) {
+    int sum = init;
+    for (int i = 0; i < n; i = i + 1) {
+        sum = sum + arr[i];
+    }
+    return sum;
+}
+
+long long_sum(long *arr, int n) {
+    long sum = 0l;
+    for (int i = 0; i < n; i = i + 1) {
+        sum = sum + arr[i];
+    }
+    return sum;
+}
+
+double dbl_sum(double *arr, int n) {
+    double sum = 0.0;
+    for (int i = 0; i < n; i = i + 1) {
+        sum = sum + arr[i];
+    }
+    return sum;
+}
+
+int one(void) {
+    return 1;
+}
+
+int main(void) {
+    init();
+    for (int n = 0; n <= 19; n = n + 1) {
+        int ref = 100;
+        for (int i = 0; i < n; i = i + one()) {
+            ref = ref + ints[i];
+        }
+        if (int_sum(ints, n, 100) != ref) {
+            return 1; // fail
+        }
+    }
+    for (int n = 0; n <= 11; n = n + 1) {
+        long ref = 0l;
+        for (int i = 0; i < n; i = i + one()) {
+            ref = ref + longs[i];
+        }
+        if (long_sum(longs, n) != ref) {
+            return 2; // fail
+        }
+    }
+    // an offset start is not aligned to the array
+    if (int_sum(ints + 3, 13, 0) != 2 - 40 + 9 + 11 - 6 + 23 + 8 - 1 + 4 + 30 - 12 + 7 + 6) {
+        return 3; // fail
+    }
+    // reassociating the sum would not cancel the large values first
+    if (dbl_sum(dbls, 10) != ((((((((0.1 + 0.2) + 0.3) + 1e16) + -1e16) + 0.7) + 1.1) + 2.5) + -0.3) + 1e-5) {
+        return 4; // fail
+    }
+    return 0; // success
+}
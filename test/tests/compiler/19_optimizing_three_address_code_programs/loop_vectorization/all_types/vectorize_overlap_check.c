@@ -0,0 +1,137 @@
+/* Test the runtime check of vectorized loops against overlapping arrays: stores
+ * to arrays less than 16 bytes away from another array must run scalar, while
+ * arrays 16 bytes or more apart can run a full vector at a time.
+ * */
+
+int ints[64];
+long longs[32];
+double dbls[32];
+long raw[40];
+
+void int_add(int *dst, int *src, int n) {
+    for (int i = 0; i < n; i = i + 1) {
+        dst[i] = src[i] + 3;
+    }
+}
+
+void long_sub(long *dst, long *src_1, long *src_2, int n) {
+    for (int i = 0; i < n; i = i + 1) {
+        dst[i] = src_1[i] - src_2[i];
+    }
+}
+
+void dbl_mul(double *dst, double *src, int n) {
+    for (int i = 0; i < n; i = i + 1) {
+        dst[i] = src[i] * 1.5;
+    }
+}
+
+// the calls keep the reference loops scalar
+int one(void) {
+    return 1;
+}
+
+void ref_int_add(int *dst, int *src, int n) {
+    for (int i = 0; i < n; i = i + one()) {
+        dst[i] = src[i] + 3;
+    }
+}
+
+void ref_long_sub(long *dst, long *src_1, long *src_2, int n) {
+    for (int i = 0; i < n; i = i + one()) {
+        dst[i] = src_1[i] - src_2[i];
+    }
+}
+
+void ref_dbl_mul(double *dst, double *src, int n) {
+    for (int i = 0; i < n; i = i + one()) {
+        dst[i] = src[i] * 1.5;
+    }
+}
+
+void init(void) {
+    for (int i = 0; i < 64; i = i + 1) {
+        ints[i] = i * 7 - 100;
+    }
+    for (int i = 0; i < 32; i = i + 1) {
+        longs[i] = i * 1000000007l;
+        dbls[i] = i * 0.25;
+    }
+    for (int i = 0; i < 40; i = i + 1) {
+        raw[i] = i * 72340172838076673l;
+    }
+}
+
+long checksum(void) {
+    long sum = 0l;
+    for (int i = 0; i < 64; i = i + 1) {
+        sum = sum * 31l + ints[i];
+    }
+    for (int i = 0; i < 32; i = i + 1) {
+        sum = sum * 31l + longs[i] + (long)(dbls[i] * 16.0);
+    }
+    for (int i = 0; i < 40; i = i + 1) {
+        sum = sum ^ raw[i];
+    }
+    return sum;
+}
+
+// distances are in bytes, from the stored array to the loaded array
+int check_int(int distance, int n) {
+    init();
+    int_add(ints + 20, ints + 20 + distance / 4, n);
+    long result = checksum();
+    init();
+    ref_int_add(ints + 20, ints + 20 + distance / 4, n);
+    return result == checksum();
+}
+
+int check_long(int distance, int n) {
+    init();
+    long_sub(longs + 8, longs + 8 + distance / 8, longs, n);
+    long result = checksum();
+    init();
+    ref_long_sub(longs + 8, longs + 8 + distance / 8, longs, n);
+    return result == checksum();
+}
+
+int check_dbl(int distance, int n) {
+    init();
+    dbl_mul(dbls + 8, dbls + 8 + distance / 8, n);
+    long result = checksum();
+    init();
+    ref_dbl_mul(dbls + 8, dbls + 8 + distance / 8, n);
+    return result == checksum();
+}
+
+// arrays 15 bytes apart are misaligned, which x86-64 allows
+int check_misaligned(int distance, int n) {
+    char *bytes = (char *)raw;
+    init();
+    int_add((int *)(bytes + 64), (int *)(bytes + 64 + distance), n);
+    long result = checksum();
+    init();
+    ref_int_add((int *)(bytes + 64), (int *)(bytes + 64 + distance), n);
+    return result == checksum();
+}
+
+int main(void) {
+    for (int n = 0; n < 12; n = n + 1) {
+        if (!(check_int(0, n) && check_int(4, n) && check_int(-4, n) && check_int(12, n) && check_int(-12, n)
+                && check_int(16, n) && check_int(-16, n) && check_int(20, n))) {
+            return 1; // fail
+        }
+        if (!(check_long(0, n) && check_long(8, n) && check_long(-8, n) && check_long(16, n)
+                && check_long(-16, n))) {
+            return 2; // fail
+        }
+        if (!(check_dbl(0, n) && check_dbl(8, n) && check_dbl(-8, n) && check_dbl(16, n) && check_dbl(-16, n))) {
+            return 3; // fail
+        }
+        if (!(check_misaligned(15, n) && check_misaligned(-15, n) && check_misaligned(16, n)
+                && check_misaligned(-16, n) && check_misaligned(17, n))) {
+            return 4; // fail
+        }
+    }
+    return 0; // success
+}
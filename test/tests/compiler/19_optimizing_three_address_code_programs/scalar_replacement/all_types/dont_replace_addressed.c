@@ -0,0 +1,53 @@
+/* Test that structures whose address is taken, or which are accessed through
+ * members which do not match one scalar member, keep their memory layout.
+ * */
+
+struct pair {
+    int a;
+    int b;
+};
+
+struct chars {
+    char c1;
+    char c2;
+    char c3;
+    char c4;
+};
+
+union mixed {
+    int i;
+    struct chars cs;
+};
+
+void bump(struct pair *p) {
+    p->a = p->a + 1;
+    p->b = p->b + 2;
+}
+
+int target(int n) {
+    struct pair p = {n, n * 2};
+    // the address escapes to the callee
+    bump(&p);
+    struct pair q = p;
+    bump(&q);
+    return p.a + p.b + q.a + q.b;
+}
+
+int union_members(int n) {
+    // union members overlap, so they can not be split
+    union mixed m;
+    m.i = 0;
+    m.cs.c1 = (char)n;
+    m.cs.c3 = 1;
+    return m.i;
+}
+
+int main(void) {
+    if (target(5) != 6 + 12 + 7 + 14) {
+        return 1; // fail
+    }
+    if (union_members(2) != 65538) {
+        return 2; // fail
+    }
+    return 0; // success
+}
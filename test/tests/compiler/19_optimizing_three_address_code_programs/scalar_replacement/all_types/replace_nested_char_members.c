@@ -0,0 +1,77 @@
+/* Test scalar replacement of structures with nested structure and char members,
+ * which are copied to and from memory around calls and returns.
+ * */
+
+struct inner {
+    char c;
+    signed char s;
+    int i;
+};
+
+struct outer {
+    struct inner in;
+    unsigned char u;
+    double d;
+    long l;
+};
+
+// the parameter is read from memory into its members
+struct outer update(struct outer o, int n) {
+    o.in.c = o.in.c + 1;
+    o.in.s = -o.in.s;
+    o.in.i = o.in.i * n;
+    o.u = o.u + 200;
+    o.d = o.d / 2.0;
+    o.l = o.l - n;
+    // returned through memory, written back from the members
+    return o;
+}
+
+long checksum(struct outer o) {
+    return o.in.c + o.in.s + o.in.i + o.u + (long)o.d + o.l;
+}
+
+long target(int n) {
+    struct outer a = {{'a', -5, 7}, 100, 9.0, 1000l};
+    struct outer b;
+    for (int i = 0; i < n; i = i + 1) {
+        // copies between replaced structures are member-wise
+        b = a;
+        // the structure is passed by value and returned around the calls
+        a = update(b, i + 1);
+        if (checksum(b) == checksum(a)) {
+            return -1l;
+        }
+    }
+    if (b.in.c != 'a' + n - 1 || b.in.s != (n % 2 ? -5 : 5) || b.u != (unsigned char)(100 + 200 * (n - 1))) {
+        return -2l;
+    }
+    return checksum(a);
+}
+
+struct inner make_inner(char c, int i) {
+    struct inner in = {c, (signed char)(c - 100), i};
+    return in;
+}
+
+int sum_inner(int n) {
+    int sum = 0;
+    for (int i = 0; i < n; i = i + 1) {
+        // returned in registers, split into members
+        struct inner in = make_inner((char)(i + 100), i * 3);
+        sum = sum + in.c + in.s + in.i;
+    }
+    return sum;
+}
+
+int main(void) {
+    // c = 'a' + 3, s = -5 * (-1)^3, i = 7 * 3!, u = 100 + 600 mod 256, d = 9 / 8, l = 1000 - 6
+    if (target(3) != ('a' + 3) + 5 + 42 + 188 + 1 + 994) {
+        return 1; // fail
+    }
+    // sum of 3 * i + 100 + i + i for i in [0, 10)
+    if (sum_inner(10) != 5 * 45 + 1000) {
+        return 2; // fail
+    }
+    return 0; // success
+}
@@ -0,0 +1,154 @@
+/* Test that conditional jumps inverted by the block layout to fall through to
+ * their most frequent successor keep the same condition, for each signed and
+ * unsigned condition code, and that double comparisons with a parity check
+ * for NaN keep both jumps
+ * */
+
+int signed_conds(long a, long b) {
+    int r = 0;
+    for (int i = 0; i < 3; i = i + 1) {
+        if (a == b) {
+            r += 1;
+        }
+        if (a != b) {
+            r += 2;
+        }
+        if (a < b) {
+            r += 4;
+        }
+        if (a <= b) {
+            r += 8;
+        }
+        if (a > b) {
+            r += 16;
+        }
+        if (a >= b) {
+            r += 32;
+        }
+    }
+    return r;
+}
+
+int unsigned_conds(unsigned int a, unsigned int b) {
+    int r = 0;
+    for (int i = 0; i < 3; i = i + 1) {
+        if (a < b) {
+            r += 1;
+        }
+        if (a <= b) {
+            r += 2;
+        }
+        if (a > b) {
+            r += 4;
+        }
+        if (a >= b) {
+            r += 8;
+        }
+    }
+    return r;
+}
+
+int char_conds(char a, unsigned char b) {
+    int r = 0;
+    if (a < 0) {
+        r += 1;
+    }
+    else if (b > 127) {
+        r += 2;
+    }
+    else {
+        r += 4;
+    }
+    return r;
+}
+
+int double_conds(double a, double b) {
+    int r = 0;
+    for (int i = 0; i < 2; i = i + 1) {
+        if (a == b) {
+            r += 1;
+        }
+        if (a != b) {
+            r += 2;
+        }
+        if (a < b) {
+            r += 4;
+        }
+        if (a <= b) {
+            r += 8;
+        }
+        if (a > b) {
+            r += 16;
+        }
+        if (a >= b) {
+            r += 32;
+        }
+    }
+    return r;
+}
+
+long else_chain(long x) {
+    // the last else is reached from each failed condition, and falls through to the return
+    long r;
+    if (x < 10l) {
+        r = 1l;
+    }
+    else if (x < 100l) {
+        r = 2l;
+    }
+    else if (x < 1000l) {
+        r = 3l;
+    }
+    else {
+        r = 4l;
+    }
+    return r;
+}
+
+long short_circuit(long a, long b, long c) {
+    long r = 0l;
+    if (a > 0l && (b > 0l || c > 0l)) {
+        r = a + b + c;
+    }
+    else if (!(a < 0l) || c == 0l) {
+        r = -1l;
+    }
+    return r;
+}
+
+int main(void) {
+    if (signed_conds(1l, 2l) != 42 || signed_conds(2l, 2l) != 123 || signed_conds(3l, 2l) != 150) {
+        return 1; // fail
+    }
+    if (signed_conds(-9223372036854775807l - 1l, 9223372036854775807l) != 42) {
+        return 2; // fail
+    }
+    if (unsigned_conds(1u, 4294967295u) != 9 || unsigned_conds(4294967295u, 1u) != 36
+        || unsigned_conds(7u, 7u) != 30) {
+        return 3; // fail
+    }
+    if (char_conds(-1, 200) != 1 || char_conds(1, 200) != 2 || char_conds(1, 1) != 4) {
+        return 4; // fail
+    }
+    if (double_conds(1.0, 2.0) != 28 || double_conds(2.0, 2.0) != 82 || double_conds(3.0, 2.0) != 100) {
+        return 5; // fail
+    }
+    {
+        double zero = 0.0;
+        double nan = zero / zero;
+        if (double_conds(nan, 1.0) != 4 || double_conds(1.0, nan) != 4 || double_conds(nan, nan) != 4) {
+            return 6; // fail
+        }
+        if (double_conds(-0.0, 0.0) != 82) {
+            return 7; // fail
+        }
+    }
+    if (else_chain(5l) != 1l || else_chain(50l) != 2l || else_chain(500l) != 3l || else_chain(5000l) != 4l) {
+        return 8; // fail
+    }
+    if (short_circuit(1l, 0l, 2l) != 3l || short_circuit(1l, 0l, 0l) != -1l || short_circuit(-1l, 1l, 1l) != 0l
+        || short_circuit(-1l, 1l, 0l) != -1l || short_circuit(0l, 1l, 1l) != -1l) {
+        return 9; // fail
+    }
+    return 0; // success
+}
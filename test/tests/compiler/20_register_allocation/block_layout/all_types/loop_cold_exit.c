@@ -0,0 +1,109 @@
+/* Test that loops keep their semantics when the block layout places the loop
+ * body before its condition and moves the early exits out of the loop, with
+ * breaks, continues, returns and gotos that leave nested loops
+ * */
+
+long arr[64];
+
+long find_first(long value, int size) {
+    for (int i = 0; i < size; i = i + 1) {
+        if (arr[i] == value) {
+            // the early return is colder than the loop body
+            return i;
+        }
+    }
+    return -1l;
+}
+
+long sum_until_negative(int size) {
+    long sum = 0l;
+    int i = 0;
+    while (i < size) {
+        if (arr[i] < 0l) {
+            break;
+        }
+        if (arr[i] % 2l == 1l) {
+            i = i + 1;
+            continue;
+        }
+        sum = sum + arr[i];
+        i = i + 1;
+    }
+    return sum + i;
+}
+
+long find_pair(long total, int size) {
+    long found = -1l;
+    for (int i = 0; i < size; i = i + 1) {
+        for (int j = i + 1; j < size; j = j + 1) {
+            if (arr[i] + arr[j] == total) {
+                found = i * 100l + j;
+                goto done;
+            }
+        }
+    }
+done:
+    return found;
+}
+
+long do_while_exit(long n) {
+    long steps = 0l;
+    do {
+        if (n == 1l) {
+            break;
+        }
+        if (n % 2l == 0l) {
+            n = n / 2l;
+        }
+        else {
+            n = 3l * n + 1l;
+        }
+        steps = steps + 1l;
+    }
+    while (steps < 1000l);
+    return steps;
+}
+
+int nested_counts(int n) {
+    int count = 0;
+    for (int i = 0; i < n; i = i + 1) {
+        for (int j = 0; j < n; j = j + 1) {
+            for (int k = 0; k < n; k = k + 1) {
+                if (i == j && j == k) {
+                    continue;
+                }
+                count = count + 1;
+            }
+            if (count > 5000) {
+                return -count;
+            }
+        }
+    }
+    return count;
+}
+
+int main(void) {
+    for (int i = 0; i < 64; i = i + 1) {
+        arr[i] = i * 3l;
+    }
+    if (find_first(30l, 64) != 10l || find_first(31l, 64) != -1l || find_first(0l, 0) != -1l) {
+        return 1; // fail
+    }
+    if (sum_until_negative(10) != 60l + 10l) {
+        return 2; // fail
+    }
+    arr[6] = -1l;
+    if (sum_until_negative(64) != 0l + 6l + 12l + 6l) {
+        return 3; // fail
+    }
+    if (find_pair(21l, 64) != 7l || find_pair(1000l, 64) != -1l) {
+        return 4; // fail
+    }
+    if (do_while_exit(27l) != 111l || do_while_exit(1l) != 0l || do_while_exit(16l) != 4l) {
+        return 5; // fail
+    }
+    if (nested_counts(10) != 990 || nested_counts(20) != -5008) {
+        return 6; // fail
+    }
+    return 0; // success
+}
@@ -0,0 +1,49 @@
+/* Test that %rbp can hold values when the frame pointer is omitted: it must be
+ * saved and restored like any other callee saved register, across calls to
+ * functions which use it too.
+ * */
+
+int glob = 3;
+
+int id(int x) {
+    return x;
+}
+
+// enough values are live across the calls to use every callee saved register
+int pressure(int a) {
+    int b = a + glob;
+    int c = b * 2;
+    int d = c - a;
+    int e = d + b;
+    int f = e * glob;
+    int g = f - c;
+    int sum = 0;
+    for (int i = 0; i < 4; i = i + 1) {
+        sum = sum + id(i);
+        sum = sum + a + b + c + d + e + f + g;
+    }
+    return sum;
+}
+
+int outer(int a) {
+    int x = a + 1;
+    int y = a + 2;
+    int z = a + 3;
+    int w = a + 4;
+    int v = a + 5;
+    int u = a + 6;
+    int r = pressure(x) + pressure(y);
+    return r + x + y + z + w + v + u;
+}
+
+int main(void) {
+    // a = 1: b = 4, c = 8, d = 7, e = 11, f = 33, g = 25, 4 * 89 + 6
+    if (pressure(1) != 362) {
+        return 1; // fail
+    }
+    // pressure(2) = 4 * 106 + 6 and pressure(3) = 4 * 123 + 6
+    if (outer(1) != 430 + 498 + 2 + 3 + 4 + 5 + 6 + 7) {
+        return 2; // fail
+    }
+    return 0; // success
+}
@@ -0,0 +1,48 @@
+/* Test that leaf functions which keep their locals in the red zone below the
+ * stack pointer do not clobber the frame of their caller, and that the red zone
+ * is not used by functions which make calls.
+ * */
+
+long leaf(long n) {
+    // the array is only addressed from the stack pointer, without a frame
+    long arr[8];
+    for (int i = 0; i < 8; i = i + 1) {
+        arr[i] = n * i;
+    }
+    long sum = 0l;
+    for (int i = 7; i >= 0; i = i - 1) {
+        sum = sum + arr[i];
+    }
+    return sum;
+}
+
+double dbl_leaf(double d) {
+    double arr[3] = {d, d * 2.0, d * 3.0};
+    return arr[0] + arr[1] + arr[2];
+}
+
+long caller(long n) {
+    // these locals live in the caller's frame, above the leaf's red zone
+    long keep[4] = {n, n + 1l, n + 2l, n + 3l};
+    long total = 0l;
+    for (int i = 0; i < 4; i = i + 1) {
+        total = total + leaf(keep[i]);
+    }
+    if (keep[0] != n || keep[1] != n + 1l || keep[2] != n + 2l || keep[3] != n + 3l) {
+        return -1l;
+    }
+    return total;
+}
+
+int main(void) {
+    if (leaf(3l) != 84l) {
+        return 1; // fail
+    }
+    if (caller(10l) != 28l * 46l) {
+        return 2; // fail
+    }
+    if (dbl_leaf(1.5) != 9.0) {
+        return 3; // fail
+    }
+    return 0; // success
+}
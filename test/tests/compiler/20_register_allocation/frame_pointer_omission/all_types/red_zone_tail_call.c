@@ -0,0 +1,90 @@
+/* Test that functions which only make tail calls keep their locals in the red
+ * zone, and that the callee can use the same stack memory after the jump
+ * without clobbering the arguments loaded from these locals.
+ * */
+
+struct pair {
+    long a;
+    long b;
+};
+
+struct dbl_pair {
+    double x;
+    double y;
+};
+
+long clobber(struct pair p, long c) {
+    // the callee's own locals overwrite the red zone of the function that jumped here
+    long arr[16];
+    for (int i = 0; i < 16; i = i + 1) {
+        arr[i] = -1l - i;
+    }
+    long sum = 0l;
+    for (int i = 0; i < 16; i = i + 1) {
+        sum = sum + arr[i];
+    }
+    return p.a * 3l + p.b + c + sum;
+}
+
+double dbl_clobber(struct dbl_pair p, struct pair q) {
+    double arr[8];
+    for (int i = 0; i < 8; i = i + 1) {
+        arr[i] = 0.5 * i;
+    }
+    return p.x - p.y + arr[7] + (double)(q.a - q.b);
+}
+
+long tail_from_red_zone(long n) {
+    // the struct lives below the stack pointer, until it is loaded in the argument registers
+    struct pair p;
+    p.a = n;
+    p.b = n * 2l;
+    return clobber(p, n + 1l);
+}
+
+double dbl_tail_from_red_zone(double d, long n) {
+    struct dbl_pair p;
+    p.x = d * 3.0;
+    p.y = d;
+    struct pair q;
+    q.a = n;
+    q.b = n - 4l;
+    return dbl_clobber(p, q);
+}
+
+long either_tail_or_ret(long n) {
+    struct pair p;
+    p.a = n;
+    p.b = n * 2l;
+    if (n > 10l) {
+        return clobber(p, 0l);
+    }
+    return p.a + p.b;
+}
+
+long not_leaf(long n) {
+    // the first call makes this function a non leaf, even though it ends with a tail call
+    struct pair p;
+    p.a = either_tail_or_ret(n);
+    p.b = n;
+    return clobber(p, p.a);
+}
+
+int main(void) {
+    if (tail_from_red_zone(5l) != 15l + 10l + 6l - 136l) {
+        return 1; // fail
+    }
+    if (dbl_tail_from_red_zone(1.5, 9l) != 3.0 + 3.5 + 4.0) {
+        return 2; // fail
+    }
+    if (either_tail_or_ret(2l) != 6l) {
+        return 3; // fail
+    }
+    if (either_tail_or_ret(11l) != 33l + 22l - 136l) {
+        return 4; // fail
+    }
+    if (not_leaf(4l) != 36l + 4l + 12l - 136l) {
+        return 5; // fail
+    }
+    return 0; // success
+}
@@ -0,0 +1,164 @@
+/* Test rip-relative addresses and relocations: global, static and static
+ * local variables in .data and .bss, string literals and floating-point
+ * constants in .rodata, pointers to string literals in .data, calls to
+ * external, global and static functions, and tail calls to each of them that
+ * are defined before or after the caller, or far enough to need a near jump
+ * */
+
+int puts(char* s);
+int abs(int x);
+
+long glob_data = 12345l;
+int glob_bss;
+static double static_data = 2.5;
+static char static_bss[24];
+static char* string_ptr = "relocated";
+char* glob_string_ptrs[3] = {"zero", "one", "two"};
+
+// data
+
+long load_globals(long x) {
+    static long counter = 3l;
+    counter = counter + x;
+    glob_bss = glob_bss + (int)counter;
+    static_bss[(int)x] = (char)(counter + 1l);
+    return glob_data + counter + static_bss[(int)x];
+}
+
+double load_constants(double x) {
+    static double scale;
+    scale = scale + 1.5;
+    return x * static_data + scale * 0.25 - 1.0e20 / 1.0e19;
+}
+
+int count_chars(char* s) {
+    int n = 0;
+    while (s[n]) {
+        n = n + 1;
+    }
+    return n;
+}
+
+int load_strings(int i) {
+    return count_chars(string_ptr) * 10 + count_chars(glob_string_ptrs[i]) + count_chars("literal");
+}
+
+// calls
+
+static int static_before(int x) {
+    return x * 3 + glob_bss;
+}
+
+int global_before(int x) {
+    return x - 7;
+}
+
+static int static_after(int x);
+int global_after(int x);
+
+int calls(int x) {
+    int a = static_before(x);
+    int b = global_before(x);
+    int c = static_after(x);
+    int d = global_after(x);
+    int e = abs(x - 100);
+    return a + b * 2 + c * 3 + d * 4 + e * 5;
+}
+
+// tail calls
+
+int tail_static_before(int x) {
+    return static_before(x + 1);
+}
+
+int tail_global_before(int x) {
+    return global_before(x * 2);
+}
+
+int tail_static_after(int x) {
+    return static_after(x - 1);
+}
+
+int tail_global_after(int x) {
+    return global_after(x / 2);
+}
+
+int tail_extern(int x) {
+    return abs(x);
+}
+
+int tail_far(int x);
+
+int tail_choice(int x) {
+    if (x > 100) {
+        return tail_far(x - 100);
+    }
+    return static_after(x);
+}
+
+static int static_after(int x) {
+    return x + 11;
+}
+
+int global_after(int x) {
+    return x * x;
+}
+
+int far_body(int a, int b, int c) {
+    int s = 0;
+    for (int i = 0; i < a; i = i + 1) {
+        s = s + b * i - c;
+        if (s > 100000) {
+            s = s - 99999;
+        }
+        else if (s < -100000) {
+            s = s + 99999;
+        }
+        s = s ^ (i * 31);
+        s = s + (b > c ? b - c : c - b) * (i % 7);
+        s = s - (a * b) % (c + 13);
+        s = s + ((s & 255) << 2) - ((s >> 3) & 127);
+        s = s + (i * i - a) / (b + 1) + (c * c) % (a + 5);
+        s = s - (i | b) + (i & c) - ((i ^ a) % 17);
+        s = s + (a - i) * (b - i) % 101;
+        s = s - (c + i) * (a + b) % 103;
+        s = s + (s % 1009) - (s / 1013);
+    }
+    return s;
+}
+
+int tail_far(int x) {
+    return far_body(x, x + 1, x + 2);
+}
+
+int main(void) {
+    if (load_globals(2l) != 12345l + 5l + 6l || glob_bss != 5) {
+        return 1;
+    }
+    if (load_globals(5l) != 12345l + 10l + 11l || glob_bss != 15) {
+        return 2;
+    }
+    if (load_constants(2.0) != 5.0 + 0.375 - 10.0 || load_constants(4.0) != 10.0 + 0.75 - 10.0) {
+        return 3;
+    }
+    if (load_strings(2) != 90 + 3 + 7 || load_strings(0) != 90 + 4 + 7) {
+        return 4;
+    }
+    if (calls(10) != (30 + 15) + 3 * 2 + 21 * 3 + 100 * 4 + 90 * 5) {
+        return 5;
+    }
+    if (tail_static_before(4) != 30 || tail_global_before(4) != 1) {
+        return 6;
+    }
+    if (tail_static_after(4) != 14 || tail_global_after(9) != 16) {
+        return 7;
+    }
+    if (tail_extern(-12) != 12) {
+        return 8;
+    }
+    if (tail_choice(5) != 16 || tail_choice(103) != far_body(3, 4, 5)) {
+        return 9;
+    }
+    puts(string_ptr);
+    return 0;
+}
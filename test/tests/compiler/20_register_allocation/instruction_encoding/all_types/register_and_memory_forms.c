@@ -0,0 +1,226 @@
+/* Test instructions whose encoding depends on their operands: the extended
+ * registers r8-r15 and xmm8-xmm15 that need a rex prefix, the byte registers
+ * of si and di, the accumulator forms with an immediate, and the sib byte of
+ * indexed addresses with each scale and with base registers that always need
+ * a displacement or a sib byte
+ * */
+
+// extended registers
+
+long sum_six(long a, long b, long c, long d, long e, long f) {
+    long x = a * b + c;
+    long y = d * e - f;
+    long z = (a + f) * (b - e);
+    return x * 3l + y * 5l + z * 7l + (c ^ d) + (e | f);
+}
+
+int mix_many(int a, int b, int c, int d, int e, int f) {
+    int v0 = a + 1;
+    int v1 = b * 2;
+    int v2 = c - 3;
+    int v3 = d * 4;
+    int v4 = e + 5;
+    int v5 = f - 6;
+    int v6 = a * b;
+    int v7 = c * d;
+    int v8 = e * f;
+    int v9 = a - f;
+    int v10 = b + e;
+    int v11 = c - d;
+    for (int i = 0; i < 3; i = i + 1) {
+        v0 = v0 + v11;
+        v1 = v1 - v10;
+        v2 = v2 + v9;
+        v3 = v3 - v8;
+        v4 = v4 + v7;
+        v5 = v5 - v6;
+    }
+    return v0 + v1 + v2 + v3 + v4 + v5 + v6 + v7 + v8 + v9 + v10 + v11;
+}
+
+double dbl_many(double a, double b, double c, double d, double e, double f, double g, double h) {
+    double v0 = a * 2.0;
+    double v1 = b + 3.0;
+    double v2 = c - 4.0;
+    double v3 = d * 5.0;
+    double v4 = e / 2.0;
+    double v5 = f + g;
+    double v6 = g * h;
+    double v7 = h - a;
+    double v8 = a * b + c;
+    double v9 = d * e - f;
+    double v10 = g / h;
+    double v11 = v0 + v1;
+    for (int i = 0; i < 2; i = i + 1) {
+        v0 = v0 + v11;
+        v1 = v1 * v10;
+        v2 = v2 - v9;
+        v3 = v3 + v8;
+    }
+    return v0 + v1 + v2 + v3 + v4 + v5 + v6 + v7 + v8 + v9 + v10 + v11;
+}
+
+// byte registers
+
+char byte_args(char a, char b, char c, char d, char e, char f) {
+    char x = a + b;
+    char y = e - f;
+    if (c < d) {
+        x = x + 1;
+    }
+    return x ^ y;
+}
+
+int byte_compare(unsigned char a, unsigned char b, signed char c, signed char d) {
+    int r = 0;
+    if (a > b) {
+        r = r + 1;
+    }
+    if (c > d) {
+        r = r + 2;
+    }
+    if (a == 200) {
+        r = r + 4;
+    }
+    return r;
+}
+
+// accumulator forms
+
+int id_int(int x) {
+    return x;
+}
+
+long id_long(long x) {
+    return x;
+}
+
+unsigned char id_uchar(unsigned char c) {
+    return c;
+}
+
+int acc_int(int x) {
+    int r = id_int(x) + 100000;
+    if (r == 123456) {
+        return 1;
+    }
+    return r - 300000;
+}
+
+long acc_long(long x) {
+    long r = id_long(x);
+    if (r == 305419896l) {
+        return r + 16777216l;
+    }
+    return (r & 2147483392l) | 65536l;
+}
+
+unsigned char acc_test(unsigned char c) {
+    unsigned char r = id_uchar(c);
+    if (r & 128) {
+        return r & 15;
+    }
+    return r | 64;
+}
+
+int acc_test_int(unsigned int u) {
+    unsigned int r = (unsigned int)id_int((int)u);
+    if (r & 1048576u) {
+        return 1;
+    }
+    return 0;
+}
+
+// indexed addresses
+
+long index_scales(long* l, int* i, char* c, long n) {
+    long sum = 0l;
+    for (long k = 0l; k < n; k = k + 1l) {
+        sum = sum + l[k] + i[k] + c[k];
+        sum = sum + l[k + 2l] - c[n - k];
+    }
+    return sum;
+}
+
+long index_extended(long* a, long* b, long* c, long* d, long* e, long n, long m) {
+    long sum = 0l;
+    for (long k = 0l; k < n; k = k + 1l) {
+        sum = sum + a[k] * b[m - k] + c[k + m] - d[k] + e[n - k - 1l];
+    }
+    return sum;
+}
+
+struct pair {
+    int first;
+    long second;
+};
+
+long struct_index(struct pair* p, long n) {
+    long sum = 0l;
+    for (long k = 0l; k < n; k = k + 1l) {
+        sum = sum + p[k].first * 3l + p[k].second;
+    }
+    return sum;
+}
+
+double dbl_index(double* x, long n) {
+    double sum = 0.0;
+    for (long k = 0l; k < n; k = k + 1l) {
+        sum = sum + x[k] * x[n - k - 1l];
+    }
+    return sum;
+}
+
+int main(void) {
+    if (sum_six(1l, 2l, 3l, 4l, 5l, 6l) != -48l) {
+        return 1;
+    }
+    if (mix_many(1, 2, 3, 4, 5, 6) != -22) {
+        return 2;
+    }
+    if (dbl_many(1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0) != 126.203125) {
+        return 3;
+    }
+    if (byte_args(1, 2, 3, 4, 10, 3) != 3) {
+        return 4;
+    }
+    if (byte_compare(200, 100, -1, -2) != 7 || byte_compare(1, 2, -3, 3) != 0) {
+        return 5;
+    }
+    if (acc_int(23456) != 1 || acc_int(5) != -199995) {
+        return 6;
+    }
+    if (acc_long(305419896l) != 322197112l || acc_long(-1l) != 2147483392l) {
+        return 7;
+    }
+    if (acc_test(200) != 8 || acc_test(3) != 67) {
+        return 8;
+    }
+    if (acc_test_int(1048577u) != 1 || acc_test_int(1048575u) != 0) {
+        return 9;
+    }
+    {
+        long l[8] = {1l, 2l, 3l, 4l, 5l, 6l, 7l, 8l};
+        int i[8] = {10, 20, 30, 40, 50, 60, 70, 80};
+        char c[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+        if (index_scales(l, i, c, 5l) != 185l) {
+            return 10;
+        }
+        if (index_extended(l, l, l, l, l, 4l, 3l) != 42l) {
+            return 11;
+        }
+    }
+    {
+        struct pair p[3] = {{1, 10l}, {2, 20l}, {3, 30l}};
+        if (struct_index(p, 3l) != 78l) {
+            return 12;
+        }
+    }
+    {
+        double x[4] = {1.0, 2.0, 3.0, 4.0};
+        if (dbl_index(x, 4l) != 20.0) {
+            return 13;
+        }
+    }
+    return 0;
+}
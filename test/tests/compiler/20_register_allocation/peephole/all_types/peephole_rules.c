@@ -0,0 +1,284 @@
+/* Test that the peephole rewrites keep the program semantics, and that each
+ * rule is not applied to a nearby instruction sequence where it would be
+ * wrong: 32-bit self moves that clear the upper half of a register, moves of
+ * zero followed by a use of the flags, stores and loads separated by an
+ * aliasing store and loads through the register they are loaded into
+ * */
+
+long glob_l = 5l;
+int glob_i = 3;
+double glob_d = 0.0;
+
+// self move
+
+long self_move_long(long a, long b) {
+    long c = a;
+    if (b > 0) {
+        c = b;
+    }
+    return c + a;
+}
+
+unsigned long self_move_zero_extend(unsigned long x) {
+    unsigned int y = (unsigned int)x;
+    return (unsigned long)y;
+}
+
+unsigned long self_move_truncate_sum(unsigned long x, unsigned long z) {
+    unsigned int y = (unsigned int)(x + z);
+    return (unsigned long)y + 1ul;
+}
+
+// jump to next label
+
+int jump_next_label(int a) {
+    int r = 1;
+    if (a > 10) {
+        r = 2;
+    }
+    else {
+    }
+    return r;
+}
+
+int jump_over_else(int a) {
+    int r;
+    if (a > 10) {
+        r = 2;
+    }
+    else {
+        r = 3;
+    }
+    return r;
+}
+
+// cond jump to next label
+
+int cond_jump_next_label(int a, int b) {
+    if (a < b) {
+    }
+    return a - b;
+}
+
+int cond_jump_over_body(int a, int b) {
+    int r = 0;
+    if (a < b) {
+        r = b - a;
+    }
+    return r;
+}
+
+// compare zero as test
+
+int cmp_zero_signed(long a) {
+    int r = 0;
+    if (a < 0l) {
+        r += 1;
+    }
+    if (a == 0l) {
+        r += 2;
+    }
+    if (a > 0l) {
+        r += 4;
+    }
+    if (a >= 0l) {
+        r += 8;
+    }
+    return r;
+}
+
+int cmp_zero_unsigned(unsigned int a) {
+    int r = 0;
+    if (a > 0u) {
+        r += 1;
+    }
+    if (a != 0u) {
+        r += 2;
+    }
+    if (a <= 0u) {
+        r += 4;
+    }
+    return r;
+}
+
+int cmp_zero_char(char c) {
+    return c < 0 ? 1 : c == 0 ? 2 : 3;
+}
+
+int cmp_nonzero(long a) {
+    return a < 1l ? 1 : 2;
+}
+
+// move zero as xor
+
+long mov_zero(long a) {
+    long r = 0l;
+    for (long i = 0l; i < a; i = i + 1l) {
+        r = r + i;
+    }
+    return r;
+}
+
+int mov_zero_flags_live(int a, int b) {
+    return a < b;
+}
+
+int mov_zero_flags_live_ne(long a, long b) {
+    int r = a != b;
+    int s = a == b;
+    return r * 2 + s;
+}
+
+unsigned long mov_zero_flags_live_quad(unsigned long a, unsigned long b) {
+    unsigned long r = a > b;
+    return r + (unsigned long)(a <= b) * 10ul;
+}
+
+// store then load
+
+long store_load(long a) {
+    long x = a;
+    long* p = &x;
+    *p = a + 1l;
+    return *p + x;
+}
+
+long store_load_alias(long* p, long* q, long a, long b) {
+    *p = a;
+    *q = b;
+    return *p;
+}
+
+double store_load_double(double* p, double a) {
+    *p = a;
+    return *p * 2.0;
+}
+
+double store_load_global(double a, double b) {
+    glob_d = a * b;
+    return glob_d * 2.0;
+}
+
+double store_load_global_alias(double* p, double a) {
+    glob_d = a;
+    *p = a + 1.0;
+    return glob_d;
+}
+
+// load then store
+
+long load_store(long* p) {
+    long x = *p;
+    *p = x;
+    return x;
+}
+
+long* load_store_through_reg(long** pp) {
+    long* p = *pp;
+    *(long**)p = p;
+    return p;
+}
+
+int load_store_global(void) {
+    int x = glob_i;
+    glob_i = x;
+    glob_l = glob_l;
+    return x;
+}
+
+int main(void) {
+    if (self_move_long(3l, 4l) != 7l) {
+        return 1; // fail
+    }
+    if (self_move_long(3l, -4l) != 6l) {
+        return 2; // fail
+    }
+    if (self_move_zero_extend(18446744069720004216ul) != 305419896ul) {
+        return 3; // fail
+    }
+    if (self_move_truncate_sum(18446744073709551615ul, 2ul) != 2ul) {
+        return 4; // fail
+    }
+    if (jump_next_label(11) != 2 || jump_next_label(10) != 1) {
+        return 5; // fail
+    }
+    if (jump_over_else(11) != 2 || jump_over_else(10) != 3) {
+        return 6; // fail
+    }
+    if (cond_jump_next_label(1, 2) != -1 || cond_jump_next_label(5, 2) != 3) {
+        return 7; // fail
+    }
+    if (cond_jump_over_body(1, 4) != 3 || cond_jump_over_body(4, 1) != 0) {
+        return 8; // fail
+    }
+    if (cmp_zero_signed(-5l) != 1 || cmp_zero_signed(0l) != 10 || cmp_zero_signed(7l) != 12) {
+        return 9; // fail
+    }
+    if (cmp_zero_signed(-9223372036854775807l - 1l) != 1) {
+        return 10; // fail
+    }
+    if (cmp_zero_unsigned(0u) != 4 || cmp_zero_unsigned(4294967295u) != 3) {
+        return 11; // fail
+    }
+    if (cmp_zero_char((char)-1) != 1 || cmp_zero_char((char)0) != 2 || cmp_zero_char((char)127) != 3) {
+        return 12; // fail
+    }
+    if (cmp_nonzero(0l) != 1 || cmp_nonzero(1l) != 2) {
+        return 13; // fail
+    }
+    if (mov_zero(5l) != 10l || mov_zero(0l) != 0l) {
+        return 14; // fail
+    }
+    if (mov_zero_flags_live(1, 2) != 1 || mov_zero_flags_live(2, 1) != 0) {
+        return 15; // fail
+    }
+    if (mov_zero_flags_live_ne(3l, 4l) != 2 || mov_zero_flags_live_ne(4l, 4l) != 1) {
+        return 16; // fail
+    }
+    if (mov_zero_flags_live_quad(5ul, 4ul) != 1ul || mov_zero_flags_live_quad(4ul, 5ul) != 10ul) {
+        return 17; // fail
+    }
+    if (store_load(4l) != 10l) {
+        return 18; // fail
+    }
+    {
+        long x = 1l;
+        long y = 2l;
+        if (store_load_alias(&x, &x, 3l, 4l) != 4l) {
+            return 19; // fail
+        }
+        if (store_load_alias(&x, &y, 5l, 6l) != 5l || y != 6l) {
+            return 20; // fail
+        }
+    }
+    {
+        double d = 0.0;
+        if (store_load_double(&d, 1.5) != 3.0 || d != 1.5) {
+            return 21; // fail
+        }
+    }
+    if (store_load_global(1.5, 3.0) != 9.0 || glob_d != 4.5) {
+        return 22; // fail
+    }
+    if (store_load_global_alias(&glob_d, 2.0) != 3.0) {
+        return 23; // fail
+    }
+    {
+        long x = 8l;
+        if (load_store(&x) != 8l || x != 8l) {
+            return 24; // fail
+        }
+    }
+    {
+        long cell = 0l;
+        long* p = &cell;
+        long** pp = &p;
+        if (load_store_through_reg(pp) != &cell || *(long**)&cell != &cell) {
+            return 25; // fail
+        }
+    }
+    if (load_store_global() != 3 || glob_i != 3 || glob_l != 5l) {
+        return 26; // fail
+    }
+    return 0; // success
+}
@@ -0,0 +1,53 @@
+/* Test that calls are not lowered to sibling calls when the caller or the
+ * callee returns a structure through memory, or when the caller takes the
+ * address of one of its locals.
+ * */
+
+struct big {
+    long a;
+    long b;
+    long c;
+};
+
+struct big make_big(long x) {
+    struct big result = {x, x * 2l, x * 3l};
+    return result;
+}
+
+// both return a structure through memory
+struct big wrap_big(long x) {
+    return make_big(x + 1l);
+}
+
+long sum_big(struct big s) {
+    return s.a + s.b + s.c;
+}
+
+// the caller returns a scalar, but passes a structure in memory
+long call_sum_big(long x) {
+    return sum_big(wrap_big(x));
+}
+
+long deref(long *ptr, long x) {
+    return *ptr + x;
+}
+
+// the callee reads a local of the caller through a pointer
+long addressed_local(long x) {
+    long local = x * 10l;
+    return deref(&local, x);
+}
+
+int main(void) {
+    struct big s = wrap_big(4l);
+    if (s.a != 5l || s.b != 10l || s.c != 15l) {
+        return 1; // fail
+    }
+    if (call_sum_big(1l) != 12l) {
+        return 2; // fail
+    }
+    if (addressed_local(3l) != 33l) {
+        return 3; // fail
+    }
+    return 0; // success
+}
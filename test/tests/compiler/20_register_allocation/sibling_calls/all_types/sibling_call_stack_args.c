@@ -0,0 +1,65 @@
+/* Test sibling calls which pass arguments on the stack: the stack arguments are
+ * stored in place in the caller's incoming argument area, so they must not be
+ * overwritten before they are read when they are passed in a different order.
+ * */
+
+long callee(long a, long b, long c, long d, long e, long f, long g, long h) {
+    return a + 2l * b + 3l * c + 4l * d + 5l * e + 6l * f + 7l * g + 8l * h;
+}
+
+// swaps the two stack arguments
+long swap_stack_args(long a, long b, long c, long d, long e, long f, long g, long h) {
+    return callee(a, b, c, d, e, f, h, g);
+}
+
+// moves register arguments to the stack and stack arguments to registers
+long rotate_args(long a, long b, long c, long d, long e, long f, long g, long h) {
+    return callee(g, h, a, b, c, d, e, f);
+}
+
+long callee_7(long a, long b, long c, long d, long e, long f, long g) {
+    return a + 2l * b + 3l * c + 4l * d + 5l * e + 6l * f + 7l * g;
+}
+
+// passes fewer stack arguments than it received
+long fewer_stack_args(long a, long b, long c, long d, long e, long f, long g, long h) {
+    return callee_7(h, g, f, e, d, c, b);
+}
+
+double dbl_callee(double a, double b, double c, double d, double e, double f, double g, double h, double i,
+    double j) {
+    return a - b + c - d + e - f + g - h + i * 10.0 - j * 100.0;
+}
+
+double dbl_swap_stack_args(double a, double b, double c, double d, double e, double f, double g, double h,
+    double i, double j) {
+    return dbl_callee(a, b, c, d, e, f, g, h, j, i);
+}
+
+// each call is a sibling call with a stack argument
+long count_down(long n, long a, long b, long c, long d, long e, long acc, long step) {
+    if (n == 0l) {
+        return acc;
+    }
+    return count_down(n - 1l, a, b, c, d, e, acc + step, step + 1l);
+}
+
+int main(void) {
+    if (swap_stack_args(1l, 2l, 3l, 4l, 5l, 6l, 7l, 8l) != 1l + 4l + 9l + 16l + 25l + 36l + 56l + 56l) {
+        return 1; // fail
+    }
+    if (rotate_args(1l, 2l, 3l, 4l, 5l, 6l, 7l, 8l) != 7l + 16l + 3l + 8l + 15l + 24l + 35l + 48l) {
+        return 2; // fail
+    }
+    if (fewer_stack_args(1l, 2l, 3l, 4l, 5l, 6l, 7l, 8l) != 8l + 14l + 18l + 20l + 20l + 18l + 14l) {
+        return 3; // fail
+    }
+    if (dbl_swap_stack_args(1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0) != -4.0 + 100.0 - 900.0) {
+        return 4; // fail
+    }
+    // acc = 1 + 2 + ... + 1000
+    if (count_down(1000l, 0l, 0l, 0l, 0l, 0l, 0l, 1l) != 500500l) {
+        return 5; // fail
+    }
+    return 0; // success
+}
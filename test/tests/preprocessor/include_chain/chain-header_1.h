@@ -0,0 +1,2 @@
+#include "chain-header_2.h"
+char* c1 = "Chain 1!";
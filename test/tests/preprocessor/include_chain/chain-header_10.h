@@ -0,0 +1,2 @@
+#include "chain-header_11.h"
+char* c10 = "Chain 10!";
@@ -0,0 +1,2 @@
+#include "chain-header_12.h"
+char* c11 = "Chain 11!";
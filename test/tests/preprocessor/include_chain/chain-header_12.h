@@ -0,0 +1,2 @@
+#include "chain-header_13.h"
+char* c12 = "Chain 12!";
@@ -0,0 +1,2 @@
+#include "chain-header_14.h"
+char* c13 = "Chain 13!";
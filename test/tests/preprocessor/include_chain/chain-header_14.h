@@ -0,0 +1,2 @@
+#include "chain-header_15.h"
+char* c14 = "Chain 14!";
@@ -0,0 +1,2 @@
+#include "chain-header_16.h"
+char* c15 = "Chain 15!";
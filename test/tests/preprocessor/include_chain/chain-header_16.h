@@ -0,0 +1,2 @@
+#include "chain-header_17.h"
+char* c16 = "Chain 16!";
@@ -0,0 +1,2 @@
+#include "chain-header_18.h"
+char* c17 = "Chain 17!";
@@ -0,0 +1,2 @@
+#include "chain-header_19.h"
+char* c18 = "Chain 18!";
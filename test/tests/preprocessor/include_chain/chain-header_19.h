@@ -0,0 +1,2 @@
+#include "chain-header_20.h"
+char* c19 = "Chain 19!";
@@ -0,0 +1,2 @@
+#include "chain-header_3.h"
+char* c2 = "Chain 2!";
@@ -0,0 +1,2 @@
+#include "chain-header_21.h"
+char* c20 = "Chain 20!";
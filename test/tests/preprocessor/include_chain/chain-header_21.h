@@ -0,0 +1,2 @@
+#include "chain-header_22.h"
+char* c21 = "Chain 21!";
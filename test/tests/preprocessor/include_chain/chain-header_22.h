@@ -0,0 +1,2 @@
+#include "chain-header_23.h"
+char* c22 = "Chain 22!";
@@ -0,0 +1,2 @@
+#include "chain-header_24.h"
+char* c23 = "Chain 23!";
@@ -0,0 +1,2 @@
+#include "chain-header_25.h"
+char* c24 = "Chain 24!";
@@ -0,0 +1,2 @@
+#include "chain-header_26.h"
+char* c25 = "Chain 25!";
@@ -0,0 +1,2 @@
+#include "chain-header_27.h"
+char* c26 = "Chain 26!";
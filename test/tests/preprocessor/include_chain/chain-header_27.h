@@ -0,0 +1,2 @@
+#include "chain-header_28.h"
+char* c27 = "Chain 27!";
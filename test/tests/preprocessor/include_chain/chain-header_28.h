@@ -0,0 +1,2 @@
+#include "chain-header_29.h"
+char* c28 = "Chain 28!";
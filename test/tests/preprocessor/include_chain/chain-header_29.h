@@ -0,0 +1,2 @@
+#include "chain-header_30.h"
+char* c29 = "Chain 29!";
@@ -0,0 +1,2 @@
+#include "chain-header_4.h"
+char* c3 = "Chain 3!";
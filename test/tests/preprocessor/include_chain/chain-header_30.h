@@ -0,0 +1,2 @@
+#include "chain-header_31.h"
+char* c30 = "Chain 30!";
@@ -0,0 +1,2 @@
+#include "chain-header_32.h"
+char* c31 = "Chain 31!";
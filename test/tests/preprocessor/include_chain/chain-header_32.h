@@ -0,0 +1,2 @@
+#include "chain-header_33.h"
+char* c32 = "Chain 32!";
@@ -0,0 +1,2 @@
+#include "chain-header_34.h"
+char* c33 = "Chain 33!";
@@ -0,0 +1,2 @@
+#include "chain-header_35.h"
+char* c34 = "Chain 34!";
@@ -0,0 +1,2 @@
+#include "chain-header_36.h"
+char* c35 = "Chain 35!";
@@ -0,0 +1,2 @@
+#include "chain-header_37.h"
+char* c36 = "Chain 36!";
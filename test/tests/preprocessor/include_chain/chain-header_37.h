@@ -0,0 +1,2 @@
+#include "chain-header_38.h"
+char* c37 = "Chain 37!";
@@ -0,0 +1,2 @@
+#include "chain-header_39.h"
+char* c38 = "Chain 38!";
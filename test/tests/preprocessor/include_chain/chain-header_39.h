@@ -0,0 +1,2 @@
+#include "chain-header_40.h"
+char* c39 = "Chain 39!";
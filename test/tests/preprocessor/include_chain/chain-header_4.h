@@ -0,0 +1,2 @@
+#include "chain-header_5.h"
+char* c4 = "Chain 4!";
@@ -0,0 +1,2 @@
+#include "chain-header_41.h"
+char* c40 = "Chain 40!";
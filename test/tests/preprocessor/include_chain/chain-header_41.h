@@ -0,0 +1,2 @@
+#include "chain-header_42.h"
+char* c41 = "Chain 41!";
@@ -0,0 +1,2 @@
+#include "chain-header_43.h"
+char* c42 = "Chain 42!";
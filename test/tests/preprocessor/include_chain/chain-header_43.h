@@ -0,0 +1,2 @@
+#include "chain-header_44.h"
+char* c43 = "Chain 43!";
@@ -0,0 +1,2 @@
+#include "chain-header_45.h"
+char* c44 = "Chain 44!";
@@ -0,0 +1,2 @@
+#include "chain-header_46.h"
+char* c45 = "Chain 45!";
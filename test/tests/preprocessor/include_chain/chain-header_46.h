@@ -0,0 +1,2 @@
+#include "chain-header_47.h"
+char* c46 = "Chain 46!";
@@ -0,0 +1,2 @@
+#include "chain-header_48.h"
+char* c47 = "Chain 47!";
@@ -0,0 +1,2 @@
+#include "chain-header_49.h"
+char* c48 = "Chain 48!";
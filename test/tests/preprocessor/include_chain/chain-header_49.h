@@ -0,0 +1,2 @@
+#include "chain-header_50.h"
+char* c49 = "Chain 49!";
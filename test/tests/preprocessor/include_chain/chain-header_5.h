@@ -0,0 +1,2 @@
+#include "chain-header_6.h"
+char* c5 = "Chain 5!";
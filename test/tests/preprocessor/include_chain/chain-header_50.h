@@ -0,0 +1,2 @@
+#include "chain-header_51.h"
+char* c50 = "Chain 50!";
@@ -0,0 +1,2 @@
+#include "chain-header_52.h"
+char* c51 = "Chain 51!";
@@ -0,0 +1,2 @@
+#include "chain-header_53.h"
+char* c52 = "Chain 52!";
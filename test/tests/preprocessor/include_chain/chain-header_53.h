@@ -0,0 +1,2 @@
+#include "chain-header_54.h"
+char* c53 = "Chain 53!";
@@ -0,0 +1,2 @@
+#include "chain-header_55.h"
+char* c54 = "Chain 54!";
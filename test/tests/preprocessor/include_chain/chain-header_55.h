@@ -0,0 +1,2 @@
+#include "chain-header_56.h"
+char* c55 = "Chain 55!";
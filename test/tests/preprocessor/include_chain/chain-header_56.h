@@ -0,0 +1,2 @@
+#include "chain-header_57.h"
+char* c56 = "Chain 56!";
@@ -0,0 +1,2 @@
+#include "chain-header_58.h"
+char* c57 = "Chain 57!";
@@ -0,0 +1,2 @@
+#include "chain-header_59.h"
+char* c58 = "Chain 58!";
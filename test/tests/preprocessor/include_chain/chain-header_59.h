@@ -0,0 +1,2 @@
+#include "chain-header_60.h"
+char* c59 = "Chain 59!";
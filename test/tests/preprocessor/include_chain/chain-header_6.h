@@ -0,0 +1,2 @@
+#include "chain-header_7.h"
+char* c6 = "Chain 6!";
@@ -0,0 +1,2 @@
+#include "chain-header_61.h"
+char* c60 = "Chain 60!";
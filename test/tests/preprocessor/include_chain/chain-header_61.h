@@ -0,0 +1,2 @@
+#include "chain-header_62.h"
+char* c61 = "Chain 61!";
@@ -0,0 +1,2 @@
+#include "chain-header_63.h"
+char* c62 = "Chain 62!";
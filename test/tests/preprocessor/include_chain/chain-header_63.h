@@ -0,0 +1,2 @@
+#include "chain-header_64.h"
+char* c63 = "Chain 63!";
@@ -0,0 +1 @@
+char* c64 = "Chain 64!";
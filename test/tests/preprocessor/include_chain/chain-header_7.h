@@ -0,0 +1,2 @@
+#include "chain-header_8.h"
+char* c7 = "Chain 7!";
@@ -0,0 +1,2 @@
+#include "chain-header_9.h"
+char* c8 = "Chain 8!";
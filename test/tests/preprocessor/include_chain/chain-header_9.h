@@ -0,0 +1,2 @@
+#include "chain-header_10.h"
+char* c9 = "Chain 9!";
@@ -0,0 +1,71 @@
+int puts(char* s);
+
+#include "chain-header_1.h"
+
+int main(void) {
+    puts(c1);
+    puts(c2);
+    puts(c3);
+    puts(c4);
+    puts(c5);
+    puts(c6);
+    puts(c7);
+    puts(c8);
+    puts(c9);
+    puts(c10);
+    puts(c11);
+    puts(c12);
+    puts(c13);
+    puts(c14);
+    puts(c15);
+    puts(c16);
+    puts(c17);
+    puts(c18);
+    puts(c19);
+    puts(c20);
+    puts(c21);
+    puts(c22);
+    puts(c23);
+    puts(c24);
+    puts(c25);
+    puts(c26);
+    puts(c27);
+    puts(c28);
+    puts(c29);
+    puts(c30);
+    puts(c31);
+    puts(c32);
+    puts(c33);
+    puts(c34);
+    puts(c35);
+    puts(c36);
+    puts(c37);
+    puts(c38);
+    puts(c39);
+    puts(c40);
+    puts(c41);
+    puts(c42);
+    puts(c43);
+    puts(c44);
+    puts(c45);
+    puts(c46);
+    puts(c47);
+    puts(c48);
+    puts(c49);
+    puts(c50);
+    puts(c51);
+    puts(c52);
+    puts(c53);
+    puts(c54);
+    puts(c55);
+    puts(c56);
+    puts(c57);
+    puts(c58);
+    puts(c59);
+    puts(c60);
+    puts(c61);
+    puts(c62);
+    puts(c63);
+    puts(c64);
+    return 64;
+}
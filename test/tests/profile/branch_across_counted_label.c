@@ -0,0 +1,40 @@
+/* Test that profile counters do not clobber the condition codes which are live
+ * across a counted label: double comparisons branch on the parity flag to an
+ * internal label which then tests the other flags.
+ * */
+
+int puts(char *s);
+
+double zero = 0.0;
+
+int compare(double a, double b) {
+    int count = 0;
+    if (a < b) {
+        count = count + 1;
+    }
+    if (a != b) {
+        count = count + 2;
+    }
+    if (a == b) {
+        count = count + 4;
+    }
+    count = count + (a >= b) * 8;
+    count = count + (a > b ? 16 : 0);
+    return count;
+}
+
+int main(void) {
+    double nan = zero / zero;
+    int total = 0;
+    for (int i = 0; i < 10; i = i + 1) {
+        total = total + compare(i * 1.0, 4.0);
+        total = total + compare(nan, i * 1.0);
+        total = total + compare(i * 1.0, nan) * 3;
+    }
+    if (total != 4 * 3 + 12 + 5 * 26 + 10 * 2 + 10 * 6) {
+        puts("fail");
+        return 1;
+    }
+    puts("success");
+    return 0;
+}
@@ -0,0 +1,76 @@
+/* Test that the block layout driven by a profile keeps the program semantics:
+ * branches that go one way most of the time fall through to their frequent
+ * successor, and blocks that never ran are moved to the end of the function.
+ * */
+
+int puts(char *s);
+
+long checks = 0l;
+
+long clamp(long x, long lo, long hi) {
+    // the clamped cases are rare, so the return of x falls through
+    if (x < lo) {
+        return lo;
+    }
+    if (x > hi) {
+        return hi;
+    }
+    return x;
+}
+
+long never_negative(long x) {
+    checks = checks + 1l;
+    if (x >= 0l) {
+        return x;
+    }
+    // this block never runs with the profile, and is placed at the end of the function
+    puts("negative");
+    return -x;
+}
+
+long classify(long x) {
+    long r;
+    switch (x % 1024l) {
+        case 0:
+            r = 10l;
+            break;
+        case 1001:
+            // this case never runs, and is placed at the end of the function
+            r = classify(x / 2l) * 3l;
+            break;
+        case 7:
+            r = 70l;
+            break;
+        default:
+            r = x % 8l;
+            break;
+    }
+    return r;
+}
+
+long unused(long x) {
+    // this function never runs with the profile
+    long r = 0l;
+    for (long i = 0l; i < x; i = i + 1l) {
+        r = r + i;
+    }
+    return r;
+}
+
+int main(void) {
+    long total = 0l;
+    for (long i = 0l; i < 1000l; i = i + 1l) {
+        total = total + clamp(i, 1l, 998l);
+        total = total + never_negative(i);
+        total = total + classify(i);
+    }
+    if (checks == 0l) {
+        total = total + unused(10l);
+    }
+    if (total != 499500l + 499500l + 125l * 28l + 10l + 63l || checks != 1000l) {
+        puts("fail");
+        return 1;
+    }
+    puts("success");
+    return 0;
+}
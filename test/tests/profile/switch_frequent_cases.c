@@ -0,0 +1,38 @@
+/* Test that switch statements which test their most frequent cases first with
+ * a profile still select the right case.
+ * */
+
+int puts(char *s);
+
+int classify(int x) {
+    // remainders of negative values are negative
+    switch (x % 7 + 1) {
+        case 1:
+            return 10;
+        case 2:
+            return 20;
+        case 4:
+            return 30;
+        case 6:
+            // the most frequent case
+            return 40;
+        case 0:
+            return 50;
+        default:
+            return 60;
+    }
+}
+
+int main(void) {
+    long total = 0l;
+    for (int i = -20; i < 200; i = i + 1) {
+        int x = i % 3 == 0 ? 5 : i;
+        total = total + classify(x);
+    }
+    if (total != 8920l) {
+        puts("fail");
+        return 1;
+    }
+    puts("success");
+    return 0;
+}
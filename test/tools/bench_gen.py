@@ -0,0 +1,106 @@
+from sys import argv, exit
+from os import makedirs
+from os.path import join
+
+# Generates parameterised large C inputs for the throughput benchmark, each kind scales one dimension of the input
+# with the size parameter and compiles to a valid program
+KINDS = ["function", "nesting", "temporaries", "switch", "initializer", "includes"]
+
+def gen_function(size):
+    lines = ["long fun(long a, long b) {", "    long x = a;", "    long y = b;"]
+    for i in range(size):
+        if i % 4 == 0:
+            lines.append("    x = x * " + str(i % 7 + 2) + " + y;")
+        elif i % 4 == 1:
+            lines.append("    y = y - x / " + str(i % 5 + 1) + ";")
+        elif i % 4 == 2:
+            lines.append("    if (x > y) { x = x - " + str(i) + "; } else { y = y + " + str(i) + "; }")
+        else:
+            lines.append("    x = x ^ (y << " + str(i % 3 + 1) + ");")
+    lines += ["    return x + y;", "}", "", "int main(void) {", "    return (int)(fun(1, 2) & 127);", "}"]
+    return lines
+
+def gen_nesting(size):
+    lines = ["int fun(int a) {", "    int x = 0;"]
+    for i in range(size):
+        indent = "    " * (i + 1)
+        if i % 2 == 0:
+            lines.append(indent + "if (a > " + str(i) + ") {")
+        else:
+            lines.append(indent + "for (int i" + str(i) + " = 0; i" + str(i) + " < a; i" + str(i) + "++) {")
+        lines.append(indent + "    x = x + " + str(i) + ";")
+    for i in reversed(range(size)):
+        lines.append("    " * (i + 1) + "}")
+    lines += ["    return x;", "}", "", "int main(void) {", "    return fun(1) & 127;", "}"]
+    return lines
+
+def gen_temporaries(size):
+    lines = ["long fun(long a) {"]
+    for i in range(size):
+        if i == 0:
+            lines.append("    long t0 = a + 1;")
+        else:
+            lines.append("    long t" + str(i) + " = t" + str(i - 1) + " * " + str(i % 9 + 2) + " + a;")
+    lines.append("    long s = 0;")
+    for i in reversed(range(size)):
+        lines.append("    s = s + t" + str(i) + ";")
+    lines += ["    return s;", "}", "", "int main(void) {", "    return (int)(fun(5) & 127);", "}"]
+    return lines
+
+def gen_switch(size):
+    lines = ["int fun(int a) {", "    int x = 0;", "    switch (a) {"]
+    for i in range(size):
+        lines.append("        case " + str(i) + ":")
+        lines.append("            x = a * " + str(i % 11 + 1) + " + " + str(i) + ";")
+        if i % 3 != 0:
+            lines.append("            break;")
+    lines += ["        default:", "            x = -1;", "    }", "    return x;", "}", "",
+              "int main(void) {", "    return fun(" + str(size // 2) + ") & 127;", "}"]
+    return lines
+
+def gen_initializer(size):
+    lines = ["long data[" + str(size) + "] = {"]
+    for i in range(0, size, 16):
+        values = [str((j * 7919) % 65521) for j in range(i, min(i + 16, size))]
+        lines.append("    " + ", ".join(values) + ",")
+    lines += ["};", "", "int main(void) {", "    double local[" + str(size) + "] = {"]
+    for i in range(0, size, 16):
+        values = [str(j) + ".5" for j in range(i, min(i + 16, size))]
+        lines.append("        " + ", ".join(values) + ",")
+    lines += ["    };", "    long s = 0;", "    for (int i = 0; i < " + str(size) + "; i++) {",
+              "        s = s + data[i] + (long)local[i];", "    }", "    return (int)(s & 127);", "}"]
+    return lines
+
+def gen_includes(size, dirname):
+    for i in range(size):
+        header = []
+        if i + 1 < size:
+            header.append("#include \"inc_" + str(i + 1) + ".h\"")
+        header += ["static int inc_" + str(i) + "(int a) {", "    return a + " + str(i) + ";", "}"]
+        with open(join(dirname, "inc_" + str(i) + ".h"), "w") as file:
+            file.write("\n".join(header) + "\n")
+    lines = ["#include \"inc_0.h\"", "", "int main(void) {", "    int x = 0;"]
+    for i in range(size):
+        lines.append("    x = inc_" + str(i) + "(x);")
+    lines += ["    return x & 127;", "}"]
+    return lines
+
+# Writes <kind>_<size>.c to dirname and returns its path
+def generate(kind, size, dirname):
+    makedirs(dirname, exist_ok=True)
+    if kind == "includes":
+        dirname = join(dirname, "includes_" + str(size))
+        makedirs(dirname, exist_ok=True)
+        lines = gen_includes(size, dirname)
+    else:
+        lines = globals()["gen_" + kind](size)
+    filename = join(dirname, kind + "_" + str(size) + ".c")
+    with open(filename, "w") as file:
+        file.write("\n".join(lines) + "\n")
+    return filename
+
+if __name__ == "__main__":
+    if len(argv) < 3 or argv[1] not in KINDS:
+        print("usage: python3 bench_gen.py {" + " | ".join(KINDS) + "} SIZE [DIR]")
+        exit(1)
+    print(generate(argv[1], int(argv[2]), argv[3] if len(argv) > 3 else "."))
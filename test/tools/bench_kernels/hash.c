@@ -0,0 +1,80 @@
+// FNV-1a hashing and an open addressing hash table
+
+int putchar(int c);
+
+// Prints the value in decimal on its own line
+static void print_long(long value) {
+    char digits[20];
+    unsigned long magnitude = (unsigned long)value;
+    if (value < 0l) {
+        putchar('-');
+        magnitude = 0ul - magnitude;
+    }
+    int size = 0;
+    do {
+        digits[size] = (char)('0' + magnitude % 10ul);
+        size++;
+        magnitude = magnitude / 10ul;
+    }
+    while (magnitude > 0ul);
+    while (size > 0) {
+        size--;
+        putchar(digits[size]);
+    }
+    putchar('\n');
+}
+
+static unsigned char bytes[65536];
+static unsigned long keys[131072];
+static long values[131072];
+
+static unsigned long fnv1a(unsigned char* buf, int size) {
+    unsigned long hash = 14695981039346656037ul;
+    for (int i = 0; i < size; i++) {
+        hash = hash ^ buf[i];
+        hash = hash * 1099511628211ul;
+    }
+    return hash;
+}
+
+static void insert(unsigned long key, long value) {
+    unsigned long slot = (key * 11400714819323198485ul) >> 47;
+    while (keys[slot] != 0ul && keys[slot] != key) {
+        slot = (slot + 1ul) & 131071ul;
+    }
+    keys[slot] = key;
+    values[slot] = values[slot] + value;
+}
+
+static long lookup(unsigned long key) {
+    unsigned long slot = (key * 11400714819323198485ul) >> 47;
+    while (keys[slot] != 0ul) {
+        if (keys[slot] == key) {
+            return values[slot];
+        }
+        slot = (slot + 1ul) & 131071ul;
+    }
+    return 0;
+}
+
+int main(void) {
+    unsigned long seed = 42ul;
+    for (int i = 0; i < 65536; i++) {
+        seed = seed * 6364136223846793005ul + 1442695040888963407ul;
+        bytes[i] = (unsigned char)(seed >> 56);
+    }
+    unsigned long hash = 0ul;
+    for (int round = 0; round < 40; round++) {
+        bytes[round] = (unsigned char)round;
+        hash = hash ^ fnv1a(bytes, 65536);
+    }
+    for (int i = 0; i < 80000; i++) {
+        insert(fnv1a(bytes + (i & 32767), 8) | 1ul, i);
+    }
+    long found = 0;
+    for (int i = 0; i < 160000; i++) {
+        found = found + lookup(fnv1a(bytes + (i & 65535), 8) | 1ul) % 1000;
+    }
+    print_long((long)(hash >> 16) ^ found);
+    return 0;
+}
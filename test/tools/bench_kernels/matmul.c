@@ -0,0 +1,60 @@
+// Dense double precision matrix multiply
+
+int putchar(int c);
+
+// Prints the value in decimal on its own line
+static void print_long(long value) {
+    char digits[20];
+    unsigned long magnitude = (unsigned long)value;
+    if (value < 0l) {
+        putchar('-');
+        magnitude = 0ul - magnitude;
+    }
+    int size = 0;
+    do {
+        digits[size] = (char)('0' + magnitude % 10ul);
+        size++;
+        magnitude = magnitude / 10ul;
+    }
+    while (magnitude > 0ul);
+    while (size > 0) {
+        size--;
+        putchar(digits[size]);
+    }
+    putchar('\n');
+}
+
+static double a[40000];
+static double b[40000];
+static double c[40000];
+
+static void matmul(double* x, double* y, double* z, int n) {
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            z[i * n + j] = 0.0;
+        }
+        for (int k = 0; k < n; k++) {
+            double scale = x[i * n + k];
+            for (int j = 0; j < n; j++) {
+                z[i * n + j] = z[i * n + j] + scale * y[k * n + j];
+            }
+        }
+    }
+}
+
+int main(void) {
+    for (int i = 0; i < 40000; i++) {
+        a[i] = (double)(i % 17) * 0.25 - 1.0;
+        b[i] = (double)(i % 13) * 0.5 + 0.125;
+    }
+    double trace = 0.0;
+    for (int round = 0; round < 4; round++) {
+        matmul(a, b, c, 200);
+        for (int i = 0; i < 200; i++) {
+            trace = trace + c[i * 200 + i];
+        }
+        a[round] = a[round] + 1.0;
+    }
+    print_long((long)trace);
+    return 0;
+}
@@ -0,0 +1,57 @@
+// Naive fibonacci, ackermann and towers of hanoi
+
+int putchar(int c);
+
+// Prints the value in decimal on its own line
+static void print_long(long value) {
+    char digits[20];
+    unsigned long magnitude = (unsigned long)value;
+    if (value < 0l) {
+        putchar('-');
+        magnitude = 0ul - magnitude;
+    }
+    int size = 0;
+    do {
+        digits[size] = (char)('0' + magnitude % 10ul);
+        size++;
+        magnitude = magnitude / 10ul;
+    }
+    while (magnitude > 0ul);
+    while (size > 0) {
+        size--;
+        putchar(digits[size]);
+    }
+    putchar('\n');
+}
+
+static long fib(int n) {
+    if (n < 2) {
+        return n;
+    }
+    return fib(n - 1) + fib(n - 2);
+}
+
+static long ackermann(long m, long n) {
+    if (m == 0) {
+        return n + 1;
+    }
+    if (n == 0) {
+        return ackermann(m - 1, 1);
+    }
+    return ackermann(m - 1, ackermann(m, n - 1));
+}
+
+static long hanoi(int n, int from, int to, int via) {
+    if (n == 0) {
+        return 0;
+    }
+    return hanoi(n - 1, from, via, to) + 1 + hanoi(n - 1, via, to, from);
+}
+
+int main(void) {
+    long checksum = fib(30);
+    checksum = checksum + ackermann(2, 2000);
+    checksum = checksum + hanoi(20, 1, 3, 2);
+    print_long(checksum);
+    return 0;
+}
@@ -0,0 +1,83 @@
+// Particles bouncing in a box, stored as an array of structures
+
+int putchar(int c);
+
+// Prints the value in decimal on its own line
+static void print_long(long value) {
+    char digits[20];
+    unsigned long magnitude = (unsigned long)value;
+    if (value < 0l) {
+        putchar('-');
+        magnitude = 0ul - magnitude;
+    }
+    int size = 0;
+    do {
+        digits[size] = (char)('0' + magnitude % 10ul);
+        size++;
+        magnitude = magnitude / 10ul;
+    }
+    while (magnitude > 0ul);
+    while (size > 0) {
+        size--;
+        putchar(digits[size]);
+    }
+    putchar('\n');
+}
+
+struct vec2 {
+    double x;
+    double y;
+};
+
+struct particle {
+    struct vec2 position;
+    struct vec2 velocity;
+    double mass;
+    int bounces;
+};
+
+static struct particle particles[2000];
+
+static void step(struct particle* p, double dt) {
+    p->velocity.y = p->velocity.y - 9.81 * dt;
+    p->position.x = p->position.x + p->velocity.x * dt;
+    p->position.y = p->position.y + p->velocity.y * dt;
+    if (p->position.x < 0.0 || p->position.x > 100.0) {
+        p->velocity.x = -p->velocity.x;
+        p->bounces++;
+    }
+    if (p->position.y < 0.0) {
+        p->position.y = -p->position.y;
+        p->velocity.y = -p->velocity.y * 0.9;
+        p->bounces++;
+    }
+}
+
+static double energy(struct particle* p) {
+    struct vec2 v = p->velocity;
+    return 0.5 * p->mass * (v.x * v.x + v.y * v.y) + p->mass * 9.81 * p->position.y;
+}
+
+int main(void) {
+    for (int i = 0; i < 2000; i++) {
+        particles[i].position.x = (double)(i % 100);
+        particles[i].position.y = (double)(i % 37) + 10.0;
+        particles[i].velocity.x = (double)(i % 11) - 5.0;
+        particles[i].velocity.y = (double)(i % 7);
+        particles[i].mass = 1.0 + (double)(i % 3);
+        particles[i].bounces = 0;
+    }
+    for (int t = 0; t < 1000; t++) {
+        for (int i = 0; i < 2000; i++) {
+            step(&particles[i], 0.01);
+        }
+    }
+    double total = 0.0;
+    long bounces = 0;
+    for (int i = 0; i < 2000; i++) {
+        total = total + energy(&particles[i]);
+        bounces = bounces + particles[i].bounces;
+    }
+    print_long((long)total + bounces);
+    return 0;
+}
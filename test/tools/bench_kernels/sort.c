@@ -0,0 +1,98 @@
+// Quicksort and insertion sort of pseudo random integers
+
+int putchar(int c);
+
+// Prints the value in decimal on its own line
+static void print_long(long value) {
+    char digits[20];
+    unsigned long magnitude = (unsigned long)value;
+    if (value < 0l) {
+        putchar('-');
+        magnitude = 0ul - magnitude;
+    }
+    int size = 0;
+    do {
+        digits[size] = (char)('0' + magnitude % 10ul);
+        size++;
+        magnitude = magnitude / 10ul;
+    }
+    while (magnitude > 0ul);
+    while (size > 0) {
+        size--;
+        putchar(digits[size]);
+    }
+    putchar('\n');
+}
+
+static int data[200000];
+static unsigned long seed = 12345ul;
+
+static int next_rand(void) {
+    seed = seed * 6364136223846793005ul + 1442695040888963407ul;
+    return (int)(seed >> 33);
+}
+
+static void insertion_sort(int* a, int lo, int hi) {
+    for (int i = lo + 1; i <= hi; i++) {
+        int key = a[i];
+        int j = i - 1;
+        while (j >= lo && a[j] > key) {
+            a[j + 1] = a[j];
+            j--;
+        }
+        a[j + 1] = key;
+    }
+}
+
+static void quick_sort(int* a, int lo, int hi) {
+    while (hi - lo > 16) {
+        int pivot = a[lo + (hi - lo) / 2];
+        int i = lo;
+        int j = hi;
+        while (i <= j) {
+            while (a[i] < pivot) {
+                i++;
+            }
+            while (a[j] > pivot) {
+                j--;
+            }
+            if (i <= j) {
+                int tmp = a[i];
+                a[i] = a[j];
+                a[j] = tmp;
+                i++;
+                j--;
+            }
+        }
+        if (j - lo < hi - i) {
+            quick_sort(a, lo, j);
+            lo = i;
+        }
+        else {
+            quick_sort(a, i, hi);
+            hi = j;
+        }
+    }
+    insertion_sort(a, lo, hi);
+}
+
+int main(void) {
+    long checksum = 0;
+    for (int round = 0; round < 5; round++) {
+        for (int i = 0; i < 200000; i++) {
+            data[i] = next_rand() % 1000000;
+        }
+        quick_sort(data, 0, 200000 - 1);
+        for (int i = 1; i < 200000; i++) {
+            if (data[i - 1] > data[i]) {
+                return 1;
+            }
+        }
+        for (int i = 0; i < 200000; i += 97) {
+            checksum = checksum * 31 + data[i];
+            checksum = checksum % 1000000007;
+        }
+    }
+    print_long(checksum);
+    return 0;
+}
@@ -0,0 +1,88 @@
+// Word counting and naive substring search over generated text
+
+int putchar(int c);
+
+// Prints the value in decimal on its own line
+static void print_long(long value) {
+    char digits[20];
+    unsigned long magnitude = (unsigned long)value;
+    if (value < 0l) {
+        putchar('-');
+        magnitude = 0ul - magnitude;
+    }
+    int size = 0;
+    do {
+        digits[size] = (char)('0' + magnitude % 10ul);
+        size++;
+        magnitude = magnitude / 10ul;
+    }
+    while (magnitude > 0ul);
+    while (size > 0) {
+        size--;
+        putchar(digits[size]);
+    }
+    putchar('\n');
+}
+
+static char text[1048576];
+
+static int count_words(char* s) {
+    int count = 0;
+    int in_word = 0;
+    for (; *s; s++) {
+        if (*s == ' ' || *s == '\n') {
+            in_word = 0;
+        }
+        else if (!in_word) {
+            in_word = 1;
+            count++;
+        }
+    }
+    return count;
+}
+
+static int count_matches(char* s, char* pattern) {
+    int count = 0;
+    for (; *s; s++) {
+        int i = 0;
+        while (pattern[i] && s[i] == pattern[i]) {
+            i++;
+        }
+        if (!pattern[i]) {
+            count++;
+        }
+    }
+    return count;
+}
+
+static long string_length(char* s) {
+    long size = 0;
+    while (s[size]) {
+        size++;
+    }
+    return size;
+}
+
+int main(void) {
+    char* words[8] = {"the ", "quick ", "brown ", "fox ", "jumps ", "over ", "lazy ", "dog\n"};
+    unsigned long seed = 7ul;
+    long size = 0;
+    while (size < 1048000) {
+        seed = seed * 6364136223846793005ul + 1442695040888963407ul;
+        char* word = words[(seed >> 40) % 8];
+        for (int i = 0; word[i]; i++) {
+            text[size] = word[i];
+            size++;
+        }
+    }
+    text[size] = 0;
+    long checksum = 0;
+    for (int round = 0; round < 4; round++) {
+        checksum = checksum + count_words(text);
+        checksum = checksum + count_matches(text, "fox jumps");
+        checksum = checksum + count_matches(text, "lazy dog");
+        checksum = checksum + string_length(text);
+    }
+    print_long(checksum);
+    return 0;
+}
@@ -0,0 +1,142 @@
+from sys import argv, exit
+from os import listdir
+from os.path import abspath, dirname, join, splitext
+from subprocess import run, PIPE, DEVNULL
+from tempfile import mkdtemp
+from shutil import copyfile, rmtree, which
+from time import perf_counter
+
+# Compiles the kernels in bench_kernels/ with gcc as a reference and with wheelcc at each optimization level, checks
+# their output against the reference and reports run time, code size, and cycles and instructions with perf stat when
+# it is available
+
+def usage():
+    print("usage: python3 bench_runtime.py [--kernels K,...] [--repeat N] [--no-gcc]")
+    exit(1)
+
+with open(join(dirname(__file__), "../../bin/pkgname.cfg")) as file:
+    PACKAGE_NAME = file.read().strip()
+
+KERNEL_DIR = abspath(join(dirname(__file__), "bench_kernels"))
+KERNEL_LIST = sorted(splitext(x)[0] for x in listdir(KERNEL_DIR) if x.endswith(".c"))
+REPEAT = 3
+IS_GCC = True
+
+i = 1
+while i < len(argv):
+    if argv[i] == "--kernels" and i + 1 < len(argv):
+        i += 1
+        KERNEL_LIST = argv[i].split(",")
+    elif argv[i] == "--repeat" and i + 1 < len(argv):
+        i += 1
+        REPEAT = int(argv[i])
+    elif argv[i] == "--no-gcc":
+        IS_GCC = False
+    else:
+        usage()
+    i += 1
+
+CONFIGS = [(PACKAGE_NAME, "-O0"), (PACKAGE_NAME, "-O1"), (PACKAGE_NAME, "-O2"), (PACKAGE_NAME, "-O3")]
+if IS_GCC:
+    CONFIGS = [("gcc", "-O0"), ("gcc", "-O2")] + CONFIGS
+
+# perf is often installed but not permitted to read the hardware counters, so it is probed once
+def has_perf():
+    if not which("perf"):
+        return False
+    result = run(["perf", "stat", "-x", ",", "-e", "cycles,instructions", "true"], stdout=DEVNULL, stderr=PIPE,
+                 universal_newlines=True)
+    return result.returncode == 0 and "<not" not in result.stderr
+
+IS_PERF = has_perf()
+
+def get_text_size(filename):
+    size = 0
+    result = run(["size", "-A", filename], stdout=PIPE, stderr=DEVNULL, universal_newlines=True)
+    for line in result.stdout.splitlines():
+        if line.startswith(".text"):
+            size += int(line.split()[1])
+    return size
+
+# Returns the executable and the code size of the object, which is measured before linking as it is removed after
+def compile_kernel(compiler, optim, kernel, tmp_dir):
+    name = kernel + "_" + compiler + optim
+    copyfile(join(KERNEL_DIR, kernel + ".c"), join(tmp_dir, name + ".c"))
+    if compiler == "gcc":
+        args = [["gcc", "-w", optim, "-c", name + ".c"], ["gcc", "-w", optim, name + ".c", "-o", name]]
+    else:
+        args = [[compiler, optim, "-c", name + ".c"], [compiler, optim, "-o", name, name + ".c"]]
+    text_size = 0
+    for arg in args:
+        result = run(arg, cwd=tmp_dir, stdout=PIPE, stderr=PIPE, universal_newlines=True)
+        if result.returncode != 0:
+            print(result.stderr)
+            return (None, 0)
+        if text_size == 0:
+            text_size = get_text_size(join(tmp_dir, name + ".o"))
+    return (join(tmp_dir, name), text_size)
+
+# Returns the output and the fastest wall time in ms, with cycles and instructions of that run
+def run_kernel(name):
+    best = None
+    for _ in range(REPEAT):
+        args = [name]
+        if IS_PERF:
+            args = ["perf", "stat", "-x", ",", "-e", "cycles,instructions"] + args
+        start = perf_counter()
+        result = run(args, stdout=PIPE, stderr=PIPE, universal_newlines=True)
+        wall = (perf_counter() - start) * 1e3
+        if result.returncode != 0:
+            return (None, 0.0, 0, 0)
+        cycles = 0
+        instrs = 0
+        if IS_PERF:
+            for line in result.stderr.splitlines():
+                fields = line.split(",")
+                if len(fields) > 2 and fields[0].isdigit():
+                    if fields[2].startswith("cycles"):
+                        cycles = int(fields[0])
+                    elif fields[2].startswith("instructions"):
+                        instrs = int(fields[0])
+        if best is None or wall < best[1]:
+            best = (result.stdout, wall, cycles, instrs)
+    return best
+
+RETURN_CODE = 0
+tmp_dir = mkdtemp(prefix="wheelcc_bench_")
+try:
+    for kernel in KERNEL_LIST:
+        print("")
+        print("----------------------------------------------------------------------")
+        print("--bench " + kernel)
+        print("----------------------------------------------------------------------")
+        print("  %-16s %12s %10s %16s %16s %12s  %s" % ("compiler", "time (ms)", "speedup", "cycles",
+                                                        "instructions", "text (B)", "output"))
+        expected = None
+        base_time = None
+        for compiler, optim in CONFIGS:
+            name, text_size = compile_kernel(compiler, optim, kernel, tmp_dir)
+            if not name:
+                print("  %-16s compilation failed" % (compiler + " " + optim))
+                RETURN_CODE = 1
+                continue
+            output, wall, cycles, instrs = run_kernel(name)
+            if output is None:
+                status = "FAIL (crashed)"
+                RETURN_CODE = 1
+            elif expected is None:
+                expected = output
+                status = "ok (reference)"
+            elif output == expected:
+                status = "ok"
+            else:
+                status = "FAIL (expected " + expected.strip() + ", got " + output.strip() + ")"
+                RETURN_CODE = 1
+            if base_time is None:
+                base_time = wall
+            print("  %-16s %12.1f %9.2fx %16s %16s %12d  %s" % (compiler + " " + optim, wall, base_time / wall,
+                  str(cycles) if IS_PERF else "-", str(instrs) if IS_PERF else "-", text_size, status))
+finally:
+    rmtree(tmp_dir)
+
+exit(RETURN_CODE)
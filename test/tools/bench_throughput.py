@@ -0,0 +1,195 @@
+from sys import argv, exit
+from os.path import basename, dirname, join, splitext
+from subprocess import run, PIPE
+from tempfile import mkdtemp
+from shutil import rmtree
+from math import log
+from json import loads, dump, load
+
+from bench_gen import KINDS, generate
+
+# Compiles generated inputs of growing size with -ftime-report=json, so that timings are measured in-process per
+# stage without the process startup, then reports throughput and scaling exponents and compares with a baseline
+
+def usage():
+    print("usage: python3 bench_throughput.py [-O0 | -O1 | -O2 | -O3] [--kinds K,...] [--sizes N,...] "
+          "[--repeat N] [--save FILE] [--baseline FILE] [--threshold R]")
+    exit(1)
+
+with open(join(dirname(__file__), "../../bin/pkgname.cfg")) as file:
+    PACKAGE_NAME = file.read().strip()
+
+OPTIM = "-O0"
+KIND_LIST = KINDS
+SIZE_LIST = None
+REPEAT = 3
+SAVE_FILE = None
+BASELINE_FILE = None
+THRESHOLD = 0.1
+
+i = 1
+while i < len(argv):
+    if argv[i] in ["-O0", "-O1", "-O2", "-O3"]:
+        OPTIM = argv[i]
+    elif argv[i] == "--kinds" and i + 1 < len(argv):
+        i += 1
+        KIND_LIST = argv[i].split(",")
+    elif argv[i] == "--sizes" and i + 1 < len(argv):
+        i += 1
+        SIZE_LIST = [int(x) for x in argv[i].split(",")]
+    elif argv[i] == "--repeat" and i + 1 < len(argv):
+        i += 1
+        REPEAT = int(argv[i])
+    elif argv[i] == "--save" and i + 1 < len(argv):
+        i += 1
+        SAVE_FILE = argv[i]
+    elif argv[i] == "--baseline" and i + 1 < len(argv):
+        i += 1
+        BASELINE_FILE = argv[i]
+    elif argv[i] == "--threshold" and i + 1 < len(argv):
+        i += 1
+        THRESHOLD = float(argv[i])
+    else:
+        usage()
+    i += 1
+
+for kind in KIND_LIST:
+    if kind not in KINDS:
+        usage()
+
+# Nesting scales with the depth of the control flow graph, so it defaults to smaller inputs
+def get_sizes(kind):
+    if SIZE_LIST:
+        return SIZE_LIST
+    elif kind == "nesting":
+        return [25, 50, 100, 200]
+    else:
+        return [250, 500, 1000, 2000]
+
+def count_lines(filename):
+    with open(filename) as file:
+        return sum(1 for _ in file)
+
+def count_source_lines(kind, size, filename):
+    count = count_lines(filename)
+    if kind == "includes":
+        for j in range(size):
+            count += count_lines(join(dirname(filename), "inc_" + str(j) + ".h"))
+    return count
+
+def count_instructions(filename):
+    count = 0
+    with open(filename) as file:
+        for line in file:
+            if line.startswith("    ") and not line.lstrip().startswith("."):
+                count += 1
+    return count
+
+# Returns the total and per stage wall times in ms of the fastest run
+def compile_file(filename):
+    best = None
+    for _ in range(REPEAT):
+        result = run([PACKAGE_NAME, OPTIM, "-ftime-report=json", "-S", basename(filename)],
+                     cwd=dirname(filename), stdout=PIPE, stderr=PIPE, universal_newlines=True)
+        if result.returncode != 0:
+            print(result.stderr)
+            exit(1)
+        report = loads(result.stderr[result.stderr.index("{"):])
+        stages = {x["name"]: x["wall_ms"] for x in report["stages"]}
+        # Passes are nested in the level 1 optimization stage
+        total = sum(stages[x] for x in stages if x in TOP_STAGES)
+        if best is None or total < best[0]:
+            best = (total, stages)
+    return best
+
+TOP_STAGES = ["lexing", "parsing", "semantic analysis", "tac representation", "level 1 optimization",
+              "assembly generation", "register allocation", "stack fix", "block layout", "peephole optimization",
+              "code emission"]
+
+# Least squares slope of log(time) over log(size), 1 is linear and 2 is quadratic
+def fit_exponent(points):
+    points = [(log(x), log(y)) for x, y in points if y > 0]
+    if len(points) < 2:
+        return 0.0
+    mean_x = sum(x for x, _ in points) / len(points)
+    mean_y = sum(y for _, y in points) / len(points)
+    cov = sum((x - mean_x) * (y - mean_y) for x, y in points)
+    var = sum((x - mean_x) ** 2 for x, _ in points)
+    return cov / var if var > 0 else 0.0
+
+results = {"optim": OPTIM, "kinds": {}}
+tmp_dir = mkdtemp(prefix="wheelcc_bench_")
+try:
+    for kind in KIND_LIST:
+        print("")
+        print("----------------------------------------------------------------------")
+        print("--bench " + kind + " " + OPTIM)
+        print("----------------------------------------------------------------------")
+        print("  %8s %10s %10s %12s %14s %16s  %s" % ("size", "lines", "instrs", "total (ms)", "lines/s",
+                                                     "instrs/s", "slowest stage"))
+        runs = {}
+        for size in get_sizes(kind):
+            filename = generate(kind, size, tmp_dir)
+            total, stages = compile_file(filename)
+            lines = count_source_lines(kind, size, filename)
+            instrs = count_instructions(splitext(filename)[0] + ".s")
+            seconds = max(total, 1e-3) / 1e3
+            slowest = max((x for x in stages if x in TOP_STAGES), key=lambda x: stages[x])
+            runs[str(size)] = {"lines": lines, "instructions": instrs, "total_ms": total,
+                               "lines_per_s": lines / seconds, "instructions_per_s": instrs / seconds,
+                               "stages_ms": stages}
+            print("  %8d %10d %10d %12.3f %14.0f %16.0f  %s (%.1f%%)" % (size, lines, instrs, total,
+                  lines / seconds, instrs / seconds, slowest, 100.0 * stages[slowest] / max(total, 1e-3)))
+        exponent = fit_exponent([(x, runs[str(x)]["total_ms"]) for x in get_sizes(kind)])
+        stage_exponents = {}
+        for stage in TOP_STAGES:
+            if all(stage in runs[str(x)]["stages_ms"] for x in get_sizes(kind)):
+                stage_exponents[stage] = fit_exponent([(x, runs[str(x)]["stages_ms"][stage])
+                                                       for x in get_sizes(kind)])
+        worst = max(stage_exponents, key=lambda x: stage_exponents[x]) if stage_exponents else ""
+        print("  scaling: time ~ size^%.2f, worst stage %s ~ size^%.2f" % (exponent, worst,
+              stage_exponents.get(worst, 0.0)))
+        results["kinds"][kind] = {"exponent": exponent, "stage_exponents": stage_exponents, "runs": runs}
+finally:
+    rmtree(tmp_dir)
+
+if SAVE_FILE:
+    with open(SAVE_FILE, "w") as file:
+        dump(results, file, indent=2)
+    print("")
+    print("baseline saved to " + SAVE_FILE)
+
+RETURN_CODE = 0
+if BASELINE_FILE:
+    with open(BASELINE_FILE) as file:
+        baseline = load(file)
+    print("")
+    print("----------------------------------------------------------------------")
+    print("--compare " + BASELINE_FILE + " (threshold " + str(int(THRESHOLD * 100)) + "%)")
+    print("----------------------------------------------------------------------")
+    if baseline["optim"] != OPTIM:
+        print("  warning: baseline measured with " + baseline["optim"])
+    for kind in results["kinds"]:
+        if kind not in baseline["kinds"]:
+            continue
+        for size in results["kinds"][kind]["runs"]:
+            if size not in baseline["kinds"][kind]["runs"]:
+                continue
+            old = baseline["kinds"][kind]["runs"][size]["lines_per_s"]
+            new = results["kinds"][kind]["runs"][size]["lines_per_s"]
+            ratio = new / old if old > 0 else 1.0
+            status = "ok"
+            if ratio < 1.0 - THRESHOLD:
+                status = "REGRESSION"
+                RETURN_CODE = 1
+            print("  %-12s %8s %14.0f -> %14.0f lines/s %+7.1f%%  %s" % (kind, size, old, new,
+                  100.0 * (ratio - 1.0), status))
+        old = baseline["kinds"][kind]["exponent"]
+        new = results["kinds"][kind]["exponent"]
+        status = "ok"
+        if new > old + THRESHOLD * 2:
+            status = "REGRESSION"
+            RETURN_CODE = 1
+        print("  %-12s %8s %14.2f -> %14.2f exponent  %s" % (kind, "scaling", old, new, status))
+
+exit(RETURN_CODE)
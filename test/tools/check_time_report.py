@@ -0,0 +1,45 @@
+from sys import argv, exit
+from json import loads
+from re import fullmatch
+
+# Checks that a time report printed by -ftime-report (table) or -ftime-report=json (json) is well-formed
+STAGE_KEYS = ["name", "calls", "wall_ms", "allocs", "bytes", "peak_rss_kb"]
+FUNCTION_KEYS = ["name", "stage", "instructions", "blocks", "dfa_iterations", "fixed_point_rounds"]
+
+def check_json(text):
+    report = loads(text)
+    if list(report.keys()) != ["stages", "functions"] or len(report["stages"]) == 0:
+        return False
+    for stage in report["stages"]:
+        if list(stage.keys()) != STAGE_KEYS or stage["calls"] < 1 or stage["wall_ms"] < 0.0:
+            return False
+    stage_names = set(stage["name"] for stage in report["stages"])
+    for function in report["functions"]:
+        if list(function.keys()) != FUNCTION_KEYS or function["stage"] not in stage_names:
+            return False
+    return True
+
+def check_table(text):
+    lines = text.splitlines()
+    if len(lines) < 3 or lines[0] != "Time report:" or lines[1].split()[0] != "stage":
+        return False
+    i = 2
+    while i < len(lines) and lines[i].split()[0] != "function":
+        if not fullmatch(r"\s+[a-z0-9 ]+?\s+\d+\s+\d+\.\d{3}\s+\d+\s+\d+\s+\d+", lines[i]):
+            return False
+        i += 1
+    if i == 2:
+        return False
+    # functions are only listed when level 1 optimizations or register allocation run
+    for line in lines[i + 1:]:
+        if not fullmatch(r"\s+\S+\s+[a-z0-9 ]+?\s+\d+\s+\d+\s+\d+\s+\d+", line):
+            return False
+    return True
+
+with open(argv[2]) as file:
+    text = file.read()
+try:
+    is_valid = check_json(text) if argv[1] == "json" else check_table(text)
+except (ValueError, KeyError, TypeError):
+    is_valid = False
+exit(0 if is_valid else 1)
@@ -16,17 +16,17 @@ fi
 
 ARG=${1}
 
-OPTIM="0 0"
+OPTIM="0 0 0 4 64 - 0"
 if [ "${1}" = "-O0" ]; then
     ARG=${2}
 elif [ "${1}" = "-O1" ]; then
-    OPTIM="15 0"
+    OPTIM="255 0 0 4 64 - 0"
     ARG=${2}
 elif [ "${1}" = "-O2" ]; then
-    OPTIM="0 2"
+    OPTIM="0 2 0 4 64 - 0"
     ARG=${2}
 elif [ "${1}" = "-O3" ]; then
-    OPTIM="15 2"
+    OPTIM="255 2 55 4 64 - 0"
     ARG=${2}
 fi
 